@@ -0,0 +1,357 @@
+#include "arrowstreamwriter.h"
+
+#include <QIODevice>
+#include <QtEndian>
+
+#include <cstring>
+
+#include "table.h"
+
+namespace
+{
+//Values of Message.fbs and Schema.fbs of the Arrow format
+const qint16 METADATA_V5 = 4;
+const quint8 HEADER_SCHEMA = 1;
+const quint8 HEADER_RECORD_BATCH = 3;
+const quint8 TYPE_INT = 2;
+const quint8 TYPE_FLOATING_POINT = 3;
+const quint8 TYPE_UTF8 = 5;
+const quint8 TYPE_BOOL = 6;
+const qint16 PRECISION_DOUBLE = 2;
+const quint32 CONTINUATION = 0xFFFFFFFF;
+
+/**
+ * @brief Lays out a flatbuffer front to back. Every object is appended after the one referring
+ * to it, so that all the unsigned offsets point forward, every vtable right before its table.
+ */
+class FlatBuilder
+{
+public:
+    struct Slot
+    {
+        int id;
+        int size;
+        qsizetype at;
+    };
+
+    FlatBuilder() : m_Data(4, '\0') {}      //the offset of the root table
+
+    inline const QByteArray& data() const { return this->m_Data; }
+
+    template<typename T> void set(const qsizetype& _at, const T& _value)
+    {
+        T value = qToLittleEndian(_value);
+        std::memcpy(this->m_Data.data() + _at, &value, sizeof(T));
+    }
+
+    void link(const qsizetype& _at, const qsizetype& _target)
+    {
+        set<quint32>(_at, static_cast<quint32>(_target - _at));
+    }
+
+    /**
+     * @brief Append a vtable and its table with the fields of _slots, the position of every field
+     * is stored in its slot. The fields are laid out by decreasing size, aligned to their size.
+     */
+    qsizetype table(QList<Slot>& _slots)
+    {
+        int count = 0;
+        QList<int> order;
+        for (int i = 0, n = static_cast<int>(_slots.size()); i < n; ++i)
+        {
+            count = qMax(count, _slots.at(i).id + 1);
+            int j = static_cast<int>(order.size());
+            while (j > 0 && _slots.at(order.at(j - 1)).size < _slots.at(i).size)
+            {
+                --j;
+            }
+            order.insert(j, i);
+        }
+        QList<int> offsets(_slots.size(), 0);
+        int size = 4;
+        foreach (int i, order)
+        {
+            int field = _slots.at(i).size;
+            size = (size + field - 1) / field * field;
+            offsets[i] = size;
+            size += field;
+        }
+
+        pad(2);
+        qsizetype vtable = reserve(4 + 2 * count);
+        set<quint16>(vtable, static_cast<quint16>(4 + 2 * count));
+        set<quint16>(vtable + 2, static_cast<quint16>(size));
+        for (int i = 0, n = static_cast<int>(_slots.size()); i < n; ++i)
+        {
+            set<quint16>(vtable + 4 + 2 * _slots.at(i).id, static_cast<quint16>(offsets.at(i)));
+        }
+        pad(8);
+        qsizetype table = reserve(size);
+        set<qint32>(table, static_cast<qint32>(table - vtable));
+        for (int i = 0, n = static_cast<int>(_slots.size()); i < n; ++i)
+        {
+            _slots[i].at = table + offsets.at(i);
+        }
+        return table;
+    }
+
+    qsizetype string(const QByteArray& _text)
+    {
+        pad(4);
+        qsizetype at = reserve(4 + _text.size() + 1);
+        set<quint32>(at, static_cast<quint32>(_text.size()));
+        std::memcpy(this->m_Data.data() + at + 4, _text.constData(), _text.size());
+        return at;
+    }
+
+    /**
+     * @brief A vector of _count offsets, the one of element i is at the result + 4 + 4 * i.
+     */
+    qsizetype offsets(const int& _count)
+    {
+        pad(4);
+        qsizetype at = reserve(4 + 4 * _count);
+        set<quint32>(at, static_cast<quint32>(_count));
+        return at;
+    }
+
+    /**
+     * @brief A vector of structs of two longs, FieldNode or Buffer, from their values in pairs.
+     */
+    qsizetype pairs(const QList<qint64>& _values)
+    {
+        pad(8, 4);
+        qsizetype at = reserve(4 + 8 * _values.size());
+        set<quint32>(at, static_cast<quint32>(_values.size() / 2));
+        for (qsizetype i = 0, n = _values.size(); i < n; ++i)
+        {
+            set<qint64>(at + 4 + 8 * i, _values.at(i));
+        }
+        return at;
+    }
+
+    /**
+     * @brief Append the Message table, the root, and return the slot of its header.
+     */
+    qsizetype message(const quint8& _headerType, const qint64& _bodyLength)
+    {
+        QList<Slot> messageSlots = { {0, 2, 0}, {1, 1, 0}, {2, 4, 0}, {3, 8, 0} };
+        link(0, table(messageSlots));
+        set<qint16>(messageSlots.at(0).at, METADATA_V5);
+        set<quint8>(messageSlots.at(1).at, _headerType);
+        set<qint64>(messageSlots.at(3).at, _bodyLength);
+        return messageSlots.at(2).at;
+    }
+
+private:
+    void pad(const int& _alignment, const int& _shift = 0)
+    {
+        while ((this->m_Data.size() + _shift) % _alignment != 0)
+        {
+            this->m_Data.append('\0');
+        }
+    }
+
+    qsizetype reserve(const qsizetype& _size)
+    {
+        qsizetype at = this->m_Data.size();
+        this->m_Data.append(QByteArray(_size, '\0'));
+        return at;
+    }
+
+private:
+    QByteArray m_Data;
+};
+
+/**
+ * @brief Append a buffer to the body, 8 byte aligned, and its offset and length to _buffers.
+ */
+void addBuffer(QByteArray& _body, QList<qint64>& _buffers, const QByteArray& _data)
+{
+    _buffers << _body.size() << _data.size();
+    _body.append(_data);
+    while (_body.size() % 8 != 0)
+    {
+        _body.append('\0');
+    }
+}
+
+void setBit(QByteArray& _bits, const qsizetype& _index)
+{
+    _bits[_index >> 3] = static_cast<char>(_bits.at(_index >> 3) | (1 << (_index & 7)));
+}
+}
+
+bool ArrowStreamWriter::writeSchema(const QList<Column>& _columns)
+{
+    return writeMessage(schema(_columns), QByteArray());
+}
+
+bool ArrowStreamWriter::writeBatch(const QueryResult& _result)
+{
+    QByteArray body;
+    QByteArray metadata = recordBatch(_result, body);
+    return writeMessage(metadata, body);
+}
+
+/**
+ * @brief Write the end of stream marker.
+ */
+bool ArrowStreamWriter::writeEnd()
+{
+    QByteArray end(8, '\0');
+    qToLittleEndian<quint32>(CONTINUATION, end.data());
+    this->m_Bytes += end.size();
+    return this->m_Device->write(end) == end.size();
+}
+
+/**
+ * @brief Write an encapsulated message: the continuation marker, the length of the metadata
+ * padded to 8 bytes, the metadata and the body.
+ */
+bool ArrowStreamWriter::writeMessage(const QByteArray& _metadata, const QByteArray& _body)
+{
+    QByteArray message(8, '\0');
+    message.append(_metadata);
+    while (message.size() % 8 != 0)
+    {
+        message.append('\0');
+    }
+    qToLittleEndian<quint32>(CONTINUATION, message.data());
+    qToLittleEndian<qint32>(static_cast<qint32>(message.size() - 8), message.data() + 4);
+    message.append(_body);
+    this->m_Bytes += message.size();
+    return this->m_Device->write(message) == message.size();
+}
+
+QByteArray ArrowStreamWriter::schema(const QList<Column>& _columns)
+{
+    FlatBuilder builder;
+    qsizetype header = builder.message(HEADER_SCHEMA, 0);
+    QList<FlatBuilder::Slot> schemaSlots = { {1, 4, 0} };
+    builder.link(header, builder.table(schemaSlots));
+    qsizetype fields = builder.offsets(static_cast<int>(_columns.size()));
+    builder.link(schemaSlots.at(0).at, fields);
+
+    for (int i = 0, n = static_cast<int>(_columns.size()); i < n; ++i)
+    {
+        //name, nullable, type_type, type and children
+        QList<FlatBuilder::Slot> fieldSlots = { {0, 4, 0}, {1, 1, 0}, {2, 1, 0}, {3, 4, 0}, {5, 4, 0} };
+        builder.link(fields + 4 + 4 * i, builder.table(fieldSlots));
+        builder.set<quint8>(fieldSlots.at(1).at, 1);
+        builder.link(fieldSlots.at(0).at, builder.string(_columns.at(i).name().toUtf8()));
+
+        QList<FlatBuilder::Slot> typeSlots;
+        switch (QueryResult::typeOf(_columns.at(i).type()))
+        {
+        case QueryResult::Integer:
+            builder.set<quint8>(fieldSlots.at(2).at, TYPE_INT);
+            typeSlots = { {0, 4, 0}, {1, 1, 0} };
+            builder.link(fieldSlots.at(3).at, builder.table(typeSlots));
+            builder.set<qint32>(typeSlots.at(0).at, 64);
+            builder.set<quint8>(typeSlots.at(1).at, 1);
+            break;
+        case QueryResult::Double:
+            builder.set<quint8>(fieldSlots.at(2).at, TYPE_FLOATING_POINT);
+            typeSlots = { {0, 2, 0} };
+            builder.link(fieldSlots.at(3).at, builder.table(typeSlots));
+            builder.set<qint16>(typeSlots.at(0).at, PRECISION_DOUBLE);
+            break;
+        case QueryResult::Boolean:
+            builder.set<quint8>(fieldSlots.at(2).at, TYPE_BOOL);
+            builder.link(fieldSlots.at(3).at, builder.table(typeSlots));
+            break;
+        case QueryResult::Varchar:
+            builder.set<quint8>(fieldSlots.at(2).at, TYPE_UTF8);
+            builder.link(fieldSlots.at(3).at, builder.table(typeSlots));
+            break;
+        }
+        builder.link(fieldSlots.at(4).at, builder.offsets(0));
+    }
+    return builder.data();
+}
+
+/**
+ * @brief The RecordBatch message of a page, its buffers are appended to _body.
+ */
+QByteArray ArrowStreamWriter::recordBatch(const QueryResult& _result, QByteArray& _body)
+{
+    qsizetype rows = _result.rowCount();
+    QList<qint64> nodes;
+    QList<qint64> buffers;
+    for (int i = 0, n = _result.columnCount(); i < n; ++i)
+    {
+        QByteArray validity((rows + 7) / 8, '\0');
+        qint64 nulls = 0;
+        for (qsizetype row = 0; row < rows; ++row)
+        {
+            if (_result.isNull(row, i))
+            {
+                nulls++;
+            }
+            else
+            {
+                setBit(validity, row);
+            }
+        }
+        nodes << rows << nulls;
+        addBuffer(_body, buffers, nulls > 0 ? validity : QByteArray());
+
+        QByteArray data;
+        switch (_result.type(i))
+        {
+        case QueryResult::Integer:
+            data.resize(rows * 8);
+            for (qsizetype row = 0; row < rows; ++row)
+            {
+                qToLittleEndian<qint64>(_result.integer(row, i), data.data() + row * 8);
+            }
+            addBuffer(_body, buffers, data);
+            break;
+        case QueryResult::Double:
+            data.resize(rows * 8);
+            for (qsizetype row = 0; row < rows; ++row)
+            {
+                qToLittleEndian<double>(_result.real(row, i), data.data() + row * 8);
+            }
+            addBuffer(_body, buffers, data);
+            break;
+        case QueryResult::Boolean:
+            data.fill('\0', (rows + 7) / 8);
+            for (qsizetype row = 0; row < rows; ++row)
+            {
+                if (_result.boolean(row, i))
+                {
+                    setBit(data, row);
+                }
+            }
+            addBuffer(_body, buffers, data);
+            break;
+        case QueryResult::Varchar:
+        {
+            QByteArray offsets((rows + 1) * 4, '\0');
+            for (qsizetype row = 0; row < rows; ++row)
+            {
+                if (!_result.isNull(row, i))
+                {
+                    data.append(_result.text(row, i).toUtf8());
+                }
+                qToLittleEndian<qint32>(static_cast<qint32>(data.size()), offsets.data() + (row + 1) * 4);
+            }
+            addBuffer(_body, buffers, offsets);
+            addBuffer(_body, buffers, data);
+            break;
+        }
+        }
+    }
+
+    FlatBuilder builder;
+    qsizetype header = builder.message(HEADER_RECORD_BATCH, _body.size());
+    //length, nodes and buffers
+    QList<FlatBuilder::Slot> batchSlots = { {0, 8, 0}, {1, 4, 0}, {2, 4, 0} };
+    builder.link(header, builder.table(batchSlots));
+    builder.set<qint64>(batchSlots.at(0).at, rows);
+    builder.link(batchSlots.at(1).at, builder.pairs(nodes));
+    builder.link(batchSlots.at(2).at, builder.pairs(buffers));
+    return builder.data();
+}
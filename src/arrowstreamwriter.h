@@ -0,0 +1,45 @@
+#ifndef ARROWSTREAMWRITER_H
+#define ARROWSTREAMWRITER_H
+
+#include <QByteArray>
+#include <QList>
+
+#include "queryresult.h"
+
+class QIODevice;
+class Column;
+
+/**
+ * @brief Writes QueryResult pages as an Apache Arrow IPC stream, one record batch per page.
+ *
+ * Integer columns are written as int64, Double as float64, Boolean as bool and Varchar as utf8,
+ * all of them nullable. The flatbuffers of the schema and batch messages are encoded here, the
+ * stream needs no Arrow library to be written and is read by any Arrow implementation of the
+ * version 5 metadata.
+ */
+class ArrowStreamWriter
+{
+public:
+    explicit ArrowStreamWriter(QIODevice* _device) : m_Device(_device) {}
+
+    bool writeSchema(const QList<Column>& _columns);
+    bool writeBatch(const QueryResult& _result);
+    bool writeEnd();
+
+    /**
+     * @brief The bytes written so far.
+     */
+    inline qint64 bytes() const { return this->m_Bytes; }
+
+private:
+    bool writeMessage(const QByteArray& _metadata, const QByteArray& _body);
+
+    static QByteArray schema(const QList<Column>& _columns);
+    static QByteArray recordBatch(const QueryResult& _result, QByteArray& _body);
+
+private:
+    QIODevice* m_Device;
+    qint64 m_Bytes = 0;
+};
+
+#endif // ARROWSTREAMWRITER_H
@@ -0,0 +1,440 @@
+#include "avrodecoder.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QDateTime>
+#include <QtEndian>
+
+#include <cstring>
+
+#include "logging.h"
+
+/**
+ * @brief Compile the JSON schema of an AVRO topic.
+ * @param _definition
+ * @return nullptr when the schema is not valid
+ */
+QSharedPointer<const SchemaDecoder> AvroDecoder::compile(const QByteArray& _definition)
+{
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(_definition, &error);
+    QJsonValue schema;
+    if (error.error == QJsonParseError::NoError)
+    {
+        schema = doc.isArray() ? QJsonValue(doc.array()) : QJsonValue(doc.object());
+    }
+    else
+    {
+        //a bare primitive like "string" is not a JSON document
+        schema = QJsonValue(QString::fromUtf8(_definition).trimmed().remove('"'));
+    }
+
+    QSharedPointer<AvroDecoder> decoder(new AvroDecoder());
+    QHash<QString, int> named;
+    decoder->m_Root = decoder->compile(schema, QString(), named);
+    if (decoder->m_Root < 0)
+    {
+        qCWarning(lcDecode) << "Avro schema does not compile: " << QString::fromUtf8(_definition.left(256)) << Qt::endl;
+        return QSharedPointer<const SchemaDecoder>();
+    }
+    return decoder;
+}
+
+int AvroDecoder::addNode(const NodeType& _type, const QString& _logicalType)
+{
+    Node node { _type, QString(), _logicalType, QStringList(), QList<int>(), 0, 0 };
+    this->m_Nodes.append(node);
+    return this->m_Nodes.size() - 1;
+}
+
+/**
+ * @brief Compile a schema into the node table.
+ * @param _schema a type name, a union as array or a complex type as object
+ * @param _namespace the enclosing namespace of named types
+ * @param _named the named types compiled so far, by full name
+ * @return the index of the node, -1 on error
+ */
+int AvroDecoder::compile(const QJsonValue& _schema, const QString& _namespace, QHash<QString, int>& _named)
+{
+    if (_schema.isArray())
+    {
+        QJsonArray branches = _schema.toArray();
+        int index = addNode(AvroDecoder::Union);
+        for (int i = 0, n = branches.size(); i < n; ++i)
+        {
+            int branch = compile(branches[i], _namespace, _named);
+            if (branch < 0)
+            {
+                return -1;
+            }
+            this->m_Nodes[index].children << branch;
+        }
+        return index;
+    }
+
+    QString type;
+    QJsonObject object;
+    if (_schema.isString())
+    {
+        type = _schema.toString();
+    }
+    else if (_schema.isObject())
+    {
+        object = _schema.toObject();
+        if (object["type"].isArray() || object["type"].isObject())
+        {
+            return compile(object["type"], _namespace, _named);
+        }
+        type = object["type"].toString();
+    }
+    else
+    {
+        return -1;
+    }
+
+    QString logicalType = object["logicalType"].toString();
+    static const QHash<QString, NodeType> primitives = {
+        { "null", AvroDecoder::Null }, { "boolean", AvroDecoder::Boolean }, { "int", AvroDecoder::Int }, { "long", AvroDecoder::Long },
+        { "float", AvroDecoder::Float }, { "double", AvroDecoder::Double }, { "bytes", AvroDecoder::Bytes }, { "string", AvroDecoder::String }
+    };
+    if (primitives.contains(type))
+    {
+        int index = addNode(primitives.value(type), logicalType);
+        this->m_Nodes[index].scale = object["scale"].toInt();
+        return index;
+    }
+
+    if (type == "array" || type == "map")
+    {
+        int index = addNode(type == "array" ? AvroDecoder::Array : AvroDecoder::Map);
+        int child = compile(object[type == "array" ? "items" : "values"], _namespace, _named);
+        if (child < 0)
+        {
+            return -1;
+        }
+        this->m_Nodes[index].children << child;
+        return index;
+    }
+
+    if (type == "record" || type == "error" || type == "enum" || type == "fixed")
+    {
+        QString name = object["name"].toString();
+        QString space = object.contains("namespace") ? object["namespace"].toString() : _namespace;
+        if (name.contains('.'))
+        {
+            space = name.section('.', 0, -2);
+        }
+        else if (!space.isEmpty())
+        {
+            name = space + "." + name;
+        }
+
+        NodeType nodeType = type == "enum" ? AvroDecoder::Enum : (type == "fixed" ? AvroDecoder::Fixed : AvroDecoder::Record);
+        int index = addNode(nodeType, logicalType);
+        this->m_Nodes[index].name = name;
+        _named.insert(name, index); //before the fields, a record may refer to itself
+        if (nodeType == AvroDecoder::Enum)
+        {
+            foreach (const QJsonValue& symbol, object["symbols"].toArray())
+            {
+                this->m_Nodes[index].names << symbol.toString();
+            }
+        }
+        else if (nodeType == AvroDecoder::Fixed)
+        {
+            this->m_Nodes[index].size = object["size"].toInt();
+            this->m_Nodes[index].scale = object["scale"].toInt();
+        }
+        else
+        {
+            foreach (const QJsonValue& value, object["fields"].toArray())
+            {
+                QJsonObject field = value.toObject();
+                int child = compile(field["type"], space, _named);
+                if (child < 0)
+                {
+                    return -1;
+                }
+                this->m_Nodes[index].names << field["name"].toString();
+                this->m_Nodes[index].children << child;
+            }
+        }
+        return index;
+    }
+
+    //a reference to a named type
+    if (_named.contains(type))
+    {
+        return _named.value(type);
+    }
+    if (!_namespace.isEmpty() && _named.contains(_namespace + "." + type))
+    {
+        return _named.value(_namespace + "." + type);
+    }
+    qCWarning(lcDecode) << "Avro type " << type << " is not defined" << Qt::endl;
+    return -1;
+}
+
+QVariant AvroDecoder::decode(const QByteArray& _key, const QByteArrayView& _value) const
+{
+    Q_UNUSED(_key);
+    const char* pos = _value.data();
+    const char* end = pos + _value.size();
+    QVariant value;
+    if (!read(this->m_Root, pos, end, value, 0))
+    {
+        return QVariant();
+    }
+    return value;
+}
+
+/**
+ * @brief Longs and ints are zig-zag encoded varints.
+ */
+bool AvroDecoder::readLong(const char*& _pos, const char* _end, qint64& _value)
+{
+    quint64 value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (_pos >= _end)
+        {
+            return false;
+        }
+        quint8 byte = static_cast<quint8>(*_pos++);
+        value |= static_cast<quint64>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            _value = static_cast<qint64>(value >> 1) ^ -static_cast<qint64>(value & 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AvroDecoder::read(const int& _node, const char*& _pos, const char* _end, QVariant& _value, const int& _depth) const
+{
+    if (_depth > MAX_DEPTH)
+    {
+        return false;
+    }
+    const Node& node = this->m_Nodes[_node];
+    switch (node.type)
+    {
+    case AvroDecoder::Null:
+        _value = QVariant();
+        return true;
+    case AvroDecoder::Boolean:
+        if (_pos >= _end)
+        {
+            return false;
+        }
+        _value = *_pos++ != 0;
+        return true;
+    case AvroDecoder::Int:
+    case AvroDecoder::Long:
+    {
+        qint64 value;
+        if (!readLong(_pos, _end, value))
+        {
+            return false;
+        }
+        _value = logical(node, node.type == AvroDecoder::Int ? QVariant(static_cast<int>(value)) : QVariant(value));
+        return true;
+    }
+    case AvroDecoder::Float:
+    case AvroDecoder::Double:
+    {
+        int width = node.type == AvroDecoder::Float ? 4 : 8;
+        if (_end - _pos < width)
+        {
+            return false;
+        }
+        if (width == 4)
+        {
+            quint32 bits = qFromLittleEndian<quint32>(_pos);
+            float value;
+            memcpy(&value, &bits, sizeof(value));
+            _value = value;
+        }
+        else
+        {
+            quint64 bits = qFromLittleEndian<quint64>(_pos);
+            double value;
+            memcpy(&value, &bits, sizeof(value));
+            _value = value;
+        }
+        _pos += width;
+        return true;
+    }
+    case AvroDecoder::Bytes:
+    case AvroDecoder::String:
+    case AvroDecoder::Fixed:
+    {
+        qint64 length = node.size;
+        if (node.type != AvroDecoder::Fixed && !readLong(_pos, _end, length))
+        {
+            return false;
+        }
+        if (length < 0 || length > _end - _pos)
+        {
+            return false;
+        }
+        if (node.type == AvroDecoder::String)
+        {
+            _value = QString::fromUtf8(_pos, static_cast<int>(length));
+        }
+        else
+        {
+            _value = logical(node, QByteArray(_pos, static_cast<int>(length)));
+        }
+        _pos += length;
+        return true;
+    }
+    case AvroDecoder::Record:
+    {
+        QVariantMap record;
+        for (int i = 0, n = node.children.size(); i < n; ++i)
+        {
+            QVariant field;
+            if (!read(node.children[i], _pos, _end, field, _depth + 1))
+            {
+                return false;
+            }
+            record.insert(node.names[i], field);
+        }
+        _value = record;
+        return true;
+    }
+    case AvroDecoder::Enum:
+    {
+        qint64 index;
+        if (!readLong(_pos, _end, index) || index < 0 || index >= node.names.size())
+        {
+            return false;
+        }
+        _value = node.names[static_cast<int>(index)];
+        return true;
+    }
+    case AvroDecoder::Union:
+    {
+        qint64 index;
+        if (!readLong(_pos, _end, index) || index < 0 || index >= node.children.size())
+        {
+            return false;
+        }
+        return read(node.children[static_cast<int>(index)], _pos, _end, _value, _depth + 1);
+    }
+    case AvroDecoder::Array:
+    case AvroDecoder::Map:
+    {
+        //Blocks of items, a negative count is followed by the size of the block in bytes
+        QVariantList list;
+        QVariantMap map;
+        qint64 count = -1;
+        while (readLong(_pos, _end, count) && count != 0)
+        {
+            if (count < 0)
+            {
+                qint64 size;
+                if (!readLong(_pos, _end, size))
+                {
+                    return false;
+                }
+                count = -count;
+            }
+            if (count > qMax<qint64>(_end - _pos, 65536))
+            {
+                return false;
+            }
+            for (qint64 i = 0; i < count; ++i)
+            {
+                QString key;
+                if (node.type == AvroDecoder::Map)
+                {
+                    qint64 length;
+                    if (!readLong(_pos, _end, length) || length < 0 || length > _end - _pos)
+                    {
+                        return false;
+                    }
+                    key = QString::fromUtf8(_pos, static_cast<int>(length));
+                    _pos += length;
+                }
+                QVariant item;
+                if (!read(node.children.first(), _pos, _end, item, _depth + 1))
+                {
+                    return false;
+                }
+                if (node.type == AvroDecoder::Map)
+                {
+                    map.insert(key, item);
+                }
+                else
+                {
+                    list << item;
+                }
+            }
+        }
+        if (count != 0)
+        {
+            return false; //ran out of data before the end marker
+        }
+        _value = node.type == AvroDecoder::Map ? QVariant(map) : QVariant(list);
+        return true;
+    }
+    }
+    return false;
+}
+
+QVariant AvroDecoder::logical(const Node& _node, const QVariant& _value) const
+{
+    const QString& type = _node.logicalType;
+    if (type.isEmpty())
+    {
+        return _value;
+    }
+    if (type == "date")
+    {
+        return QDate(1970, 1, 1).addDays(_value.toLongLong());
+    }
+    if (type == "time-millis")
+    {
+        return QTime(0, 0).addMSecs(_value.toInt());
+    }
+    if (type == "time-micros")
+    {
+        return QTime(0, 0).addMSecs(static_cast<int>(_value.toLongLong() / 1000));
+    }
+    if (type == "timestamp-millis")
+    {
+        return QDateTime::fromMSecsSinceEpoch(_value.toLongLong(), Qt::UTC);
+    }
+    if (type == "timestamp-micros")
+    {
+        return QDateTime::fromMSecsSinceEpoch(_value.toLongLong() / 1000, Qt::UTC);
+    }
+    if (type == "decimal")
+    {
+        //a big endian two's complement unscaled value, up to 8 bytes are converted
+        QByteArray bytes = _value.toByteArray();
+        if (bytes.isEmpty() || bytes.size() > 8)
+        {
+            return _value;
+        }
+        //shifted unsigned, a negative value must not be shifted and the minimum has no absolute value
+        quint64 bits = static_cast<quint64>(static_cast<qint64>(static_cast<qint8>(bytes[0])));
+        for (int i = 1; i < bytes.size(); ++i)
+        {
+            bits = (bits << 8) | static_cast<quint8>(bytes[i]);
+        }
+        const qint64 unscaled = static_cast<qint64>(bits);
+        const quint64 magnitude = unscaled < 0 ? 0 - bits : bits;
+        QString digits = QString::number(magnitude).rightJustified(_node.scale + 1, '0');
+        if (_node.scale > 0)
+        {
+            digits.insert(digits.size() - _node.scale, '.');
+        }
+        return unscaled < 0 ? digits.prepend('-') : digits;
+    }
+    return _value;
+}
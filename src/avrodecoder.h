@@ -0,0 +1,61 @@
+#ifndef AVRODECODER_H
+#define AVRODECODER_H
+
+#include <QVector>
+#include <QHash>
+#include <QStringList>
+
+#include "schemadecoder.h"
+
+class QJsonValue;
+
+/**
+ * @brief Decoder of the Avro binary encoding.
+ *
+ * The JSON schema is compiled into a table of nodes, named types refer to their node by
+ * index so recursive records need no special handling. The logical types date, time-millis,
+ * time-micros, timestamp-millis, timestamp-micros and decimal are converted, the others are
+ * left as their underlying type.
+ */
+class AvroDecoder : public SchemaDecoder
+{
+public:
+    QVariant decode(const QByteArray& _key, const QByteArrayView& _value) const override;
+
+    static QSharedPointer<const SchemaDecoder> compile(const QByteArray& _definition);
+
+private:
+    explicit AvroDecoder() : SchemaDecoder("AVRO"), m_Root(-1) {}
+
+    enum NodeType
+    {
+        Null, Boolean, Int, Long, Float, Double, Bytes, String, Record, Enum, Array, Map, Union, Fixed
+    };
+
+    struct Node
+    {
+        NodeType type;
+        QString name;
+        QString logicalType;
+        QStringList names; //the fields of a record, the symbols of an enum
+        QList<int> children; //the field types of a record, the branches of a union, the items of an array or map
+        int size; //of a fixed
+        int scale; //of a decimal
+    };
+
+    int compile(const QJsonValue& _schema, const QString& _namespace, QHash<QString, int>& _named);
+    int addNode(const NodeType& _type, const QString& _logicalType = QString());
+
+    bool read(const int& _node, const char*& _pos, const char* _end, QVariant& _value, const int& _depth) const;
+    QVariant logical(const Node& _node, const QVariant& _value) const;
+
+    static bool readLong(const char*& _pos, const char* _end, qint64& _value);
+
+private:
+    QVector<Node> m_Nodes;
+    int m_Root;
+
+    static const int MAX_DEPTH = 128;
+};
+
+#endif // AVRODECODER_H
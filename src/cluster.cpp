@@ -8,6 +8,7 @@ Cluster& Cluster::operator =(const Cluster& _other)
     this->m_AdminUrl = _other.adminUrl();
     this->m_FunctionUrl = _other.functionUrl();
     this->m_PrestoUrl = _other.prestoUrl();
+    this->m_TlsAllowInsecureConnection = _other.tlsAllowInsecureConnection();
     this->m_Status = _other.status();
     return *this;
 }
@@ -16,7 +17,7 @@ bool Cluster::operator==(const Cluster& _other) const
 {
     return Token::operator==(_other) && this->adminUrl() == _other.adminUrl()
            && this->functionUrl() == _other.functionUrl() && this->prestoUrl() == _other.prestoUrl()
-           && this->status() == _other.status();
+           && this->tlsAllowInsecureConnection() == _other.tlsAllowInsecureConnection() && this->status() == _other.status();
 }
 
 Cluster Cluster::fromVariantMap(const QVariantMap& _var)
@@ -26,6 +27,7 @@ Cluster Cluster::fromVariantMap(const QVariantMap& _var)
     cluster.setAdminUrl(_var["serviceUrl"].toString());
     cluster.setFunctionUrl(_var["functionUrl"].toString());
     cluster.setPrestoUrl(_var["prestoUrl"].toString());
+    cluster.setTlsAllowInsecureConnection(_var["tlsAllowInsecureConnection"].toBool());
     cluster.setAuthtoken(_var["authToken"].toString());
     return cluster;
 }
@@ -36,5 +38,6 @@ QVariantMap Cluster::toQVariantMap() const
     map["serviceUrl"] = QVariant(this->m_AdminUrl);
     map["functionUrl"] = QVariant(this->m_FunctionUrl);
     map["prestoUrl"] = QVariant(this->m_PrestoUrl);
+    map["tlsAllowInsecureConnection"] = QVariant(this->m_TlsAllowInsecureConnection);
     return map;
 }
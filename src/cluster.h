@@ -12,8 +12,9 @@ public:
         Disconnected = 2
     };
 
-    explicit Cluster(): Token(), m_AdminUrl(QString()), m_FunctionUrl(QString()), m_PrestoUrl(QString()), m_Status(Cluster::Status::Disconnected) {}
-    Cluster(const Cluster& _other): Token(_other), m_AdminUrl(_other.adminUrl()), m_FunctionUrl(_other.functionUrl()), m_PrestoUrl(_other.prestoUrl()), m_Status(_other.status()) {}
+    explicit Cluster(): Token(), m_AdminUrl(QString()), m_FunctionUrl(QString()), m_PrestoUrl(QString()), m_TlsAllowInsecureConnection(false), m_Status(Cluster::Status::Disconnected) {}
+    Cluster(const Cluster& _other): Token(_other), m_AdminUrl(_other.adminUrl()), m_FunctionUrl(_other.functionUrl()), m_PrestoUrl(_other.prestoUrl()),
+        m_TlsAllowInsecureConnection(_other.tlsAllowInsecureConnection()), m_Status(_other.status()) {}
     Cluster& operator=(const Cluster& _other);
     bool operator==(const Cluster& _other) const;
 
@@ -26,6 +27,12 @@ public:
     inline void setPrestoUrl(const QString& _url) { this->m_PrestoUrl = _url; }
     inline QString prestoUrl() const { return this->m_PrestoUrl; }
 
+    /**
+     * @brief Accept any certificate of the cluster's https urls, for brokers with self-signed ones.
+     */
+    inline void setTlsAllowInsecureConnection(const bool& _allow) { this->m_TlsAllowInsecureConnection = _allow; }
+    inline bool tlsAllowInsecureConnection() const { return this->m_TlsAllowInsecureConnection; }
+
     inline void setStatus(const Cluster::Status& _status) { this->m_Status = _status; }
     inline Cluster::Status status() const { return this->m_Status; }
 
@@ -42,6 +49,7 @@ private:
     QString m_AdminUrl;
     QString m_FunctionUrl;
     QString m_PrestoUrl;
+    bool m_TlsAllowInsecureConnection;
     Cluster::Status m_Status;
 
 };
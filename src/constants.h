@@ -12,6 +12,25 @@ const QString APPLICATION_VERSION = "1.0.2";
 const QString SERVICE_HOST_KEY = "PULSAR_SERVICE_HOST/HOST";
 const QString FUNCTION_HOST_KEY = "PULSAR_FUNCTION_HOST/HOST";
 const QString PRESTO_HOST_KEY = "PULSAR_PRESTO_HOST/HOST";
+const QString PRESTO_MAX_ROWS_KEY = "PULSAR_PRESTO_HOST/MAX_ROWS";
+const QString PRESTO_POLL_MIN_INTERVAL_KEY = "PULSAR_PRESTO_HOST/POLL_MIN_INTERVAL";
+const QString PRESTO_POLL_MAX_INTERVAL_KEY = "PULSAR_PRESTO_HOST/POLL_MAX_INTERVAL";
+const QString PRESTO_EXPORT_QUEUED_PAGES_KEY = "PULSAR_PRESTO_HOST/EXPORT_QUEUED_PAGES";
+const QString LOGGING_RULES_KEY = "LOGGING/RULES";
+const QString MAX_IN_FLIGHT_REQUESTS_KEY = "HTTP_CLIENT/MAX_IN_FLIGHT_REQUESTS";
+const QString MESSAGE_FETCH_WINDOW_KEY = "HTTP_CLIENT/MESSAGE_FETCH_WINDOW";
+const QString CHUNK_MAX_BUFFERED_BYTES_KEY = "MESSAGE_CHUNK/MAX_BUFFERED_BYTES";
+const QString CHUNK_MAX_SCAN_ENTRIES_KEY = "MESSAGE_CHUNK/MAX_SCAN_ENTRIES";
+const QString MESSAGE_PAGE_SIZE_KEY = "MESSAGE_BROWSER/PAGE_SIZE";
+const QString MESSAGE_MAX_CACHED_BYTES_KEY = "MESSAGE_BROWSER/MAX_CACHED_BYTES";
+const QString LATEST_SCHEMA_TTL_KEY = "MESSAGE_BROWSER/LATEST_SCHEMA_TTL";
+const QString EXPORT_READ_AHEAD_KEY = "MESSAGE_EXPORT/READ_AHEAD";
+const QString EXPORT_MAX_BUFFERED_MESSAGES_KEY = "MESSAGE_EXPORT/MAX_BUFFERED_MESSAGES";
+const QString EXPORT_RECEIVER_QUEUE_SIZE_KEY = "MESSAGE_EXPORT/RECEIVER_QUEUE_SIZE";
+const QString CACHE_DEFAULT_TTL_KEY = "HTTP_CACHE/DEFAULT_TTL";
+const QString CACHE_MAX_ENTRIES_KEY = "HTTP_CACHE/MAX_ENTRIES";
+const QString CACHE_MAX_BYTES_KEY = "HTTP_CACHE/MAX_BYTES";
+const QString CACHE_MAX_STREAMED_BODY_KEY = "HTTP_CACHE/MAX_STREAMED_BODY";
 const QString GET_TENANTS_PATH_KEY = "PULSAR_SERVICE_PATH/GET_TENANTS_PATH";
 const QString GET_NAMESPACES_PATH_KEY = "PULSAR_SERVICE_PATH/GET_NAMESPACES_PATH";
 const QString GET_CLUSTERS_PATH_KEY = "PULSAR_SERVICE_PATH/GET_CLUSTERS_PATH";
@@ -21,6 +40,7 @@ const QString DELETE_TENANT_PATH_KEY = "PULSAR_SERVICE_PATH/DELETE_TENANT_PATH";
 const QString PUT_NEW_NAMESPACE_PATH_KEY = "PULSAR_SERVICE_PATH/PUT_NEW_NAMESPACE_PATH";
 const QString DELETE_NAMESPACE_PATH_KEY = "PULSAR_SERVICE_PATH/DELETE_NAMESPACE_PATH";
 const QString GET_TOPIC_STATS_KEY = "PULSAR_SERVICE_PATH/GET_TOPIC_STATS_PATH";
+const QString GET_PARTITIONED_TOPIC_STATS_KEY = "PULSAR_SERVICE_PATH/GET_PARTITIONED_TOPIC_STATS_PATH";
 const QString GET_TOPICS_PATH_KEY = "PULSAR_SERVICE_PATH/GET_TOPICS_PATH";
 const QString GET_PARTITIONED_TOPICS_PATH_KEY = "PULSAR_SERVICE_PATH/GET_PARTITIONED_TOPICS_PATH";
 const QString GET_PARTITIONS_TOPIC_PATH_KEY = "PULSAR_SERVICE_PATH/GET_PARTITIONS_TOPIC_PATH";
@@ -62,5 +82,7 @@ const QString PRESTO_STATEMENT_PATH_KEY = "PULSAR_SERVICE_PATH/PRESTO_STATEMENT_
 const QString PEEK_SUBSCRIPTION_MSG_PATH_KEY = "PULSAR_SERVICE_PATH/PEEK_SUBSCRIPTION_MSG_PATH";
 const QString PUT_SUBSCRIPTION_PATH_KEY = "PULSAR_SERVICE_PATH/PUT_SUBSCRIPTION_PATH";
 const QString DELETE_SUBSCRIPTION_PATH_KEY = "PULSAR_SERVICE_PATH/DELETE_SUBSCRIPTION_PATH";
+const QString GET_SCHEMA_PATH_KEY = "PULSAR_SERVICE_PATH/GET_SCHEMA_PATH";
+const QString GET_LATEST_SCHEMA_PATH_KEY = "PULSAR_SERVICE_PATH/GET_LATEST_SCHEMA_PATH";
 
 #endif // CONSTANTS_H
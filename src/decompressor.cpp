@@ -0,0 +1,301 @@
+#include "decompressor.h"
+
+#include <QtEndian>
+#include <cstring>
+
+#ifdef PDM_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "logging.h"
+
+/**
+ * @brief Map the compression name of the X-Pulsar-compression header.
+ * @param _name e.g. "LZ4", "ZSTD", "SNAPPY", "ZLIB" or "NONE"
+ * @return
+ */
+MessageMetadata::CompressionType Decompressor::compressionType(const QByteArray& _name)
+{
+    QByteArray name = _name.trimmed().toUpper();
+    if (name == "LZ4")
+    {
+        return MessageMetadata::LZ4;
+    }
+    if (name == "ZLIB")
+    {
+        return MessageMetadata::ZLIB;
+    }
+    if (name == "ZSTD")
+    {
+        return MessageMetadata::ZSTD;
+    }
+    if (name == "SNAPPY")
+    {
+        return MessageMetadata::SNAPPY;
+    }
+    return MessageMetadata::NONE;
+}
+
+/**
+ * @brief Decompress a payload.
+ * @param _type
+ * @param _input
+ * @param _uncompressedSize the size reported by the broker, the output must match it
+ * @param _output
+ * @return false if the codec is not available or the input does not decode to that size
+ */
+bool Decompressor::decompress(const MessageMetadata::CompressionType& _type, const QByteArray& _input, const int& _uncompressedSize, QByteArray& _output)
+{
+    if (_type == MessageMetadata::NONE)
+    {
+        _output = _input;
+        return true;
+    }
+    if (_uncompressedSize < 0)
+    {
+        _output.clear();
+        return false;
+    }
+
+    _output = QByteArray(_uncompressedSize, Qt::Uninitialized);
+    bool ok = false;
+    switch (_type)
+    {
+    case MessageMetadata::LZ4:
+        ok = lz4(_input, _output);
+        break;
+    case MessageMetadata::SNAPPY:
+        ok = snappy(_input, _output);
+        break;
+    case MessageMetadata::ZLIB:
+        ok = zlib(_input, _output);
+        break;
+    case MessageMetadata::ZSTD:
+        ok = zstd(_input, _output);
+        break;
+    default:
+        break;
+    }
+    if (!ok)
+    {
+        qCWarning(lcDecode) << "Decompress payload failed, compression: " << _type << ", size: " << _input.size() << " -> " << _uncompressedSize << Qt::endl;
+        _output.clear();
+    }
+    return ok;
+}
+
+/**
+ * @brief LZ4 block format: sequences of literals followed by a back reference, the last
+ * sequence has literals only.
+ */
+bool Decompressor::lz4(const QByteArray& _input, QByteArray& _output)
+{
+    const quint8* in = reinterpret_cast<const quint8*>(_input.constData());
+    const quint8* inEnd = in + _input.size();
+    quint8* out = reinterpret_cast<quint8*>(_output.data());
+    quint8* const outStart = out;
+    quint8* const outEnd = out + _output.size();
+
+    while (in < inEnd)
+    {
+        quint8 token = *in++;
+        qsizetype literals = token >> 4;
+        if (literals == 15)
+        {
+            quint8 byte;
+            do
+            {
+                if (in >= inEnd)
+                {
+                    return false;
+                }
+                byte = *in++;
+                literals += byte;
+            } while (byte == 255);
+        }
+        if (literals > inEnd - in || literals > outEnd - out)
+        {
+            return false;
+        }
+        memcpy(out, in, literals);
+        in += literals;
+        out += literals;
+        if (in >= inEnd)
+        {
+            break; //last sequence
+        }
+
+        if (inEnd - in < 2)
+        {
+            return false;
+        }
+        qsizetype offset = in[0] | (in[1] << 8);
+        in += 2;
+        if (offset == 0 || offset > out - outStart)
+        {
+            return false;
+        }
+        qsizetype length = token & 0x0F;
+        if (length == 15)
+        {
+            quint8 byte;
+            do
+            {
+                if (in >= inEnd)
+                {
+                    return false;
+                }
+                byte = *in++;
+                length += byte;
+            } while (byte == 255);
+        }
+        length += 4;
+        if (length > outEnd - out)
+        {
+            return false;
+        }
+        const quint8* match = out - offset;
+        for (qsizetype i = 0; i < length; ++i)
+        {
+            out[i] = match[i]; //may overlap
+        }
+        out += length;
+    }
+    return out == outEnd;
+}
+
+/**
+ * @brief Snappy raw format: the varint uncompressed length, then literal and copy elements.
+ */
+bool Decompressor::snappy(const QByteArray& _input, QByteArray& _output)
+{
+    const quint8* in = reinterpret_cast<const quint8*>(_input.constData());
+    const quint8* inEnd = in + _input.size();
+    quint8* out = reinterpret_cast<quint8*>(_output.data());
+    quint8* const outStart = out;
+    quint8* const outEnd = out + _output.size();
+
+    quint64 length = 0;
+    for (int shift = 0; ; shift += 7)
+    {
+        if (in >= inEnd || shift > 28)
+        {
+            return false;
+        }
+        quint8 byte = *in++;
+        length |= static_cast<quint64>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            break;
+        }
+    }
+    if (length != static_cast<quint64>(_output.size()))
+    {
+        return false;
+    }
+
+    while (in < inEnd)
+    {
+        quint8 tag = *in++;
+        qsizetype len;
+        qsizetype offset;
+        switch (tag & 0x03)
+        {
+        case 0: //literal
+        {
+            len = tag >> 2;
+            if (len >= 60)
+            {
+                int bytes = static_cast<int>(len) - 59;
+                if (inEnd - in < bytes)
+                {
+                    return false;
+                }
+                len = 0;
+                for (int i = 0; i < bytes; ++i)
+                {
+                    len |= static_cast<qsizetype>(in[i]) << (8 * i);
+                }
+                in += bytes;
+            }
+            len += 1;
+            if (len > inEnd - in || len > outEnd - out)
+            {
+                return false;
+            }
+            memcpy(out, in, len);
+            in += len;
+            out += len;
+            continue;
+        }
+        case 1:
+            if (inEnd - in < 1)
+            {
+                return false;
+            }
+            len = ((tag >> 2) & 0x07) + 4;
+            offset = ((tag >> 5) << 8) | in[0];
+            in += 1;
+            break;
+        case 2:
+            if (inEnd - in < 2)
+            {
+                return false;
+            }
+            len = (tag >> 2) + 1;
+            offset = qFromLittleEndian<quint16>(in);
+            in += 2;
+            break;
+        default:
+            if (inEnd - in < 4)
+            {
+                return false;
+            }
+            len = (tag >> 2) + 1;
+            offset = qFromLittleEndian<quint32>(in);
+            in += 4;
+            break;
+        }
+        if (offset == 0 || offset > out - outStart || len > outEnd - out)
+        {
+            return false;
+        }
+        const quint8* match = out - offset;
+        for (qsizetype i = 0; i < len; ++i)
+        {
+            out[i] = match[i]; //may overlap
+        }
+        out += len;
+    }
+    return out == outEnd;
+}
+
+/**
+ * @brief qUncompress expects the zlib stream behind the big endian uncompressed size.
+ */
+bool Decompressor::zlib(const QByteArray& _input, QByteArray& _output)
+{
+    QByteArray framed(4 + _input.size(), Qt::Uninitialized);
+    qToBigEndian<quint32>(static_cast<quint32>(_output.size()), framed.data());
+    memcpy(framed.data() + 4, _input.constData(), _input.size());
+    QByteArray result = qUncompress(framed);
+    if (result.size() != _output.size())
+    {
+        return false;
+    }
+    _output = result;
+    return true;
+}
+
+bool Decompressor::zstd(const QByteArray& _input, QByteArray& _output)
+{
+#ifdef PDM_HAVE_ZSTD
+    size_t size = ZSTD_decompress(_output.data(), _output.size(), _input.constData(), _input.size());
+    return !ZSTD_isError(size) && size == static_cast<size_t>(_output.size());
+#else
+    Q_UNUSED(_input);
+    Q_UNUSED(_output);
+    qCWarning(lcDecode) << "ZSTD payloads need a build with libzstd" << Qt::endl;
+    return false;
+#endif
+}
@@ -0,0 +1,30 @@
+#ifndef DECOMPRESSOR_H
+#define DECOMPRESSOR_H
+
+#include <QByteArray>
+
+#include "messagemetadata.h"
+
+/**
+ * @brief Decompression of entry payloads with the codecs of the pulsar producers.
+ *
+ * LZ4 (block format) and Snappy (raw format) are decoded here, ZLIB goes through qUncompress
+ * and ZSTD through libzstd when the build found it. Every codec writes into a buffer pre-sized
+ * from the uncompressed size the broker reports. The functions are reentrant and meant to run
+ * on worker threads.
+ */
+class Decompressor
+{
+public:
+    static MessageMetadata::CompressionType compressionType(const QByteArray& _name);
+
+    static bool decompress(const MessageMetadata::CompressionType& _type, const QByteArray& _input, const int& _uncompressedSize, QByteArray& _output);
+
+private:
+    static bool lz4(const QByteArray& _input, QByteArray& _output);
+    static bool snappy(const QByteArray& _input, QByteArray& _output);
+    static bool zlib(const QByteArray& _input, QByteArray& _output);
+    static bool zstd(const QByteArray& _input, QByteArray& _output);
+};
+
+#endif // DECOMPRESSOR_H
@@ -0,0 +1,240 @@
+#include "jsonreader.h"
+
+#include <cstring>
+
+JsonReader::JsonReader() : m_Pos(0), m_Finished(false), m_Started(false), m_ExpectName(false), m_SkipDepth(-1), m_Token(JsonReader::NoToken) {}
+
+void JsonReader::addData(const QByteArray& _data)
+{
+    //Drop what has been consumed once it is at least half of the buffer
+    if (this->m_Pos > 0 && this->m_Pos >= this->m_Buffer.size() / 2)
+    {
+        this->m_Buffer.remove(0, this->m_Pos);
+        this->m_Pos = 0;
+    }
+    this->m_Buffer.append(_data);
+}
+
+/**
+ * @brief No more data will be added, a trailing number or literal can be completed now.
+ */
+void JsonReader::finish()
+{
+    this->m_Finished = true;
+}
+
+JsonReader::TokenType JsonReader::readNext()
+{
+    if (this->m_Token == JsonReader::Invalid)
+    {
+        return this->m_Token;
+    }
+    forever
+    {
+        TokenType token = readToken();
+        this->m_Token = token;
+        if (token == JsonReader::NeedMoreData || token == JsonReader::EndDocument || token == JsonReader::Invalid)
+        {
+            return token;
+        }
+        if (this->m_SkipDepth >= 0)
+        {
+            if ((token == JsonReader::EndObject || token == JsonReader::EndArray) && depth() == this->m_SkipDepth)
+            {
+                this->m_SkipDepth = -1;
+            }
+            continue;
+        }
+        return token;
+    }
+}
+
+/**
+ * @brief Skip the object or array just started, readNext() resumes after its end token.
+ */
+void JsonReader::skipCurrent()
+{
+    if (this->m_Token == JsonReader::StartObject || this->m_Token == JsonReader::StartArray)
+    {
+        this->m_SkipDepth = depth() - 1;
+    }
+}
+
+JsonReader::TokenType JsonReader::fail(const QString& _error)
+{
+    this->m_Error = _error;
+    return JsonReader::Invalid;
+}
+
+JsonReader::TokenType JsonReader::readToken()
+{
+    const char* data = this->m_Buffer.constData();
+    const int size = this->m_Buffer.size();
+    forever
+    {
+        while (this->m_Pos < size && (data[this->m_Pos] == ' ' || data[this->m_Pos] == '\t' || data[this->m_Pos] == '\r' || data[this->m_Pos] == '\n'))
+        {
+            this->m_Pos++;
+        }
+        if (this->m_Pos >= size)
+        {
+            if (!this->m_Finished)
+            {
+                return JsonReader::NeedMoreData;
+            }
+            if (this->m_Started && this->m_Stack.isEmpty())
+            {
+                return JsonReader::EndDocument;
+            }
+            return fail(QString("Unexpected end of document"));
+        }
+
+        char c = data[this->m_Pos];
+        switch (c)
+        {
+        case ',':
+            if (this->m_Stack.isEmpty())
+            {
+                return fail(QString("Unexpected ',' at offset %1").arg(this->m_Pos));
+            }
+            this->m_ExpectName = this->m_Stack.endsWith('{');
+            this->m_Pos++;
+            continue;
+        case ':':
+            this->m_Pos++;
+            continue;
+        case '{':
+            this->m_Stack.append('{');
+            this->m_ExpectName = true;
+            this->m_Started = true;
+            this->m_Pos++;
+            return JsonReader::StartObject;
+        case '[':
+            this->m_Stack.append('[');
+            this->m_ExpectName = false;
+            this->m_Started = true;
+            this->m_Pos++;
+            return JsonReader::StartArray;
+        case '}':
+        case ']':
+            if (this->m_Stack.isEmpty() || this->m_Stack.back() != (c == '}' ? '{' : '['))
+            {
+                return fail(QString("Unbalanced '%1' at offset %2").arg(c).arg(this->m_Pos));
+            }
+            this->m_Stack.chop(1);
+            this->m_ExpectName = false;
+            this->m_Pos++;
+            return c == '}' ? JsonReader::EndObject : JsonReader::EndArray;
+        case '"':
+        {
+            int end = findStringEnd(this->m_Pos + 1);
+            if (end < 0)
+            {
+                return this->m_Finished ? fail(QString("Unterminated string")) : JsonReader::NeedMoreData;
+            }
+            QString str = unescape(data + this->m_Pos + 1, end - this->m_Pos - 1);
+            this->m_Pos = end + 1;
+            this->m_Started = true;
+            if (this->m_ExpectName)
+            {
+                this->m_ExpectName = false;
+                this->m_Name = str;
+                return JsonReader::Name;
+            }
+            this->m_Text = str;
+            return JsonReader::String;
+        }
+        default:
+        {
+            //number, true, false or null: runs up to the next delimiter
+            int end = this->m_Pos;
+            while (end < size && !strchr(",:]} \t\r\n", data[end]))
+            {
+                end++;
+            }
+            if (end >= size && !this->m_Finished)
+            {
+                return JsonReader::NeedMoreData;
+            }
+            QByteArray raw(data + this->m_Pos, end - this->m_Pos);
+            this->m_Pos = end;
+            this->m_Started = true;
+            this->m_Text = QString::fromLatin1(raw);
+            if (raw == "true" || raw == "false")
+            {
+                return JsonReader::Bool;
+            }
+            if (raw == "null")
+            {
+                return JsonReader::Null;
+            }
+            if (raw.isEmpty() || !(raw[0] == '-' || (raw[0] >= '0' && raw[0] <= '9')))
+            {
+                return fail(QString("Unexpected '%1' at offset %2").arg(QString::fromLatin1(raw.left(16))).arg(end - raw.size()));
+            }
+            return JsonReader::Number;
+        }
+        }
+    }
+}
+
+int JsonReader::findStringEnd(int _from) const
+{
+    const char* data = this->m_Buffer.constData();
+    const int size = this->m_Buffer.size();
+    for (int i = _from; i < size; ++i)
+    {
+        if (data[i] == '\\')
+        {
+            i++;
+        }
+        else if (data[i] == '"')
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+QString JsonReader::unescape(const char* _data, int _length)
+{
+    if (!memchr(_data, '\\', _length))
+    {
+        return QString::fromUtf8(_data, _length);
+    }
+
+    QString result;
+    int run = 0;
+    for (int i = 0; i < _length; ++i)
+    {
+        if (_data[i] != '\\')
+        {
+            continue;
+        }
+        result.append(QString::fromUtf8(_data + run, i - run));
+        char e = i + 1 < _length ? _data[i + 1] : '\0';
+        switch (e)
+        {
+        case 'b': result.append(QChar('\b')); break;
+        case 'f': result.append(QChar('\f')); break;
+        case 'n': result.append(QChar('\n')); break;
+        case 'r': result.append(QChar('\r')); break;
+        case 't': result.append(QChar('\t')); break;
+        case 'u':
+            if (i + 5 < _length)
+            {
+                bool ok;
+                ushort unit = QByteArray(_data + i + 2, 4).toUShort(&ok, 16);
+                //Surrogate pairs arrive as two escapes and combine in UTF-16 as they are
+                result.append(QChar(ok ? unit : 0xFFFD));
+                i += 4;
+            }
+            break;
+        default: result.append(QChar::fromLatin1(e)); break;
+        }
+        i++;
+        run = i + 1;
+    }
+    result.append(QString::fromUtf8(_data + run, _length - run));
+    return result;
+}
@@ -0,0 +1,73 @@
+#ifndef JSONREADER_H
+#define JSONREADER_H
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @brief Incremental pull parser for JSON text, in the spirit of QXmlStreamReader.
+ *
+ * Bytes are appended with addData() as they arrive and tokens are pulled with readNext().
+ * NeedMoreData is returned when the buffered input ends in the middle of a token; the
+ * token is re-read once more data has been added. No document tree is ever built.
+ */
+class JsonReader
+{
+public:
+    enum TokenType
+    {
+        NoToken = 0,
+        StartObject,
+        EndObject,
+        StartArray,
+        EndArray,
+        Name,
+        String,
+        Number,
+        Bool,
+        Null,
+        NeedMoreData,
+        EndDocument,
+        Invalid
+    };
+
+    explicit JsonReader();
+
+    void addData(const QByteArray& _data);
+    void finish();
+
+    TokenType readNext();
+    void skipCurrent();
+
+    inline TokenType tokenType() const { return this->m_Token; }
+    inline int depth() const { return this->m_Stack.size(); }
+    inline bool hasError() const { return this->m_Token == JsonReader::Invalid; }
+    inline QString errorString() const { return this->m_Error; }
+
+    inline QString name() const { return this->m_Name; }
+    inline QString text() const { return this->m_Text; }
+    inline qint64 toInteger() const { return this->m_Text.toLongLong(); }
+    inline double toDouble() const { return this->m_Text.toDouble(); }
+    inline bool toBool() const { return this->m_Text == "true"; }
+
+private:
+    TokenType readToken();
+    TokenType fail(const QString& _error);
+    int findStringEnd(int _from) const;
+    static QString unescape(const char* _data, int _length);
+
+private:
+    QByteArray m_Buffer;
+    int m_Pos;
+    bool m_Finished;
+    bool m_Started;
+    bool m_ExpectName;
+    int m_SkipDepth;
+    QByteArray m_Stack;
+    TokenType m_Token;
+    QString m_Name;
+    QString m_Text;
+    QString m_Error;
+};
+
+#endif // JSONREADER_H
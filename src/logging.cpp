@@ -0,0 +1,30 @@
+#include "logging.h"
+
+#include <QStringList>
+
+Q_LOGGING_CATEGORY(lcHttp, "pdm.http", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcAdmin, "pdm.admin", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcTopic, "pdm.topic", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcFunction, "pdm.function", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcPresto, "pdm.presto", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcDecode, "pdm.decode", QtInfoMsg)
+
+/**
+ * @brief Apply the filter rules of config.ini, QT_LOGGING_RULES still takes precedence.
+ * @param _rules one rule per entry, e.g. "pdm.http.debug=true"
+ */
+void setupLogging(const QStringList& _rules)
+{
+    QStringList rules;
+    foreach (const QString& rule, _rules)
+    {
+        if (!rule.trimmed().isEmpty())
+        {
+            rules << rule.trimmed();
+        }
+    }
+    if (!rules.isEmpty())
+    {
+        QLoggingCategory::setFilterRules(rules.join('\n'));
+    }
+}
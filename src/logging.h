@@ -0,0 +1,22 @@
+#ifndef LOGGING_H
+#define LOGGING_H
+
+#include <QLoggingCategory>
+
+/**
+ * Logging categories of the subsystems. Urls are logged at info level, request and response
+ * bodies and payload dumps at debug level, which is off unless enabled by a filter rule,
+ * e.g. "pdm.topic.debug=true" in LOGGING/RULES of config.ini or in QT_LOGGING_RULES.
+ * The arguments of a disabled statement are not evaluated. Release builds compile the
+ * debug statements out altogether.
+ */
+Q_DECLARE_LOGGING_CATEGORY(lcHttp)
+Q_DECLARE_LOGGING_CATEGORY(lcAdmin)
+Q_DECLARE_LOGGING_CATEGORY(lcTopic)
+Q_DECLARE_LOGGING_CATEGORY(lcFunction)
+Q_DECLARE_LOGGING_CATEGORY(lcPresto)
+Q_DECLARE_LOGGING_CATEGORY(lcDecode)
+
+void setupLogging(const QStringList& _rules);
+
+#endif // LOGGING_H
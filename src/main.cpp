@@ -2,10 +2,12 @@
 
 #include <QApplication>
 #include <QDir>
+#include <QSettings>
 
 #include <qca-qt6/QtCrypto>
 
 #include "constants.h"
+#include "logging.h"
 
 int main(int argc, char* argv[])
 {
@@ -14,6 +16,8 @@ int main(int argc, char* argv[])
     QApplication a(argc, argv);
 
     QDir basePath(QCoreApplication::applicationDirPath());
+    QSettings settings(basePath.absoluteFilePath(INI_FILE), QSettings::IniFormat);
+    setupLogging(settings.value(LOGGING_RULES_KEY).toStringList());
     qDebug() << "The application's working directory: " << QDir::currentPath() << Qt::endl;
 
     QCoreApplication::addLibraryPath(basePath.absoluteFilePath("plugins"));
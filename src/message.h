@@ -8,8 +8,10 @@ class Message
 public:
     explicit Message();
     Message(const int& _ledgerId, const int& _entryId);
-    Message(const Message& _other) { *this = _other; }
-    Message& operator=(const Message& _other);
+    Message(const Message& _other) = default;
+    Message(Message&& _other) noexcept = default;
+    Message& operator=(const Message& _other) = default;
+    Message& operator=(Message&& _other) noexcept = default;
 
     inline void setLedgerId(const int& _ledgerId) { this->m_LedgerId = _ledgerId; }
     inline int ledgerId() const { return this->m_LedgerId; }
@@ -0,0 +1,348 @@
+#include "messagefilter.h"
+
+#include <QPointer>
+#include <QThreadPool>
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include <algorithm>
+
+MessageFilter::MessageFilter(QObject* parent) : QObject(parent), m_Job(0), m_Running(0), m_Done(0), m_Total(0)
+{
+}
+
+MessageFilter::~MessageFilter()
+{
+    cancel();
+}
+
+bool MessageFilter::setCriteria(const Field& _field, const Mode& _mode, const QString& _text)
+{
+    this->m_Error.clear();
+    QSharedPointer<Criteria> criteria(new Criteria);
+    criteria->field = _field;
+    criteria->mode = _mode;
+    criteria->text = _text;
+    criteria->hasExpected = false;
+    if (!_text.isEmpty())
+    {
+        switch (_mode)
+        {
+        case Contains:
+            criteria->needle = _text.toUtf8();
+            break;
+        case Regex:
+            criteria->regex = QRegularExpression(_text);
+            if (!criteria->regex.isValid())
+            {
+                this->m_Error = criteria->regex.errorString();
+                return false;
+            }
+            criteria->regex.optimize(); //compiled here, not by the first worker
+            break;
+        case JsonPath:
+            if (!parsePath(_text, *criteria, this->m_Error))
+            {
+                return false;
+            }
+            break;
+        }
+    }
+    this->m_Criteria = criteria;
+    return true;
+}
+
+bool MessageFilter::isEmpty() const
+{
+    return this->m_Criteria.isNull() || this->m_Criteria->text.isEmpty();
+}
+
+/**
+ * @brief The messages are shared with the workers, a slice reports back once all of its
+ * messages are evaluated or stops early when the job is cancelled.
+ */
+void MessageFilter::start(const QList<PulsarMessage>& _messages)
+{
+    cancel();
+    this->m_Matches.clear();
+    this->m_Done = 0;
+    this->m_Total = _messages.size();
+    if (this->m_Total == 0 || isEmpty())
+    {
+        for (int i = 0; i < this->m_Total; ++i)
+        {
+            this->m_Matches << i;
+        }
+        emit progress(this->m_Total, this->m_Total);
+        emit finished(this->m_Matches);
+        return;
+    }
+
+    QSharedPointer<QAtomicInt> canceled(new QAtomicInt(0));
+    this->m_Canceled = canceled;
+    QSharedPointer<const Criteria> criteria = this->m_Criteria;
+    QPointer<MessageFilter> self(this);
+    int job = this->m_Job;
+    this->m_Running = (this->m_Total + SLICE_SIZE - 1) / SLICE_SIZE;
+    for (int start = 0; start < this->m_Total; start += SLICE_SIZE)
+    {
+        int end = qMin(start + SLICE_SIZE, this->m_Total);
+        QThreadPool::globalInstance()->start([self, job, canceled, criteria, _messages, start, end]()
+        {
+            QList<int> found;
+            for (int i = start; i < end; ++i)
+            {
+                if (canceled->loadRelaxed() != 0)
+                {
+                    return;
+                }
+                if (matches(*criteria, _messages.at(i)))
+                {
+                    found << i;
+                }
+            }
+            QMetaObject::invokeMethod(QCoreApplication::instance(), [self, job, start, end, found]()
+            {
+                if (!self.isNull())
+                {
+                    self->completed(job, end - start, found);
+                }
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void MessageFilter::cancel()
+{
+    if (!this->m_Canceled.isNull())
+    {
+        this->m_Canceled->storeRelaxed(1);
+        this->m_Canceled.reset();
+    }
+    this->m_Job++;
+    this->m_Running = 0;
+}
+
+void MessageFilter::completed(const int& _job, const int& _count, const QList<int>& _matches)
+{
+    if (_job != this->m_Job || this->m_Running == 0)
+    {
+        return; //a cancelled job
+    }
+    this->m_Matches << _matches;
+    this->m_Done += _count;
+    emit progress(this->m_Done, this->m_Total);
+    if (--this->m_Running == 0)
+    {
+        this->m_Canceled.reset();
+        std::sort(this->m_Matches.begin(), this->m_Matches.end());
+        emit finished(this->m_Matches);
+    }
+}
+
+/**
+ * @brief Reads <tt>$.a.b[2].c</tt> or <tt>a.b[2].c</tt>, followed by an optional
+ * <tt>== value</tt>. Quotes around the value are dropped.
+ */
+bool MessageFilter::parsePath(const QString& _text, Criteria& _criteria, QString& _error)
+{
+    QString path = _text.trimmed();
+    int length = 2;
+    int equals = path.indexOf("==");
+    if (equals < 0)
+    {
+        length = 1;
+        equals = path.indexOf('=');
+    }
+    if (equals >= 0)
+    {
+        _criteria.hasExpected = true;
+        _criteria.expected = path.mid(equals + length).trimmed();
+        if (_criteria.expected.size() >= 2 && _criteria.expected.startsWith('"') && _criteria.expected.endsWith('"'))
+        {
+            _criteria.expected = _criteria.expected.mid(1, _criteria.expected.size() - 2);
+        }
+        path = path.left(equals).trimmed();
+    }
+    if (path.startsWith('$'))
+    {
+        path = path.mid(1);
+    }
+
+    QString name;
+    for (int i = 0, n = path.size(); i < n; ++i)
+    {
+        QChar c = path.at(i);
+        if (c == '.' || c == '[')
+        {
+            if (!name.isEmpty())
+            {
+                _criteria.path << name;
+                name.clear();
+            }
+            if (c == '[')
+            {
+                bool ok = false;
+                int close = path.indexOf(']', i);
+                int index = close < 0 ? -1 : path.mid(i + 1, close - i - 1).trimmed().toInt(&ok);
+                if (!ok || index < 0)
+                {
+                    _error = tr("Invalid array index at %1").arg(i);
+                    return false;
+                }
+                _criteria.path << QString("[%1]").arg(index);
+                i = close;
+            }
+        }
+        else
+        {
+            name += c;
+        }
+    }
+    if (!name.isEmpty())
+    {
+        _criteria.path << name;
+    }
+    if (_criteria.path.isEmpty())
+    {
+        _error = tr("The JSON path is empty");
+        return false;
+    }
+    return true;
+}
+
+bool MessageFilter::matches(const Criteria& _criteria, const PulsarMessage& _message)
+{
+    if (_criteria.text.isEmpty())
+    {
+        return true;
+    }
+    bool any = _criteria.field == Any;
+    if (any || _criteria.field == Key)
+    {
+        bool matched = _criteria.mode == JsonPath ? matchJson(_criteria, QJsonValue(_message.key())) : matchText(_criteria, _message.key());
+        if (matched)
+        {
+            return true;
+        }
+    }
+    if ((any || _criteria.field == Properties) && matchProperties(_criteria, _message.properties()))
+    {
+        return true;
+    }
+    if (any || _criteria.field == Body)
+    {
+        QByteArrayView body = _message.bodyView();
+        switch (_criteria.mode)
+        {
+        case Contains:
+            return std::search(body.begin(), body.end(), _criteria.needle.begin(), _criteria.needle.end()) != body.end();
+        case Regex:
+            return matchText(_criteria, QString::fromUtf8(body));
+        case JsonPath:
+        {
+            QJsonDocument doc = QJsonDocument::fromJson(_message.body());
+            if (doc.isObject())
+            {
+                return matchJson(_criteria, doc.object());
+            }
+            if (doc.isArray())
+            {
+                return matchJson(_criteria, doc.array());
+            }
+            return false;
+        }
+        }
+    }
+    return false;
+}
+
+bool MessageFilter::matchText(const Criteria& _criteria, const QString& _text)
+{
+    if (_criteria.mode == Regex)
+    {
+        return _criteria.regex.match(_text).hasMatch();
+    }
+    return _text.contains(_criteria.text);
+}
+
+/**
+ * @brief A property is matched as <tt>name=value</tt>, a JSON path starts with the name of the
+ * property.
+ */
+bool MessageFilter::matchProperties(const Criteria& _criteria, const Properties& _properties)
+{
+    if (_criteria.mode == JsonPath)
+    {
+        QJsonObject object;
+        for (Properties::const_iterator it = _properties.constBegin(); it != _properties.constEnd(); ++it)
+        {
+            object.insert(it.key(), it.value());
+        }
+        return matchJson(_criteria, object);
+    }
+    for (Properties::const_iterator it = _properties.constBegin(); it != _properties.constEnd(); ++it)
+    {
+        if (matchText(_criteria, it.key() + "=" + it.value()))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Walks the path, a string on the way is read as a JSON document so that a key or a
+ * property holding JSON can be looked into.
+ */
+bool MessageFilter::matchJson(const Criteria& _criteria, QJsonValue _value)
+{
+    foreach (const QString& segment, _criteria.path)
+    {
+        if (_value.isString())
+        {
+            QJsonDocument doc = QJsonDocument::fromJson(_value.toString().toUtf8());
+            _value = doc.isObject() ? QJsonValue(doc.object()) : doc.isArray() ? QJsonValue(doc.array()) : QJsonValue(QJsonValue::Undefined);
+        }
+        if (segment.startsWith('['))
+        {
+            int index = segment.mid(1, segment.size() - 2).toInt();
+            if (!_value.isArray() || index >= _value.toArray().size())
+            {
+                return false;
+            }
+            _value = _value.toArray().at(index);
+        }
+        else
+        {
+            if (!_value.isObject() || !_value.toObject().contains(segment))
+            {
+                return false;
+            }
+            _value = _value.toObject().value(segment);
+        }
+    }
+    if (!_criteria.hasExpected)
+    {
+        return true;
+    }
+    switch (_value.type())
+    {
+    case QJsonValue::String:
+        return _value.toString() == _criteria.expected;
+    case QJsonValue::Double:
+    {
+        bool ok = false;
+        double expected = _criteria.expected.toDouble(&ok);
+        return ok && expected == _value.toDouble();
+    }
+    case QJsonValue::Bool:
+        return _criteria.expected == (_value.toBool() ? "true" : "false");
+    case QJsonValue::Null:
+        return _criteria.expected == "null";
+    default:
+        return false;
+    }
+}
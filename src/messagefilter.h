@@ -0,0 +1,97 @@
+#ifndef MESSAGEFILTER_H
+#define MESSAGEFILTER_H
+
+#include <QObject>
+#include <QRegularExpression>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include <QJsonValue>
+
+#include "pulsarmessage.h"
+
+/**
+ * @brief Evaluates a predicate over a list of messages on the global thread pool.
+ *
+ * The predicate looks at the key, the properties or the body of a message, or at any of them,
+ * with a substring, a regular expression or a JSON path equality such as
+ * <tt>$.order.items[0].id == 42</tt>. A JSON path without a value only asks for the path to
+ * exist. The list is cut into slices that run concurrently, a running filter is cancelled by
+ * the next start() or by cancel() and its results are dropped.
+ */
+class MessageFilter : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Field
+    {
+        Any,
+        Key,
+        Properties,
+        Body
+    };
+
+    enum Mode
+    {
+        Contains,
+        Regex,
+        JsonPath
+    };
+
+    explicit MessageFilter(QObject* parent = nullptr);
+    virtual ~MessageFilter();
+
+    /**
+     * @brief Compiles the predicate, an empty text matches every message.
+     * @return false when the text is not a valid expression of the mode, see errorString()
+     */
+    bool setCriteria(const Field& _field, const Mode& _mode, const QString& _text);
+    inline QString errorString() const { return this->m_Error; }
+    bool isEmpty() const;
+
+    void start(const QList<PulsarMessage>& _messages);
+    void cancel();
+    inline bool isRunning() const { return this->m_Running > 0; }
+
+signals:
+    void progress(int _done, int _total);
+    /**
+     * @brief The indexes of the matching messages in ascending order.
+     */
+    void finished(const QList<int>& _matches);
+
+private:
+    struct Criteria
+    {
+        Field field;
+        Mode mode;
+        QString text;
+        QByteArray needle;
+        QRegularExpression regex;
+        QStringList path;
+        bool hasExpected;
+        QString expected;
+    };
+
+    void completed(const int& _job, const int& _count, const QList<int>& _matches);
+
+    static bool parsePath(const QString& _text, Criteria& _criteria, QString& _error);
+    static bool matches(const Criteria& _criteria, const PulsarMessage& _message);
+    static bool matchText(const Criteria& _criteria, const QString& _text);
+    static bool matchProperties(const Criteria& _criteria, const Properties& _properties);
+    static bool matchJson(const Criteria& _criteria, QJsonValue _value);
+
+private:
+    QSharedPointer<const Criteria> m_Criteria;
+    QSharedPointer<QAtomicInt> m_Canceled;
+    QString m_Error;
+    int m_Job;
+    int m_Running;
+    int m_Done;
+    int m_Total;
+    QList<int> m_Matches;
+
+    static const int SLICE_SIZE = 2048;
+};
+
+#endif // MESSAGEFILTER_H
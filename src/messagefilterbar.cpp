@@ -0,0 +1,172 @@
+#include "messagefilterbar.h"
+
+#include <QHBoxLayout>
+#include <QComboBox>
+#include <QLineEdit>
+#include <QLabel>
+#include <QPushButton>
+#include <QTimer>
+#include <QTreeView>
+
+#include "messagefilter.h"
+#include "messagemodel.h"
+
+MessageFilterBar::MessageFilterBar(QTreeView* _view, MessageModel* _model, QWidget* _parent) : QWidget(_parent), m_Timer(new QTimer(this)), m_Filter(new MessageFilter(this)), m_View(_view), m_Model(_model), m_Scroll(false)
+{
+    this->cbField = new QComboBox;
+    this->cbField->addItem(tr("Any"), MessageFilter::Any);
+    this->cbField->addItem(tr("Key"), MessageFilter::Key);
+    this->cbField->addItem(tr("Properties"), MessageFilter::Properties);
+    this->cbField->addItem(tr("Body"), MessageFilter::Body);
+    this->cbMode = new QComboBox;
+    this->cbMode->addItem(tr("Contains"), MessageFilter::Contains);
+    this->cbMode->addItem(tr("Regex"), MessageFilter::Regex);
+    this->cbMode->addItem(tr("JSON Path"), MessageFilter::JsonPath);
+    this->tbText = new QLineEdit;
+    this->tbText->setClearButtonEnabled(true);
+    this->tbText->setPlaceholderText(tr("order-42, ^ord-\\d+$ or $.order.id == 42"));
+    this->btnCancel = new QPushButton(tr("Cancel"));
+    this->btnCancel->setEnabled(false);
+    this->lblStatus = new QLabel;
+
+    QHBoxLayout* layout = new QHBoxLayout;
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(new QLabel(tr("Filter:")));
+    layout->addWidget(this->cbField);
+    layout->addWidget(this->cbMode);
+    layout->addWidget(this->tbText, 1);
+    layout->addWidget(this->btnCancel);
+    layout->addWidget(this->lblStatus);
+    setLayout(layout);
+
+    this->m_Timer->setSingleShot(true);
+    this->m_Timer->setInterval(300);
+
+    connect(this->tbText, &QLineEdit::textChanged, this, &MessageFilterBar::handleCriteriaChanged);
+    connect(this->tbText, &QLineEdit::returnPressed, this, &MessageFilterBar::handleApply);
+    connect(this->cbField, &QComboBox::currentIndexChanged, this, &MessageFilterBar::handleCriteriaChanged);
+    connect(this->cbMode, &QComboBox::currentIndexChanged, this, &MessageFilterBar::handleCriteriaChanged);
+    connect(this->btnCancel, &QPushButton::clicked, this, &MessageFilterBar::handleCancel);
+    connect(this->m_Timer, &QTimer::timeout, this, &MessageFilterBar::handleApply);
+    connect(this->m_Filter, &MessageFilter::progress, this, &MessageFilterBar::handleProgress);
+    connect(this->m_Filter, &MessageFilter::finished, this, &MessageFilterBar::handleFinished);
+    connect(this->m_Model, &QAbstractItemModel::modelAboutToBeReset, this, &MessageFilterBar::handleReset);
+}
+
+/**
+ * @brief Run an active filter again, over the messages in memory now.
+ */
+void MessageFilterBar::refresh()
+{
+    if (isActive())
+    {
+        apply(false);
+    }
+}
+
+bool MessageFilterBar::isActive() const
+{
+    return !this->tbText->text().isEmpty();
+}
+
+void MessageFilterBar::handleCriteriaChanged()
+{
+    this->m_Timer->start();
+}
+
+void MessageFilterBar::handleApply()
+{
+    apply(true);
+}
+
+/**
+ * @brief _scroll is left out when pages come in, so the view stays where it was scrolled to.
+ */
+void MessageFilterBar::apply(const bool& _scroll)
+{
+    this->m_Scroll = _scroll;
+    this->m_Timer->stop();
+    this->m_Filter->cancel();
+    this->btnCancel->setEnabled(false);
+    if (!isActive())
+    {
+        this->m_Indexes.clear();
+        this->m_Model->setMatches(QModelIndexList());
+        this->lblStatus->clear();
+        return;
+    }
+    MessageFilter::Field field = static_cast<MessageFilter::Field>(this->cbField->currentData().toInt());
+    MessageFilter::Mode mode = static_cast<MessageFilter::Mode>(this->cbMode->currentData().toInt());
+    if (!this->m_Filter->setCriteria(field, mode, this->tbText->text()))
+    {
+        this->lblStatus->setText(this->m_Filter->errorString());
+        return;
+    }
+    this->btnCancel->setEnabled(true);
+    this->lblStatus->setText(tr("Filtering..."));
+    QList<PulsarMessage> messages;
+    this->m_Indexes.clear();
+    this->m_Model->residentMessages(this->m_Indexes, messages);
+    this->m_Filter->start(messages);
+}
+
+void MessageFilterBar::handleCancel()
+{
+    this->m_Timer->stop();
+    this->m_Filter->cancel();
+    this->btnCancel->setEnabled(false);
+    this->lblStatus->setText(tr("Cancelled"));
+}
+
+/**
+ * @brief The rows are gone, so is the running filter.
+ */
+void MessageFilterBar::handleReset()
+{
+    this->m_Filter->cancel();
+    this->m_Indexes.clear();
+    this->btnCancel->setEnabled(false);
+    this->lblStatus->clear();
+}
+
+void MessageFilterBar::handleProgress(int _done, int _total)
+{
+    if (_done < _total)
+    {
+        this->lblStatus->setText(tr("Filtering %1 of %2...").arg(_done).arg(_total));
+    }
+}
+
+/**
+ * @brief The rows not in memory are not looked at, the status tells how many there are.
+ */
+void MessageFilterBar::handleFinished(const QList<int>& _matches)
+{
+    this->btnCancel->setEnabled(false);
+    QModelIndexList indexes;
+    indexes.reserve(_matches.size());
+    foreach (int row, _matches)
+    {
+        indexes << this->m_Indexes.at(row);
+    }
+    this->m_Model->setMatches(indexes);
+    foreach (const QModelIndex& index, indexes)
+    {
+        if (index.parent().isValid())
+        {
+            this->m_View->expand(index.parent());
+        }
+    }
+    if (this->m_Scroll && !indexes.isEmpty())
+    {
+        this->m_View->scrollTo(indexes.first());
+    }
+
+    QString status = tr("%1 of %2 match").arg(_matches.size()).arg(this->m_Indexes.size());
+    int unloaded = this->m_Model->leafCount() - this->m_Indexes.size();
+    if (unloaded > 0)
+    {
+        status.append(tr(", %1 not in memory").arg(unloaded));
+    }
+    this->lblStatus->setText(status);
+}
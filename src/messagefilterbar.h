@@ -0,0 +1,61 @@
+#ifndef MESSAGEFILTERBAR_H
+#define MESSAGEFILTERBAR_H
+
+#include <QWidget>
+#include <QModelIndex>
+
+#include "pulsarmessage.h"
+
+class QComboBox;
+class QLineEdit;
+class QLabel;
+class QPushButton;
+class QTimer;
+class QTreeView;
+class MessageModel;
+class MessageFilter;
+
+/**
+ * @brief The filter bar of the message windows.
+ *
+ * Picks the part of the message to look at and the kind of predicate, and runs a MessageFilter
+ * over the messages of a MessageModel that are in memory. Matching rows are highlighted and the
+ * batches holding one are expanded. The filter starts a moment after the typing stops or on
+ * Enter, and again on refresh() once pages were read.
+ */
+class MessageFilterBar : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit MessageFilterBar(QTreeView* _view, MessageModel* _model, QWidget* _parent = nullptr);
+
+    void refresh();
+    bool isActive() const;
+
+private slots:
+    void handleCriteriaChanged();
+    void handleApply();
+    void handleCancel();
+    void handleReset();
+    void handleProgress(int _done, int _total);
+    void handleFinished(const QList<int>& _matches);
+
+private:
+    void apply(const bool& _scroll);
+
+private:
+    QComboBox* cbField;
+    QComboBox* cbMode;
+    QLineEdit* tbText;
+    QPushButton* btnCancel;
+    QLabel* lblStatus;
+    QTimer* m_Timer;
+    MessageFilter* m_Filter;
+    QTreeView* m_View;
+    MessageModel* m_Model;
+    QModelIndexList m_Indexes;
+    bool m_Scroll;
+};
+
+#endif // MESSAGEFILTERBAR_H
@@ -0,0 +1,218 @@
+#include "messagemetadata.h"
+
+#include "protobufreader.h"
+
+#include <limits>
+
+namespace
+{
+/**
+ * @brief Decode a KeyValue message, key is field 1 and value field 2.
+ */
+bool readKeyValue(ProtobufReader& _reader, Properties& _properties)
+{
+    const char* data;
+    int length;
+    if (!_reader.readBytes(data, length))
+    {
+        return false;
+    }
+    ProtobufReader reader(data, length);
+    QString key;
+    QString value;
+    quint32 field;
+    int wireType;
+    while (reader.next(field, wireType))
+    {
+        const char* str;
+        int len;
+        if ((field == 1 || field == 2) && wireType == ProtobufReader::LengthDelimited)
+        {
+            if (!reader.readBytes(str, len))
+            {
+                return false;
+            }
+            (field == 1 ? key : value) = QString::fromUtf8(str, len);
+        }
+        else if (!reader.skip(wireType))
+        {
+            return false;
+        }
+    }
+    if (reader.hasError())
+    {
+        return false;
+    }
+    _properties.insert(key, value);
+    return true;
+}
+
+bool readString(ProtobufReader& _reader, QString& _value)
+{
+    const char* data;
+    int length;
+    if (!_reader.readBytes(data, length))
+    {
+        return false;
+    }
+    _value = QString::fromUtf8(data, length);
+    return true;
+}
+
+/**
+ * @brief The int32 fields come as 64 bit varints, a negative or too large value is malformed input.
+ */
+bool toInt(const quint64& _value, int& _result)
+{
+    if (_value > static_cast<quint64>(std::numeric_limits<int>::max()))
+    {
+        return false;
+    }
+    _result = static_cast<int>(_value);
+    return true;
+}
+
+bool readBytes(ProtobufReader& _reader, QByteArray& _value)
+{
+    const char* data;
+    int length;
+    if (!_reader.readBytes(data, length))
+    {
+        return false;
+    }
+    _value = QByteArray(data, length);
+    return true;
+}
+}
+
+SingleMessageMetadata::SingleMessageMetadata()
+    : m_PartitionKeyB64Encoded(false), m_PayloadSize(0), m_CompactedOut(false), m_EventTime(0), m_HasSequenceId(false), m_SequenceId(0),
+      m_NullValue(false), m_NullPartitionKey(false)
+{
+}
+
+/**
+ * @brief Decode the metadata in place, only the decoded strings are copied out of the span.
+ * @param _data
+ * @param _size
+ * @param _metadata
+ * @return false if the input is truncated, malformed or lacks the payload size
+ */
+bool SingleMessageMetadata::parse(const char* _data, const int& _size, SingleMessageMetadata& _metadata)
+{
+    ProtobufReader reader(_data, _size);
+    bool hasPayloadSize = false;
+    quint32 field;
+    int wireType;
+    while (reader.next(field, wireType))
+    {
+        quint64 value = 0;
+        bool ok = true;
+        if (wireType == ProtobufReader::LengthDelimited)
+        {
+            switch (field)
+            {
+            case 1: ok = readKeyValue(reader, _metadata.m_Properties); break;
+            case 2: ok = readString(reader, _metadata.m_PartitionKey); break;
+            case 7: ok = readBytes(reader, _metadata.m_OrderingKey); break;
+            default: ok = reader.skip(wireType); break;
+            }
+        }
+        else if (wireType == ProtobufReader::Varint)
+        {
+            ok = reader.readVarint(value);
+            switch (field)
+            {
+            case 3: ok = ok && toInt(value, _metadata.m_PayloadSize); hasPayloadSize = true; break;
+            case 4: _metadata.m_CompactedOut = value != 0; break;
+            case 5: _metadata.m_EventTime = value; break;
+            case 6: _metadata.m_PartitionKeyB64Encoded = value != 0; break;
+            case 8: _metadata.m_SequenceId = value; _metadata.m_HasSequenceId = true; break;
+            case 9: _metadata.m_NullValue = value != 0; break;
+            case 10: _metadata.m_NullPartitionKey = value != 0; break;
+            default: break;
+            }
+        }
+        else
+        {
+            ok = reader.skip(wireType);
+        }
+        if (!ok)
+        {
+            return false;
+        }
+    }
+    return !reader.hasError() && hasPayloadSize;
+}
+
+MessageMetadata::MessageMetadata()
+    : m_SequenceId(0), m_PublishTime(0), m_PartitionKeyB64Encoded(false), m_Compression(MessageMetadata::NONE), m_UncompressedSize(0), m_NumMessagesInBatch(1),
+      m_EventTime(0), m_DeliverAtTime(0), m_MarkerType(0), m_HighestSequenceId(0), m_NullValue(false), m_NumChunksFromMsg(0), m_TotalChunkMsgSize(0),
+      m_ChunkId(0), m_NullPartitionKey(false)
+{
+}
+
+bool MessageMetadata::parse(const char* _data, const int& _size, MessageMetadata& _metadata)
+{
+    ProtobufReader reader(_data, _size);
+    quint32 field;
+    int wireType;
+    while (reader.next(field, wireType))
+    {
+        quint64 value = 0;
+        bool ok = true;
+        if (wireType == ProtobufReader::LengthDelimited)
+        {
+            switch (field)
+            {
+            case 1: ok = readString(reader, _metadata.m_ProducerName); break;
+            case 4: ok = readKeyValue(reader, _metadata.m_Properties); break;
+            case 5: ok = readString(reader, _metadata.m_ReplicatedFrom); break;
+            case 6: ok = readString(reader, _metadata.m_PartitionKey); break;
+            case 7:
+            {
+                QString cluster;
+                ok = readString(reader, cluster);
+                _metadata.m_ReplicateTo << cluster;
+                break;
+            }
+            case 16: ok = readBytes(reader, _metadata.m_SchemaVersion); break;
+            case 18: ok = readBytes(reader, _metadata.m_OrderingKey); break;
+            case 26: ok = readString(reader, _metadata.m_Uuid); break;
+            default: ok = reader.skip(wireType); break;
+            }
+        }
+        else if (wireType == ProtobufReader::Varint)
+        {
+            ok = reader.readVarint(value);
+            switch (field)
+            {
+            case 2: _metadata.m_SequenceId = value; break;
+            case 3: _metadata.m_PublishTime = value; break;
+            case 8: _metadata.m_Compression = static_cast<MessageMetadata::CompressionType>(value); break;
+            case 9: _metadata.m_UncompressedSize = static_cast<quint32>(value); break;
+            case 11: ok = ok && toInt(value, _metadata.m_NumMessagesInBatch); break;
+            case 12: _metadata.m_EventTime = value; break;
+            case 17: _metadata.m_PartitionKeyB64Encoded = value != 0; break;
+            case 19: _metadata.m_DeliverAtTime = static_cast<qint64>(value); break;
+            case 20: ok = ok && toInt(value, _metadata.m_MarkerType); break;
+            case 24: _metadata.m_HighestSequenceId = value; break;
+            case 25: _metadata.m_NullValue = value != 0; break;
+            case 27: ok = ok && toInt(value, _metadata.m_NumChunksFromMsg); break;
+            case 28: ok = ok && toInt(value, _metadata.m_TotalChunkMsgSize); break;
+            case 29: ok = ok && toInt(value, _metadata.m_ChunkId); break;
+            case 30: _metadata.m_NullPartitionKey = value != 0; break;
+            default: break;
+            }
+        }
+        else
+        {
+            ok = reader.skip(wireType);
+        }
+        if (!ok)
+        {
+            return false;
+        }
+    }
+    return !reader.hasError();
+}
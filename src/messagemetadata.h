@@ -0,0 +1,117 @@
+#ifndef MESSAGEMETADATA_H
+#define MESSAGEMETADATA_H
+
+#include <QObject>
+#include <QMap>
+#include <QByteArray>
+#include <QStringList>
+
+typedef QMap<QString, QString> Properties;
+
+/**
+ * @brief The metadata in front of every message of a batch, see SingleMessageMetadata in
+ * PulsarApi.proto.
+ */
+class SingleMessageMetadata
+{
+public:
+    explicit SingleMessageMetadata();
+
+    static bool parse(const char* _data, const int& _size, SingleMessageMetadata& _metadata);
+
+    inline Properties properties() const { return this->m_Properties; }
+    inline QString partitionKey() const { return this->m_PartitionKey; }
+    inline bool partitionKeyB64Encoded() const { return this->m_PartitionKeyB64Encoded; }
+    inline int payloadSize() const { return this->m_PayloadSize; }
+    inline bool compactedOut() const { return this->m_CompactedOut; }
+    inline quint64 eventTime() const { return this->m_EventTime; }
+    inline QByteArray orderingKey() const { return this->m_OrderingKey; }
+    inline bool hasSequenceId() const { return this->m_HasSequenceId; }
+    inline quint64 sequenceId() const { return this->m_SequenceId; }
+    inline bool nullValue() const { return this->m_NullValue; }
+    inline bool nullPartitionKey() const { return this->m_NullPartitionKey; }
+
+private:
+    Properties m_Properties;
+    QString m_PartitionKey;
+    bool m_PartitionKeyB64Encoded;
+    int m_PayloadSize;
+    bool m_CompactedOut;
+    quint64 m_EventTime;
+    QByteArray m_OrderingKey;
+    bool m_HasSequenceId;
+    quint64 m_SequenceId;
+    bool m_NullValue;
+    bool m_NullPartitionKey;
+};
+
+/**
+ * @brief The metadata of an entry as written by the producer, see MessageMetadata in
+ * PulsarApi.proto. The encryption and transaction fields are skipped.
+ */
+class MessageMetadata
+{
+public:
+    enum CompressionType
+    {
+        NONE = 0, LZ4 = 1, ZLIB = 2, ZSTD = 3, SNAPPY = 4
+    };
+
+    explicit MessageMetadata();
+
+    static bool parse(const char* _data, const int& _size, MessageMetadata& _metadata);
+
+    inline QString producerName() const { return this->m_ProducerName; }
+    inline quint64 sequenceId() const { return this->m_SequenceId; }
+    inline quint64 publishTime() const { return this->m_PublishTime; }
+    inline Properties properties() const { return this->m_Properties; }
+    inline QString replicatedFrom() const { return this->m_ReplicatedFrom; }
+    inline QString partitionKey() const { return this->m_PartitionKey; }
+    inline bool partitionKeyB64Encoded() const { return this->m_PartitionKeyB64Encoded; }
+    inline QStringList replicateTo() const { return this->m_ReplicateTo; }
+    inline MessageMetadata::CompressionType compression() const { return this->m_Compression; }
+    inline quint32 uncompressedSize() const { return this->m_UncompressedSize; }
+    inline int numMessagesInBatch() const { return this->m_NumMessagesInBatch; }
+    inline quint64 eventTime() const { return this->m_EventTime; }
+    inline QByteArray schemaVersion() const { return this->m_SchemaVersion; }
+    inline QByteArray orderingKey() const { return this->m_OrderingKey; }
+    inline qint64 deliverAtTime() const { return this->m_DeliverAtTime; }
+    inline int markerType() const { return this->m_MarkerType; }
+    inline quint64 highestSequenceId() const { return this->m_HighestSequenceId; }
+    inline bool nullValue() const { return this->m_NullValue; }
+    inline QString uuid() const { return this->m_Uuid; }
+    inline int numChunksFromMsg() const { return this->m_NumChunksFromMsg; }
+    inline int totalChunkMsgSize() const { return this->m_TotalChunkMsgSize; }
+    inline int chunkId() const { return this->m_ChunkId; }
+    inline bool nullPartitionKey() const { return this->m_NullPartitionKey; }
+
+private:
+    QString m_ProducerName;
+    quint64 m_SequenceId;
+    quint64 m_PublishTime;
+    Properties m_Properties;
+    QString m_ReplicatedFrom;
+    QString m_PartitionKey;
+    bool m_PartitionKeyB64Encoded;
+    QStringList m_ReplicateTo;
+    MessageMetadata::CompressionType m_Compression;
+    quint32 m_UncompressedSize;
+    int m_NumMessagesInBatch;
+    quint64 m_EventTime;
+    QByteArray m_SchemaVersion;
+    QByteArray m_OrderingKey;
+    qint64 m_DeliverAtTime;
+    int m_MarkerType;
+    quint64 m_HighestSequenceId;
+    bool m_NullValue;
+    QString m_Uuid;
+    int m_NumChunksFromMsg;
+    int m_TotalChunkMsgSize;
+    int m_ChunkId;
+    bool m_NullPartitionKey;
+};
+
+Q_DECLARE_METATYPE(SingleMessageMetadata);
+Q_DECLARE_METATYPE(MessageMetadata);
+
+#endif // MESSAGEMETADATA_H
@@ -0,0 +1,550 @@
+#include "messagemodel.h"
+
+#include <QBrush>
+#include <QColor>
+#include <QPointer>
+#include <QHash>
+#include <QSet>
+
+static const int COLUMN_COUNT = 6;
+
+MessageModel::MessageModel(QObject* parent)
+    : QAbstractItemModel(parent), m_PageSize(100), m_MaxCachedBytes(128 * 1024 * 1024), m_CachedBytes(0), m_Generation(0), m_Loading(false), m_More(false), m_NextPage(0), m_Clock(0)
+{
+}
+
+/**
+ * @brief Drop the rows and start over with the loader, the first page is read on fetchMore().
+ */
+void MessageModel::setLoader(const PageLoader& _loader)
+{
+    beginResetModel();
+    this->m_Generation++;
+    this->m_Loader = _loader;
+    this->m_Rows.clear();
+    this->m_Pages.clear();
+    this->m_CachedBytes = 0;
+    this->m_Loading = false;
+    this->m_More = true;
+    this->m_NextPage = 0;
+    endResetModel();
+}
+
+void MessageModel::clear()
+{
+    setLoader(PageLoader());
+    this->m_More = false;
+}
+
+/**
+ * @brief Append messages that did not come from the loader, such as the ones joined from
+ * chunks. They stay in memory.
+ */
+void MessageModel::appendMessages(const QList<PulsarMessage>& _messages)
+{
+    if (_messages.isEmpty())
+    {
+        return;
+    }
+    Page page { -1, -1, 0, QList<PulsarMessage>(), 0, true, true, false, ++this->m_Clock };
+    this->m_Pages << page;
+    int index = this->m_Pages.size() - 1;
+    appendRows(this->m_Pages[index], index, _messages);
+    emit pageLoaded(leaves(this->m_Pages[index]));
+}
+
+/**
+ * @brief The message of a row, an empty message when its page was dropped, the page is then
+ * read again.
+ */
+PulsarMessage MessageModel::message(const QModelIndex& _index) const
+{
+    if (!_index.isValid())
+    {
+        return PulsarMessage();
+    }
+    int row = _index.internalId() == 0 ? _index.row() : int(_index.internalId()) - 1;
+    const Row& entry = this->m_Rows.at(row);
+    const Page& page = this->m_Pages.at(entry.page);
+    if (!page.resident)
+    {
+        MessageModel* self = const_cast<MessageModel*>(this);
+        int index = entry.page;
+        QMetaObject::invokeMethod(self, [self, index]()
+        {
+            self->load(index);
+        }, Qt::QueuedConnection);
+        return PulsarMessage();
+    }
+    page.used = ++this->m_Clock;
+    PulsarMessage message = page.messages.value(entry.offset);
+    if (_index.internalId() == 0)
+    {
+        return message;
+    }
+    return message.isBatch() ? message.batch().value(_index.row()) : PulsarMessage();
+}
+
+int MessageModel::leafCount() const
+{
+    int count = 0;
+    foreach (const Row& row, this->m_Rows)
+    {
+        int children = 0;
+        foreach (const Cell& child, row.children)
+        {
+            children += child.hasMessage ? 1 : 0;
+        }
+        count += children > 0 ? children : (row.cell.hasMessage ? 1 : 0);
+    }
+    return count;
+}
+
+/**
+ * @brief The rows whose messages are in memory with their messages, in row order.
+ */
+void MessageModel::residentMessages(QModelIndexList& _indexes, QList<PulsarMessage>& _messages) const
+{
+    for (int i = 0, n = this->m_Pages.size(); i < n; ++i)
+    {
+        const Page& page = this->m_Pages.at(i);
+        if (!page.resident)
+        {
+            continue;
+        }
+        QModelIndexList indexes = leaves(page);
+        foreach (const QModelIndex& index, indexes)
+        {
+            const PulsarMessage& message = page.messages.at(this->m_Rows.at(index.internalId() == 0 ? index.row() : int(index.internalId()) - 1).offset);
+            _messages << (index.internalId() == 0 ? message : message.batch().value(index.row()));
+        }
+        _indexes << indexes;
+    }
+}
+
+/**
+ * @brief Highlight the rows, the ones highlighted before are cleared.
+ */
+void MessageModel::setMatches(const QModelIndexList& _indexes)
+{
+    QSet<int> parents;
+    for (int i = 0, n = this->m_Rows.size(); i < n; ++i)
+    {
+        Row& row = this->m_Rows[i];
+        row.cell.matched = false;
+        for (int j = 0, m = row.children.size(); j < m; ++j)
+        {
+            if (row.children[j].matched)
+            {
+                row.children[j].matched = false;
+                parents.insert(i);
+            }
+        }
+    }
+    foreach (const QModelIndex& index, _indexes)
+    {
+        if (index.internalId() == 0)
+        {
+            this->m_Rows[index.row()].cell.matched = true;
+        }
+        else
+        {
+            int row = int(index.internalId()) - 1;
+            this->m_Rows[row].children[index.row()].matched = true;
+            parents.insert(row);
+        }
+    }
+    if (!this->m_Rows.isEmpty())
+    {
+        emit dataChanged(index(0, 0), index(this->m_Rows.size() - 1, COLUMN_COUNT - 1), QList<int>() << Qt::BackgroundRole);
+    }
+    foreach (int row, parents)
+    {
+        QModelIndex parent = index(row, 0);
+        emit dataChanged(index(0, 0, parent), index(this->m_Rows.at(row).children.size() - 1, COLUMN_COUNT - 1, parent), QList<int>() << Qt::BackgroundRole);
+    }
+}
+
+/**
+ * @brief Top-level rows have 0 as internal id, child rows the row of their parent plus one.
+ */
+QModelIndex MessageModel::index(int _row, int _column, const QModelIndex& _parent) const
+{
+    if (!hasIndex(_row, _column, _parent))
+    {
+        return QModelIndex();
+    }
+    return createIndex(_row, _column, _parent.isValid() ? quintptr(_parent.row() + 1) : quintptr(0));
+}
+
+QModelIndex MessageModel::parent(const QModelIndex& _index) const
+{
+    if (!_index.isValid() || _index.internalId() == 0)
+    {
+        return QModelIndex();
+    }
+    return createIndex(int(_index.internalId()) - 1, 0, quintptr(0));
+}
+
+int MessageModel::rowCount(const QModelIndex& _parent) const
+{
+    if (!_parent.isValid())
+    {
+        return this->m_Rows.size();
+    }
+    if (_parent.internalId() == 0 && _parent.column() == 0)
+    {
+        return this->m_Rows.at(_parent.row()).children.size();
+    }
+    return 0;
+}
+
+int MessageModel::columnCount(const QModelIndex& _parent) const
+{
+    Q_UNUSED(_parent);
+    return COLUMN_COUNT;
+}
+
+QVariant MessageModel::data(const QModelIndex& _index, int _role) const
+{
+    if (!_index.isValid())
+    {
+        return QVariant();
+    }
+    const Cell& cell = this->cell(_index);
+    switch (_role)
+    {
+    case Qt::DisplayRole:
+        switch (_index.column())
+        {
+        case 0:
+            return QString::number(cell.ledgerId);
+        case 1:
+            return QString::number(cell.entryId);
+        case 2:
+            return cell.batch;
+        case 3:
+            return cell.key;
+        case 4:
+            return cell.hasMessage ? QString::number(cell.properties) : QString();
+        case 5:
+            return cell.hasMessage ? QString::number(cell.bodyLength) : QString();
+        }
+        break;
+    case Qt::TextAlignmentRole:
+        if (_index.column() <= 2)
+        {
+            return int(Qt::AlignCenter);
+        }
+        if (_index.column() >= 4)
+        {
+            return int(Qt::AlignRight | Qt::AlignVCenter);
+        }
+        break;
+    case Qt::BackgroundRole:
+        if (cell.matched)
+        {
+            return QBrush(QColor(255, 236, 139));
+        }
+        break;
+    case MessageRole:
+        if (cell.hasMessage)
+        {
+            PulsarMessage message = this->message(_index);
+            if (!message.data().isEmpty())
+            {
+                return QVariant::fromValue(message);
+            }
+        }
+        break;
+    case DecodedRole:
+        return cell.decoded;
+    }
+    return QVariant();
+}
+
+/**
+ * @brief Only the decoded body of a row is set, it is dropped with the page.
+ */
+bool MessageModel::setData(const QModelIndex& _index, const QVariant& _value, int _role)
+{
+    if (!_index.isValid() || _role != DecodedRole)
+    {
+        return false;
+    }
+    Row& row = this->m_Rows[_index.internalId() == 0 ? _index.row() : int(_index.internalId()) - 1];
+    Cell& cell = _index.internalId() == 0 ? row.cell : row.children[_index.row()];
+    cell.decoded = _value;
+    emit dataChanged(_index, _index, QList<int>() << DecodedRole);
+    return true;
+}
+
+QVariant MessageModel::headerData(int _section, Qt::Orientation _orientation, int _role) const
+{
+    if (_orientation != Qt::Horizontal || _role != Qt::DisplayRole)
+    {
+        return QVariant();
+    }
+    switch (_section)
+    {
+    case 0:
+        return tr("LedgerId");
+    case 1:
+        return tr("EntryId");
+    case 2:
+        return tr("Batch Index");
+    case 3:
+        return tr("Message Key");
+    case 4:
+        return tr("Properties Count");
+    case 5:
+        return tr("Body Length");
+    }
+    return QVariant();
+}
+
+bool MessageModel::canFetchMore(const QModelIndex& _parent) const
+{
+    return !_parent.isValid() && this->m_Loader && this->m_More && !this->m_Loading;
+}
+
+void MessageModel::fetchMore(const QModelIndex& _parent)
+{
+    if (!canFetchMore(_parent))
+    {
+        return;
+    }
+    Page page { this->m_NextPage++, -1, 0, QList<PulsarMessage>(), 0, false, false, false, 0 };
+    this->m_Pages << page;
+    this->m_Loading = true;
+    emit loadingChanged(true);
+    load(this->m_Pages.size() - 1);
+}
+
+const MessageModel::Cell& MessageModel::cell(const QModelIndex& _index) const
+{
+    if (_index.internalId() == 0)
+    {
+        return this->m_Rows.at(_index.row()).cell;
+    }
+    return this->m_Rows.at(int(_index.internalId()) - 1).children.at(_index.row());
+}
+
+void MessageModel::load(const int& _page)
+{
+    if (_page >= this->m_Pages.size())
+    {
+        return;
+    }
+    Page& page = this->m_Pages[_page];
+    if (page.loading || page.resident || page.pinned)
+    {
+        return;
+    }
+    page.loading = true;
+    QPointer<MessageModel> self(this);
+    int generation = this->m_Generation;
+    this->m_Loader(page.number, page.first >= 0, [self, generation, _page](const QList<PulsarMessage>& _messages, const bool& _more)
+    {
+        if (!self.isNull())
+        {
+            self->loaded(generation, _page, _messages, _more);
+        }
+    });
+}
+
+/**
+ * @brief A new page adds its rows, a page read again only gets its messages back. Pages over
+ * the budget are dropped afterwards, the one just read is kept.
+ */
+void MessageModel::loaded(const int& _generation, const int& _page, const QList<PulsarMessage>& _messages, const bool& _more)
+{
+    if (_generation != this->m_Generation)
+    {
+        return; //the model was reset
+    }
+    Page& page = this->m_Pages[_page];
+    page.loading = false;
+    if (page.first < 0)
+    {
+        appendRows(page, _page, _messages);
+        this->m_More = _more;
+        this->m_Loading = false;
+        emit loadingChanged(false);
+        if (_messages.isEmpty() && this->m_More)
+        {
+            //no rows for the view to scroll to, go on with the next page
+            QMetaObject::invokeMethod(this, [this]()
+            {
+                fetchMore(QModelIndex());
+            }, Qt::QueuedConnection);
+        }
+    }
+    else
+    {
+        //A loader reading by position may return other messages than before, e.g. once a
+        //subscription has moved on, every row gets back the message of its own id or none.
+        QHash<QPair<int, int>, int> ids;
+        for (int i = 0, n = _messages.size(); i < n; ++i)
+        {
+            ids.insert(qMakePair(_messages.at(i).ledgerId(), _messages.at(i).entryId()), i);
+        }
+        QList<PulsarMessage> messages;
+        for (int i = page.first, n = page.first + page.count; i < n; ++i)
+        {
+            const Cell& cell = this->m_Rows.at(i).cell;
+            int found = ids.value(qMakePair(cell.ledgerId, cell.entryId), -1);
+            messages << (found >= 0 ? _messages.at(found) : PulsarMessage());
+        }
+        page.messages = messages;
+        page.resident = true;
+        page.used = ++this->m_Clock;
+        page.bytes = 0;
+        foreach (const PulsarMessage& message, page.messages)
+        {
+            page.bytes += message.data().size();
+        }
+        this->m_CachedBytes += page.bytes;
+        if (page.count > 0)
+        {
+            emit dataChanged(index(page.first, 0), index(page.first + page.count - 1, COLUMN_COUNT - 1), QList<int>() << MessageRole);
+        }
+    }
+    evict(_page);
+    emit pageLoaded(leaves(this->m_Pages[_page]));
+}
+
+/**
+ * @brief Drop the least recently used pages until the cache is within its budget. The rows and
+ * what they show stay, the messages and their decoded bodies go.
+ */
+void MessageModel::evict(const int& _keep)
+{
+    while (this->m_CachedBytes > this->m_MaxCachedBytes)
+    {
+        int oldest = -1;
+        for (int i = 0, n = this->m_Pages.size(); i < n; ++i)
+        {
+            const Page& page = this->m_Pages.at(i);
+            if (i != _keep && page.resident && !page.pinned && (oldest < 0 || page.used < this->m_Pages.at(oldest).used))
+            {
+                oldest = i;
+            }
+        }
+        if (oldest < 0)
+        {
+            break;
+        }
+        Page& page = this->m_Pages[oldest];
+        this->m_CachedBytes -= page.bytes;
+        page.bytes = 0;
+        page.messages.clear();
+        page.resident = false;
+        for (int i = page.first, n = page.first + page.count; i < n; ++i)
+        {
+            Row& row = this->m_Rows[i];
+            row.cell.decoded = QVariant();
+            for (int j = 0, m = row.children.size(); j < m; ++j)
+            {
+                row.children[j].decoded = QVariant();
+            }
+        }
+    }
+}
+
+/**
+ * @brief The rows of a page holding a message, the messages of a batch instead of the batch.
+ */
+QModelIndexList MessageModel::leaves(const Page& _page) const
+{
+    QModelIndexList indexes;
+    for (int i = _page.first, n = _page.first + _page.count; i < n; ++i)
+    {
+        const Row& row = this->m_Rows.at(i);
+        QModelIndex parent = index(i, 0);
+        bool children = false;
+        for (int j = 0, m = row.children.size(); j < m; ++j)
+        {
+            if (row.children.at(j).hasMessage)
+            {
+                indexes << index(j, 0, parent);
+                children = true;
+            }
+        }
+        if (!children && row.cell.hasMessage)
+        {
+            indexes << parent;
+        }
+    }
+    return indexes;
+}
+
+void MessageModel::appendRows(Page& _page, const int& _index, const QList<PulsarMessage>& _messages)
+{
+    _page.first = this->m_Rows.size();
+    _page.count = _messages.size();
+    _page.messages = _messages;
+    _page.resident = true;
+    _page.used = ++this->m_Clock;
+    _page.bytes = 0;
+    if (_messages.isEmpty())
+    {
+        return;
+    }
+    beginInsertRows(QModelIndex(), _page.first, _page.first + _page.count - 1);
+    for (int i = 0, n = _messages.size(); i < n; ++i)
+    {
+        Row row = toRow(_messages.at(i));
+        row.page = _index;
+        row.offset = i;
+        this->m_Rows << row;
+        _page.bytes += _messages.at(i).data().size();
+    }
+    endInsertRows();
+    this->m_CachedBytes += _page.bytes;
+}
+
+/**
+ * @brief One row per entry, the messages of a batch and the chunks of a large message are its
+ * child rows.
+ */
+MessageModel::Row MessageModel::toRow(const PulsarMessage& _message) const
+{
+    Row row { toCell(_message), QList<Cell>(), -1, -1 };
+    foreach (const PulsarMessage& child, _message.batch())
+    {
+        row.children << toCell(child);
+    }
+    QList<Message> chunks = _message.chunks();
+    for (int i = 0, n = chunks.size(); i < n; ++i)
+    {
+        row.children << Cell { chunks[i].ledgerId(), chunks[i].entryId(), tr("chunk %1").arg(i), QString(), -1, -1, false, false, QVariant() };
+    }
+    return row;
+}
+
+MessageModel::Cell MessageModel::toCell(const PulsarMessage& _message) const
+{
+    return Cell { _message.ledgerId(), _message.entryId(), batchText(_message), _message.key(), int(_message.properties().size()), _message.bodyLength(), true, false, QVariant() };
+}
+
+QString MessageModel::batchText(const PulsarMessage& _message) const
+{
+    if (_message.batchIndex() >= 0)
+    {
+        return QString::number(_message.batchIndex());
+    }
+    if (_message.isBatch())
+    {
+        return tr("%1 messages").arg(_message.batch().size());
+    }
+    if (_message.isChunked())
+    {
+        return tr("%1 chunks").arg(_message.chunks().size());
+    }
+    if (_message.isChunk())
+    {
+        return tr("chunk %1 of %2").arg(_message.chunkId()).arg(_message.numChunks());
+    }
+    return QString();
+}
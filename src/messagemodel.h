@@ -0,0 +1,136 @@
+#ifndef MESSAGEMODEL_H
+#define MESSAGEMODEL_H
+
+#include <QAbstractItemModel>
+#include <functional>
+
+#include "pulsarmessage.h"
+
+/**
+ * @brief The messages of a topic as a model paged in on demand.
+ *
+ * Top-level rows are entries, the messages of a batch and the chunks of a large message are
+ * their child rows. Pages are read with the loader as the view scrolls to the end, see
+ * canFetchMore(). Every row keeps the few fields the columns show, the messages themselves are
+ * held per page and the least recently used pages are dropped once they take more than
+ * maxCachedBytes(). A dropped page is read again when one of its messages is asked for,
+ * pageLoaded() tells when it is back.
+ */
+class MessageModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum Role
+    {
+        MessageRole = Qt::UserRole,
+        DecodedRole
+    };
+
+    typedef std::function<void(const QList<PulsarMessage>&, const bool&)> PageCallback;
+    /**
+     * @brief Reads the page _page and hands its messages to the callback, with whether more pages
+     * follow. _reload is set when the page was read before and dropped, its messages are matched
+     * to the rows by id, a row whose message does not come back is left without one.
+     */
+    typedef std::function<void(const int& _page, const bool& _reload, const PageCallback& _callback)> PageLoader;
+
+    explicit MessageModel(QObject* parent = nullptr);
+
+    void setLoader(const PageLoader& _loader);
+    void clear();
+    void appendMessages(const QList<PulsarMessage>& _messages);
+
+    /**
+     * @brief The number of entries a loader reads per page.
+     */
+    inline void setPageSize(const int& _size) { this->m_PageSize = qMax(1, _size); }
+    inline int pageSize() const { return this->m_PageSize; }
+    inline void setMaxCachedBytes(const qint64& _max) { this->m_MaxCachedBytes = qMax<qint64>(0, _max); }
+    inline qint64 maxCachedBytes() const { return this->m_MaxCachedBytes; }
+    inline qint64 cachedBytes() const { return this->m_CachedBytes; }
+    inline bool isLoading() const { return this->m_Loading; }
+
+    PulsarMessage message(const QModelIndex& _index) const;
+    int leafCount() const;
+    void residentMessages(QModelIndexList& _indexes, QList<PulsarMessage>& _messages) const;
+    void setMatches(const QModelIndexList& _indexes);
+
+    QModelIndex index(int _row, int _column, const QModelIndex& _parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& _index) const override;
+    int rowCount(const QModelIndex& _parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& _parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& _index, int _role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex& _index, const QVariant& _value, int _role = Qt::EditRole) override;
+    QVariant headerData(int _section, Qt::Orientation _orientation, int _role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex& _parent) const override;
+    void fetchMore(const QModelIndex& _parent) override;
+
+signals:
+    /**
+     * @brief A page was read or read again, _indexes are its rows holding a message, the messages
+     * of a batch instead of the batch itself.
+     */
+    void pageLoaded(const QModelIndexList& _indexes);
+    void loadingChanged(bool _loading);
+
+private:
+    struct Cell
+    {
+        int ledgerId;
+        int entryId;
+        QString batch;
+        QString key;
+        int properties;
+        int bodyLength;
+        bool hasMessage;
+        bool matched;
+        QVariant decoded;
+    };
+
+    struct Row
+    {
+        Cell cell;
+        QList<Cell> children;
+        int page;
+        int offset;
+    };
+
+    struct Page
+    {
+        int number;
+        int first;
+        int count;
+        QList<PulsarMessage> messages;
+        qint64 bytes;
+        bool resident;
+        bool pinned;
+        bool loading;
+        mutable quint64 used;
+    };
+
+    const Cell& cell(const QModelIndex& _index) const;
+    void load(const int& _page);
+    void loaded(const int& _generation, const int& _page, const QList<PulsarMessage>& _messages, const bool& _more);
+    void evict(const int& _keep);
+    QModelIndexList leaves(const Page& _page) const;
+    void appendRows(Page& _page, const int& _index, const QList<PulsarMessage>& _messages);
+    Row toRow(const PulsarMessage& _message) const;
+    Cell toCell(const PulsarMessage& _message) const;
+    QString batchText(const PulsarMessage& _message) const;
+
+private:
+    PageLoader m_Loader;
+    QList<Row> m_Rows;
+    QList<Page> m_Pages;
+    int m_PageSize;
+    qint64 m_MaxCachedBytes;
+    qint64 m_CachedBytes;
+    int m_Generation;
+    bool m_Loading;
+    bool m_More;
+    int m_NextPage;
+    mutable quint64 m_Clock;
+};
+
+#endif // MESSAGEMODEL_H
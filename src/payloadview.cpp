@@ -0,0 +1,338 @@
+#include "payloadview.h"
+
+#include <QPainter>
+#include <QScrollBar>
+#include <QFontDatabase>
+#include <QKeyEvent>
+#include <QMenu>
+#include <QClipboard>
+#include <QGuiApplication>
+#include <QThreadPool>
+#include <QPointer>
+#include <QCoreApplication>
+
+namespace
+{
+const int HEX_BYTES_PER_LINE = 16;
+//00000010  xx xx xx xx xx xx xx xx  xx xx xx xx xx xx xx xx  |................|
+const int HEX_ASCII_COLUMN = 10 + HEX_BYTES_PER_LINE * 3 + 2;
+const int HEX_LINE_WIDTH = HEX_ASCII_COLUMN + HEX_BYTES_PER_LINE + 1;
+const int SYNC_RENDER_BYTES = 64 * 1024;
+const int MARGIN = 4;
+}
+
+PayloadView::PayloadView(QWidget* _parent) : QAbstractScrollArea(_parent), m_HasMessage(false), m_Mode(Text), m_Cache(32 * 1024 * 1024), m_Generation(0)
+{
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    setFocusPolicy(Qt::StrongFocus);
+    viewport()->setBackgroundRole(QPalette::Base);
+    viewport()->setAutoFillBackground(true);
+}
+
+void PayloadView::setMessage(const PulsarMessage& _message)
+{
+    this->m_Message = _message;
+    this->m_HasMessage = true;
+    verticalScrollBar()->setValue(0);
+    horizontalScrollBar()->setValue(0);
+    updateRendering();
+}
+
+void PayloadView::clear()
+{
+    this->m_Message = PulsarMessage();
+    this->m_HasMessage = false;
+    this->m_Rendering.reset();
+    this->m_Generation++;
+    updateScrollBars();
+    viewport()->update();
+}
+
+void PayloadView::setMode(const Mode& _mode)
+{
+    if (this->m_Mode == _mode)
+    {
+        return;
+    }
+    this->m_Mode = _mode;
+    verticalScrollBar()->setValue(0);
+    horizontalScrollBar()->setValue(0);
+    if (this->m_HasMessage)
+    {
+        updateRendering();
+    }
+}
+
+/**
+ * @brief The whole rendering, the hex of a large body is as large as three times the body.
+ */
+QString PayloadView::toPlainText() const
+{
+    if (!this->m_HasMessage)
+    {
+        return QString();
+    }
+    if (this->m_Mode != Hex)
+    {
+        return this->m_Rendering ? this->m_Rendering->text : QString();
+    }
+    QString text;
+    QByteArrayView body = this->m_Message.bodyView();
+    for (int i = 0, n = lineCount(); i < n; i++)
+    {
+        text.append(hexLine(body, i)).append('\n');
+    }
+    return text;
+}
+
+/**
+ * @brief Take the rendering from the cache or make it, right here for small bodies and on a
+ * worker thread for the others; the view paints a placeholder until it is back.
+ */
+void PayloadView::updateRendering()
+{
+    this->m_Generation++;
+    this->m_Rendering.reset();
+    if (this->m_Mode != Hex)
+    {
+        QString key = cacheKey();
+        if (RenderingPointer* cached = this->m_Cache.object(key))
+        {
+            this->m_Rendering = *cached;
+        }
+        else if (this->m_Message.bodyLength() <= SYNC_RENDER_BYTES)
+        {
+            this->m_Rendering = renderBody(this->m_Message, this->m_Mode);
+            this->m_Cache.insert(key, new RenderingPointer(this->m_Rendering), this->m_Rendering->text.size() * 2);
+        }
+        else
+        {
+            int generation = this->m_Generation;
+            PulsarMessage message = this->m_Message;
+            Mode mode = this->m_Mode;
+            QPointer<PayloadView> self(this);
+            QThreadPool::globalInstance()->start([self, generation, message, mode, key]()
+            {
+                RenderingPointer rendering = renderBody(message, mode);
+                QMetaObject::invokeMethod(QCoreApplication::instance(), [self, generation, rendering, key]()
+                {
+                    if (!self)
+                    {
+                        return;
+                    }
+                    self->m_Cache.insert(key, new RenderingPointer(rendering), rendering->text.size() * 2);
+                    if (generation == self->m_Generation)
+                    {
+                        self->m_Rendering = rendering;
+                        self->updateScrollBars();
+                        self->viewport()->update();
+                    }
+                }, Qt::QueuedConnection);
+            });
+        }
+    }
+    updateScrollBars();
+    viewport()->update();
+}
+
+/**
+ * @brief Renders the body the way the message formats it and indexes the lines, may run on any
+ * thread.
+ */
+PayloadView::RenderingPointer PayloadView::renderBody(const PulsarMessage& _message, const Mode& _mode)
+{
+    QSharedPointer<Rendering> rendering(new Rendering);
+    rendering->text = _mode == Json ? _message.toJson() : _message.toString();
+    rendering->width = 0;
+    const QChar* data = rendering->text.constData();
+    int start = 0;
+    for (int i = 0, n = static_cast<int>(rendering->text.size()); i <= n; i++)
+    {
+        if (i == n || data[i] == QLatin1Char('\n'))
+        {
+            rendering->lines.append(start);
+            rendering->width = qMax(rendering->width, i - start);
+            start = i + 1;
+        }
+    }
+    return rendering;
+}
+
+QString PayloadView::hexLine(const QByteArrayView& _body, const int& _line)
+{
+    static const char digits[] = "0123456789abcdef";
+    qsizetype offset = static_cast<qsizetype>(_line) * HEX_BYTES_PER_LINE;
+    QByteArrayView bytes = _body.sliced(offset, qMin<qsizetype>(HEX_BYTES_PER_LINE, _body.size() - offset));
+    QByteArray line(HEX_LINE_WIDTH, ' ');
+    char* out = line.data();
+    for (int i = 7; i >= 0; i--)
+    {
+        out[i] = digits[(offset >> ((7 - i) * 4)) & 0xf];
+    }
+    int ascii = HEX_ASCII_COLUMN;
+    out[ascii - 1] = '|';
+    for (qsizetype i = 0, n = bytes.size(); i < n; i++)
+    {
+        uchar byte = static_cast<uchar>(bytes.at(i));
+        int column = 10 + static_cast<int>(i) * 3 + (i >= HEX_BYTES_PER_LINE / 2 ? 1 : 0);
+        out[column] = digits[byte >> 4];
+        out[column + 1] = digits[byte & 0xf];
+        out[ascii + i] = byte >= 0x20 && byte < 0x7f ? static_cast<char>(byte) : '.';
+    }
+    out[ascii + bytes.size()] = '|';
+    line.truncate(ascii + bytes.size() + 1);
+    return QString::fromLatin1(line);
+}
+
+int PayloadView::lineCount() const
+{
+    if (!this->m_HasMessage)
+    {
+        return 0;
+    }
+    if (this->m_Mode == Hex)
+    {
+        return static_cast<int>((this->m_Message.bodyView().size() + HEX_BYTES_PER_LINE - 1) / HEX_BYTES_PER_LINE);
+    }
+    return this->m_Rendering ? static_cast<int>(this->m_Rendering->lines.size()) : 0;
+}
+
+int PayloadView::lineWidth() const
+{
+    if (this->m_Mode == Hex)
+    {
+        return HEX_LINE_WIDTH;
+    }
+    return this->m_Rendering ? this->m_Rendering->width : 0;
+}
+
+/**
+ * @brief The visible part of a line, from _column on at most _columns characters. Only that part
+ * is copied, a body of a single multi-MB line costs no more to paint than a short one.
+ */
+QString PayloadView::line(const int& _line, const int& _column, const int& _columns) const
+{
+    if (this->m_Mode == Hex)
+    {
+        return hexLine(this->m_Message.bodyView(), _line).mid(_column, _columns);
+    }
+    const QString& text = this->m_Rendering->text;
+    const QList<int>& lines = this->m_Rendering->lines;
+    int start = lines.at(_line);
+    int end = _line + 1 < lines.size() ? lines.at(_line + 1) - 1 : static_cast<int>(text.size());
+    if (end > start && text.at(end - 1) == QLatin1Char('\r'))
+    {
+        end--;
+    }
+    start = qMin(end, start + qMax(0, _column));
+    return text.mid(start, qMin(end - start, qMax(0, _columns)));
+}
+
+/**
+ * @brief Ledger ids are unique in a cluster, the length tells the messages of different
+ * clusters apart.
+ */
+QString PayloadView::cacheKey() const
+{
+    return QString("%1:%2:%3:%4:%5").arg(this->m_Message.ledgerId()).arg(this->m_Message.entryId()).arg(this->m_Message.batchIndex()).arg(this->m_Message.bodyLength()).arg(this->m_Mode);
+}
+
+void PayloadView::updateScrollBars()
+{
+    QFontMetrics metrics(font());
+    int rows = qMax(1, (viewport()->height() - MARGIN) / metrics.height());
+    int columns = qMax(1, (viewport()->width() - 2 * MARGIN) / qMax(1, metrics.horizontalAdvance(QLatin1Char('0'))));
+    verticalScrollBar()->setRange(0, qMax(0, lineCount() - rows));
+    verticalScrollBar()->setPageStep(rows);
+    horizontalScrollBar()->setRange(0, qMax(0, lineWidth() - columns));
+    horizontalScrollBar()->setPageStep(columns);
+}
+
+void PayloadView::paintEvent(QPaintEvent* _event)
+{
+    Q_UNUSED(_event);
+    QPainter painter(viewport());
+    painter.setFont(font());
+    painter.setPen(palette().color(QPalette::Text));
+    if (!this->m_HasMessage)
+    {
+        return;
+    }
+    if (this->m_Mode != Hex && !this->m_Rendering)
+    {
+        painter.drawText(viewport()->rect(), Qt::AlignCenter, tr("Formatting %1 bytes...").arg(this->m_Message.bodyLength()));
+        return;
+    }
+    QFontMetrics metrics(font());
+    int height = metrics.height();
+    int column = horizontalScrollBar()->value();
+    int columns = viewport()->width() / qMax(1, metrics.horizontalAdvance(QLatin1Char('0'))) + 2;
+    int first = verticalScrollBar()->value();
+    int last = qMin(lineCount(), first + viewport()->height() / height + 2);
+    int y = MARGIN + metrics.ascent();
+    for (int i = first; i < last; i++, y += height)
+    {
+        painter.drawText(MARGIN, y, line(i, column, columns));
+    }
+}
+
+void PayloadView::resizeEvent(QResizeEvent* _event)
+{
+    QAbstractScrollArea::resizeEvent(_event);
+    updateScrollBars();
+}
+
+void PayloadView::keyPressEvent(QKeyEvent* _event)
+{
+    if (_event->matches(QKeySequence::Copy))
+    {
+        QGuiApplication::clipboard()->setText(toPlainText());
+    }
+    else if (_event->matches(QKeySequence::MoveToNextLine))
+    {
+        verticalScrollBar()->triggerAction(QAbstractSlider::SliderSingleStepAdd);
+    }
+    else if (_event->matches(QKeySequence::MoveToPreviousLine))
+    {
+        verticalScrollBar()->triggerAction(QAbstractSlider::SliderSingleStepSub);
+    }
+    else if (_event->matches(QKeySequence::MoveToNextPage))
+    {
+        verticalScrollBar()->triggerAction(QAbstractSlider::SliderPageStepAdd);
+    }
+    else if (_event->matches(QKeySequence::MoveToPreviousPage))
+    {
+        verticalScrollBar()->triggerAction(QAbstractSlider::SliderPageStepSub);
+    }
+    else if (_event->matches(QKeySequence::MoveToStartOfDocument))
+    {
+        verticalScrollBar()->triggerAction(QAbstractSlider::SliderToMinimum);
+    }
+    else if (_event->matches(QKeySequence::MoveToEndOfDocument))
+    {
+        verticalScrollBar()->triggerAction(QAbstractSlider::SliderToMaximum);
+    }
+    else if (_event->matches(QKeySequence::MoveToNextChar))
+    {
+        horizontalScrollBar()->triggerAction(QAbstractSlider::SliderSingleStepAdd);
+    }
+    else if (_event->matches(QKeySequence::MoveToPreviousChar))
+    {
+        horizontalScrollBar()->triggerAction(QAbstractSlider::SliderSingleStepSub);
+    }
+    else
+    {
+        QAbstractScrollArea::keyPressEvent(_event);
+    }
+}
+
+void PayloadView::contextMenuEvent(QContextMenuEvent* _event)
+{
+    QMenu menu(this);
+    QAction* copy = menu.addAction(QIcon(":/copy"), tr("&Copy All"));
+    copy->setEnabled(this->m_HasMessage && (this->m_Mode == Hex || this->m_Rendering));
+    if (menu.exec(_event->globalPos()) == copy)
+    {
+        QGuiApplication::clipboard()->setText(toPlainText());
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef PAYLOADVIEW_H
+#define PAYLOADVIEW_H
+
+#include <QAbstractScrollArea>
+#include <QCache>
+#include <QSharedPointer>
+
+#include "pulsarmessage.h"
+
+/**
+ * @brief Shows the body of a message as text, pretty printed JSON or hex with ASCII.
+ *
+ * Only the lines in sight are painted. The hex lines are formatted from the body as they are
+ * painted, text and JSON are rendered once per message and mode with a line index, on a worker
+ * thread when the body is large, and kept in a cache of at most maxCachedBytes() so switching
+ * modes or going back to a message does not render it again. Lines are not wrapped, long ones
+ * scroll horizontally.
+ */
+class PayloadView : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    enum Mode
+    {
+        Text,
+        Json,
+        Hex
+    };
+
+    explicit PayloadView(QWidget* _parent = nullptr);
+
+    void setMessage(const PulsarMessage& _message);
+    inline PulsarMessage message() const { return this->m_Message; }
+    void clear();
+    void setMode(const Mode& _mode);
+    inline Mode mode() const { return this->m_Mode; }
+
+    inline void setMaxCachedBytes(const int& _max) { this->m_Cache.setMaxCost(qMax(0, _max)); }
+    inline int maxCachedBytes() const { return static_cast<int>(this->m_Cache.maxCost()); }
+
+    QString toPlainText() const;
+
+protected:
+    void paintEvent(QPaintEvent* _event) override;
+    void resizeEvent(QResizeEvent* _event) override;
+    void keyPressEvent(QKeyEvent* _event) override;
+    void contextMenuEvent(QContextMenuEvent* _event) override;
+
+private:
+    struct Rendering
+    {
+        QString text;
+        QList<int> lines;           //the offset of every line in text
+        int width;                  //of the longest line, in characters
+    };
+    typedef QSharedPointer<const Rendering> RenderingPointer;
+
+    void updateRendering();
+    void updateScrollBars();
+    int lineCount() const;
+    int lineWidth() const;
+    QString line(const int& _line, const int& _column, const int& _columns) const;
+    QString cacheKey() const;
+
+    static RenderingPointer renderBody(const PulsarMessage& _message, const Mode& _mode);
+    static QString hexLine(const QByteArrayView& _body, const int& _line);
+
+private:
+    PulsarMessage m_Message;
+    bool m_HasMessage;
+    Mode m_Mode;
+    RenderingPointer m_Rendering;
+    QCache<QString, RenderingPointer> m_Cache;
+    int m_Generation;
+};
+
+#endif // PAYLOADVIEW_H
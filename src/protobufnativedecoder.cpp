@@ -0,0 +1,505 @@
+#include "protobufnativedecoder.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <cstring>
+
+#include "protobufreader.h"
+#include "logging.h"
+
+/**
+ * @brief Compile the schema of a PROTOBUF_NATIVE topic, a JSON document with the base64
+ * encoded fileDescriptorSet and the rootMessageTypeName.
+ * @param _definition
+ * @return nullptr when the descriptors do not decode or the root message is not among them
+ */
+QSharedPointer<const SchemaDecoder> ProtobufNativeDecoder::compile(const QByteArray& _definition)
+{
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(_definition, &error);
+    if (error.error != QJsonParseError::NoError || !doc.isObject())
+    {
+        qCWarning(lcDecode) << "Protobuf native schema is not a JSON document" << Qt::endl;
+        return QSharedPointer<const SchemaDecoder>();
+    }
+    QByteArray descriptors = QByteArray::fromBase64(doc.object()["fileDescriptorSet"].toString().toLatin1());
+
+    //FileDescriptorSet: repeated FileDescriptorProto file = 1
+    QSharedPointer<ProtobufNativeDecoder> decoder(new ProtobufNativeDecoder());
+    ProtobufReader reader(descriptors.constData(), descriptors.size());
+    quint32 field;
+    int wireType;
+    while (reader.next(field, wireType))
+    {
+        if (field == 1 && wireType == ProtobufReader::LengthDelimited)
+        {
+            const char* data;
+            int length;
+            if (!reader.readBytes(data, length) || !decoder->readFile(data, length))
+            {
+                break;
+            }
+        }
+        else if (!reader.skip(wireType))
+        {
+            break;
+        }
+    }
+
+    decoder->m_Root = doc.object()["rootMessageTypeName"].toString();
+    if (reader.hasError() || !decoder->m_Messages.contains(decoder->m_Root))
+    {
+        qCWarning(lcDecode) << "Protobuf native schema has no message " << decoder->m_Root << Qt::endl;
+        return QSharedPointer<const SchemaDecoder>();
+    }
+    return decoder;
+}
+
+/**
+ * @brief FileDescriptorProto: package = 2, message_type = 4, enum_type = 5. The package is
+ * looked up first, the types are named after it.
+ */
+bool ProtobufNativeDecoder::readFile(const char* _data, const int& _size)
+{
+    QString package;
+    quint32 field;
+    int wireType;
+    ProtobufReader scan(_data, _size);
+    while (scan.next(field, wireType))
+    {
+        const char* data;
+        int length;
+        if (field == 2 && wireType == ProtobufReader::LengthDelimited)
+        {
+            if (!scan.readBytes(data, length))
+            {
+                return false;
+            }
+            package = QString::fromUtf8(data, length);
+        }
+        else if (!scan.skip(wireType))
+        {
+            return false;
+        }
+    }
+
+    ProtobufReader reader(_data, _size);
+    while (reader.next(field, wireType))
+    {
+        const char* data;
+        int length;
+        if ((field == 4 || field == 5) && wireType == ProtobufReader::LengthDelimited)
+        {
+            if (!reader.readBytes(data, length))
+            {
+                return false;
+            }
+            if (field == 4 ? !readMessage(data, length, package) : !readEnum(data, length, package))
+            {
+                return false;
+            }
+        }
+        else if (!reader.skip(wireType))
+        {
+            return false;
+        }
+    }
+    return !reader.hasError();
+}
+
+/**
+ * @brief DescriptorProto: name = 1, field = 2, nested_type = 3, enum_type = 4.
+ */
+bool ProtobufNativeDecoder::readMessage(const char* _data, const int& _size, const QString& _scope)
+{
+    QString name;
+    quint32 field;
+    int wireType;
+    ProtobufReader scan(_data, _size);
+    while (scan.next(field, wireType))
+    {
+        const char* data;
+        int length;
+        if (field == 1 && wireType == ProtobufReader::LengthDelimited)
+        {
+            if (!scan.readBytes(data, length))
+            {
+                return false;
+            }
+            name = QString::fromUtf8(data, length);
+        }
+        else if (!scan.skip(wireType))
+        {
+            return false;
+        }
+    }
+    QString fullName = _scope.isEmpty() ? name : _scope + "." + name;
+
+    MessageType type;
+    ProtobufReader reader(_data, _size);
+    while (reader.next(field, wireType))
+    {
+        const char* data;
+        int length;
+        if (field >= 2 && field <= 4 && wireType == ProtobufReader::LengthDelimited)
+        {
+            if (!reader.readBytes(data, length))
+            {
+                return false;
+            }
+            if (field == 2)
+            {
+                quint32 number;
+                Field descriptor;
+                if (!readField(data, length, number, descriptor))
+                {
+                    return false;
+                }
+                type.fields.insert(number, descriptor);
+            }
+            else if (field == 3 ? !readMessage(data, length, fullName) : !readEnum(data, length, fullName))
+            {
+                return false;
+            }
+        }
+        else if (!reader.skip(wireType))
+        {
+            return false;
+        }
+    }
+    this->m_Messages.insert(fullName, type);
+    return !reader.hasError();
+}
+
+/**
+ * @brief EnumDescriptorProto: name = 1, value = 2 with EnumValueDescriptorProto: name = 1,
+ * number = 2.
+ */
+bool ProtobufNativeDecoder::readEnum(const char* _data, const int& _size, const QString& _scope)
+{
+    QString name;
+    QHash<int, QString> values;
+    quint32 field;
+    int wireType;
+    ProtobufReader reader(_data, _size);
+    while (reader.next(field, wireType))
+    {
+        const char* data;
+        int length;
+        if ((field == 1 || field == 2) && wireType == ProtobufReader::LengthDelimited)
+        {
+            if (!reader.readBytes(data, length))
+            {
+                return false;
+            }
+            if (field == 1)
+            {
+                name = QString::fromUtf8(data, length);
+                continue;
+            }
+            QString valueName;
+            quint64 number = 0;
+            ProtobufReader value(data, length);
+            quint32 valueField;
+            int valueWireType;
+            while (value.next(valueField, valueWireType))
+            {
+                const char* valueData;
+                int valueLength;
+                if (valueField == 1 && valueWireType == ProtobufReader::LengthDelimited && value.readBytes(valueData, valueLength))
+                {
+                    valueName = QString::fromUtf8(valueData, valueLength);
+                }
+                else if (valueField == 2 && valueWireType == ProtobufReader::Varint)
+                {
+                    value.readVarint(number);
+                }
+                else if (!value.skip(valueWireType))
+                {
+                    return false;
+                }
+            }
+            values.insert(static_cast<int>(number), valueName);
+        }
+        else if (!reader.skip(wireType))
+        {
+            return false;
+        }
+    }
+    this->m_Enums.insert(_scope.isEmpty() ? name : _scope + "." + name, values);
+    return !reader.hasError();
+}
+
+/**
+ * @brief FieldDescriptorProto: name = 1, number = 3, label = 4, type = 5, type_name = 6.
+ */
+bool ProtobufNativeDecoder::readField(const char* _data, const int& _size, quint32& _number, Field& _field)
+{
+    _field.type = 0;
+    _field.repeated = false;
+    _number = 0;
+    quint32 field;
+    int wireType;
+    ProtobufReader reader(_data, _size);
+    while (reader.next(field, wireType))
+    {
+        const char* data;
+        int length;
+        quint64 value;
+        if ((field == 1 || field == 6) && wireType == ProtobufReader::LengthDelimited)
+        {
+            if (!reader.readBytes(data, length))
+            {
+                return false;
+            }
+            QString text = QString::fromUtf8(data, length);
+            if (field == 1)
+            {
+                _field.name = text;
+            }
+            else
+            {
+                _field.typeName = text.startsWith('.') ? text.mid(1) : text; //fully qualified
+            }
+        }
+        else if ((field == 3 || field == 4 || field == 5) && wireType == ProtobufReader::Varint)
+        {
+            if (!reader.readVarint(value))
+            {
+                return false;
+            }
+            if (field == 3)
+            {
+                _number = static_cast<quint32>(value);
+            }
+            else if (field == 4)
+            {
+                _field.repeated = value == 3; //LABEL_REPEATED
+            }
+            else
+            {
+                _field.type = static_cast<int>(value);
+            }
+        }
+        else if (!reader.skip(wireType))
+        {
+            return false;
+        }
+    }
+    return !reader.hasError() && _number > 0;
+}
+
+QVariant ProtobufNativeDecoder::decode(const QByteArray& _key, const QByteArrayView& _value) const
+{
+    Q_UNUSED(_key);
+    QVariant value;
+    if (!read(this->m_Root, _value.data(), static_cast<int>(_value.size()), value, 0))
+    {
+        return QVariant();
+    }
+    return value;
+}
+
+bool ProtobufNativeDecoder::read(const QString& _type, const char* _data, const int& _size, QVariant& _value, const int& _depth) const
+{
+    if (_depth > MAX_DEPTH || !this->m_Messages.contains(_type))
+    {
+        return false;
+    }
+    const MessageType& type = this->m_Messages[_type];
+    QVariantMap message;
+    ProtobufReader reader(_data, _size);
+    quint32 number;
+    int wireType;
+    while (reader.next(number, wireType))
+    {
+        Field field;
+        if (type.fields.contains(number))
+        {
+            field = type.fields[number];
+        }
+        else
+        {
+            //unknown to the descriptor, kept as the raw wire value
+            static const int types[] = { TypeUint64, TypeFixed64, TypeBytes, 0, 0, TypeFixed32 };
+            field = Field { QString::number(number), wireType < 6 ? types[wireType] : 0, false, QString() };
+        }
+
+        bool scalar = field.type != TypeString && field.type != TypeBytes && field.type != TypeMessage && field.type != TypeGroup;
+        if (field.repeated && scalar && wireType == ProtobufReader::LengthDelimited)
+        {
+            //packed repeated scalars
+            const char* data;
+            int length;
+            if (!reader.readBytes(data, length))
+            {
+                return false;
+            }
+            int packedWireType = ProtobufReader::Varint;
+            if (field.type == TypeDouble || field.type == TypeFixed64 || field.type == TypeSfixed64)
+            {
+                packedWireType = ProtobufReader::Fixed64;
+            }
+            else if (field.type == TypeFloat || field.type == TypeFixed32 || field.type == TypeSfixed32)
+            {
+                packedWireType = ProtobufReader::Fixed32;
+            }
+            QVariantList list = message.value(field.name).toList();
+            ProtobufReader packed(data, length);
+            while (!packed.atEnd())
+            {
+                QVariant item;
+                if (!readValue(field, packed, packedWireType, item, _depth))
+                {
+                    return false;
+                }
+                list << item;
+            }
+            message.insert(field.name, list);
+            continue;
+        }
+
+        QVariant value;
+        if (!readValue(field, reader, wireType, value, _depth))
+        {
+            return false;
+        }
+        if (field.repeated)
+        {
+            QVariantList list = message.value(field.name).toList();
+            list << value;
+            message.insert(field.name, list);
+        }
+        else
+        {
+            message.insert(field.name, value);
+        }
+    }
+    if (reader.hasError())
+    {
+        return false;
+    }
+    _value = message;
+    return true;
+}
+
+bool ProtobufNativeDecoder::readValue(const Field& _field, ProtobufReader& _reader, const int& _wireType, QVariant& _value, const int& _depth) const
+{
+    switch (_field.type)
+    {
+    case TypeInt64:
+    case TypeUint64:
+    case TypeInt32:
+    case TypeUint32:
+    case TypeBool:
+    case TypeEnum:
+    case TypeSint32:
+    case TypeSint64:
+    {
+        quint64 value;
+        if (_wireType != ProtobufReader::Varint || !_reader.readVarint(value))
+        {
+            return false;
+        }
+        switch (_field.type)
+        {
+        case TypeInt64:
+            _value = static_cast<qint64>(value);
+            break;
+        case TypeUint64:
+            _value = value;
+            break;
+        case TypeInt32:
+            _value = static_cast<qint32>(value);
+            break;
+        case TypeUint32:
+            _value = static_cast<quint32>(value);
+            break;
+        case TypeBool:
+            _value = value != 0;
+            break;
+        case TypeEnum:
+        {
+            QHash<int, QString> values = this->m_Enums.value(_field.typeName);
+            int number = static_cast<qint32>(value);
+            _value = values.contains(number) ? QVariant(values.value(number)) : QVariant(number);
+            break;
+        }
+        case TypeSint32:
+            _value = static_cast<qint32>((value >> 1) ^ -(value & 1));
+            break;
+        default:
+            _value = static_cast<qint64>(value >> 1) ^ -static_cast<qint64>(value & 1);
+            break;
+        }
+        return true;
+    }
+    case TypeDouble:
+    case TypeFixed64:
+    case TypeSfixed64:
+    {
+        quint64 value;
+        if (_wireType != ProtobufReader::Fixed64 || !_reader.readFixed64(value))
+        {
+            return false;
+        }
+        if (_field.type == TypeDouble)
+        {
+            double number;
+            memcpy(&number, &value, sizeof(number));
+            _value = number;
+        }
+        else
+        {
+            _value = _field.type == TypeFixed64 ? QVariant(value) : QVariant(static_cast<qint64>(value));
+        }
+        return true;
+    }
+    case TypeFloat:
+    case TypeFixed32:
+    case TypeSfixed32:
+    {
+        quint32 value;
+        if (_wireType != ProtobufReader::Fixed32 || !_reader.readFixed32(value))
+        {
+            return false;
+        }
+        if (_field.type == TypeFloat)
+        {
+            float number;
+            memcpy(&number, &value, sizeof(number));
+            _value = number;
+        }
+        else
+        {
+            _value = _field.type == TypeFixed32 ? QVariant(value) : QVariant(static_cast<qint32>(value));
+        }
+        return true;
+    }
+    case TypeString:
+    case TypeBytes:
+    case TypeMessage:
+    {
+        const char* data;
+        int length;
+        if (_wireType != ProtobufReader::LengthDelimited || !_reader.readBytes(data, length))
+        {
+            return false;
+        }
+        if (_field.type == TypeString)
+        {
+            _value = QString::fromUtf8(data, length);
+            return true;
+        }
+        if (_field.type == TypeBytes)
+        {
+            _value = QByteArray(data, length);
+            return true;
+        }
+        return read(_field.typeName, data, length, _value, _depth + 1);
+    }
+    default:
+        return false; //groups are deprecated and not written by pulsar producers
+    }
+}
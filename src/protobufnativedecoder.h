@@ -0,0 +1,65 @@
+#ifndef PROTOBUFNATIVEDECODER_H
+#define PROTOBUFNATIVEDECODER_H
+
+#include <QHash>
+
+#include "schemadecoder.h"
+
+class ProtobufReader;
+
+/**
+ * @brief Decoder of PROTOBUF_NATIVE topics.
+ *
+ * The schema carries the FileDescriptorSet of the producer's .proto files and the name of the
+ * root message. The descriptors are read with ProtobufReader into tables of messages and enums
+ * once, the payload is then decoded field by field. Fields missing from the descriptor are kept
+ * under their number.
+ */
+class ProtobufNativeDecoder : public SchemaDecoder
+{
+public:
+    QVariant decode(const QByteArray& _key, const QByteArrayView& _value) const override;
+
+    static QSharedPointer<const SchemaDecoder> compile(const QByteArray& _definition);
+
+private:
+    explicit ProtobufNativeDecoder() : SchemaDecoder("PROTOBUF_NATIVE") {}
+
+    //FieldDescriptorProto.Type
+    enum FieldType
+    {
+        TypeDouble = 1, TypeFloat = 2, TypeInt64 = 3, TypeUint64 = 4, TypeInt32 = 5, TypeFixed64 = 6, TypeFixed32 = 7, TypeBool = 8,
+        TypeString = 9, TypeGroup = 10, TypeMessage = 11, TypeBytes = 12, TypeUint32 = 13, TypeEnum = 14, TypeSfixed32 = 15,
+        TypeSfixed64 = 16, TypeSint32 = 17, TypeSint64 = 18
+    };
+
+    struct Field
+    {
+        QString name;
+        int type;
+        bool repeated;
+        QString typeName;
+    };
+
+    struct MessageType
+    {
+        QHash<quint32, Field> fields;
+    };
+
+    bool readFile(const char* _data, const int& _size);
+    bool readMessage(const char* _data, const int& _size, const QString& _scope);
+    bool readEnum(const char* _data, const int& _size, const QString& _scope);
+    static bool readField(const char* _data, const int& _size, quint32& _number, Field& _field);
+
+    bool read(const QString& _type, const char* _data, const int& _size, QVariant& _value, const int& _depth) const;
+    bool readValue(const Field& _field, ProtobufReader& _reader, const int& _wireType, QVariant& _value, const int& _depth) const;
+
+private:
+    QHash<QString, MessageType> m_Messages;
+    QHash<QString, QHash<int, QString>> m_Enums;
+    QString m_Root;
+
+    static const int MAX_DEPTH = 64;
+};
+
+#endif // PROTOBUFNATIVEDECODER_H
@@ -0,0 +1,132 @@
+#include "protobufreader.h"
+
+#include <QtEndian>
+
+/**
+ * @brief Read the key of the next field.
+ * @param _field the field number
+ * @param _wireType
+ * @return false at the end of the span or on malformed input
+ */
+bool ProtobufReader::next(quint32& _field, int& _wireType)
+{
+    if (this->m_Error || atEnd())
+    {
+        return false;
+    }
+    quint64 key;
+    if (!readVarint(key))
+    {
+        return false;
+    }
+    _field = static_cast<quint32>(key >> 3);
+    _wireType = static_cast<int>(key & 0x07);
+    if (_field == 0)
+    {
+        this->m_Error = true;
+        return false;
+    }
+    return true;
+}
+
+bool ProtobufReader::readVarint(quint64& _value)
+{
+    _value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (this->m_Pos >= this->m_Size)
+        {
+            this->m_Error = true;
+            return false;
+        }
+        quint8 byte = static_cast<quint8>(this->m_Data[this->m_Pos++]);
+        _value |= static_cast<quint64>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            return true;
+        }
+    }
+    this->m_Error = true; //more than 10 bytes
+    return false;
+}
+
+bool ProtobufReader::readBytes(const char*& _data, int& _length)
+{
+    quint64 length;
+    if (!readVarint(length))
+    {
+        return false;
+    }
+    if (length > static_cast<quint64>(this->m_Size - this->m_Pos))
+    {
+        this->m_Error = true;
+        return false;
+    }
+    _data = this->m_Data + this->m_Pos;
+    _length = static_cast<int>(length);
+    this->m_Pos += _length;
+    return true;
+}
+
+bool ProtobufReader::readFixed32(quint32& _value)
+{
+    if (this->m_Size - this->m_Pos < 4)
+    {
+        this->m_Error = true;
+        return false;
+    }
+    _value = qFromLittleEndian<quint32>(this->m_Data + this->m_Pos);
+    this->m_Pos += 4;
+    return true;
+}
+
+bool ProtobufReader::readFixed64(quint64& _value)
+{
+    if (this->m_Size - this->m_Pos < 8)
+    {
+        this->m_Error = true;
+        return false;
+    }
+    _value = qFromLittleEndian<quint64>(this->m_Data + this->m_Pos);
+    this->m_Pos += 8;
+    return true;
+}
+
+/**
+ * @brief Skip the value of a field that is not of interest.
+ * @param _wireType
+ * @return
+ */
+bool ProtobufReader::skip(const int& _wireType)
+{
+    switch (_wireType)
+    {
+    case ProtobufReader::Varint:
+    {
+        quint64 value;
+        return readVarint(value);
+    }
+    case ProtobufReader::LengthDelimited:
+    {
+        const char* data;
+        int length;
+        return readBytes(data, length);
+    }
+    case ProtobufReader::Fixed64:
+    case ProtobufReader::Fixed32:
+    {
+        int width = _wireType == ProtobufReader::Fixed64 ? 8 : 4;
+        if (this->m_Size - this->m_Pos < width)
+        {
+            this->m_Error = true;
+            return false;
+        }
+        this->m_Pos += width;
+        return true;
+    }
+    default:
+        //groups are not used by the pulsar protocol
+        this->m_Error = true;
+        return false;
+    }
+}
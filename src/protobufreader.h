@@ -0,0 +1,41 @@
+#ifndef PROTOBUFREADER_H
+#define PROTOBUFREADER_H
+
+#include <QtGlobal>
+
+/**
+ * @brief Reader of the protobuf wire format over a byte span it does not own.
+ *
+ * Length-delimited fields are returned as pointers into the span, nothing is copied.
+ * Every read is bounds checked, a truncated or malformed input makes next() return false.
+ */
+class ProtobufReader
+{
+public:
+    enum WireType
+    {
+        Varint = 0, Fixed64 = 1, LengthDelimited = 2, StartGroup = 3, EndGroup = 4, Fixed32 = 5
+    };
+
+    ProtobufReader(const char* _data, const int& _size) : m_Data(_data), m_Size(_size), m_Pos(0), m_Error(false) {}
+
+    bool next(quint32& _field, int& _wireType);
+
+    bool readVarint(quint64& _value);
+    bool readBytes(const char*& _data, int& _length);
+    bool readFixed32(quint32& _value);
+    bool readFixed64(quint64& _value);
+    bool skip(const int& _wireType);
+
+    inline bool atEnd() const { return this->m_Pos >= this->m_Size; }
+    inline bool hasError() const { return this->m_Error; }
+    inline int position() const { return this->m_Pos; }
+
+private:
+    const char* m_Data;
+    int m_Size;
+    int m_Pos;
+    bool m_Error;
+};
+
+#endif // PROTOBUFREADER_H
@@ -2,56 +2,338 @@
 
 #include <QJsonDocument>
 #include <QTextCodec>
-#include <QtDebug>
 #include <QVariantMap>
+#include <QtEndian>
 
-PulsarMessage::PulsarMessage(const QByteArray& _data) : Message(), m_Data(_data), m_Key(QString()), m_Body(QByteArray())
-{
-    this->m_Length = m_Data.length();
-    bool ok;
-    int length = this->m_Data.left(HEADER_LENGTH).toHex().toInt(&ok, 16);
-    if (length < this->m_Length)
-    {
-        this->m_HeaderLength = length;
-        qDebug() << "read header length: " << QString::number(this->m_HeaderLength) << Qt::endl;
+#include "logging.h"
 
-        this->m_Position = HEADER_LENGTH;
-        qDebug() << "current read position: " << this->m_Position << Qt::endl;
+class PulsarMessageData : public QSharedData
+{
+public:
+    PulsarMessageData() : offset(0), length(0), headerOffset(0), headerLength(0), bodyOffset(0), bodyLength(0), hasKey(false), batchIndex(-1),
+        chunkId(-1), numChunks(0), totalChunkSize(0), compression(MessageMetadata::NONE), uncompressedSize(0), schemaVersion(-1) {}
 
-        this->m_Header = this->m_Data.mid(this->m_Position, this->m_HeaderLength);
-        this->m_Position += this->m_HeaderLength;
+    QByteArray data; //the whole entry, shared by the messages of a batch
+    int offset;
+    int length;
+    int headerOffset;
+    int headerLength;
+    int bodyOffset;
+    int bodyLength;
+    SingleMessageMetadata metadata; //parsed once with the offsets, holds the partition key and properties
 
-        qDebug() << "read header data: " << QString::fromLatin1(this->m_Header.toHex(' ')) << ", current pos: " << this->m_Position << Qt::endl;
+    QString key;
+    bool hasKey;
+    Properties properties;
+    QList<PulsarMessage> batch;
+    int batchIndex;
 
-        this->m_Body = this->m_Data.mid(this->m_Position, (this->m_Length - this->m_Position));
+    QString uuid;
+    int chunkId;
+    int numChunks;
+    int totalChunkSize;
+    QList<Message> chunks;
+    MessageMetadata::CompressionType compression;
+    int uncompressedSize;
+    qint64 schemaVersion;
+};
 
-        qDebug() << "read body data: " << QString::fromLatin1(this->m_Body.toHex(' ')) << Qt::endl;
+PulsarMessage::PulsarMessage() : Message(), d(new PulsarMessageData) {}
 
-        int pos = 0;
-        readHeader(pos);
+/**
+ * @brief An entry of a batch starts with the big endian size of its SingleMessageMetadata,
+ * anything that does not decode as such is taken as a plain payload.
+ * @param _data
+ */
+PulsarMessage::PulsarMessage(const QByteArray& _data) : Message(), d(new PulsarMessageData)
+{
+    d->data = _data;
+    d->length = _data.length();
+    const char* data = _data.constData();
+    quint32 length = d->length >= HEADER_LENGTH ? qFromBigEndian<quint32>(data) : 0;
+    SingleMessageMetadata metadata;
+    if (length > 0 && length <= static_cast<quint32>(d->length - HEADER_LENGTH) && SingleMessageMetadata::parse(data + HEADER_LENGTH, length, metadata))
+    {
+        d->headerOffset = HEADER_LENGTH;
+        d->headerLength = length;
+        d->bodyOffset = HEADER_LENGTH + length;
+        d->bodyLength = qBound(0, metadata.payloadSize(), d->length - d->bodyOffset);
+        d->metadata = metadata;
+        qCDebug(lcDecode) << "read header length: " << d->headerLength << ", header data: " << QString::fromLatin1(_data.mid(d->headerOffset, d->headerLength).toHex(' ')) << Qt::endl;
     }
     else
     {
-        this->m_Body = this->m_Data.mid(0, this->m_Length);
+        d->bodyLength = d->length;
+    }
+    qCDebug(lcDecode) << "read body data: " << QString::fromLatin1(body().toHex(' ')) << Qt::endl;
+}
+
+PulsarMessage::PulsarMessage(const PulsarMessage& _other) = default;
+PulsarMessage::PulsarMessage(PulsarMessage&& _other) noexcept = default;
+PulsarMessage::~PulsarMessage() = default;
+PulsarMessage& PulsarMessage::operator=(const PulsarMessage& _other) = default;
+PulsarMessage& PulsarMessage::operator=(PulsarMessage&& _other) noexcept = default;
+
+/**
+ * @brief The properties of the metadata, overlaid with the ones set on the message.
+ * @return
+ */
+Properties PulsarMessage::properties() const
+{
+    if (d->properties.isEmpty())
+    {
+        return d->metadata.properties();
+    }
+    Properties properties = d->metadata.properties();
+    QMap<QString, QString>::const_iterator it;
+    for (it = d->properties.constBegin(); it != d->properties.constEnd(); ++it)
+    {
+        properties[it.key()] = it.value();
     }
+    return properties;
+}
+
+void PulsarMessage::setProperties(const Properties& _properties)
+{
+    d->properties = _properties;
 }
 
-PulsarMessage& PulsarMessage::operator=(const PulsarMessage& _other)
+void PulsarMessage::addProperties(const QString& _key, const QString& _value)
 {
-    Message::operator=(_other);
-    this->m_Data = _other.data();
-    this->m_Properties = _other.properties();
-    this->m_Key = _other.key();
-    this->m_Body = _other.body();
-    return *this;
+    d->properties[_key] = _value;
+}
+
+/**
+ * @brief The bytes of this message, its size prefix and metadata included.
+ * @return
+ */
+QByteArray PulsarMessage::data() const
+{
+    if (d->offset == 0 && d->length == d->data.length())
+    {
+        return d->data;
+    }
+    return d->data.mid(d->offset, d->length);
+}
+
+QString PulsarMessage::key() const
+{
+    return d->hasKey ? d->key : d->metadata.partitionKey();
+}
+
+void PulsarMessage::setKey(const QString& _key)
+{
+    d->key = _key;
+    d->hasKey = true;
+}
+
+/**
+ * @brief The body shares the payload when it spans all of it, a slice is copied out.
+ * bodyView() never copies.
+ * @return
+ */
+QByteArray PulsarMessage::body() const
+{
+    if (d->bodyOffset == 0 && d->bodyLength == d->data.length())
+    {
+        return d->data;
+    }
+    return d->data.mid(d->bodyOffset, d->bodyLength);
+}
+
+/**
+ * @brief The body inside the shared payload, valid as long as a copy of the message lives.
+ * @return
+ */
+QByteArrayView PulsarMessage::bodyView() const
+{
+    return QByteArrayView(d->data.constData() + d->bodyOffset, d->bodyLength);
+}
+
+int PulsarMessage::bodyLength() const
+{
+    return d->bodyLength;
+}
+
+/**
+ * @brief Decoded once when the message is built, empty for a message without metadata.
+ * @return
+ */
+SingleMessageMetadata PulsarMessage::metadata() const
+{
+    return d->metadata;
+}
+
+QList<PulsarMessage> PulsarMessage::batch() const
+{
+    return d->batch;
+}
+
+void PulsarMessage::setBatch(const QList<PulsarMessage>& _batch)
+{
+    d->batch = _batch;
+}
+
+bool PulsarMessage::isBatch() const
+{
+    return !d->batch.isEmpty();
+}
+
+int PulsarMessage::batchIndex() const
+{
+    return d->batchIndex;
+}
+
+QString PulsarMessage::uuid() const
+{
+    return d->uuid;
+}
+
+int PulsarMessage::chunkId() const
+{
+    return d->chunkId;
+}
+
+int PulsarMessage::numChunks() const
+{
+    return d->numChunks;
+}
+
+int PulsarMessage::totalChunkSize() const
+{
+    return d->totalChunkSize;
+}
+
+/**
+ * @brief Mark the message as one chunk of a message too large to be published at once.
+ * @param _uuid identifies the chunks of the same message
+ * @param _chunkId
+ * @param _numChunks
+ * @param _totalChunkSize the size of the whole payload
+ */
+void PulsarMessage::setChunk(const QString& _uuid, const int& _chunkId, const int& _numChunks, const int& _totalChunkSize)
+{
+    d->uuid = _uuid;
+    d->chunkId = _chunkId;
+    d->numChunks = _numChunks;
+    d->totalChunkSize = _totalChunkSize;
+}
+
+bool PulsarMessage::isChunk() const
+{
+    return d->numChunks > 1 && d->chunkId >= 0 && !d->uuid.isEmpty();
+}
+
+QList<Message> PulsarMessage::chunks() const
+{
+    return d->chunks;
+}
+
+void PulsarMessage::setChunks(const QList<Message>& _chunks)
+{
+    d->chunks = _chunks;
+}
+
+bool PulsarMessage::isChunked() const
+{
+    return !d->chunks.isEmpty();
+}
+
+/**
+ * @brief The version of the topic schema the message was produced with, -1 when unknown.
+ * @return
+ */
+qint64 PulsarMessage::schemaVersion() const
+{
+    return d->schemaVersion;
+}
+
+void PulsarMessage::setSchemaVersion(const qint64& _version)
+{
+    d->schemaVersion = _version;
+}
+
+MessageMetadata::CompressionType PulsarMessage::compression() const
+{
+    return d->compression;
+}
+
+int PulsarMessage::uncompressedSize() const
+{
+    return d->uncompressedSize;
+}
+
+void PulsarMessage::setCompression(const MessageMetadata::CompressionType& _compression, const int& _uncompressedSize)
+{
+    d->compression = _compression;
+    d->uncompressedSize = _uncompressedSize;
+}
+
+/**
+ * @brief A message whose payload is known not to carry a metadata prefix.
+ * @param _payload
+ * @return
+ */
+PulsarMessage PulsarMessage::fromPayload(const QByteArray& _payload)
+{
+    PulsarMessage message;
+    message.d->data = _payload;
+    message.d->length = _payload.length();
+    message.d->bodyLength = message.d->length;
+    return message;
+}
+
+/**
+ * @brief Split the payload of a batch entry, every message is the big endian size of its
+ * SingleMessageMetadata, the metadata and the payload. Splitting stops at the first message
+ * that does not decode. The messages share _data, nothing is copied.
+ * @param _data
+ * @param _num the number of messages in the batch
+ * @return
+ */
+QList<PulsarMessage> PulsarMessage::splitBatch(const QByteArray& _data, const int& _num)
+{
+    QList<PulsarMessage> messages;
+    messages.reserve(_num);
+    const char* data = _data.constData();
+    const int size = _data.size();
+    int offset = 0;
+    for (int i = 0; i < _num && size - offset >= HEADER_LENGTH; ++i)
+    {
+        quint32 length = qFromBigEndian<quint32>(data + offset);
+        if (length > static_cast<quint32>(size - offset - HEADER_LENGTH))
+        {
+            break;
+        }
+        SingleMessageMetadata metadata;
+        if (!SingleMessageMetadata::parse(data + offset + HEADER_LENGTH, length, metadata))
+        {
+            qCWarning(lcDecode) << "Batch message " << i << " has no valid metadata at offset " << offset << Qt::endl;
+            break;
+        }
+        PulsarMessage message;
+        message.d->data = _data;
+        message.d->offset = offset;
+        message.d->headerOffset = offset + HEADER_LENGTH;
+        message.d->headerLength = length;
+        offset += HEADER_LENGTH + length;
+        message.d->bodyOffset = offset;
+        message.d->bodyLength = qBound(0, metadata.payloadSize(), size - offset);
+        message.d->metadata = metadata;
+        offset += message.d->bodyLength;
+        message.d->length = offset - message.d->offset;
+        message.d->batchIndex = i;
+        messages << std::move(message);
+    }
+    return messages;
 }
 
 QString PulsarMessage::toJson() const
 {
-    if (this->m_Body.length() > 0)
+    if (d->bodyLength > 0)
     {
         QJsonParseError error;
-        QJsonDocument doc = QJsonDocument::fromJson(this->m_Body, &error);
+        QJsonDocument doc = QJsonDocument::fromJson(body(), &error);
         if (error.error == QJsonParseError::ParseError::NoError)
         {
             QTextCodec* codec = QTextCodec::codecForName("UTF-8");
@@ -61,13 +343,14 @@ QString PulsarMessage::toJson() const
     return QString("{}");
 }
 
-QString PulsarMessage::formatProperties()
+QString PulsarMessage::formatProperties() const
 {
-    if (this->m_Properties.size() > 0)
+    Properties properties = this->properties();
+    if (properties.size() > 0)
     {
         QVariantMap map;
         QMap<QString, QString>::const_iterator it;
-        for (it = this->m_Properties.constBegin(); it != this->m_Properties.constEnd(); ++it)
+        for (it = properties.constBegin(); it != properties.constEnd(); ++it)
         {
             map[it.key()] = it.value();
         }
@@ -77,72 +360,24 @@ QString PulsarMessage::formatProperties()
     return QString();
 }
 
-QString PulsarMessage::toHex()
+QString PulsarMessage::toHex() const
 {
     QString str;
-    if (this->m_Body.length() > 0)
+    if (d->bodyLength > 0)
     {
-        return QString::fromLatin1(this->m_Body.toHex(' '));
+        return QString::fromLatin1(body().toHex(' '));
     }
     return str;
 }
 
-QString PulsarMessage::toString()
+QString PulsarMessage::toString() const
 {
     QString str;
-    if (this->m_Body.length() > 0)
+    if (d->bodyLength > 0)
     {
         QTextCodec* codec = QTextCodec::codecForName("UTF-8");
-        str = codec->toUnicode(this->m_Body);
+        QByteArrayView view = bodyView();
+        str = codec->toUnicode(view.data(), static_cast<int>(view.size()));
     }
     return str;
 }
-
-void PulsarMessage::readHeader(int& _pos)
-{
-    bool ok;
-    QByteArray id = this->m_Header.mid(_pos++, 1);
-    if (id == QString("\n"))
-    {
-        //读取一个字节(property的长度)
-        int len = this->m_Header.mid(_pos++, 1).toHex().toInt(&ok, 16);
-        //读取len字节(property)
-        QByteArray property = this->m_Header.mid(_pos, len);
-        _pos += len;
-        readProperty(property);
-        readHeader(_pos); //继续读
-    }
-    else if (id == QString("\x12"))
-    {
-        //读取一个字节(message key的长度)
-        int len = this->m_Header.mid(_pos++, 1).toHex().toInt(&ok, 16);
-        //读取len字节(message key)
-        QByteArray key = this->m_Header.mid(_pos, len);
-        _pos += len;
-        this->m_Key = QString::fromLatin1(key);
-        readHeader(_pos); //继续读
-    }
-    else if (id == QString("\x18"))
-    {
-        //读取一个字节(body的长度)
-        int len = this->m_Header.mid(_pos++, 1).toHex().toInt(&ok, 16);
-        if (len >= 128)
-        {
-            int exlen = this->m_Header.mid(_pos++, 1).toHex().toInt(&ok, 16);
-            len += (exlen - 1) * 128;
-        }
-        this->m_BodyLength = len;
-    }
-}
-
-void PulsarMessage::readProperty(const QByteArray& _property)
-{
-    bool ok;
-    int pos = 0;
-    int keyLength = _property.mid(++pos, 1).toHex().toInt(&ok, 16); //key length
-    QByteArray key = _property.mid(++pos, keyLength);
-    pos += keyLength;
-    int valueLength = _property.mid(++pos, 1).toHex().toInt(&ok, 16); //value length
-    QByteArray value = _property.mid(++pos, valueLength);
-    this->addProperties(QString::fromLatin1(key), QString::fromLatin1(value));
-}
@@ -3,51 +3,80 @@
 
 #include <QObject>
 #include <QByteArray>
+#include <QByteArrayView>
 #include <QMap>
+#include <QSharedDataPointer>
 
 #include "message.h"
+#include "messagemetadata.h"
 
-typedef QMap<QString, QString> Properties;
+class PulsarMessageData;
 
+/**
+ * @brief A message read from a topic, implicitly shared.
+ *
+ * The payload of an entry is held once, the metadata and the body of a message are offsets
+ * into it and the messages split from a batch share the buffer of their entry. The metadata is
+ * decoded once when the message is built, the key and the properties set explicitly take
+ * precedence over its own.
+ */
 class PulsarMessage : public Message
 {
 public:
-    explicit PulsarMessage() : Message() {}
+    explicit PulsarMessage();
     PulsarMessage(const QByteArray& _data);
-    PulsarMessage(const PulsarMessage& _other) : Message(_other) { *this = _other; }
+    PulsarMessage(const PulsarMessage& _other);
+    PulsarMessage(PulsarMessage&& _other) noexcept;
+    ~PulsarMessage();
     PulsarMessage& operator=(const PulsarMessage& _other);
+    PulsarMessage& operator=(PulsarMessage&& _other) noexcept;
 
-    inline Properties properties() const { return this->m_Properties; }
-    inline void setProperties(const Properties& _properties) { this->m_Properties = _properties; }
+    Properties properties() const;
+    void setProperties(const Properties& _properties);
+    void addProperties(const QString& _key, const QString& _value);
 
-    inline QByteArray data() const { return this->m_Data; }
-    inline QString key() const { return this->m_Key; }
-    inline QByteArray body() const { return this->m_Body; }
+    QByteArray data() const;
+    QString key() const;
+    void setKey(const QString& _key);
+    QByteArray body() const;
+    QByteArrayView bodyView() const;
+    int bodyLength() const;
+    SingleMessageMetadata metadata() const;
 
-    inline void addProperties(const QString& _key, const QString& _value) { this->m_Properties[_key] = _value; }
-    QString toJson() const;
-    QString formatProperties();
-    QString toString();
-    QString toHex();
+    QList<PulsarMessage> batch() const;
+    void setBatch(const QList<PulsarMessage>& _batch);
+    bool isBatch() const;
+    int batchIndex() const;
 
-private:
-    QByteArray m_Data;
-    Properties m_Properties;
-    QString m_Key;
-    QByteArray m_Body;
-    QByteArray m_Header;
+    QString uuid() const;
+    int chunkId() const;
+    int numChunks() const;
+    int totalChunkSize() const;
+    void setChunk(const QString& _uuid, const int& _chunkId, const int& _numChunks, const int& _totalChunkSize);
+    bool isChunk() const;
+    QList<Message> chunks() const;
+    void setChunks(const QList<Message>& _chunks);
+    bool isChunked() const;
+
+    qint64 schemaVersion() const;
+    void setSchemaVersion(const qint64& _version);
 
-    int m_Length;
-    int m_HeaderLength;
-    int m_BodyLength;
-    int m_Position;
+    MessageMetadata::CompressionType compression() const;
+    int uncompressedSize() const;
+    void setCompression(const MessageMetadata::CompressionType& _compression, const int& _uncompressedSize);
 
-    const int HEADER_LENGTH = 4;
+    static PulsarMessage fromPayload(const QByteArray& _payload);
+    static QList<PulsarMessage> splitBatch(const QByteArray& _data, const int& _num);
+
+    QString toJson() const;
+    QString formatProperties() const;
+    QString toString() const;
+    QString toHex() const;
 
 private:
-    void readHeader(int& _pos);
-    void readProperty(const QByteArray& _property);
+    QSharedDataPointer<PulsarMessageData> d;
 
+    static const int HEADER_LENGTH = 4;
 };
 
 Q_DECLARE_METATYPE(PulsarMessage);
@@ -0,0 +1,396 @@
+#include "queryresult.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocale>
+
+#include <cmath>
+#include <limits>
+
+#include "table.h"
+
+namespace
+{
+//A varchar column keeps its dictionary while less than half of its values are distinct.
+const qsizetype DICTIONARY_MIN_SIZE = 4096;
+
+/**
+ * @brief The value of an integer column, exact when the number is integral, else truncated
+ * toward zero and held to the range of int64: toInteger() alone gives 0 for 2.5 or 1e19.
+ */
+qint64 toInteger(const QJsonValue& _value)
+{
+    bool ok = false;
+    qint64 integer = _value.isString() ? _value.toString().toLongLong(&ok) : _value.toInteger(0);
+    if (ok || (!_value.isString() && (integer != 0 || _value.toDouble() == 0)))
+    {
+        return integer;
+    }
+    double real = _value.isString() ? _value.toString().toDouble() : _value.toDouble();
+    if (std::isnan(real))
+    {
+        return 0;
+    }
+    if (real >= 9223372036854775808.0)
+    {
+        return std::numeric_limits<qint64>::max();
+    }
+    if (real <= -9223372036854775808.0)
+    {
+        return std::numeric_limits<qint64>::min();
+    }
+    return static_cast<qint64>(real);
+}
+}
+
+void QueryResult::setColumns(const QList<Column>& _columns)
+{
+    clear();
+    foreach (const Column& column, _columns)
+    {
+        Vector vector;
+        vector.type = typeOf(column.type());
+        vector.plain = false;
+        vector.textBytes = 0;
+        this->m_Columns << vector;
+    }
+}
+
+/**
+ * @brief Append the rows of a page, at most _max of them when it is not negative.
+ * @return the number of rows appended
+ */
+qsizetype QueryResult::append(const QJsonArray& _rows, const qsizetype& _max)
+{
+    qsizetype count = _max >= 0 ? qMin<qsizetype>(_max, _rows.size()) : _rows.size();
+    if (count <= 0 || this->m_Columns.isEmpty())
+    {
+        return 0;
+    }
+    for (Vector& vector : this->m_Columns)
+    {
+        qsizetype size = this->m_Rows + count;
+        switch (vector.type)
+        {
+        case Integer:
+            vector.integers.reserve(size);
+            break;
+        case Double:
+            vector.doubles.reserve(size);
+            break;
+        case Boolean:
+            break;
+        case Varchar:
+            if (vector.plain)
+            {
+                vector.strings.reserve(size);
+            }
+            else
+            {
+                vector.codes.reserve(size);
+            }
+            break;
+        }
+    }
+    for (qsizetype i = 0; i < count; ++i)
+    {
+        QJsonArray row = _rows.at(i).toArray();
+        for (int j = 0, n = columnCount(); j < n; ++j)
+        {
+            appendValue(this->m_Columns[j], this->m_Rows, j < row.size() ? row.at(j) : QJsonValue(QJsonValue::Null));
+        }
+        this->m_Rows++;
+    }
+    for (Vector& vector : this->m_Columns)
+    {
+        if (vector.type == Varchar && !vector.plain && vector.dictionary.size() > DICTIONARY_MIN_SIZE && vector.dictionary.size() * 2 > this->m_Rows)
+        {
+            makePlain(vector);
+        }
+    }
+    return count;
+}
+
+void QueryResult::clear()
+{
+    this->m_Columns.clear();
+    this->m_Rows = 0;
+}
+
+/**
+ * @brief Drop the rows and keep the column types, for the next page of a statement which does
+ * not keep its rows.
+ */
+void QueryResult::clearRows()
+{
+    for (Vector& vector : this->m_Columns)
+    {
+        Vector empty;
+        empty.type = vector.type;
+        empty.plain = false;
+        empty.textBytes = 0;
+        vector = empty;
+    }
+    this->m_Rows = 0;
+}
+
+bool QueryResult::isNull(const qsizetype& _row, const int& _column) const
+{
+    return bit(this->m_Columns.at(_column).nulls, _row);
+}
+
+QVariant QueryResult::value(const qsizetype& _row, const int& _column) const
+{
+    const Vector& vector = this->m_Columns.at(_column);
+    if (bit(vector.nulls, _row))
+    {
+        return QVariant();
+    }
+    switch (vector.type)
+    {
+    case Integer:
+        return vector.integers.at(_row);
+    case Double:
+        return vector.doubles.at(_row);
+    case Boolean:
+        return bit(vector.booleans, _row);
+    case Varchar:
+        break;
+    }
+    return string(vector, _row);
+}
+
+/**
+ * @brief The value as shown in the grid, empty for null; numbers keep all their digits.
+ */
+QString QueryResult::text(const qsizetype& _row, const int& _column) const
+{
+    const Vector& vector = this->m_Columns.at(_column);
+    if (bit(vector.nulls, _row))
+    {
+        return QString();
+    }
+    switch (vector.type)
+    {
+    case Integer:
+        return QString::number(vector.integers.at(_row));
+    case Double:
+        return QString::number(vector.doubles.at(_row), 'g', QLocale::FloatingPointShortest);
+    case Boolean:
+        return bit(vector.booleans, _row) ? QString("true") : QString("false");
+    case Varchar:
+        break;
+    }
+    return string(vector, _row);
+}
+
+/**
+ * @brief Order two rows by a column, nulls first.
+ */
+int QueryResult::compare(const int& _column, const qsizetype& _left, const qsizetype& _right) const
+{
+    const Vector& vector = this->m_Columns.at(_column);
+    bool leftNull = bit(vector.nulls, _left);
+    bool rightNull = bit(vector.nulls, _right);
+    if (leftNull || rightNull)
+    {
+        return leftNull == rightNull ? 0 : (leftNull ? -1 : 1);
+    }
+    switch (vector.type)
+    {
+    case Integer:
+    {
+        qint64 left = vector.integers.at(_left);
+        qint64 right = vector.integers.at(_right);
+        return left < right ? -1 : (left > right ? 1 : 0);
+    }
+    case Double:
+    {
+        double left = vector.doubles.at(_left);
+        double right = vector.doubles.at(_right);
+        if (std::isnan(left) || std::isnan(right))
+        {
+            return std::isnan(left) == std::isnan(right) ? 0 : (std::isnan(left) ? 1 : -1);
+        }
+        return left < right ? -1 : (left > right ? 1 : 0);
+    }
+    case Boolean:
+        return static_cast<int>(bit(vector.booleans, _left)) - static_cast<int>(bit(vector.booleans, _right));
+    case Varchar:
+        if (!vector.plain && vector.codes.at(_left) == vector.codes.at(_right))
+        {
+            return 0;
+        }
+        break;
+    }
+    return string(vector, _left).compare(string(vector, _right));
+}
+
+/**
+ * @brief About the memory the rows take.
+ */
+qint64 QueryResult::bytes() const
+{
+    qint64 bytes = 0;
+    foreach (const Vector& vector, this->m_Columns)
+    {
+        bytes += vector.integers.capacity() * sizeof(qint64);
+        bytes += vector.doubles.capacity() * sizeof(double);
+        bytes += vector.booleans.capacity() * sizeof(quint64);
+        bytes += vector.codes.capacity() * sizeof(quint32);
+        bytes += vector.nulls.capacity() * sizeof(quint64);
+        bytes += vector.strings.capacity() * sizeof(QString);
+        bytes += vector.dictionary.size() * (sizeof(QString) * 2 + sizeof(quint32) + sizeof(void*));
+        bytes += vector.textBytes;
+    }
+    return bytes;
+}
+
+QueryResult::Type QueryResult::typeOf(const QString& _prestoType)
+{
+    QString type = _prestoType.trimmed().toLower();
+    if (type == "bigint" || type == "integer" || type == "int" || type == "smallint" || type == "tinyint")
+    {
+        return Integer;
+    }
+    if (type == "double" || type == "real")
+    {
+        return Double;
+    }
+    if (type == "boolean")
+    {
+        return Boolean;
+    }
+    return Varchar;
+}
+
+void QueryResult::appendValue(Vector& _vector, const qsizetype& _row, const QJsonValue& _value)
+{
+    bool null = _value.isNull() || _value.isUndefined();
+    setBit(_vector.nulls, _row, null);
+    switch (_vector.type)
+    {
+    case Integer:
+        _vector.integers << (null ? 0 : toInteger(_value));
+        return;
+    case Double:
+        if (null)
+        {
+            _vector.doubles << 0.0;
+        }
+        else if (_value.isString())
+        {
+            //Presto sends the values JSON numbers cannot hold as strings.
+            QString text = _value.toString();
+            if (text == "NaN")
+            {
+                _vector.doubles << std::nan("");
+            }
+            else if (text == "Infinity" || text == "-Infinity")
+            {
+                _vector.doubles << (text.startsWith('-') ? -HUGE_VAL : HUGE_VAL);
+            }
+            else
+            {
+                _vector.doubles << text.toDouble();
+            }
+        }
+        else
+        {
+            _vector.doubles << _value.toDouble();
+        }
+        return;
+    case Boolean:
+        setBit(_vector.booleans, _row, !null && _value.toBool());
+        return;
+    case Varchar:
+        break;
+    }
+    if (null || _value.isString())
+    {
+        appendText(_vector, _value.toString());
+    }
+    else if (_value.isBool())
+    {
+        appendText(_vector, _value.toBool() ? QString("true") : QString("false"));
+    }
+    else if (_value.isDouble())
+    {
+        qint64 integer = _value.toInteger(std::numeric_limits<qint64>::min());
+        appendText(_vector, integer != std::numeric_limits<qint64>::min() ? QString::number(integer) : QString::number(_value.toDouble(), 'g', QLocale::FloatingPointShortest));
+    }
+    else if (_value.isArray())
+    {
+        appendText(_vector, QString::fromUtf8(QJsonDocument(_value.toArray()).toJson(QJsonDocument::Compact)));
+    }
+    else
+    {
+        appendText(_vector, QString::fromUtf8(QJsonDocument(_value.toObject()).toJson(QJsonDocument::Compact)));
+    }
+}
+
+void QueryResult::appendText(Vector& _vector, const QString& _text)
+{
+    if (_vector.plain)
+    {
+        _vector.strings << _text;
+        _vector.textBytes += _text.size() * sizeof(QChar);
+        return;
+    }
+    QHash<QString, quint32>::const_iterator it = _vector.lookup.constFind(_text);
+    if (it != _vector.lookup.constEnd())
+    {
+        _vector.codes << it.value();
+        return;
+    }
+    quint32 code = static_cast<quint32>(_vector.dictionary.size());
+    _vector.dictionary << _text;
+    _vector.lookup.insert(_text, code);
+    _vector.textBytes += _text.size() * sizeof(QChar);
+    _vector.codes << code;
+}
+
+/**
+ * @brief The strings still share their data with the dictionary entries they came from.
+ */
+void QueryResult::makePlain(Vector& _vector)
+{
+    _vector.strings.reserve(_vector.codes.size());
+    foreach (quint32 code, _vector.codes)
+    {
+        _vector.strings << _vector.dictionary.at(code);
+    }
+    _vector.codes = QList<quint32>();
+    _vector.dictionary = QStringList();
+    _vector.lookup = QHash<QString, quint32>();
+    _vector.plain = true;
+}
+
+void QueryResult::setBit(QList<quint64>& _bits, const qsizetype& _index, const bool& _value)
+{
+    qsizetype word = _index >> 6;
+    while (_bits.size() <= word)
+    {
+        _bits << 0;
+    }
+    quint64 mask = quint64(1) << (_index & 63);
+    if (_value)
+    {
+        _bits[word] |= mask;
+    }
+    else
+    {
+        _bits[word] &= ~mask;
+    }
+}
+
+bool QueryResult::bit(const QList<quint64>& _bits, const qsizetype& _index)
+{
+    qsizetype word = _index >> 6;
+    return word < _bits.size() && (_bits.at(word) & (quint64(1) << (_index & 63))) != 0;
+}
+
+const QString& QueryResult::string(const Vector& _vector, const qsizetype& _row) const
+{
+    return _vector.plain ? _vector.strings.at(_row) : _vector.dictionary.at(_vector.codes.at(_row));
+}
@@ -0,0 +1,85 @@
+#ifndef QUERYRESULT_H
+#define QUERYRESULT_H
+
+#include <QList>
+#include <QHash>
+#include <QStringList>
+#include <QVariant>
+#include <QJsonArray>
+
+class Column;
+
+/**
+ * @brief The rows of a Presto query stored by column, typed by the Presto column type.
+ *
+ * Integer types are kept as int64, real and double as double and boolean as bits. Every other
+ * type, varchar, date, timestamp, decimal and the structural ones, is kept as text in a
+ * dictionary of the distinct values and a code per row; a column whose values are mostly
+ * distinct falls back to one string per row. Every column has a bitmap of its nulls. Pages are
+ * appended straight from the data array of the JSON response.
+ */
+class QueryResult
+{
+public:
+    enum Type
+    {
+        Integer,
+        Double,
+        Boolean,
+        Varchar
+    };
+
+    explicit QueryResult() : m_Rows(0) {}
+
+    void setColumns(const QList<Column>& _columns);
+    inline int columnCount() const { return static_cast<int>(this->m_Columns.size()); }
+    inline qsizetype rowCount() const { return this->m_Rows; }
+    inline Type type(const int& _column) const { return this->m_Columns.at(_column).type; }
+
+    qsizetype append(const QJsonArray& _rows, const qsizetype& _max = -1);
+    void clear();
+    void clearRows();
+
+    bool isNull(const qsizetype& _row, const int& _column) const;
+    QVariant value(const qsizetype& _row, const int& _column) const;
+    QString text(const qsizetype& _row, const int& _column) const;
+    /**
+     * @brief The value of an Integer, Double or Boolean column, 0 or false for null.
+     */
+    inline qint64 integer(const qsizetype& _row, const int& _column) const { return this->m_Columns.at(_column).integers.at(_row); }
+    inline double real(const qsizetype& _row, const int& _column) const { return this->m_Columns.at(_column).doubles.at(_row); }
+    inline bool boolean(const qsizetype& _row, const int& _column) const { return bit(this->m_Columns.at(_column).booleans, _row); }
+    int compare(const int& _column, const qsizetype& _left, const qsizetype& _right) const;
+    qint64 bytes() const;
+
+    static Type typeOf(const QString& _prestoType);
+
+private:
+    struct Vector
+    {
+        Type type;
+        QList<qint64> integers;
+        QList<double> doubles;
+        QList<quint64> booleans;            //one bit per row
+        QList<quint32> codes;               //into dictionary, while plain is not set
+        QStringList dictionary;
+        QHash<QString, quint32> lookup;
+        QStringList strings;                //one per row once plain is set
+        bool plain;
+        QList<quint64> nulls;               //one bit per row
+        qint64 textBytes;
+    };
+
+    static void appendValue(Vector& _vector, const qsizetype& _row, const QJsonValue& _value);
+    static void appendText(Vector& _vector, const QString& _text);
+    static void makePlain(Vector& _vector);
+    static void setBit(QList<quint64>& _bits, const qsizetype& _index, const bool& _value);
+    static bool bit(const QList<quint64>& _bits, const qsizetype& _index);
+    const QString& string(const Vector& _vector, const qsizetype& _row) const;
+
+private:
+    QList<Vector> m_Columns;
+    qsizetype m_Rows;
+};
+
+#endif // QUERYRESULT_H
@@ -0,0 +1,168 @@
+#include "queryresultmodel.h"
+
+#include <QHash>
+
+#include <algorithm>
+#include <limits>
+
+QueryResultModel::QueryResultModel(const QueryResult* _result, QObject* _parent) : QAbstractTableModel(_parent), m_Result(_result), m_RowCount(0)
+{
+}
+
+void QueryResultModel::setColumns(const QList<Column>& _columns)
+{
+    beginResetModel();
+    this->m_Columns = _columns;
+    endResetModel();
+}
+
+/**
+ * @brief Insert the rows the result has gained since the last call.
+ */
+void QueryResultModel::update()
+{
+    int count = static_cast<int>(qMin<qsizetype>(this->m_Result->rowCount(), std::numeric_limits<int>::max()));
+    if (count <= this->m_RowCount || this->m_Columns.isEmpty())
+    {
+        return;
+    }
+    beginInsertRows(QModelIndex(), this->m_RowCount, count - 1);
+    if (!this->m_Order.isEmpty())
+    {
+        for (int i = this->m_RowCount; i < count; ++i)
+        {
+            this->m_Order << i;
+        }
+    }
+    this->m_RowCount = count;
+    endInsertRows();
+}
+
+/**
+ * @brief Forget the rows and the columns, before the result is cleared for another query.
+ */
+void QueryResultModel::reset()
+{
+    beginResetModel();
+    this->m_Columns.clear();
+    this->m_Order.clear();
+    this->m_RowCount = 0;
+    endResetModel();
+}
+
+/**
+ * @brief The cells of a row separated by tabs, for the clipboard.
+ */
+QString QueryResultModel::rowText(const int& _row) const
+{
+    if (_row < 0 || _row >= this->m_RowCount)
+    {
+        return QString();
+    }
+    QStringList cells;
+    for (int i = 0, n = columnCount(); i < n; ++i)
+    {
+        cells << this->m_Result->text(source(_row), i);
+    }
+    return cells.join('\t');
+}
+
+int QueryResultModel::rowCount(const QModelIndex& _parent) const
+{
+    return _parent.isValid() ? 0 : this->m_RowCount;
+}
+
+int QueryResultModel::columnCount(const QModelIndex& _parent) const
+{
+    return _parent.isValid() ? 0 : static_cast<int>(qMin<qsizetype>(this->m_Columns.size(), this->m_Result->columnCount()));
+}
+
+QVariant QueryResultModel::data(const QModelIndex& _index, int _role) const
+{
+    if (!_index.isValid())
+    {
+        return QVariant();
+    }
+    if (_role == Qt::DisplayRole || _role == Qt::ToolTipRole)
+    {
+        return this->m_Result->text(source(_index.row()), _index.column());
+    }
+    if (_role == Qt::TextAlignmentRole)
+    {
+        QueryResult::Type type = this->m_Result->type(_index.column());
+        if (type == QueryResult::Integer || type == QueryResult::Double)
+        {
+            return QVariant(Qt::AlignRight | Qt::AlignVCenter);
+        }
+    }
+    return QVariant();
+}
+
+QVariant QueryResultModel::headerData(int _section, Qt::Orientation _orientation, int _role) const
+{
+    if (_role == Qt::DisplayRole && _orientation == Qt::Horizontal && _section < this->m_Columns.size())
+    {
+        return this->m_Columns.at(_section).name();
+    }
+    if (_role == Qt::ToolTipRole && _orientation == Qt::Horizontal && _section < this->m_Columns.size())
+    {
+        return this->m_Columns.at(_section).type();
+    }
+    return QAbstractTableModel::headerData(_section, _orientation, _role);
+}
+
+/**
+ * @brief Order the rows by the typed values of a column, nulls first; a column of -1 brings
+ * back the order the rows came in.
+ */
+void QueryResultModel::sort(int _column, Qt::SortOrder _order)
+{
+    emit layoutAboutToBeChanged();
+    QModelIndexList from = persistentIndexList();
+    QList<qsizetype> rows;
+    rows.reserve(from.size());
+    foreach (const QModelIndex& index, from)
+    {
+        rows << source(index.row());
+    }
+
+    this->m_Order.clear();
+    if (_column >= 0 && _column < columnCount())
+    {
+        this->m_Order.reserve(this->m_RowCount);
+        for (int i = 0; i < this->m_RowCount; ++i)
+        {
+            this->m_Order << i;
+        }
+        const QueryResult* result = this->m_Result;
+        std::stable_sort(this->m_Order.begin(), this->m_Order.end(), [result, _column, _order](const qsizetype& _left, const qsizetype& _right)
+        {
+            int compare = result->compare(_column, _left, _right);
+            return _order == Qt::AscendingOrder ? compare < 0 : compare > 0;
+        });
+    }
+
+    //Keep the current and selected rows on the same records.
+    QHash<qsizetype, int> positions;
+    if (!from.isEmpty() && !this->m_Order.isEmpty())
+    {
+        for (int i = 0; i < this->m_RowCount; ++i)
+        {
+            positions.insert(this->m_Order.at(i), i);
+        }
+    }
+    QModelIndexList to;
+    to.reserve(from.size());
+    for (int i = 0, n = static_cast<int>(from.size()); i < n; ++i)
+    {
+        int row = this->m_Order.isEmpty() ? static_cast<int>(rows.at(i)) : positions.value(rows.at(i));
+        to << index(row, from.at(i).column());
+    }
+    changePersistentIndexList(from, to);
+    emit layoutChanged();
+}
+
+qsizetype QueryResultModel::source(const int& _row) const
+{
+    return this->m_Order.isEmpty() ? _row : this->m_Order.at(_row);
+}
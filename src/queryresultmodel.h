@@ -0,0 +1,44 @@
+#ifndef QUERYRESULTMODEL_H
+#define QUERYRESULTMODEL_H
+
+#include <QAbstractTableModel>
+
+#include "table.h"
+
+/**
+ * @brief Shows the QueryResult of a statement as its pages are read.
+ *
+ * The result is read in place, update() tells the view about the rows appended since the last
+ * call. The view asks for the cells in sight only, so a large result costs its columns and
+ * nothing per cell. Sorting orders a list of row numbers with the typed values, the rows
+ * appended afterwards go below the sorted ones.
+ */
+class QueryResultModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit QueryResultModel(const QueryResult* _result, QObject* _parent = nullptr);
+
+    void setColumns(const QList<Column>& _columns);
+    void update();
+    void reset();
+    QString rowText(const int& _row) const;
+
+    int rowCount(const QModelIndex& _parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& _parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& _index, int _role = Qt::DisplayRole) const override;
+    QVariant headerData(int _section, Qt::Orientation _orientation, int _role = Qt::DisplayRole) const override;
+    void sort(int _column, Qt::SortOrder _order = Qt::AscendingOrder) override;
+
+private:
+    qsizetype source(const int& _row) const;
+
+private:
+    const QueryResult* m_Result;
+    QList<Column> m_Columns;
+    QList<qsizetype> m_Order;
+    int m_RowCount;
+};
+
+#endif // QUERYRESULTMODEL_H
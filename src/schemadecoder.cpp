@@ -0,0 +1,230 @@
+#include "schemadecoder.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDateTime>
+#include <QtEndian>
+
+#include <cstring>
+
+#include "avrodecoder.h"
+#include "protobufnativedecoder.h"
+#include "logging.h"
+
+QSharedPointer<const SchemaDecoder> SchemaDecoder::create(const QByteArray& _type, const QByteArray& _definition, const Properties& _properties)
+{
+    QSharedPointer<const SchemaDecoder> decoder;
+    if (_type == "AVRO")
+    {
+        decoder = AvroDecoder::compile(_definition);
+    }
+    else if (_type == "JSON")
+    {
+        decoder.reset(new JsonSchemaDecoder());
+    }
+    else if (_type == "PROTOBUF_NATIVE")
+    {
+        decoder = ProtobufNativeDecoder::compile(_definition);
+    }
+    else if (_type == "KEY_VALUE")
+    {
+        decoder = KeyValueDecoder::create(_definition, _properties);
+    }
+    else if (PrimitiveDecoder::isPrimitive(_type))
+    {
+        decoder.reset(new PrimitiveDecoder(_type));
+    }
+    else
+    {
+        qCWarning(lcDecode) << "Schema type " << _type << " is not supported" << Qt::endl;
+    }
+    return decoder;
+}
+
+bool PrimitiveDecoder::isPrimitive(const QByteArray& _type)
+{
+    static const QList<QByteArray> types = { "NONE", "BYTES", "STRING", "BOOLEAN", "INT8", "INT16", "INT32", "INT64", "FLOAT", "DOUBLE",
+                                             "DATE", "TIME", "TIMESTAMP", "INSTANT", "LOCAL_DATE", "LOCAL_TIME", "LOCAL_DATE_TIME" };
+    return types.contains(_type);
+}
+
+QVariant PrimitiveDecoder::decode(const QByteArray& _key, const QByteArrayView& _value) const
+{
+    Q_UNUSED(_key);
+    const QByteArray& type = this->type();
+    const char* data = _value.data();
+    const qsizetype size = _value.size();
+    if (type == "STRING")
+    {
+        return QString::fromUtf8(data, size);
+    }
+    if (type == "BOOLEAN" && size == 1)
+    {
+        return data[0] != 0;
+    }
+    if (type == "INT8" && size == 1)
+    {
+        return static_cast<int>(static_cast<qint8>(data[0]));
+    }
+    if (type == "INT16" && size == 2)
+    {
+        return static_cast<int>(qFromBigEndian<qint16>(data));
+    }
+    if (type == "INT32" && size == 4)
+    {
+        return qFromBigEndian<qint32>(data);
+    }
+    if (type == "INT64" && size == 8)
+    {
+        return qFromBigEndian<qint64>(data);
+    }
+    if (type == "FLOAT" && size == 4)
+    {
+        quint32 bits = qFromBigEndian<quint32>(data);
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    if (type == "DOUBLE" && size == 8)
+    {
+        quint64 bits = qFromBigEndian<quint64>(data);
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    if ((type == "DATE" || type == "TIME" || type == "TIMESTAMP") && size == 8)
+    {
+        return QDateTime::fromMSecsSinceEpoch(qFromBigEndian<qint64>(data), Qt::UTC);
+    }
+    if (type == "INSTANT" && size == 12)
+    {
+        qint64 seconds = qFromBigEndian<qint64>(data);
+        qint32 nanos = qFromBigEndian<qint32>(data + 8);
+        return QDateTime::fromMSecsSinceEpoch(seconds * 1000 + nanos / 1000000, Qt::UTC);
+    }
+    if (type == "LOCAL_DATE" && size == 8)
+    {
+        return QDate(1970, 1, 1).addDays(qFromBigEndian<qint64>(data));
+    }
+    if (type == "LOCAL_TIME" && size == 8)
+    {
+        return QTime(0, 0).addMSecs(static_cast<int>(qFromBigEndian<qint64>(data) / 1000000));
+    }
+    if (type == "LOCAL_DATE_TIME" && size == 16)
+    {
+        QDate date = QDate(1970, 1, 1).addDays(qFromBigEndian<qint64>(data));
+        QTime time = QTime(0, 0).addMSecs(static_cast<int>(qFromBigEndian<qint64>(data + 8) / 1000000));
+        return QDateTime(date, time);
+    }
+    if (type == "BYTES" || type == "NONE")
+    {
+        return _value.toByteArray();
+    }
+    return QVariant();
+}
+
+QVariant JsonSchemaDecoder::decode(const QByteArray& _key, const QByteArrayView& _value) const
+{
+    Q_UNUSED(_key);
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(_value.toByteArray(), &error);
+    if (error.error != QJsonParseError::NoError)
+    {
+        return QVariant();
+    }
+    return doc.toVariant();
+}
+
+/**
+ * @brief The admin api returns the schemas of the key and the value as a JSON document, older
+ * brokers the binary KeyValue encoding with the types in the properties.
+ * @param _definition
+ * @param _properties
+ * @return
+ */
+QSharedPointer<const SchemaDecoder> KeyValueDecoder::create(const QByteArray& _definition, const Properties& _properties)
+{
+    QByteArray keyType, keyDefinition, valueType, valueDefinition;
+    Properties keyProperties, valueProperties;
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(_definition, &error);
+    if (error.error == QJsonParseError::NoError && doc.isObject())
+    {
+        QJsonObject key = doc.object()["key"].toObject();
+        QJsonObject value = doc.object()["value"].toObject();
+        keyType = key["type"].toString().toUtf8();
+        valueType = value["type"].toString().toUtf8();
+        keyDefinition = key["schema"].isObject() ? QJsonDocument(key["schema"].toObject()).toJson(QJsonDocument::Compact) : key["schema"].toString().toUtf8();
+        valueDefinition = value["schema"].isObject() ? QJsonDocument(value["schema"].toObject()).toJson(QJsonDocument::Compact) : value["schema"].toString().toUtf8();
+        foreach (const QString& name, key["properties"].toObject().keys())
+        {
+            keyProperties[name] = key["properties"].toObject()[name].toString();
+        }
+        foreach (const QString& name, value["properties"].toObject().keys())
+        {
+            valueProperties[name] = value["properties"].toObject()[name].toString();
+        }
+    }
+    else if (_definition.size() >= 8)
+    {
+        const char* data = _definition.constData();
+        qint32 keyLength = qFromBigEndian<qint32>(data);
+        if (keyLength < 0 || keyLength > _definition.size() - 8)
+        {
+            return QSharedPointer<const SchemaDecoder>();
+        }
+        qint32 valueLength = qFromBigEndian<qint32>(data + 4 + keyLength);
+        if (valueLength < 0 || valueLength > _definition.size() - 8 - keyLength)
+        {
+            return QSharedPointer<const SchemaDecoder>();
+        }
+        keyDefinition = _definition.mid(4, keyLength);
+        valueDefinition = _definition.mid(8 + keyLength, valueLength);
+        keyType = _properties.value("key.schema.type").toUtf8();
+        valueType = _properties.value("value.schema.type").toUtf8();
+    }
+
+    QSharedPointer<const SchemaDecoder> key = SchemaDecoder::create(keyType, keyDefinition, keyProperties);
+    QSharedPointer<const SchemaDecoder> value = SchemaDecoder::create(valueType, valueDefinition, valueProperties);
+    if (key.isNull() || value.isNull())
+    {
+        return QSharedPointer<const SchemaDecoder>();
+    }
+    bool separated = _properties.value("kv.encoding.type") == "SEPARATED";
+    return QSharedPointer<const SchemaDecoder>(new KeyValueDecoder(key, value, separated));
+}
+
+QVariant KeyValueDecoder::decode(const QByteArray& _key, const QByteArrayView& _value) const
+{
+    QVariantMap result;
+    if (this->m_Separated)
+    {
+        QByteArray key = QByteArray::fromBase64(_key);
+        result["key"] = this->m_Key->decode(QByteArray(), QByteArrayView(key));
+        result["value"] = this->m_Value->decode(QByteArray(), _value);
+        return result;
+    }
+
+    //A length of -1 stands for a null key or value
+    const char* data = _value.data();
+    const qsizetype size = _value.size();
+    if (size < 4)
+    {
+        return QVariant();
+    }
+    qint32 keyLength = qFromBigEndian<qint32>(data);
+    //In qint64, a corrupt length near INT_MAX must not wrap around the bounds checks
+    const qint64 offset = 4 + qMax<qint64>(0, keyLength);
+    if (keyLength < -1 || offset + 4 > size)
+    {
+        return QVariant();
+    }
+    qint32 valueLength = qFromBigEndian<qint32>(data + offset);
+    if (valueLength < -1 || offset + 4 + qMax<qint64>(0, valueLength) > size)
+    {
+        return QVariant();
+    }
+    result["key"] = keyLength < 0 ? QVariant() : this->m_Key->decode(QByteArray(), QByteArrayView(data + 4, keyLength));
+    result["value"] = valueLength < 0 ? QVariant() : this->m_Value->decode(QByteArray(), QByteArrayView(data + offset + 4, valueLength));
+    return result;
+}
@@ -0,0 +1,93 @@
+#ifndef SCHEMADECODER_H
+#define SCHEMADECODER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QVariant>
+#include <QSharedPointer>
+
+#include "messagemetadata.h"
+
+/**
+ * @brief Decodes message payloads with the schema registered for the topic.
+ *
+ * A decoder is compiled once from the schema definition and is read-only afterwards, so one
+ * instance decodes on any number of worker threads at the same time. Values are decoded into
+ * QVariant trees: records and maps become QVariantMap, arrays QVariantList, bytes QByteArray.
+ * An invalid QVariant means the payload does not match the schema.
+ */
+class SchemaDecoder
+{
+public:
+    virtual ~SchemaDecoder() {}
+
+    /**
+     * @param _key the partition key of the message, used by KeyValue schemas with separated keys
+     * @param _value the payload
+     */
+    virtual QVariant decode(const QByteArray& _key, const QByteArrayView& _value) const = 0;
+
+    inline QByteArray type() const { return this->m_Type; }
+
+    /**
+     * @brief Compile a schema as returned by the admin api.
+     * @param _type AVRO, JSON, PROTOBUF_NATIVE, KEY_VALUE or a primitive type like STRING
+     * @param _definition the schema data
+     * @param _properties the schema properties
+     * @return nullptr when the schema cannot be compiled
+     */
+    static QSharedPointer<const SchemaDecoder> create(const QByteArray& _type, const QByteArray& _definition, const Properties& _properties);
+
+protected:
+    explicit SchemaDecoder(const QByteArray& _type) : m_Type(_type) {}
+
+private:
+    QByteArray m_Type;
+};
+
+/**
+ * @brief The fixed-width big endian encodings of the primitive schemas, strings as UTF-8.
+ */
+class PrimitiveDecoder : public SchemaDecoder
+{
+public:
+    explicit PrimitiveDecoder(const QByteArray& _type) : SchemaDecoder(_type) {}
+
+    QVariant decode(const QByteArray& _key, const QByteArrayView& _value) const override;
+
+    static bool isPrimitive(const QByteArray& _type);
+};
+
+/**
+ * @brief JSON schemas carry the message as a JSON document, the schema itself is not needed.
+ */
+class JsonSchemaDecoder : public SchemaDecoder
+{
+public:
+    explicit JsonSchemaDecoder() : SchemaDecoder("JSON") {}
+
+    QVariant decode(const QByteArray& _key, const QByteArrayView& _value) const override;
+};
+
+/**
+ * @brief A key and a value each with its own schema. INLINE encoding puts both into the
+ * payload with a big endian length in front of each, SEPARATED encoding keeps the key in the
+ * base64 encoded partition key.
+ */
+class KeyValueDecoder : public SchemaDecoder
+{
+public:
+    explicit KeyValueDecoder(const QSharedPointer<const SchemaDecoder>& _key, const QSharedPointer<const SchemaDecoder>& _value, const bool& _separated)
+        : SchemaDecoder("KEY_VALUE"), m_Key(_key), m_Value(_value), m_Separated(_separated) {}
+
+    QVariant decode(const QByteArray& _key, const QByteArrayView& _value) const override;
+
+    static QSharedPointer<const SchemaDecoder> create(const QByteArray& _definition, const Properties& _properties);
+
+private:
+    QSharedPointer<const SchemaDecoder> m_Key;
+    QSharedPointer<const SchemaDecoder> m_Value;
+    bool m_Separated;
+};
+
+#endif // SCHEMADECODER_H
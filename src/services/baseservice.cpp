@@ -6,9 +6,12 @@
 
 #include "../constants.h"
 #include "httpclient.h"
+#include "requestqueue.h"
 
 BaseService::BaseService(QObject* parent) : QObject(parent), m_Client(new HttpClient(this))
 {
     QDir dir(QCoreApplication::applicationDirPath());
     this->m_Settings = new QSettings(dir.absoluteFilePath(INI_FILE), QSettings::IniFormat, this);
+    //Read with the settings rather than on every request, the queues of the clusters share it
+    RequestQueue::setDefaultMaxInFlight(this->m_Settings->value(MAX_IN_FLIGHT_REQUESTS_KEY, 6).toInt());
 }
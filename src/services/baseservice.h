@@ -14,6 +14,7 @@ public:
     explicit BaseService(QObject* parent = nullptr);
 
     inline void setAuthToken(const QString& _token) { this->m_Client->setToken(_token); }
+    inline void setCacheMode(const HttpRequest::CacheMode& _mode) { this->m_Client->setCacheMode(_mode); }
 
 signals:
 
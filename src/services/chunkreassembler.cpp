@@ -0,0 +1,305 @@
+#include "chunkreassembler.h"
+
+#include <QPointer>
+#include <QThreadPool>
+#include <QCoreApplication>
+
+#include "requestqueue.h"
+#include "topicservice.h"
+#include "../decompressor.h"
+#include "../logging.h"
+
+namespace
+{
+//The most chunks of one message, about 500 GB in chunks of the default max message size of 5 MB
+const int MAX_CHUNKS = 100000;
+}
+
+ChunkReassembler::ChunkReassembler(const HttpClient* _client, const QString& _cluster, const QString& _messagePath, QObject* _parent)
+    : QObject(_parent), m_Client(_client), m_Cluster(_cluster), m_MessagePath(_messagePath), m_MaxBufferedBytes(64 * 1024 * 1024), m_BufferedBytes(0),
+      m_MaxScanEntries(64), m_Flushed(false), m_Canceled(false)
+{
+}
+
+/**
+ * @brief Buffer a chunk, the message is assembled as soon as its last missing chunk is added.
+ * A chunk whose counts are out of range or differ from those of its message is handed out on
+ * its own as incomplete, one added twice is buffered once.
+ * @param _message
+ * @return false when the message is not a chunk and was left alone
+ */
+bool ChunkReassembler::add(const PulsarMessage& _message)
+{
+    if (!_message.isChunk())
+    {
+        return false;
+    }
+    if (this->m_Canceled)
+    {
+        return true;
+    }
+
+    QString uuid = _message.uuid();
+    if (this->m_Taken.contains(uuid))
+    {
+        return true; //read again with an overlapping range
+    }
+    //The counts come from the broker headers, they are checked before anything is allocated
+    //for them; every chunk carries at least one byte of the message.
+    if (_message.numChunks() <= 0 || _message.numChunks() > MAX_CHUNKS || _message.numChunks() > qint64(_message.totalChunkSize()) + 1
+        || _message.chunkId() < 0 || _message.chunkId() >= _message.numChunks()
+        || (this->m_Pending.contains(uuid) && _message.numChunks() != this->m_Pending[uuid].chunks.size()))
+    {
+        qCWarning(lcDecode) << "Chunk " << _message.chunkId() << "/" << _message.numChunks() << " of " << _message.totalChunkSize() << " bytes of " << uuid << " does not match its message" << Qt::endl;
+        emit messageIncomplete(QList<PulsarMessage>() << _message);
+        if (this->m_Flushed)
+        {
+            scan(uuid); //goes on past an entry read while scanning
+        }
+        return true;
+    }
+    if (!this->m_Pending.contains(uuid))
+    {
+        Pending pending { QVector<PulsarMessage>(_message.numChunks()), 0, 0, _message.ledgerId(), _message.entryId(), _message.entryId(), 0, false, false, false };
+        this->m_Pending.insert(uuid, pending);
+        this->m_Order << uuid;
+    }
+
+    Pending& pending = this->m_Pending[uuid];
+    if (pending.chunks[_message.chunkId()].uuid().isEmpty())
+    {
+        pending.chunks[_message.chunkId()] = _message;
+        pending.received++;
+        pending.bytes += _message.bodyLength();
+        this->m_BufferedBytes += _message.bodyLength();
+    }
+    if (_message.ledgerId() == pending.ledgerId)
+    {
+        pending.firstEntry = qMin(pending.firstEntry, _message.entryId());
+        pending.lastEntry = qMax(pending.lastEntry, _message.entryId());
+    }
+
+    if (pending.received == pending.chunks.size())
+    {
+        assemble(uuid);
+        return true;
+    }
+
+    //Over the cap the oldest messages are given up first
+    while (this->m_BufferedBytes > this->m_MaxBufferedBytes && !this->m_Order.isEmpty())
+    {
+        QString oldest = this->m_Order.first(); //a copy, take() removes the entry from m_Order
+        qCWarning(lcDecode) << "Chunk buffer over " << this->m_MaxBufferedBytes << " bytes, dropping message " << oldest << Qt::endl;
+        drop(oldest);
+    }
+    if (this->m_Flushed)
+    {
+        scan(uuid);
+    }
+    return true;
+}
+
+/**
+ * @brief No more chunks will be added, look up the missing ones of every incomplete message.
+ */
+void ChunkReassembler::flush()
+{
+    this->m_Flushed = true;
+    QStringList order = this->m_Order;
+    foreach (const QString& uuid, order)
+    {
+        scan(uuid);
+    }
+}
+
+/**
+ * @brief Stop scanning and drop the buffered chunks, the requests in flight are ignored when
+ * they come back.
+ */
+void ChunkReassembler::cancel()
+{
+    this->m_Canceled = true;
+    this->m_Pending.clear();
+    this->m_Order.clear();
+    this->m_Taken.clear();
+    this->m_BufferedBytes = 0;
+}
+
+void ChunkReassembler::scan(const QString& _uuid)
+{
+    if (this->m_Canceled || !this->m_Pending.contains(_uuid))
+    {
+        return;
+    }
+    Pending& pending = this->m_Pending[_uuid];
+    if (pending.scanning)
+    {
+        return;
+    }
+
+    int first = 0;
+    while (first < pending.chunks.size() && pending.chunks[first].uuid().isEmpty())
+    {
+        first++;
+    }
+    int last = pending.chunks.size() - 1;
+    while (last >= 0 && pending.chunks[last].uuid().isEmpty())
+    {
+        last--;
+    }
+
+    int entryId = -1;
+    bool backward = false;
+    if (first > 0 && !pending.backwardDone && pending.firstEntry > 0)
+    {
+        entryId = pending.firstEntry - 1;
+        backward = true;
+    }
+    else if (last < pending.chunks.size() - 1 && !pending.forwardDone)
+    {
+        entryId = pending.lastEntry + 1;
+    }
+    if (entryId < 0 || pending.scanned >= this->m_MaxScanEntries)
+    {
+        qCWarning(lcDecode) << "Message " << _uuid << " is missing " << pending.chunks.size() - pending.received << " of " << pending.chunks.size() << " chunks" << Qt::endl;
+        drop(_uuid);
+        return;
+    }
+
+    pending.scanning = true;
+    pending.scanned++;
+    QUrl url(this->m_MessagePath.arg(pending.ledgerId).arg(entryId));
+    qCInfo(lcTopic) << "Get Message chunk Service url: " << url.toString() << Qt::endl;
+    RequestQueue::instance(this->m_Cluster)->enqueue(this->m_Client, HttpRequest(HttpRequest::Get, url), this, [this, _uuid, entryId, backward](const HttpResponse& _response)
+    {
+        scanned(_uuid, entryId, backward, _response);
+    });
+}
+
+void ChunkReassembler::scanned(const QString& _uuid, const int& _entryId, const bool& _backward, const HttpResponse& _response)
+{
+    if (this->m_Canceled || !this->m_Pending.contains(_uuid))
+    {
+        return;
+    }
+    Pending& pending = this->m_Pending[_uuid];
+    pending.scanning = false;
+    if (_backward)
+    {
+        pending.firstEntry = qMin(pending.firstEntry, _entryId);
+    }
+    else
+    {
+        pending.lastEntry = qMax(pending.lastEntry, _entryId);
+    }
+
+    if (!_response.isSuccess())
+    {
+        //Past either end of the ledger
+        if (_backward)
+        {
+            pending.backwardDone = true;
+        }
+        else
+        {
+            pending.forwardDone = true;
+        }
+        scan(_uuid);
+        return;
+    }
+
+    PulsarMessage message = TopicService::toMessage(_response, pending.ledgerId, _entryId);
+    if (message.isChunk() && message.uuid() == _uuid)
+    {
+        add(message); //scans on or assembles
+    }
+    else
+    {
+        scan(_uuid);
+    }
+}
+
+/**
+ * @brief The chunks are joined and decompressed on the global thread pool.
+ */
+void ChunkReassembler::assemble(const QString& _uuid)
+{
+    Pending pending = take(_uuid);
+    QPointer<ChunkReassembler> self(this);
+    QVector<PulsarMessage> chunks = pending.chunks;
+    QThreadPool::globalInstance()->start([self, chunks]()
+    {
+        PulsarMessage message = join(chunks);
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [self, message]()
+        {
+            if (!self.isNull() && !self->m_Canceled)
+            {
+                emit self->messageAssembled(message);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+/**
+ * @brief Give up an incomplete message, the chunks received are handed out as they are.
+ */
+void ChunkReassembler::drop(const QString& _uuid)
+{
+    Pending pending = take(_uuid);
+    QList<PulsarMessage> chunks;
+    foreach (const PulsarMessage& chunk, pending.chunks)
+    {
+        if (!chunk.uuid().isEmpty())
+        {
+            chunks << chunk;
+        }
+    }
+    emit messageIncomplete(chunks);
+}
+
+ChunkReassembler::Pending ChunkReassembler::take(const QString& _uuid)
+{
+    Pending pending = this->m_Pending.take(_uuid);
+    this->m_Order.removeOne(_uuid);
+    this->m_Taken.insert(_uuid);
+    this->m_BufferedBytes -= pending.bytes;
+    return pending;
+}
+
+/**
+ * @brief The message takes the id of its last chunk, the key and the properties of its first.
+ * @param _chunks all chunks in order
+ * @return
+ */
+PulsarMessage ChunkReassembler::join(const QVector<PulsarMessage>& _chunks)
+{
+    const PulsarMessage& first = _chunks.first();
+    const PulsarMessage& last = _chunks.last();
+    QByteArray payload;
+    payload.reserve(first.totalChunkSize());
+    QList<Message> ids;
+    foreach (const PulsarMessage& chunk, _chunks)
+    {
+        QByteArrayView body = chunk.bodyView();
+        payload.append(body.data(), body.size());
+        ids << Message(chunk.ledgerId(), chunk.entryId());
+    }
+
+    if (first.compression() != MessageMetadata::NONE)
+    {
+        QByteArray uncompressed;
+        if (Decompressor::decompress(first.compression(), payload, first.uncompressedSize(), uncompressed))
+        {
+            payload = uncompressed;
+        }
+    }
+
+    PulsarMessage message = PulsarMessage::fromPayload(payload);
+    message.setKey(first.key());
+    message.setProperties(first.properties());
+    message.setChunks(ids);
+    message.setSchemaVersion(first.schemaVersion());
+    message.setLedgerId(last.ledgerId());
+    message.setEntryId(last.entryId());
+    return message;
+}
@@ -0,0 +1,91 @@
+#ifndef CHUNKREASSEMBLER_H
+#define CHUNKREASSEMBLER_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QStringList>
+
+#include "httpclient.h"
+#include "../pulsarmessage.h"
+
+/**
+ * @brief Joins the chunks of messages larger than the max message size into one message.
+ *
+ * Chunks are buffered by uuid until all of them are in, the joined payload is decompressed on
+ * a worker thread and handed out as one message carrying the id of its last chunk. When the
+ * bytes buffered go over maxBufferedBytes() the oldest incomplete message is given up.
+ *
+ * After flush() the chunks that were never added are read entry by entry around the ones known,
+ * backwards for the leading chunks and forwards for the trailing ones, within the ledger of the
+ * chunks and at most maxScanEntries() entries per message. Chunks added after flush() are
+ * looked up right away, the ones of a message already handed out or given up are ignored so
+ * that ranges read page by page may overlap.
+ */
+class ChunkReassembler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param _client must outlive the reassembler, normally the reassembler is a child of its service
+     * @param _cluster the admin url of the cluster, selects the request queue
+     * @param _messagePath the entry url with %1 left for the ledger and %2 for the entry
+     */
+    explicit ChunkReassembler(const HttpClient* _client, const QString& _cluster, const QString& _messagePath, QObject* parent = nullptr);
+
+    inline void setMaxBufferedBytes(const qint64& _max) { this->m_MaxBufferedBytes = qMax<qint64>(0, _max); }
+    inline qint64 maxBufferedBytes() const { return this->m_MaxBufferedBytes; }
+    inline qint64 bufferedBytes() const { return this->m_BufferedBytes; }
+
+    inline void setMaxScanEntries(const int& _max) { this->m_MaxScanEntries = qMax(0, _max); }
+    inline int maxScanEntries() const { return this->m_MaxScanEntries; }
+
+    bool add(const PulsarMessage& _message);
+    void flush();
+    void cancel();
+
+signals:
+    void messageAssembled(const PulsarMessage&);
+    void messageIncomplete(const QList<PulsarMessage>&);
+
+private:
+    struct Pending
+    {
+        QVector<PulsarMessage> chunks;
+        int received;
+        qint64 bytes;
+        int ledgerId;
+        int firstEntry;
+        int lastEntry;
+        int scanned;
+        bool scanning;
+        bool backwardDone;
+        bool forwardDone;
+    };
+
+    void scan(const QString& _uuid);
+    void scanned(const QString& _uuid, const int& _entryId, const bool& _backward, const HttpResponse& _response);
+    void assemble(const QString& _uuid);
+    void drop(const QString& _uuid);
+    Pending take(const QString& _uuid);
+
+    static PulsarMessage join(const QVector<PulsarMessage>& _chunks);
+
+private:
+    const HttpClient* m_Client;
+    QString m_Cluster;
+    QString m_MessagePath;
+    qint64 m_MaxBufferedBytes;
+    qint64 m_BufferedBytes;
+    int m_MaxScanEntries;
+    bool m_Flushed;
+    bool m_Canceled;
+
+    QHash<QString, Pending> m_Pending;
+    QStringList m_Order;
+    QSet<QString> m_Taken;
+};
+
+#endif // CHUNKREASSEMBLER_H
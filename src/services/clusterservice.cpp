@@ -6,9 +6,9 @@
 #include <QSettings>
 #include <QDir>
 #include <QCoreApplication>
-#include <QDebug>
 
 #include "../constants.h"
+#include "../logging.h"
 #include "../cluster.h"
 
 ClusterService::ClusterService(QObject* parent) : BaseService(parent) {}
@@ -19,7 +19,7 @@ QStringList ClusterService::clusters(const Cluster& _cluster) const
     QString path(_cluster.adminUrl());
     path = path.append(this->m_Settings->value(GET_CLUSTERS_PATH_KEY).toString());
     QUrl url(path);
-    qDebug() << "Get the list of all the Pulsar clusters service url: " << url.toString() << Qt::endl;
+    qCInfo(lcAdmin) << "Get the list of all the Pulsar clusters service url: " << url.toString() << Qt::endl;
 
     QByteArray result = this->m_Client->get(url);
     QJsonParseError error;
@@ -31,7 +31,7 @@ QStringList ClusterService::clusters(const Cluster& _cluster) const
         {
             clusters << roots[i].toString();
         }
-        qDebug() << "Get the list of all the Pulsar clusters response result: " << QString::fromLatin1(result) << Qt::endl;
+        qCDebug(lcAdmin) << "Get the list of all the Pulsar clusters response result: " << QString::fromLatin1(result) << Qt::endl;
     }
     return clusters;
 }
@@ -84,7 +84,7 @@ void ClusterService::write()
         QJsonDocument doc = QJsonDocument::fromVariant(roots);
         QByteArray json = doc.toJson(QJsonDocument::Compact);
 
-        qDebug() << "Write clusters json: " << QString::fromLatin1(json) << Qt::endl;
+        qCDebug(lcAdmin) << "Write clusters json: " << QString::fromLatin1(json) << Qt::endl;
 
         file.write(json);
         file.close();
@@ -96,7 +96,7 @@ QString ClusterService::brokerServiceUrl(const Cluster& _cluster, const QString&
     QString path(_cluster.adminUrl());
     path = path.append(this->m_Settings->value(GET_BROKER_SRV_PATH_KEY).toString()).arg(_name);
     QUrl url(path);
-    qDebug() << "Get the configuration for the specified cluster url: " << url.toString() << Qt::endl;
+    qCInfo(lcAdmin) << "Get the configuration for the specified cluster url: " << url.toString() << Qt::endl;
 
     QByteArray result = this->m_Client->get(url);
     QJsonParseError error;
@@ -105,7 +105,7 @@ QString ClusterService::brokerServiceUrl(const Cluster& _cluster, const QString&
     {
         QJsonObject root = doc.object();
         QString result(root["brokerServiceUrl"].toString());
-        qDebug() << "Get the configuration for the specified cluster response result: " << result << Qt::endl;
+        qCDebug(lcAdmin) << "Get the configuration for the specified cluster response result: " << result << Qt::endl;
         return result;
     }
     return QString("");
@@ -124,7 +124,7 @@ void ClusterService::read()
             QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
             if (error.error == QJsonParseError::ParseError::NoError)
             {
-                qDebug() << "Read clusters json: " << QString::fromLatin1(doc.toJson(QJsonDocument::Compact)) << Qt::endl;
+                qCDebug(lcAdmin) << "Read clusters json: " << QString::fromLatin1(doc.toJson(QJsonDocument::Compact)) << Qt::endl;
 
                 QJsonArray roots = doc.array();
                 for (int i = 0; i < roots.size(); ++i)
@@ -135,7 +135,7 @@ void ClusterService::read()
             }
             else
             {
-                qDebug() << "parse JSON error: " << error.error << Qt::endl;
+                qCWarning(lcAdmin) << "parse JSON error: " << error.error << Qt::endl;
             }
         }
         file.close();
@@ -0,0 +1,141 @@
+#include "connectionpool.h"
+
+#include <QCoreApplication>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QSslSocket>
+#include <QSsl>
+#include <QUrl>
+#include <QDebug>
+
+#include "../cluster.h"
+
+ConnectionPool* ConnectionPool::s_Instance = Q_NULLPTR;
+
+ConnectionPool::ConnectionPool(QObject* _parent) : QObject(_parent)
+{
+}
+
+ConnectionPool* ConnectionPool::instance()
+{
+    if (!s_Instance)
+    {
+        s_Instance = new ConnectionPool(QCoreApplication::instance());
+    }
+    return s_Instance;
+}
+
+QString ConnectionPool::origin(const QUrl& _url)
+{
+    return _url.adjusted(QUrl::RemovePath | QUrl::RemoveQuery | QUrl::RemoveFragment | QUrl::RemoveUserInfo).toString().toLower();
+}
+
+/**
+ * @brief Return the manager of the url's origin, creating it on first use. Redirects to other
+ * brokers of the cluster end up with their own entry.
+ * @param _url
+ * @return
+ */
+QNetworkAccessManager* ConnectionPool::manager(const QUrl& _url)
+{
+    return connection(_url).manager;
+}
+
+/**
+ * @brief HTTP/1.1 keeps connections alive by default, HTTP/2 multiplexes on one. An https
+ * request takes the TLS configuration of its origin.
+ * @param _request
+ */
+void ConnectionPool::setupRequest(QNetworkRequest& _request)
+{
+    _request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+    if (_request.url().scheme() == "https")
+    {
+        _request.setSslConfiguration(connection(_request.url()).ssl);
+    }
+}
+
+/**
+ * @brief Apply the TLS setting of a cluster to its origins and establish their connections
+ * ahead of the first request. The certificates are verified unless the cluster allows insecure
+ * connections; an origin shared by two clusters takes the setting of the one opened last.
+ * @param _cluster
+ */
+void ConnectionPool::open(const Cluster& _cluster)
+{
+    foreach (const QString& str, urls(_cluster))
+    {
+        QUrl url(str);
+        Connection& connection = this->connection(url);
+        connection.ssl.setPeerVerifyMode(_cluster.tlsAllowInsecureConnection() ? QSslSocket::VerifyNone : QSslSocket::AutoVerifyPeer);
+        if (url.scheme() == "https")
+        {
+            connection.manager->connectToHostEncrypted(url.host(), url.port(443), connection.ssl);
+        }
+        else
+        {
+            connection.manager->connectToHost(url.host(), url.port(80));
+        }
+    }
+}
+
+/**
+ * @brief Drop the idle connections and session tickets of a cluster. The managers stay alive,
+ * replies still running on them are not aborted.
+ * @param _cluster
+ */
+void ConnectionPool::close(const Cluster& _cluster)
+{
+    foreach (const QString& str, urls(_cluster))
+    {
+        QString key = origin(QUrl(str));
+        if (this->m_Connections.contains(key))
+        {
+            Connection& connection = this->m_Connections[key];
+            connection.manager->clearConnectionCache();
+            connection.ssl.setSessionTicket(QByteArray());
+        }
+    }
+}
+
+/**
+ * @brief The entry of the url's origin, created on first use with the certificates verified.
+ */
+ConnectionPool::Connection& ConnectionPool::connection(const QUrl& _url)
+{
+    QString key = origin(_url);
+    if (!this->m_Connections.contains(key))
+    {
+        Connection connection;
+        connection.manager = new QNetworkAccessManager(this);
+        connection.ssl = QSslConfiguration::defaultConfiguration();
+        //Keep the session around so that new connections can resume it instead of a full handshake
+        connection.ssl.setSslOption(QSsl::SslOptionDisableSessionPersistence, false);
+        connection.ssl.setSslOption(QSsl::SslOptionDisableSessionTickets, false);
+        connect(connection.manager, &QNetworkAccessManager::finished, this, &ConnectionPool::handleFinished);
+        this->m_Connections.insert(key, connection);
+    }
+    return this->m_Connections[key];
+}
+
+QStringList ConnectionPool::urls(const Cluster& _cluster) const
+{
+    QStringList urls;
+    urls << _cluster.adminUrl() << _cluster.functionUrl() << _cluster.prestoUrl();
+    urls.removeAll(QString());
+    return urls;
+}
+
+void ConnectionPool::handleFinished(QNetworkReply* _reply)
+{
+    if (_reply->url().scheme() == "https")
+    {
+        QByteArray ticket = _reply->sslConfiguration().sessionTicket();
+        QString key = origin(_reply->url());
+        if (!ticket.isEmpty() && this->m_Connections.contains(key))
+        {
+            this->m_Connections[key].ssl.setSessionTicket(ticket);
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef CONNECTIONPOOL_H
+#define CONNECTIONPOOL_H
+
+#include <QObject>
+#include <QHash>
+#include <QSslConfiguration>
+
+class QNetworkAccessManager;
+class QNetworkReply;
+class QNetworkRequest;
+class QUrl;
+class Cluster;
+
+/**
+ * @brief Process-wide registry of the network stack, one QNetworkAccessManager per origin
+ * (scheme, host and port) of a cluster.
+ *
+ * Every HttpClient borrows its manager from here, so keep-alive connections, HTTP/2 sessions
+ * and TLS session tickets are shared by all services and windows talking to the same cluster.
+ * Certificates are verified, except for the origins of a cluster which allows insecure TLS
+ * connections, see open().
+ */
+class ConnectionPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    static ConnectionPool* instance();
+
+    QNetworkAccessManager* manager(const QUrl& _url);
+    void setupRequest(QNetworkRequest& _request);
+
+    void open(const Cluster& _cluster);
+    void close(const Cluster& _cluster);
+
+    static QString origin(const QUrl& _url);
+
+private:
+    explicit ConnectionPool(QObject* parent = nullptr);
+
+    QStringList urls(const Cluster& _cluster) const;
+
+private slots:
+    void handleFinished(QNetworkReply*);
+
+private:
+    struct Connection
+    {
+        QNetworkAccessManager* manager;
+        QSslConfiguration ssl;
+    };
+
+    Connection& connection(const QUrl& _url);
+
+    QHash<QString, Connection> m_Connections;
+
+    static ConnectionPool* s_Instance;
+};
+
+#endif // CONNECTIONPOOL_H
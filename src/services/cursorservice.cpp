@@ -1,11 +1,8 @@
 #include "cursorservice.h"
 
-#include <QJsonDocument>
-#include <QJsonArray>
-#include <QJsonObject>
-#include <QDebug>
-
 #include "../constants.h"
+#include "../logging.h"
+#include "internalstatsreader.h"
 
 Cursor CursorService::find(const Topic& _topic, const int& _partition, const QString& _name)
 {
@@ -14,31 +11,20 @@ Cursor CursorService::find(const Topic& _topic, const int& _partition, const QSt
     QString path(_topic.getNamespace().tenant().cluster().adminUrl());
     path = path.append(this->m_Settings->value(GET_STORED_TOPIC_METADATA_KEY).toString());
     QUrl url(path.arg(_topic.getNamespace().tenant().name(), _topic.getNamespace().name(), topicName, _topic.domain()));
-    qDebug() << "Find Cursor by name Service url: " << url.toString() << Qt::endl;
+    qCInfo(lcTopic) << "Find Cursor by name Service url: " << url.toString() << Qt::endl;
 
-    int code;
-    QByteArray result = this->m_Client->get(url, code);
-    QJsonParseError error;
-    QJsonDocument doc = QJsonDocument::fromJson(result, &error);
-    if (error.error == QJsonParseError::ParseError::NoError)
+    //Only the cursor asked for is mapped, the ledgers and the other cursors are skipped
+    InternalStatsReader reader(_name);
+    HttpResponse response = this->m_Client->executeStream(HttpRequest(HttpRequest::Get, url), [&reader](const QByteArray& _chunk)
+    {
+        reader.addData(_chunk);
+    });
+    if (response.isSuccess() && reader.finish() && reader.hasCursor())
     {
-        QJsonObject root = doc.object();
-        QJsonObject cursors = root["cursors"].toObject();
-        QJsonObject::const_iterator it;
-        for (it = cursors.constBegin(); it != cursors.constEnd(); ++it)
-        {
-            //Log4Qt::Logger::logger("main")->debug("Cursor name: %1", it.key());
-            if (it.key() == _name)
-            {
-                QJsonDocument _doc(it.value().toObject());
-                cursor = Cursor::fromJson(_doc.toJson(), cursor);
-                cursor.setName(it.key());
-                break;
-            }
-        }
+        cursor = reader.cursor();
     }
 
-    qDebug() << "Find Cursor by name response result: " << QString::fromLatin1(result) << Qt::endl;
+    qCDebug(lcTopic) << "Find Cursor by name response: " << response.code << ", found: " << reader.hasCursor() << Qt::endl;
 
     return cursor;
 }
@@ -0,0 +1,133 @@
+#include "endpointmetrics.h"
+
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QDateTime>
+#include <QtMath>
+
+EndpointStats::EndpointStats() : m_Count(0), m_Errors(0), m_BytesIn(0), m_BytesOut(0), m_Buckets(bounds().size() + 1, 0) {}
+
+/**
+ * @brief Upper bounds in milliseconds of the histogram buckets, the last bucket is unbounded.
+ * @return
+ */
+const QVector<int>& EndpointStats::bounds()
+{
+    static const QVector<int> bounds { 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 30000 };
+    return bounds;
+}
+
+void EndpointStats::record(const qint64& _elapsed, const qint64& _bytesIn, const qint64& _bytesOut, const bool& _error)
+{
+    const QVector<int>& b = bounds();
+    int i = 0;
+    while (i < b.size() && _elapsed > b[i])
+    {
+        i++;
+    }
+    this->m_Buckets[i]++;
+    this->m_Count++;
+    this->m_BytesIn += _bytesIn;
+    this->m_BytesOut += _bytesOut;
+    if (_error)
+    {
+        this->m_Errors++;
+    }
+}
+
+/**
+ * @brief Estimate a latency percentile as the upper bound of the bucket it falls into.
+ * @param _p between 0 and 1
+ * @return milliseconds, -1 if nothing has been recorded, or the last bound + 1 for the overflow bucket
+ */
+int EndpointStats::percentile(const double& _p) const
+{
+    if (this->m_Count == 0)
+    {
+        return -1;
+    }
+    const QVector<int>& b = bounds();
+    qint64 rank = qMax<qint64>(1, qCeil(_p * this->m_Count));
+    qint64 cumulative = 0;
+    for (int i = 0, n = this->m_Buckets.size(); i < n; ++i)
+    {
+        cumulative += this->m_Buckets[i];
+        if (cumulative >= rank)
+        {
+            return i < b.size() ? b[i] : b.last() + 1;
+        }
+    }
+    return b.last() + 1;
+}
+
+EndpointMetrics* EndpointMetrics::s_Instance = Q_NULLPTR;
+
+EndpointMetrics::EndpointMetrics(QObject* _parent) : QObject(_parent)
+{
+}
+
+EndpointMetrics* EndpointMetrics::instance()
+{
+    if (!s_Instance)
+    {
+        s_Instance = new EndpointMetrics(QCoreApplication::instance());
+    }
+    return s_Instance;
+}
+
+void EndpointMetrics::record(const QString& _endpoint, const qint64& _elapsed, const qint64& _bytesIn, const qint64& _bytesOut, const bool& _error)
+{
+    EndpointStats& stats = this->m_Stats[_endpoint];
+    stats.setEndpoint(_endpoint);
+    stats.record(_elapsed, _bytesIn, _bytesOut, _error);
+    emit updated();
+}
+
+QList<EndpointStats> EndpointMetrics::snapshot() const
+{
+    return this->m_Stats.values();
+}
+
+QByteArray EndpointMetrics::toJson() const
+{
+    QJsonArray bounds;
+    foreach (int bound, EndpointStats::bounds())
+    {
+        bounds.append(bound);
+    }
+
+    QJsonArray endpoints;
+    foreach (const EndpointStats& stats, this->m_Stats)
+    {
+        QJsonObject obj;
+        obj["endpoint"] = stats.endpoint();
+        obj["count"] = stats.count();
+        obj["errors"] = stats.errors();
+        obj["bytesIn"] = stats.bytesIn();
+        obj["bytesOut"] = stats.bytesOut();
+        obj["p50"] = stats.percentile(0.50);
+        obj["p90"] = stats.percentile(0.90);
+        obj["p99"] = stats.percentile(0.99);
+        QJsonArray buckets;
+        foreach (int bucket, stats.buckets())
+        {
+            buckets.append(bucket);
+        }
+        obj["buckets"] = buckets;
+        endpoints.append(obj);
+    }
+
+    QJsonObject root;
+    root["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    root["bucketBoundsMs"] = bounds;
+    root["endpoints"] = endpoints;
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+void EndpointMetrics::reset()
+{
+    this->m_Stats.clear();
+    emit updated();
+}
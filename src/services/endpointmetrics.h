@@ -0,0 +1,67 @@
+#ifndef ENDPOINTMETRICS_H
+#define ENDPOINTMETRICS_H
+
+#include <QObject>
+#include <QMap>
+#include <QVector>
+
+/**
+ * @brief Counters and latency histogram of one endpoint template.
+ */
+class EndpointStats
+{
+public:
+    explicit EndpointStats();
+
+    static const QVector<int>& bounds();
+
+    void record(const qint64& _elapsed, const qint64& _bytesIn, const qint64& _bytesOut, const bool& _error);
+    int percentile(const double& _p) const;
+
+    inline QString endpoint() const { return this->m_Endpoint; }
+    inline void setEndpoint(const QString& _endpoint) { this->m_Endpoint = _endpoint; }
+
+    inline int count() const { return this->m_Count; }
+    inline int errors() const { return this->m_Errors; }
+    inline qint64 bytesIn() const { return this->m_BytesIn; }
+    inline qint64 bytesOut() const { return this->m_BytesOut; }
+    inline QVector<int> buckets() const { return this->m_Buckets; }
+
+private:
+    QString m_Endpoint;
+    int m_Count;
+    int m_Errors;
+    qint64 m_BytesIn;
+    qint64 m_BytesOut;
+    QVector<int> m_Buckets;
+};
+
+/**
+ * @brief Process-wide metrics of the requests sent by HttpClient, grouped by the
+ * PULSAR_SERVICE_PATH key the url was built from.
+ */
+class EndpointMetrics : public QObject
+{
+    Q_OBJECT
+
+public:
+    static EndpointMetrics* instance();
+
+    void record(const QString& _endpoint, const qint64& _elapsed, const qint64& _bytesIn, const qint64& _bytesOut, const bool& _error);
+    QList<EndpointStats> snapshot() const;
+    QByteArray toJson() const;
+    void reset();
+
+signals:
+    void updated();
+
+private:
+    explicit EndpointMetrics(QObject* parent = nullptr);
+
+private:
+    QMap<QString, EndpointStats> m_Stats;
+
+    static EndpointMetrics* s_Instance;
+};
+
+#endif // ENDPOINTMETRICS_H
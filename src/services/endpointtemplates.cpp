@@ -0,0 +1,96 @@
+#include "endpointtemplates.h"
+
+#include <QDir>
+#include <QSettings>
+#include <QCoreApplication>
+
+#include "../constants.h"
+
+EndpointTemplates* EndpointTemplates::instance()
+{
+    static EndpointTemplates templates;
+    return &templates;
+}
+
+/**
+ * @brief Compile every path of the PULSAR_SERVICE_PATH section, the %N placeholders match a
+ * single path segment.
+ */
+EndpointTemplates::EndpointTemplates()
+{
+    QDir dir(QCoreApplication::applicationDirPath());
+    QSettings settings(dir.absoluteFilePath(INI_FILE), QSettings::IniFormat);
+    settings.beginGroup("PULSAR_SERVICE_PATH");
+    QStringList keys = settings.childKeys();
+    foreach (const QString& key, keys)
+    {
+        QString path = settings.value(key).toString().section('?', 0, 0);
+        QString pattern("^.*");
+        int literals = 0;
+        QRegularExpression placeholder("%\\d+");
+        int last = 0;
+        QRegularExpressionMatchIterator it = placeholder.globalMatch(path);
+        while (it.hasNext())
+        {
+            QRegularExpressionMatch m = it.next();
+            QString literal = path.mid(last, m.capturedStart() - last);
+            pattern.append(QRegularExpression::escape(literal)).append("[^/]+");
+            literals += literal.length();
+            last = m.capturedEnd();
+        }
+        pattern.append(QRegularExpression::escape(path.mid(last))).append("$");
+        literals += path.length() - last;
+
+        Template t { key, QRegularExpression(pattern), literals };
+        this->m_Templates.append(t);
+        this->m_Keys.append(key);
+    }
+    settings.endGroup();
+}
+
+QString EndpointTemplates::methodName(const HttpRequest::Method& _method)
+{
+    switch (_method)
+    {
+    case HttpRequest::Get:
+        return QString("GET");
+    case HttpRequest::Post:
+        return QString("POST");
+    case HttpRequest::Put:
+        return QString("PUT");
+    case HttpRequest::Delete:
+        return QString("DELETE");
+    }
+    return QString();
+}
+
+/**
+ * @brief The most specific template wins, i.e. the one with the most literal characters.
+ * Templates sharing a path (PUT_NEW_TENANT_PATH, DELETE_TENANT_PATH, ...) are told apart by
+ * the method prefix of their key.
+ * @param _method
+ * @param _url
+ * @return the key, or an empty string for urls outside of the admin api.
+ */
+QString EndpointTemplates::match(const HttpRequest::Method& _method, const QUrl& _url) const
+{
+    QString path = _url.path();
+    QString prefix = methodName(_method).append('_');
+    QString result;
+    int best = -1;
+    bool bestPrefix = false;
+    foreach (const Template& t, this->m_Templates)
+    {
+        if (t.pattern.match(path).hasMatch())
+        {
+            bool samePrefix = t.key.startsWith(prefix);
+            if (t.literals > best || (t.literals == best && samePrefix && !bestPrefix))
+            {
+                result = t.key;
+                best = t.literals;
+                bestPrefix = samePrefix;
+            }
+        }
+    }
+    return result;
+}
@@ -0,0 +1,39 @@
+#ifndef ENDPOINTTEMPLATES_H
+#define ENDPOINTTEMPLATES_H
+
+#include <QString>
+#include <QList>
+#include <QRegularExpression>
+
+#include "httpclient.h"
+
+/**
+ * @brief Maps a request url back to the PULSAR_SERVICE_PATH key it was built from, e.g.
+ * /admin/v2/persistent/public/default/foo/stats to GET_TOPIC_STATS_PATH.
+ */
+class EndpointTemplates
+{
+public:
+    static EndpointTemplates* instance();
+
+    QString match(const HttpRequest::Method& _method, const QUrl& _url) const;
+    inline QStringList keys() const { return this->m_Keys; }
+
+    static QString methodName(const HttpRequest::Method& _method);
+
+private:
+    EndpointTemplates();
+
+private:
+    struct Template
+    {
+        QString key;
+        QRegularExpression pattern;
+        int literals;
+    };
+
+    QList<Template> m_Templates;
+    QStringList m_Keys;
+};
+
+#endif // ENDPOINTTEMPLATES_H
@@ -6,9 +6,9 @@
 #include <QHttpMultiPart>
 #include <QMimeDatabase>
 #include <QFileInfo>
-#include <QDebug>
 
 #include "../constants.h"
+#include "../logging.h"
 
 QList<Function> FunctionService::functions(const Namespace& _namespace) const
 {
@@ -16,7 +16,7 @@ QList<Function> FunctionService::functions(const Namespace& _namespace) const
     QString path(_namespace.tenant().cluster().functionUrl());
     path += this->m_Settings->value(GET_FUNCTIONS_PATH_KEY).toString();
     QUrl url(path.arg(_namespace.tenant().name(), _namespace.name()));
-    qDebug() << "Get Functions List service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Get Functions List service url: " << url.toString() << Qt::endl;
 
     QByteArray result = this->m_Client->get(url);
     QJsonParseError error;
@@ -34,7 +34,7 @@ QList<Function> FunctionService::functions(const Namespace& _namespace) const
         }
     }
 
-    qDebug() << "Get Functions List response result: " << QString::fromLatin1(result) << Qt::endl;
+    qCDebug(lcFunction) << "Get Functions List response result: " << QString::fromLatin1(result) << Qt::endl;
 
     return functions;
 }
@@ -44,11 +44,11 @@ QByteArray FunctionService::status(const Function& _function) const
     QString path(_function.getNamespace().tenant().cluster().functionUrl());
     path += this->m_Settings->value(GET_FUNCTION_STATUS_PATH_KEY).toString();
     QUrl url(path.arg(_function.getNamespace().tenant().name(), _function.getNamespace().name(), _function.name()));
-    qDebug() << "Get Functions status service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Get Functions status service url: " << url.toString() << Qt::endl;
 
     QByteArray result = this->m_Client->get(url);
 
-    qDebug() << "Get Functions status response result: " << QString::fromLatin1(result) << Qt::endl;
+    qCDebug(lcFunction) << "Get Functions status response result: " << QString::fromLatin1(result) << Qt::endl;
 
     return result;
 }
@@ -58,11 +58,11 @@ QByteArray FunctionService::information(const Namespace& _namespace, const QStri
     QString path(_namespace.tenant().cluster().functionUrl());
     path += this->m_Settings->value(GET_FUNCTION_INFO_PATH_KEY).toString();
     QUrl url(path.arg(_namespace.tenant().name(), _namespace.name(), _name));
-    qDebug() << "Get Function information service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Get Function information service url: " << url.toString() << Qt::endl;
 
     QByteArray result = this->m_Client->get(url);
 
-    qDebug() << "Get Function information response result: " << QString::fromLatin1(result) << Qt::endl;
+    qCDebug(lcFunction) << "Get Function information response result: " << QString::fromLatin1(result) << Qt::endl;
 
     return  result;
 }
@@ -71,7 +71,7 @@ void FunctionService::createFunction(const Function& _function, QFile* _file, Ht
 {
     QByteArray json = _function.toJson();
 
-    qDebug() << "Greate a new Function request body: " << QString::fromLatin1(json) << Qt::endl;
+    qCDebug(lcFunction) << "Greate a new Function request body: " << QString::fromLatin1(json) << Qt::endl;
 
     QHttpMultiPart* multiPart = new QHttpMultiPart(QHttpMultiPart::FormDataType);
     //配置部分
@@ -99,7 +99,7 @@ void FunctionService::createFunction(const Function& _function, QFile* _file, Ht
     QString path(_function.getNamespace().tenant().cluster().functionUrl());
     path += this->m_Settings->value(PUT_NEW_FUNCTION_PATH_KEY).toString();
     QUrl url(path.arg(_function.getNamespace().tenant().name(), _function.getNamespace().name(), _function.name()));
-    qDebug() << "Greate a new Function service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Greate a new Function service url: " << url.toString() << Qt::endl;
 
     int code;
     QByteArray result = this->m_Client->post(url, multiPart, code);
@@ -122,14 +122,14 @@ void FunctionService::createFunction(const Function& _function, QFile* _file, Ht
         break;
     }
 
-    qDebug() << "Greate a new Function response result: " << QString::fromLatin1(result) << ", code: " << code << Qt::endl;
+    qCDebug(lcFunction) << "Greate a new Function response result: " << QString::fromLatin1(result) << ", code: " << code << Qt::endl;
 }
 
 void FunctionService::updateFunction(const Function& _function, QFile* _file, HttpStatusCode& _code)
 {
     QByteArray json = _function.toJson();
 
-    qDebug() << "Update Function request body: " << QString::fromLatin1(json) << Qt::endl;
+    qCDebug(lcFunction) << "Update Function request body: " << QString::fromLatin1(json) << Qt::endl;
 
     QHttpMultiPart* multiPart = new QHttpMultiPart(QHttpMultiPart::FormDataType);
     //配置部分
@@ -157,7 +157,7 @@ void FunctionService::updateFunction(const Function& _function, QFile* _file, Ht
     QString path(_function.getNamespace().tenant().cluster().functionUrl());
     path += this->m_Settings->value(UPDATE_FUNCTION_PATH_KEY).toString();
     QUrl url(path.arg(_function.getNamespace().tenant().name(), _function.getNamespace().name(), _function.name()));
-    qDebug() << "Updae a Source service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Updae a Source service url: " << url.toString() << Qt::endl;
 
     int code;
     QByteArray result = this->m_Client->put(url, multiPart, code);
@@ -192,7 +192,7 @@ void FunctionService::updateFunction(const Function& _function, QFile* _file, Ht
         break;
     }
 
-    qDebug() << "Updae a Function response result: " << QString::fromLatin1(result) << ", code: " << code << Qt::endl;
+    qCDebug(lcFunction) << "Updae a Function response result: " << QString::fromLatin1(result) << ", code: " << code << Qt::endl;
 }
 
 void FunctionService::deleteFunction(const Function& _function, HttpStatusCode& _code)
@@ -200,7 +200,7 @@ void FunctionService::deleteFunction(const Function& _function, HttpStatusCode&
     QString path(_function.getNamespace().tenant().cluster().functionUrl());
     path += this->m_Settings->value(DELETE_FUNCTION_PATH_KEY).toString();
     QUrl url(path.arg(_function.getNamespace().tenant().name(), _function.getNamespace().name(), _function.name()));
-    qDebug() << "Delete a Function service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Delete a Function service url: " << url.toString() << Qt::endl;
 
     int statusCode;
     QByteArray result = this->m_Client->deleteResource(url, statusCode);
@@ -227,7 +227,7 @@ void FunctionService::deleteFunction(const Function& _function, HttpStatusCode&
         break;
     }
 
-    qDebug() << "Delete a Function response result: " << QString::fromLatin1(result) << ", code: " << statusCode << Qt::endl;
+    qCDebug(lcFunction) << "Delete a Function response result: " << QString::fromLatin1(result) << ", code: " << statusCode << Qt::endl;
 }
 
 void FunctionService::startFunction(const Function& _function, HttpStatusCode& _code)
@@ -235,7 +235,7 @@ void FunctionService::startFunction(const Function& _function, HttpStatusCode& _
     QString path(_function.getNamespace().tenant().cluster().functionUrl());
     path += this->m_Settings->value(START_FUNCTION_PATH_KEY).toString();
     QUrl url(path.arg(_function.getNamespace().tenant().name(), _function.getNamespace().name(), _function.name()));
-    qDebug() << "Start a Function service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Start a Function service url: " << url.toString() << Qt::endl;
 
     int statusCode;
     QByteArray result = this->m_Client->post(url, QByteArray(), statusCode);
@@ -258,7 +258,7 @@ void FunctionService::startFunction(const Function& _function, HttpStatusCode& _
         break;
     }
 
-    qDebug() << "Start a Function response result: " << QString::fromLatin1(result) << ", code: " << statusCode << Qt::endl;
+    qCDebug(lcFunction) << "Start a Function response result: " << QString::fromLatin1(result) << ", code: " << statusCode << Qt::endl;
 }
 
 void FunctionService::stopFunction(const Function& _function, HttpStatusCode& _code)
@@ -266,7 +266,7 @@ void FunctionService::stopFunction(const Function& _function, HttpStatusCode& _c
     QString path(_function.getNamespace().tenant().cluster().functionUrl());
     path += this->m_Settings->value(STOP_FUNCTION_PATH_KEY).toString();
     QUrl url(path.arg(_function.getNamespace().tenant().name(), _function.getNamespace().name(), _function.name()));
-    qDebug() << "Stop a Function service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Stop a Function service url: " << url.toString() << Qt::endl;
 
     int statusCode;
     QByteArray result = this->m_Client->post(url, QByteArray(), statusCode);
@@ -289,7 +289,7 @@ void FunctionService::stopFunction(const Function& _function, HttpStatusCode& _c
         break;
     }
 
-    qDebug() << "Stop a Function response result: " << QString::fromLatin1(result) << ", code: " << statusCode << Qt::endl;
+    qCDebug(lcFunction) << "Stop a Function response result: " << QString::fromLatin1(result) << ", code: " << statusCode << Qt::endl;
 }
 
 QList<FunctionInstance> FunctionService::instances(const Function& _function) const
@@ -298,7 +298,7 @@ QList<FunctionInstance> FunctionService::instances(const Function& _function) co
     QString path(_function.getNamespace().tenant().cluster().functionUrl());
     path += this->m_Settings->value(GET_FUNCTION_STATUS_PATH_KEY).toString();
     QUrl url(path.arg(_function.getNamespace().tenant().name(), _function.getNamespace().name(), _function.name()));
-    qDebug() << "Get Function status service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Get Function status service url: " << url.toString() << Qt::endl;
 
     int code;
     QByteArray result = this->m_Client->get(url, code);
@@ -328,7 +328,7 @@ QList<FunctionInstance> FunctionService::instances(const Function& _function) co
         }
     }
 
-    qDebug() << "Get Source Function response result: " << QString::fromLatin1(result) << Qt::endl;
+    qCDebug(lcFunction) << "Get Source Function response result: " << QString::fromLatin1(result) << Qt::endl;
 
     return instances;
 }
@@ -2,249 +2,489 @@
 
 #include <QString>
 #include <QEventLoop>
-#include <QSslConfiguration>
-#include <QSslSocket>
-#include <QSsl>
+#include <QPointer>
 #include <QHttpMultiPart>
+#include <QSharedPointer>
 
-HttpClient::HttpClient(QObject* parent) : QObject(parent), m_Client(new QNetworkAccessManager(this))
+#include "connectionpool.h"
+#include "responsecache.h"
+#include "requestcoalescer.h"
+#include "endpointtemplates.h"
+#include "endpointmetrics.h"
+#include "../logging.h"
+
+QByteArray HttpResponse::header(const QByteArray& _name) const
+{
+    foreach (const QNetworkReply::RawHeaderPair& pair, this->headers)
+    {
+        if (pair.first.compare(_name, Qt::CaseInsensitive) == 0)
+        {
+            return pair.second;
+        }
+    }
+    return QByteArray();
+}
+
+/**
+ * @brief The network stack is borrowed from ConnectionPool, so that all clients of a cluster share it.
+ * @param parent
+ */
+HttpClient::HttpClient(QObject* parent) : QObject(parent), m_CacheMode(HttpRequest::PreferCache)
 {
-    //this->qnam->setTransferTimeout(500);
 }
 
 HttpClient::~HttpClient()
 {
-    if (m_Client)
-    {
-        delete m_Client;
-        m_Client = Q_NULLPTR;
-    }
 }
 
 QByteArray HttpClient::get(const QUrl& _url) const
 {
-    QNetworkRequest request(_url);
-    if (!this->m_Token.isEmpty())
-    {
-        request.setRawHeader(QString("Authorization").toLatin1(), QString("Bearer ").append(this->m_Token).toLatin1());
-    }
-    QNetworkReply* reply = this->m_Client->get(request);
-    QByteArray response =  waitFor(reply);
-    QVariant status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
-    int code = status.toInt();
-    if (code == HttpStatusCode::StatusCode::TemporaryRedirect)
-    {
-        QVariant redirection = reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
-        response = get(redirection.toUrl());
-
-        qDebug() << "RedirectionTargetAttribute: " << redirection.toString() << Qt::endl;
-    }
-    reply->deleteLater();
-    return response;
+    return execute(HttpRequest(HttpRequest::Get, _url)).body;
 }
 
 QByteArray HttpClient::get(const QUrl& _url, int& _code) const
 {
-    QNetworkRequest request(_url);
-    if (!this->m_Token.isEmpty())
-    {
-        request.setRawHeader(QString("Authorization").toLatin1(), QString("Bearer ").append(this->m_Token).toLatin1());
-    }
-    QNetworkReply* reply = this->m_Client->get(request);
-    QByteArray response =  waitFor(reply);
-    QVariant status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
-    _code = status.toInt();
-    if (_code == HttpStatusCode::StatusCode::TemporaryRedirect)
-    {
-        QVariant redirection = reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
-        response = get(redirection.toUrl(), _code);
-
-        qDebug() << "RedirectionTargetAttribute: " << redirection.toString() << Qt::endl;
-    }
-    reply->deleteLater();
-    return response;
+    HttpResponse response = execute(HttpRequest(HttpRequest::Get, _url));
+    _code = response.code;
+    return response.body;
 }
 
 QByteArray HttpClient::deleteResource(const QUrl& _url) const
 {
-    QNetworkRequest request(_url);
-    if (!this->m_Token.isEmpty())
-    {
-        request.setRawHeader(QString("Authorization").toLatin1(), QString("Bearer ").append(this->m_Token).toLatin1());
-    }
-    QNetworkReply* reply = this->m_Client->deleteResource(request);
-    QByteArray response =  waitFor(reply);
-    QVariant status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
-    int code = status.toInt();
-    if (code == HttpStatusCode::StatusCode::TemporaryRedirect)
-    {
-        QVariant redirection = reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
-        response = deleteResource(redirection.toUrl(), code);
-
-        qDebug() << "RedirectionTargetAttribute: " << redirection.toString() << Qt::endl;
-    }
-    reply->deleteLater();
-    return response;
+    return execute(HttpRequest(HttpRequest::Delete, _url)).body;
 }
 
 QByteArray HttpClient::deleteResource(const QUrl& _url, int& _code) const
 {
-    QNetworkRequest request(_url);
-    if (!this->m_Token.isEmpty())
+    HttpResponse response = execute(HttpRequest(HttpRequest::Delete, _url));
+    _code = response.code;
+    return response.body;
+}
+
+QByteArray HttpClient::post(const QUrl& _url, const QByteArray& _body, const QString& _contentType) const
+{
+    int code;
+    return post(_url, _body, code, _contentType);
+}
+
+QByteArray HttpClient::post(const QUrl& _url, const QByteArray& _body, int& _code, const QString& _contentType) const
+{
+    HttpRequest request(HttpRequest::Post, _url);
+    request.body = _body;
+    request.contentType = _contentType;
+    HttpResponse response = execute(request);
+    _code = response.code;
+    return response.body;
+}
+
+QByteArray HttpClient::post(const QUrl& _url, QHttpMultiPart* _multiPart, int& _code)
+{
+    HttpRequest request(HttpRequest::Post, _url);
+    request.multiPart = _multiPart;
+    HttpResponse response = execute(request);
+    _code = response.code;
+    return response.body;
+}
+
+QByteArray HttpClient::put(const QUrl& _url, const QByteArray& _body, const QString& _contentType) const
+{
+    int code;
+    return put(_url, _body, code, _contentType);
+}
+
+QByteArray HttpClient::put(const QUrl& _url, const QByteArray& _body, int& _code, const QString& _contentType) const
+{
+    HttpRequest request(HttpRequest::Put, _url);
+    request.body = _body;
+    request.contentType = _contentType;
+    HttpResponse response = execute(request);
+    _code = response.code;
+    return response.body;
+}
+
+QByteArray HttpClient::put(const QUrl& _url, QHttpMultiPart* _multiPart, int& _code)
+{
+    HttpRequest request(HttpRequest::Put, _url);
+    request.multiPart = _multiPart;
+    HttpResponse response = execute(request);
+    _code = response.code;
+    return response.body;
+}
+
+void HttpClient::postAsync(const QUrl& _url, const QByteArray& _body, QObject* _context, const HttpCallback& _callback, const QString& _contentType) const
+{
+    HttpRequest request(HttpRequest::Post, _url);
+    request.body = _body;
+    request.contentType = _contentType;
+    send(request, _context, _callback);
+}
+
+void HttpClient::putAsync(const QUrl& _url, const QByteArray& _body, QObject* _context, const HttpCallback& _callback, const QString& _contentType) const
+{
+    HttpRequest request(HttpRequest::Put, _url);
+    request.body = _body;
+    request.contentType = _contentType;
+    send(request, _context, _callback);
+}
+
+void HttpClient::send(const HttpRequest& _request, QObject* _context, const HttpCallback& _callback) const
+{
+    HttpRequest request(_request);
+    if (this->m_CacheMode == HttpRequest::RefreshCache)
     {
-        request.setRawHeader(QString("Authorization").toLatin1(), QString("Bearer ").append(this->m_Token).toLatin1());
+        request.cacheMode = HttpRequest::RefreshCache;
     }
-    QNetworkReply* reply = this->m_Client->deleteResource(request);
-    QByteArray response =  waitFor(reply);
-    QVariant status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
-    _code = status.toInt();
-    if (_code == HttpStatusCode::StatusCode::TemporaryRedirect)
+    if (request.method == HttpRequest::Get)
     {
-        QVariant redirection = reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
-        response = deleteResource(redirection.toUrl(), _code);
+        ResponseCache* cache = ResponseCache::instance();
+        request.cacheKey = ResponseCache::key(request.url, this->m_Token);
+        HttpResponse cached;
+        if (request.cacheMode == HttpRequest::PreferCache && cache->lookup(request.cacheKey, cached))
+        {
+            //Still delivered from the event loop, callers see the same ordering as for a reply
+            QPointer<QObject> context(_context);
+            QMetaObject::invokeMethod(cache, [_context, context, _callback, cached]()
+            {
+                if (!_context || !context.isNull())
+                {
+                    _callback(cached);
+                }
+            }, Qt::QueuedConnection);
+            return;
+        }
+        cache->prepare(request.cacheKey, request);
 
-        qDebug() << "RedirectionTargetAttribute: " << redirection.toString() << Qt::endl;
+        RequestCoalescer* coalescer = RequestCoalescer::instance();
+        if (coalescer->join(request.cacheKey, _context, _callback))
+        {
+            return;
+        }
+        //The coalescer outlives every requester, so the waiters are served even if the first one is gone
+        QNetworkReply* reply = dispatch(request, this->m_Token);
+        connect(reply, &QNetworkReply::errorOccurred, this, &HttpClient::handleRequestError);
+        QString key = request.cacheKey;
+        QElapsedTimer timer;
+        timer.start();
+        watch(reply, request, this->m_Token, timer, coalescer, [key](const HttpResponse& _response)
+        {
+            RequestCoalescer::instance()->complete(key, _response);
+        });
+        return;
     }
-    reply->deleteLater();
-    return response;
+
+    QElapsedTimer timer;
+    timer.start();
+    QNetworkReply* reply = dispatch(request, this->m_Token);
+    connect(reply, &QNetworkReply::errorOccurred, this, &HttpClient::handleRequestError);
+    watch(reply, request, this->m_Token, timer, _context, _callback);
 }
 
-QByteArray HttpClient::post(const QUrl& _url, const QByteArray& _body, const QString& _contentType) const
+/**
+ * @brief Blocking wrapper around send(), spins a local event loop until the reply has finished.
+ * @param _request
+ * @return
+ */
+HttpResponse HttpClient::execute(const HttpRequest& _request) const
 {
-    QNetworkRequest request(_url);
-    setupRequest(request, _contentType, _body.length());
-    if (!this->m_Token.isEmpty())
+    HttpResponse response;
+    bool finished = false;
+    QEventLoop eventLoop;
+    send(_request, &eventLoop, [&response, &finished, &eventLoop](const HttpResponse& _response)
     {
-        request.setRawHeader(QString("Authorization").toLatin1(), QString("Bearer ").append(this->m_Token).toLatin1());
-    }
-    QNetworkReply* reply = this->m_Client->post(request, _body);
-    QByteArray response = waitFor(reply);
-    QVariant status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
-    int code = status.toInt();
-    if (code == HttpStatusCode::StatusCode::TemporaryRedirect)
+        response = _response;
+        finished = true;
+        eventLoop.quit();
+    });
+    if (!finished)
     {
-        QVariant redirection = reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
-        response = post(redirection.toUrl(), _body, _contentType);
-
-        qDebug() << "RedirectionTargetAttribute: " << redirection.toString() << Qt::endl;
+        eventLoop.exec(); //block until finish
     }
-    reply->deleteLater();
     return response;
 }
 
-QByteArray HttpClient::post(const QUrl& _url, const QByteArray& _body, int& _code, const QString& _contentType) const
+void HttpClient::stream(const HttpRequest& _request, QObject* _context, const HttpStreamCallback& _onData, const HttpCallback& _onFinished) const
 {
-    QNetworkRequest request(_url);
-    setupRequest(request, _contentType, _body.length());
-    if (!this->m_Token.isEmpty())
+    HttpRequest request(_request);
+    if (this->m_CacheMode == HttpRequest::RefreshCache)
     {
-        request.setRawHeader(QString("Authorization").toLatin1(), QString("Bearer ").append(this->m_Token).toLatin1());
+        request.cacheMode = HttpRequest::RefreshCache;
     }
-    QNetworkReply* reply = this->m_Client->post(request, _body);
-    QByteArray response = waitFor(reply);
-    QVariant status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
-    _code = status.toInt();
-    if (_code == HttpStatusCode::StatusCode::TemporaryRedirect)
+    if (request.method == HttpRequest::Get)
     {
-        QVariant redirection = reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
-        response = post(redirection.toUrl(), _body, _code, _contentType);
-
-        qDebug() << "RedirectionTargetAttribute: " << redirection.toString() << Qt::endl;
+        ResponseCache* cache = ResponseCache::instance();
+        request.cacheKey = ResponseCache::key(request.url, this->m_Token);
+        HttpResponse cached;
+        if (request.cacheMode == HttpRequest::PreferCache && cache->lookup(request.cacheKey, cached))
+        {
+            QPointer<QObject> context(_context);
+            QMetaObject::invokeMethod(cache, [_context, context, _onData, _onFinished, cached]()
+            {
+                if (_context && context.isNull())
+                {
+                    return;
+                }
+                _onData(cached.body);
+                HttpResponse response(cached);
+                response.body.clear();
+                _onFinished(response);
+            }, Qt::QueuedConnection);
+            return;
+        }
+        cache->prepare(request.cacheKey, request);
     }
-    reply->deleteLater();
-    return response;
+
+    QElapsedTimer timer;
+    timer.start();
+    QNetworkReply* reply = dispatch(request, this->m_Token);
+    connect(reply, &QNetworkReply::errorOccurred, this, &HttpClient::handleRequestError);
+    watchStream(reply, request, this->m_Token, timer, _context, _onData, _onFinished);
 }
 
-QByteArray HttpClient::post(const QUrl& _url, QHttpMultiPart* _multiPart, int& _code)
+/**
+ * @brief Blocking wrapper around stream(), the data callback runs while the event loop spins.
+ * @param _request
+ * @param _onData
+ * @return
+ */
+HttpResponse HttpClient::executeStream(const HttpRequest& _request, const HttpStreamCallback& _onData) const
 {
-    QNetworkRequest request(_url);
-    setupRequest(request);
-    if (!this->m_Token.isEmpty())
+    HttpResponse response;
+    bool finished = false;
+    QEventLoop eventLoop;
+    stream(_request, &eventLoop, _onData, [&response, &finished, &eventLoop](const HttpResponse& _response)
     {
-        request.setRawHeader(QString("Authorization").toLatin1(), QString("Bearer ").append(this->m_Token).toLatin1());
+        response = _response;
+        finished = true;
+        eventLoop.quit();
+    });
+    if (!finished)
+    {
+        eventLoop.exec(); //block until finish
     }
-    QNetworkReply* reply = this->m_Client->post(request, _multiPart);
-    QByteArray response = waitFor(reply);
-    _multiPart->setParent(reply);
-    QVariant status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
-    _code = status.toInt();
-    reply->deleteLater();
     return response;
 }
 
-QByteArray HttpClient::put(const QUrl& _url, const QByteArray& _body, const QString& _contentType) const
+QNetworkReply* HttpClient::dispatch(const HttpRequest& _request, const QString& _token)
 {
-    QNetworkRequest request(_url);
-    setupRequest(request, _contentType, _body.length());
-    if (!this->m_Token.isEmpty())
+    QNetworkAccessManager* manager = ConnectionPool::instance()->manager(_request.url);
+    QNetworkRequest request(_request.url);
+    ConnectionPool::instance()->setupRequest(request);
+    if (_request.method == HttpRequest::Post || _request.method == HttpRequest::Put)
     {
-        request.setRawHeader(QString("Authorization").toLatin1(), QString("Bearer ").append(this->m_Token).toLatin1());
+        setupRequest(request, _request.contentType, _request.multiPart ? 0 : _request.body.length());
     }
-    QNetworkReply* reply = this->m_Client->put(request, _body);
-    QByteArray response = waitFor(reply);
-    QVariant status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
-    int code = status.toInt();
-    if (code == HttpStatusCode::StatusCode::TemporaryRedirect)
+    if (!_token.isEmpty())
     {
-        QVariant redirection = reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
-        response = put(redirection.toUrl(), _body, _contentType);
-
-        qDebug() << "RedirectionTargetAttribute: " << redirection.toString() << Qt::endl;
+        request.setRawHeader(QString("Authorization").toLatin1(), QString("Bearer ").append(_token).toLatin1());
+    }
+    foreach (const QNetworkReply::RawHeaderPair& header, _request.headers)
+    {
+        request.setRawHeader(header.first, header.second);
     }
-    reply->deleteLater();
-    return response;
-}
 
-QByteArray HttpClient::put(const QUrl& _url, const QByteArray& _body, int& _code, const QString& _contentType) const
-{
-    QNetworkRequest request(_url);
-    setupRequest(request, _contentType, _body.length());
-    if (!this->m_Token.isEmpty())
+    QNetworkReply* reply = Q_NULLPTR;
+    switch (_request.method)
     {
-        request.setRawHeader(QString("Authorization").toLatin1(), QString("Bearer ").append(this->m_Token).toLatin1());
+    case HttpRequest::Get:
+        reply = manager->get(request);
+        break;
+    case HttpRequest::Post:
+        reply = _request.multiPart ? manager->post(request, _request.multiPart) : manager->post(request, _request.body);
+        break;
+    case HttpRequest::Put:
+        reply = _request.multiPart ? manager->put(request, _request.multiPart) : manager->put(request, _request.body);
+        break;
+    case HttpRequest::Delete:
+        reply = manager->deleteResource(request);
+        break;
     }
-    QNetworkReply* reply = this->m_Client->put(request, _body);
-    QByteArray response = waitFor(reply);
-    QVariant status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
-    _code = status.toInt();
-    if (_code == HttpStatusCode::StatusCode::TemporaryRedirect)
+    if (_request.multiPart)
     {
-        QVariant redirection = reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
-        response = put(redirection.toUrl(), _body, _code, _contentType);
-
-        qDebug() << "RedirectionTargetAttribute: " << redirection.toString() << Qt::endl;
+        _request.multiPart->setParent(reply);
     }
-    reply->deleteLater();
-    return response;
+    return reply;
 }
 
-QByteArray HttpClient::put(const QUrl& _url, QHttpMultiPart* _multiPart, int& _code)
+void HttpClient::watch(QNetworkReply* _reply, const HttpRequest& _request, const QString& _token, const QElapsedTimer& _timer, QObject* _context, const HttpCallback& _callback)
 {
-    QNetworkRequest request(_url);
-    setupRequest(request);
-    if (!this->m_Token.isEmpty())
+    QPointer<QObject> context(_context);
+    connect(_reply, &QNetworkReply::finished, _reply, [=]()
     {
-        request.setRawHeader(QString("Authorization").toLatin1(), QString("Bearer ").append(this->m_Token).toLatin1());
-    }
-    QNetworkReply* reply = this->m_Client->put(request, _multiPart);
-    QByteArray response = waitFor(reply);
-    _multiPart->setParent(reply);
-    QVariant status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
-    _code = status.toInt();
-    reply->deleteLater();
-    return response;
+        _reply->deleteLater();
+        if (_context && context.isNull())
+        {
+            return; //the requester has gone away
+        }
+
+        HttpResponse response;
+        response.code = _reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (response.code == HttpStatusCode::StatusCode::TemporaryRedirect && !_request.multiPart)
+        {
+            QVariant redirection = _reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
+            HttpRequest request(_request);
+            request.url = _request.url.resolved(redirection.toUrl());
+            qCDebug(lcHttp) << "RedirectionTargetAttribute: " << redirection.toString() << Qt::endl;
+
+            watch(dispatch(request, _token), request, _token, _timer, _context, _callback);
+            return;
+        }
+        response.headers = _reply->rawHeaderPairs();
+        response.body = _reply->readAll();
+        response.error = _reply->error();
+        if (response.error != QNetworkReply::NoError)
+        {
+            response.errorDesc = _reply->errorString();
+        }
+
+        //Latency includes the redirects, urls outside of the admin api are lumped together
+        QString endpoint = EndpointTemplates::instance()->match(_request.method, _request.url);
+        bool failed = response.error != QNetworkReply::NoError && response.code != 304;
+        EndpointMetrics::instance()->record(endpoint.isEmpty() ? QString("OTHER") : endpoint, _timer.elapsed(), response.body.size(), _request.body.size(), failed);
+
+        if (_request.method == HttpRequest::Get)
+        {
+            if (response.code == 304)
+            {
+                response = ResponseCache::instance()->revalidated(_request.cacheKey, _request, response);
+            }
+            else
+            {
+                ResponseCache::instance()->store(_request.cacheKey, _request, response);
+            }
+        }
+        else if (response.isSuccess())
+        {
+            //Whatever was read below or above the changed resource is outdated now
+            ResponseCache::instance()->invalidate(_request.url);
+        }
+        _callback(response);
+    });
+}
+
+namespace
+{
+struct StreamState
+{
+    StreamState() : received(0), cacheable(false) {}
+
+    qint64 received;
+    bool cacheable;
+    QByteArray cached;
+    QByteArray error;
+};
 }
 
-void HttpClient::setupRequest(QNetworkRequest& _req, const QString& _contentType, int _length) const
+void HttpClient::watchStream(QNetworkReply* _reply, const HttpRequest& _request, const QString& _token, const QElapsedTimer& _timer, QObject* _context, const HttpStreamCallback& _onData, const HttpCallback& _onFinished)
 {
-    QString scheme = _req.url().scheme();
-    if (scheme == "https")
+    QPointer<QObject> context(_context);
+    QSharedPointer<StreamState> state(new StreamState);
+    ResponseCache* cache = ResponseCache::instance();
+    state->cacheable = cache->ttl(_request) > 0;
+    int limit = cache->maxStreamedBody();
+
+    //Small bodies are kept for the cache as well, large ones are only passed through
+    auto consume = [=](const QByteArray& _chunk)
     {
-        QSslConfiguration config;
-        config.setPeerVerifyMode(QSslSocket::VerifyNone);
-        config.setProtocol(QSsl::TlsV1_3);
-        _req.setSslConfiguration(config);
-    }
+        if (_chunk.isEmpty())
+        {
+            return;
+        }
+        state->received += _chunk.size();
+        int code = _reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (code < 200 || code >= 300)
+        {
+            state->error.append(_chunk);
+            return;
+        }
+        if (state->cacheable)
+        {
+            if (state->cached.size() + _chunk.size() <= limit)
+            {
+                state->cached.append(_chunk);
+            }
+            else
+            {
+                state->cacheable = false;
+                state->cached.clear();
+            }
+        }
+        if (!_context || !context.isNull())
+        {
+            _onData(_chunk);
+        }
+    };
+
+    connect(_reply, &QNetworkReply::readyRead, _reply, [=]()
+    {
+        int code = _reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (code == HttpStatusCode::StatusCode::TemporaryRedirect || code == 304)
+        {
+            return; //not the body of the resource, finished() takes care
+        }
+        consume(_reply->readAll());
+    });
+    connect(_reply, &QNetworkReply::finished, _reply, [=]()
+    {
+        _reply->deleteLater();
+        if (_context && context.isNull())
+        {
+            return;
+        }
+
+        HttpResponse response;
+        response.code = _reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (response.code == HttpStatusCode::StatusCode::TemporaryRedirect && !_request.multiPart)
+        {
+            QVariant redirection = _reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
+            HttpRequest request(_request);
+            request.url = _request.url.resolved(redirection.toUrl());
+            qCDebug(lcHttp) << "RedirectionTargetAttribute: " << redirection.toString() << Qt::endl;
+
+            watchStream(dispatch(request, _token), request, _token, _timer, _context, _onData, _onFinished);
+            return;
+        }
+        if (response.code != 304)
+        {
+            consume(_reply->readAll());
+        }
+        response.headers = _reply->rawHeaderPairs();
+        response.body = state->error;
+        response.error = _reply->error();
+        if (response.error != QNetworkReply::NoError)
+        {
+            response.errorDesc = _reply->errorString();
+        }
+
+        QString endpoint = EndpointTemplates::instance()->match(_request.method, _request.url);
+        bool failed = response.error != QNetworkReply::NoError && response.code != 304;
+        EndpointMetrics::instance()->record(endpoint.isEmpty() ? QString("OTHER") : endpoint, _timer.elapsed(), state->received, _request.body.size(), failed);
+
+        if (_request.method == HttpRequest::Get)
+        {
+            if (response.code == 304)
+            {
+                HttpResponse cached = ResponseCache::instance()->revalidated(_request.cacheKey, _request, response);
+                _onData(cached.body);
+                response.code = cached.code;
+                response.headers = cached.headers;
+            }
+            else if (response.isSuccess() && state->cacheable)
+            {
+                HttpResponse stored(response);
+                stored.body = state->cached;
+                ResponseCache::instance()->store(_request.cacheKey, _request, stored);
+            }
+        }
+        else if (response.isSuccess())
+        {
+            ResponseCache::instance()->invalidate(_request.url);
+        }
+        _onFinished(response);
+    });
+}
+
+void HttpClient::setupRequest(QNetworkRequest& _req, const QString& _contentType, int _length)
+{
     if (_length > 0)
     {
         _req.setHeader(QNetworkRequest::ContentTypeHeader, _contentType);
@@ -255,15 +495,5 @@ void HttpClient::setupRequest(QNetworkRequest& _req, const QString& _contentType
 
 void HttpClient::handleRequestError(QNetworkReply::NetworkError _error)
 {
-    qDebug() << "Http request has occurred error: " << _error/* == QNetworkReply::NetworkError::OperationCanceledError*/ << Qt::endl;
-}
-
-QByteArray HttpClient::waitFor(QNetworkReply* reply) const
-{
-    QEventLoop eventLoop;
-    connect(reply, &QNetworkReply::errorOccurred, this, &HttpClient::handleRequestError);
-    connect(this->m_Client, SIGNAL(finished(QNetworkReply*)), &eventLoop, SLOT(quit()));
-    connect(reply, &QNetworkReply::errorOccurred, &eventLoop, &QEventLoop::quit);
-    eventLoop.exec(); //block until finish
-    return reply->readAll();
+    qCWarning(lcHttp) << "Http request has occurred error: " << _error/* == QNetworkReply::NetworkError::OperationCanceledError*/ << Qt::endl;
 }
@@ -5,6 +5,11 @@
 #include <QNetworkReply>
 #include <QNetworkRequest>
 #include <QUrl>
+#include <QElapsedTimer>
+
+#include <functional>
+
+class QHttpMultiPart;
 
 struct HttpStatusCode
 {
@@ -32,6 +37,53 @@ struct HttpStatusCode
     StatusCode code;
 };
 
+/**
+ * @brief A request description for the asynchronous api of HttpClient.
+ */
+struct HttpRequest
+{
+    enum Method
+    {
+        Get = 0, Post, Put, Delete
+    };
+
+    enum CacheMode
+    {
+        PreferCache = 0, RefreshCache
+    };
+
+    HttpRequest(const HttpRequest::Method& _method, const QUrl& _url) : method(_method), url(_url), multiPart(nullptr), contentType("application/json"), cacheMode(HttpRequest::PreferCache) {}
+
+    HttpRequest::Method method;
+    QUrl url;
+    QByteArray body;
+    QHttpMultiPart* multiPart;
+    QString contentType;
+    QList<QNetworkReply::RawHeaderPair> headers;
+    HttpRequest::CacheMode cacheMode;
+    QString cacheKey;
+};
+
+/**
+ * @brief The status, headers and body of a finished request.
+ */
+struct HttpResponse
+{
+    HttpResponse() : code(0), error(QNetworkReply::NoError) {}
+
+    inline bool isSuccess() const { return this->code >= 200 && this->code < 300; }
+    QByteArray header(const QByteArray& _name) const;
+
+    int code;
+    QList<QNetworkReply::RawHeaderPair> headers;
+    QByteArray body;
+    QNetworkReply::NetworkError error;
+    QString errorDesc;
+};
+
+typedef std::function<void(const HttpResponse&)> HttpCallback;
+typedef std::function<void(const QByteArray&)> HttpStreamCallback;
+
 class HttpClient : public QObject
 {
 public:
@@ -52,16 +104,45 @@ public:
     QByteArray deleteResource(const QUrl& _url) const;
     QByteArray deleteResource(const QUrl& _url, int& _code) const;
 
+    /**
+     * Issue the request without blocking, the callback runs on the caller's thread once the
+     * reply has finished. It is dropped if the context object is destroyed before that.
+     */
+    void send(const HttpRequest& _request, QObject* _context, const HttpCallback& _callback) const;
+    HttpResponse execute(const HttpRequest& _request) const;
+
+    /**
+     * Like send(), but the body of a successful response is handed to the data callback chunk by
+     * chunk as it arrives, the finished callback gets the status and headers only. Error bodies
+     * are still delivered whole in the response. Streamed requests are not coalesced.
+     */
+    void stream(const HttpRequest& _request, QObject* _context, const HttpStreamCallback& _onData, const HttpCallback& _onFinished) const;
+    HttpResponse executeStream(const HttpRequest& _request, const HttpStreamCallback& _onData) const;
+
+    inline void getAsync(const QUrl& _url, QObject* _context, const HttpCallback& _callback) const { send(HttpRequest(HttpRequest::Get, _url), _context, _callback); }
+    void postAsync(const QUrl& _url, const QByteArray& _body, QObject* _context, const HttpCallback& _callback, const QString& _contentType = "application/json") const;
+    void putAsync(const QUrl& _url, const QByteArray& _body, QObject* _context, const HttpCallback& _callback, const QString& _contentType = "application/json") const;
+    inline void deleteAsync(const QUrl& _url, QObject* _context, const HttpCallback& _callback) const { send(HttpRequest(HttpRequest::Delete, _url), _context, _callback); }
+
     inline void setToken(const QString& _token) { this->m_Token = _token; }
     inline QString token() const { return this->m_Token; }
 
+    /**
+     * RefreshCache skips the cached responses for the requests issued from now on, they are
+     * still stored for the next reader.
+     */
+    inline void setCacheMode(const HttpRequest::CacheMode& _mode) { this->m_CacheMode = _mode; }
+    inline HttpRequest::CacheMode cacheMode() const { return this->m_CacheMode; }
+
 protected:
-    QByteArray waitFor(QNetworkReply* _reply) const;
-    void setupRequest(QNetworkRequest& _req, const QString& _contentType = "application/json", int _length = 0) const;
+    static QNetworkReply* dispatch(const HttpRequest& _request, const QString& _token);
+    static void watch(QNetworkReply* _reply, const HttpRequest& _request, const QString& _token, const QElapsedTimer& _timer, QObject* _context, const HttpCallback& _callback);
+    static void watchStream(QNetworkReply* _reply, const HttpRequest& _request, const QString& _token, const QElapsedTimer& _timer, QObject* _context, const HttpStreamCallback& _onData, const HttpCallback& _onFinished);
+    static void setupRequest(QNetworkRequest& _req, const QString& _contentType = "application/json", int _length = 0);
 
 private:
-    QNetworkAccessManager* m_Client;
     QString m_Token;
+    HttpRequest::CacheMode m_CacheMode;
 
 private slots:
     void handleRequestError(QNetworkReply::NetworkError);
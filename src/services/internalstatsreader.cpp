@@ -0,0 +1,209 @@
+#include "internalstatsreader.h"
+
+#include "../logging.h"
+
+
+InternalStatsReader::InternalStatsReader(const QString& _cursor) : m_Section(InternalStatsReader::Root), m_CursorName(_cursor), m_HasCursor(false), m_TotalSize(0), m_Entries(0), m_CurrentLedgerEntries(0), m_CurrentLedgerSize(0) {}
+
+void InternalStatsReader::addData(const QByteArray& _data)
+{
+    this->m_Reader.addData(_data);
+    parse();
+}
+
+/**
+ * @brief The whole document has been added.
+ * @return false if it was truncated or malformed
+ */
+bool InternalStatsReader::finish()
+{
+    this->m_Reader.finish();
+    parse();
+    if (this->m_Reader.hasError())
+    {
+        qCWarning(lcTopic) << "Parse internal stats error: " << this->m_Reader.errorString() << Qt::endl;
+    }
+    return this->m_Reader.tokenType() == JsonReader::EndDocument;
+}
+
+/**
+ * @brief The last ledger is the one being written, its size is only known from currentLedger*.
+ * @return
+ */
+TopicStorage InternalStatsReader::storage() const
+{
+    TopicStorage storage;
+    storage.setStorageSize(this->m_TotalSize);
+    storage.setEntryNum(this->m_Entries);
+    storage.setSegmentNum(this->m_Segments.size());
+    TopicSegments segments(this->m_Segments);
+    for (int i = 0, n = segments.size(); i < n; ++i)
+    {
+        if (i < n - 1)
+        {
+            segments[i].setStatus(TopicSegment::Status::CLOSE);
+        }
+        else
+        {
+            segments[i].setEntries(this->m_CurrentLedgerEntries);
+            segments[i].setSize(this->m_CurrentLedgerSize);
+            segments[i].setStatus(TopicSegment::Status::OPEN);
+        }
+    }
+    storage.setSegments(segments);
+    return storage;
+}
+
+void InternalStatsReader::parse()
+{
+    forever
+    {
+        JsonReader::TokenType token = this->m_Reader.readNext();
+        if (token == JsonReader::NeedMoreData || token == JsonReader::EndDocument || token == JsonReader::Invalid)
+        {
+            return;
+        }
+        int depth = this->m_Reader.depth();
+        QString name = this->m_Reader.name();
+        switch (token)
+        {
+        case JsonReader::StartObject:
+            if (depth == 1)
+            {
+                break;
+            }
+            if (depth == 2 && this->m_Section == InternalStatsReader::Root && name == "cursors")
+            {
+                this->m_Section = InternalStatsReader::Cursors;
+            }
+            else if (depth == 3 && this->m_Section == InternalStatsReader::Ledgers)
+            {
+                this->m_Section = InternalStatsReader::Ledger;
+                this->m_Segment = TopicSegment();
+                this->m_Segment.setLedgerId(0);
+                this->m_Segment.setEntries(0);
+                this->m_Segment.setSize(0);
+                this->m_Segment.setOffload(false);
+            }
+            else if (depth == 3 && this->m_Section == InternalStatsReader::Cursors && (this->m_CursorName.isEmpty() || name == this->m_CursorName) && !this->m_HasCursor)
+            {
+                this->m_Section = InternalStatsReader::CursorObject;
+                this->m_Cursor = Cursor();
+                this->m_Cursor.setName(name);
+            }
+            else
+            {
+                this->m_Reader.skipCurrent();
+            }
+            break;
+        case JsonReader::StartArray:
+            if (depth == 2 && this->m_Section == InternalStatsReader::Root && name == "ledgers")
+            {
+                this->m_Section = InternalStatsReader::Ledgers;
+            }
+            else
+            {
+                this->m_Reader.skipCurrent();
+            }
+            break;
+        case JsonReader::EndObject:
+            if (this->m_Section == InternalStatsReader::Ledger)
+            {
+                this->m_Segments.append(this->m_Segment);
+                this->m_Section = InternalStatsReader::Ledgers;
+            }
+            else if (this->m_Section == InternalStatsReader::CursorObject)
+            {
+                this->m_HasCursor = true;
+                this->m_Section = InternalStatsReader::Cursors;
+            }
+            else if (this->m_Section == InternalStatsReader::Cursors)
+            {
+                this->m_Section = InternalStatsReader::Root;
+            }
+            break;
+        case JsonReader::EndArray:
+            this->m_Section = InternalStatsReader::Root;
+            break;
+        case JsonReader::String:
+        case JsonReader::Number:
+        case JsonReader::Bool:
+            if (this->m_Section == InternalStatsReader::Root && depth == 1)
+            {
+                if (name == "totalSize")
+                {
+                    this->m_TotalSize = this->m_Reader.toInteger();
+                }
+                else if (name == "numberOfEntries")
+                {
+                    this->m_Entries = this->m_Reader.toInteger();
+                }
+                else if (name == "currentLedgerEntries")
+                {
+                    this->m_CurrentLedgerEntries = this->m_Reader.toInteger();
+                }
+                else if (name == "currentLedgerSize")
+                {
+                    this->m_CurrentLedgerSize = this->m_Reader.toInteger();
+                }
+            }
+            else if (this->m_Section == InternalStatsReader::Ledger)
+            {
+                readLedgerField();
+            }
+            else if (this->m_Section == InternalStatsReader::CursorObject)
+            {
+                readCursorField();
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void InternalStatsReader::readLedgerField()
+{
+    QString name = this->m_Reader.name();
+    if (name == "ledgerId")
+    {
+        this->m_Segment.setLedgerId(this->m_Reader.toInteger());
+    }
+    else if (name == "entries")
+    {
+        this->m_Segment.setEntries(this->m_Reader.toInteger());
+    }
+    else if (name == "size")
+    {
+        this->m_Segment.setSize(this->m_Reader.toInteger());
+    }
+    else if (name == "offloaded")
+    {
+        this->m_Segment.setOffload(this->m_Reader.toBool());
+    }
+}
+
+void InternalStatsReader::readCursorField()
+{
+    QString name = this->m_Reader.name();
+    if (name == "markDeletePosition")
+    {
+        this->m_Cursor.setMarkDeletePosition(this->m_Reader.text());
+    }
+    else if (name == "readPosition")
+    {
+        this->m_Cursor.setReadPosition(this->m_Reader.text());
+    }
+    else if (name == "waitingReadOp")
+    {
+        this->m_Cursor.setWaitingReadOp(this->m_Reader.toBool());
+    }
+    else if (name == "pendingReadOps")
+    {
+        this->m_Cursor.setPendingReadOps(this->m_Reader.toInteger());
+    }
+    else if (name == "numberOfEntriesSinceFirstNotAckedMessage")
+    {
+        this->m_Cursor.setEntries(this->m_Reader.toInteger());
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef INTERNALSTATSREADER_H
+#define INTERNALSTATSREADER_H
+
+#include "../jsonreader.h"
+#include "../topic.h"
+#include "../cursor.h"
+
+/**
+ * @brief Maps the internalStats document of a topic into TopicStorage and Cursor while its
+ * bytes are still arriving. Only the fields used by the windows are kept, everything else,
+ * including the cursors that were not asked for, is skipped without being decoded.
+ */
+class InternalStatsReader
+{
+public:
+    explicit InternalStatsReader(const QString& _cursor = QString());
+
+    void addData(const QByteArray& _data);
+    bool finish();
+
+    inline bool hasError() const { return this->m_Reader.hasError(); }
+    inline QString errorString() const { return this->m_Reader.errorString(); }
+
+    TopicStorage storage() const;
+    inline bool hasCursor() const { return this->m_HasCursor; }
+    inline Cursor cursor() const { return this->m_Cursor; }
+
+private:
+    void parse();
+    void readLedgerField();
+    void readCursorField();
+
+private:
+    enum Section
+    {
+        Root = 0, Ledgers, Ledger, Cursors, CursorObject
+    };
+
+    JsonReader m_Reader;
+    Section m_Section;
+    QString m_CursorName;
+    bool m_HasCursor;
+    Cursor m_Cursor;
+    TopicSegment m_Segment;
+    TopicSegments m_Segments;
+    qint64 m_TotalSize;
+    qint64 m_Entries;
+    qint64 m_CurrentLedgerEntries;
+    qint64 m_CurrentLedgerSize;
+};
+
+#endif // INTERNALSTATSREADER_H
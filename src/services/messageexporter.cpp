@@ -0,0 +1,388 @@
+#include "messageexporter.h"
+
+#include <QPointer>
+#include <QThreadPool>
+#include <QCoreApplication>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QSaveFile>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringDecoder>
+#include <QtEndian>
+
+#include <memory>
+
+#include <pulsar/Client.h>
+
+#include "../logging.h"
+
+using namespace pulsar;
+
+/**
+ * @brief The state shared by the worker writing the file and the callbacks of the reader, the
+ * callbacks keep it alive until the reader is closed.
+ */
+struct MessageExporter::Job
+{
+    QPointer<MessageExporter> owner;
+    QString serviceUrl;
+    QString topic;
+    QString authToken;
+    QString fileName;
+    Range range;
+    Format format;
+    int readAhead;
+    int maxBuffered;
+    int receiverQueueSize;
+
+    std::unique_ptr<Client> client;
+    Reader reader;
+
+    QMutex mutex;
+    QWaitCondition ready;
+    QQueue<Message> queue;
+    int pending = 0;
+    Result result = ResultOk;
+    QAtomicInt cancelled;
+
+    qint64 messages = 0;
+    qint64 bytes = 0;
+    QString error;
+};
+
+namespace
+{
+const int FLUSH_BYTES = 1024 * 1024;
+const int PROGRESS_INTERVAL = 200;
+
+QJsonObject header(const Message& _message)
+{
+    const MessageId& id = _message.getMessageId();
+    QJsonObject object;
+    object.insert("ledgerId", static_cast<qint64>(id.ledgerId()));
+    object.insert("entryId", static_cast<qint64>(id.entryId()));
+    if (id.batchIndex() >= 0)
+    {
+        object.insert("batchIndex", id.batchIndex());
+    }
+    object.insert("publishTime", static_cast<qint64>(_message.getPublishTimestamp()));
+    if (_message.getEventTimestamp() > 0)
+    {
+        object.insert("eventTime", static_cast<qint64>(_message.getEventTimestamp()));
+    }
+    if (_message.hasPartitionKey())
+    {
+        object.insert("key", QString::fromStdString(_message.getPartitionKey()));
+    }
+    if (_message.hasOrderingKey())
+    {
+        object.insert("orderingKey", QString::fromStdString(_message.getOrderingKey()));
+    }
+    const Message::StringMap& properties = _message.getProperties();
+    if (!properties.empty())
+    {
+        QJsonObject map;
+        for (const auto& property : properties)
+        {
+            map.insert(QString::fromStdString(property.first), QString::fromStdString(property.second));
+        }
+        object.insert("properties", map);
+    }
+    return object;
+}
+
+void appendLength(QByteArray& _buffer, const qsizetype& _length)
+{
+    quint32 length = qToBigEndian(static_cast<quint32>(_length));
+    _buffer.append(reinterpret_cast<const char*>(&length), sizeof(length));
+}
+
+void write(const MessageExporter::Format& _format, const Message& _message, QByteArray& _buffer)
+{
+    QJsonObject object = header(_message);
+    QByteArray payload = QByteArray::fromRawData(static_cast<const char*>(_message.getData()), static_cast<qsizetype>(_message.getLength()));
+    if (_format == MessageExporter::LengthPrefixed)
+    {
+        QByteArray json = QJsonDocument(object).toJson(QJsonDocument::Compact);
+        appendLength(_buffer, json.size());
+        _buffer.append(json);
+        appendLength(_buffer, payload.size());
+        _buffer.append(payload);
+        return;
+    }
+    QStringDecoder decoder(QStringDecoder::Utf8, QStringDecoder::Flag::Stateless);
+    QString text = decoder.decode(payload);
+    if (decoder.hasError())
+    {
+        object.insert("payloadBase64", QString::fromLatin1(payload.toBase64()));
+    }
+    else
+    {
+        object.insert("payload", text);
+    }
+    _buffer.append(QJsonDocument(object).toJson(QJsonDocument::Compact));
+    _buffer.append('\n');
+}
+
+/**
+ * @brief Whether _id is in an entry after the one of _last.
+ */
+bool isAfter(const MessageId& _id, const MessageId& _last)
+{
+    return _id.ledgerId() > _last.ledgerId() || (_id.ledgerId() == _last.ledgerId() && _id.entryId() > _last.entryId());
+}
+
+bool isLastEntry(const MessageId& _id, const MessageId& _last)
+{
+    return _id.ledgerId() == _last.ledgerId() && _id.entryId() == _last.entryId();
+}
+}
+
+MessageExporter::MessageExporter(QObject* parent) : QObject(parent), m_ReadAhead(64), m_MaxBufferedMessages(10000), m_ReceiverQueueSize(1000)
+{
+}
+
+MessageExporter::~MessageExporter()
+{
+    cancel();
+}
+
+/**
+ * @brief Start an export, the one running is cancelled and reports no more.
+ */
+void MessageExporter::start(const QString& _serviceUrl, const QString& _topic, const QString& _authToken, const Range& _range, const Format& _format, const QString& _fileName)
+{
+    cancel();
+    QSharedPointer<Job> job(new Job);
+    job->owner = this;
+    job->serviceUrl = _serviceUrl;
+    job->topic = _topic;
+    job->authToken = _authToken;
+    job->fileName = _fileName;
+    job->range = _range;
+    job->format = _format;
+    job->readAhead = this->m_ReadAhead;
+    job->maxBuffered = qMax(this->m_MaxBufferedMessages, this->m_ReadAhead);
+    job->receiverQueueSize = this->m_ReceiverQueueSize;
+    this->m_Job = job;
+    qCInfo(lcTopic) << "export" << _topic << "from" << _serviceUrl << "to" << _fileName << Qt::endl;
+    QThreadPool::globalInstance()->start([job]()
+    {
+        run(job);
+    });
+}
+
+/**
+ * @brief Stop the running export, finished() still comes once the worker has let go of the
+ * file, which is then left as it was. A job replaced by start() reports nothing more.
+ */
+void MessageExporter::cancel()
+{
+    if (this->m_Job.isNull())
+    {
+        return;
+    }
+    QMutexLocker locker(&this->m_Job->mutex);
+    this->m_Job->cancelled.storeRelaxed(1);
+    this->m_Job->ready.wakeAll();
+}
+
+/**
+ * @brief Keep readAhead reads pending, less when the queue would go over maxBuffered. The reads
+ * are made outside the lock since the reader calls back right away when it has a message.
+ */
+void MessageExporter::pump(const QSharedPointer<Job>& _job)
+{
+    int reads = 0;
+    {
+        QMutexLocker locker(&_job->mutex);
+        if (_job->result == ResultOk && _job->cancelled.loadRelaxed() == 0)
+        {
+            reads = qMin(_job->readAhead - _job->pending, _job->maxBuffered - _job->pending - static_cast<int>(_job->queue.size()));
+            reads = qMax(0, reads);
+            _job->pending += reads;
+        }
+    }
+    for (int i = 0; i < reads; i++)
+    {
+        _job->reader.readNextAsync([_job](Result _result, const Message& _message)
+        {
+            QMutexLocker locker(&_job->mutex);
+            _job->pending--;
+            if (_result == ResultOk)
+            {
+                _job->queue.enqueue(_message);
+            }
+            else if (_job->result == ResultOk && _job->cancelled.loadRelaxed() == 0)
+            {
+                _job->result = _result;
+            }
+            _job->ready.wakeAll();
+        });
+    }
+}
+
+void MessageExporter::run(const QSharedPointer<Job>& _job)
+{
+    ClientConfiguration configuration;
+    if (!_job->authToken.isEmpty())
+    {
+        configuration.setAuth(AuthToken::createWithToken(_job->authToken.toStdString()));
+    }
+    _job->client.reset(new Client(_job->serviceUrl.toStdString(), configuration));
+
+    ReaderConfiguration readerConfiguration;
+    readerConfiguration.setReceiverQueueSize(_job->receiverQueueSize);
+    readerConfiguration.setStartMessageIdInclusive(true);
+    MessageId start = _job->range.ledgerId >= 0 ? MessageId(-1, _job->range.ledgerId, _job->range.entryId, -1) : MessageId::earliest();
+    Result result = _job->client->createReader(_job->topic.toStdString(), start, readerConfiguration, _job->reader);
+    if (result == ResultOk && _job->range.startTime.isValid())
+    {
+        result = _job->reader.seek(static_cast<uint64_t>(_job->range.startTime.toMSecsSinceEpoch()));
+    }
+
+    MessageId last;
+    bool hasLast = false;
+    bool done = false;
+    if (result == ResultOk)
+    {
+        //Non-persistent topics have no last message, they are read until a limit or cancel().
+        hasLast = _job->reader.getLastMessageId(last) == ResultOk;
+        bool available = true;
+        done = hasLast && (last.entryId() < 0 || (_job->reader.hasMessageAvailable(available) == ResultOk && !available));
+    }
+
+    QSaveFile file(_job->fileName);
+    if (result != ResultOk)
+    {
+        _job->error = QCoreApplication::translate("MessageExporter", "The reader could not be created: %1").arg(strResult(result));
+    }
+    else if (!file.open(QIODevice::WriteOnly))
+    {
+        _job->error = file.errorString();
+    }
+    else
+    {
+        QByteArray buffer;
+        buffer.reserve(FLUSH_BYTES + FLUSH_BYTES / 4);
+        QElapsedTimer elapsed;
+        elapsed.start();
+        bool atTail = false;
+        qint64 max = _job->range.maxMessages;
+        qint64 endTime = _job->range.endTime.isValid() ? _job->range.endTime.toMSecsSinceEpoch() : -1;
+        while (!done && _job->cancelled.loadRelaxed() == 0)
+        {
+            pump(_job);
+            QQueue<Message> batch;
+            {
+                QMutexLocker locker(&_job->mutex);
+                while (_job->queue.isEmpty() && _job->result == ResultOk && _job->cancelled.loadRelaxed() == 0 && !atTail)
+                {
+                    _job->ready.wait(&_job->mutex);
+                }
+                batch.swap(_job->queue);
+                result = _job->result;
+            }
+            if (batch.isEmpty() && atTail && result == ResultOk)
+            {
+                //The last entry was reached, only the rest of its batch may still come.
+                bool available = true;
+                done = _job->reader.hasMessageAvailable(available) == ResultOk && !available;
+                atTail = false;
+                continue;
+            }
+            while (!batch.isEmpty() && !done)
+            {
+                Message message = batch.dequeue();
+                const MessageId& id = message.getMessageId();
+                if ((hasLast && isAfter(id, last)) || (endTime >= 0 && static_cast<qint64>(message.getPublishTimestamp()) > endTime))
+                {
+                    done = true;
+                    break;
+                }
+                write(_job->format, message, buffer);
+                _job->messages++;
+                atTail = hasLast && isLastEntry(id, last);
+                done = max > 0 && _job->messages >= max;
+            }
+            if (buffer.size() >= FLUSH_BYTES)
+            {
+                _job->bytes += file.write(buffer);
+                buffer.clear();
+            }
+            if (result != ResultOk && !done)
+            {
+                _job->error = QCoreApplication::translate("MessageExporter", "Reading the topic failed: %1").arg(strResult(result));
+                break;
+            }
+            if (elapsed.elapsed() >= PROGRESS_INTERVAL)
+            {
+                report(_job, false);
+                elapsed.restart();
+            }
+        }
+        if (!buffer.isEmpty())
+        {
+            _job->bytes += file.write(buffer);
+        }
+        if (_job->cancelled.loadRelaxed() != 0 && _job->error.isEmpty())
+        {
+            _job->error = QCoreApplication::translate("MessageExporter", "The export was cancelled.");
+        }
+        if (!_job->error.isEmpty())
+        {
+            file.cancelWriting();
+        }
+        else if (!file.commit())
+        {
+            _job->error = file.errorString();
+        }
+    }
+
+    {
+        //The reads still pending fail once the reader is closed, they must not count as errors.
+        QMutexLocker locker(&_job->mutex);
+        _job->cancelled.storeRelaxed(1);
+    }
+    _job->reader.close();
+    _job->client->close();
+    //Let go of them here, not on the thread of the client running the last failed callback.
+    _job->reader = Reader();
+    _job->client.reset();
+    if (_job->error.isEmpty())
+    {
+        qCInfo(lcTopic) << "exported" << _job->messages << "messages of" << _job->topic << Qt::endl;
+    }
+    else
+    {
+        qCWarning(lcTopic) << "export of" << _job->topic << "failed:" << _job->error << Qt::endl;
+    }
+    report(_job, true);
+}
+
+void MessageExporter::report(const QSharedPointer<Job>& _job, const bool& _finished)
+{
+    qint64 messages = _job->messages;
+    qint64 bytes = _job->bytes;
+    QString error = _job->error;
+    QMetaObject::invokeMethod(QCoreApplication::instance(), [_job, _finished, messages, bytes, error]()
+    {
+        MessageExporter* owner = _job->owner;
+        if (!owner || owner->m_Job != _job)
+        {
+            return;
+        }
+        if (_finished)
+        {
+            owner->m_Job.reset();
+            emit owner->finished(error, messages, bytes);
+        }
+        else
+        {
+            emit owner->progress(messages, bytes);
+        }
+    }, Qt::QueuedConnection);
+}
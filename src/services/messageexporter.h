@@ -0,0 +1,86 @@
+#ifndef MESSAGEEXPORTER_H
+#define MESSAGEEXPORTER_H
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QDateTime>
+
+/**
+ * @brief Writes a range of a topic to a local file with the Pulsar client Reader.
+ *
+ * The range starts at the earliest message, at a message id or at a publish time, and ends at
+ * the last message of the topic when the export started, at an end publish time or after a
+ * number of messages, whichever comes first. Non-persistent topics have no last message and are
+ * read until one of the other limits or cancel().
+ *
+ * The export runs on a worker thread. Up to readAhead() reads are kept pending on the reader,
+ * the messages they return wait in a queue of at most maxBufferedMessages() until the worker
+ * writes them, no new reads are made while the queue is full. The file is written as a whole
+ * or not at all.
+ *
+ * Ndjson writes one JSON object per line with the id, the times, the key, the properties and the
+ * payload, as text when it is UTF-8 or as payloadBase64 otherwise. LengthPrefixed writes per
+ * message the length of the header as a big-endian 32 bit integer, the header as the same JSON
+ * object without the payload, the length of the payload the same way and the payload.
+ */
+class MessageExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Format
+    {
+        Ndjson,
+        LengthPrefixed
+    };
+
+    struct Range
+    {
+        qint64 ledgerId = -1;           //with entryId the first message, -1 to start at the earliest
+        qint64 entryId = -1;
+        QDateTime startTime;            //if valid, the first message published at or after it
+        QDateTime endTime;              //if valid, the export ends at the first message published after it
+        qint64 maxMessages = 0;         //0 for no limit
+    };
+
+    explicit MessageExporter(QObject* parent = nullptr);
+    ~MessageExporter();
+
+    inline void setReadAhead(const int& _reads) { this->m_ReadAhead = qMax(1, _reads); }
+    inline int readAhead() const { return this->m_ReadAhead; }
+    inline void setMaxBufferedMessages(const int& _max) { this->m_MaxBufferedMessages = qMax(1, _max); }
+    inline int maxBufferedMessages() const { return this->m_MaxBufferedMessages; }
+    inline void setReceiverQueueSize(const int& _size) { this->m_ReceiverQueueSize = qMax(1, _size); }
+    inline int receiverQueueSize() const { return this->m_ReceiverQueueSize; }
+
+    /**
+     * @param _serviceUrl the broker service url, pulsar://host:6650
+     * @param _topic the full name of a non-partitioned topic or of one partition
+     * @param _authToken the token of the cluster, empty when it has no authentication
+     */
+    void start(const QString& _serviceUrl, const QString& _topic, const QString& _authToken, const Range& _range, const Format& _format, const QString& _fileName);
+    void cancel();
+    inline bool isRunning() const { return !this->m_Job.isNull(); }
+
+signals:
+    void progress(qint64 _messages, qint64 _bytes);
+    /**
+     * @brief The export is done, _error is empty when the file was written.
+     */
+    void finished(const QString& _error, qint64 _messages, qint64 _bytes);
+
+private:
+    struct Job;
+
+    static void run(const QSharedPointer<Job>& _job);
+    static void pump(const QSharedPointer<Job>& _job);
+    static void report(const QSharedPointer<Job>& _job, const bool& _finished);
+
+private:
+    QSharedPointer<Job> m_Job;
+    int m_ReadAhead;
+    int m_MaxBufferedMessages;
+    int m_ReceiverQueueSize;
+};
+
+#endif // MESSAGEEXPORTER_H
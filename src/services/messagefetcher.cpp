@@ -0,0 +1,200 @@
+#include "messagefetcher.h"
+
+#include <QSharedPointer>
+#include <QPointer>
+#include <QThreadPool>
+#include <QCoreApplication>
+
+#include <algorithm>
+
+#include "requestqueue.h"
+#include "internalstatsreader.h"
+#include "topicservice.h"
+#include "../logging.h"
+
+MessageFetcher::MessageFetcher(const HttpClient* _client, const QString& _cluster, const QString& _messagePath, const QUrl& _storageUrl, QObject* _parent)
+    : QObject(_parent), m_Client(_client), m_Cluster(_cluster), m_MessagePath(_messagePath), m_StorageUrl(_storageUrl), m_Window(8), m_Canceled(false),
+      m_LedgerId(-1), m_EntryId(-1), m_Num(0), m_Next(0), m_InFlight(0), m_Emitted(0)
+{
+}
+
+/**
+ * @brief Fetch the _num entries ending with _ledgerId:_entryId, the oldest comes first.
+ * @param _ledgerId
+ * @param _entryId
+ * @param _num
+ */
+void MessageFetcher::start(const int& _ledgerId, const int& _entryId, const int& _num)
+{
+    this->m_LedgerId = _ledgerId;
+    this->m_EntryId = _entryId;
+    this->m_Num = _num;
+    if (_ledgerId < 0 || _entryId < 0 || _num <= 0)
+    {
+        finish();
+        return;
+    }
+    if (_entryId + 1 >= _num)
+    {
+        plan(TopicSegments());
+        return;
+    }
+
+    //The range crosses into previous ledgers, their sizes come from internalStats
+    QSharedPointer<InternalStatsReader> reader(new InternalStatsReader());
+    this->m_Client->stream(HttpRequest(HttpRequest::Get, this->m_StorageUrl), this, [reader](const QByteArray& _chunk)
+    {
+        reader->addData(_chunk);
+    }, [this, reader](const HttpResponse& _response)
+    {
+        TopicSegments segments;
+        if (_response.isSuccess() && reader->finish())
+        {
+            segments = reader->storage().segments();
+        }
+        plan(segments);
+    });
+}
+
+/**
+ * @brief Stop dispatching, the requests in flight are ignored when they come back.
+ */
+void MessageFetcher::cancel()
+{
+    this->m_Canceled = true;
+}
+
+void MessageFetcher::plan(const TopicSegments& _segments)
+{
+    if (this->m_Canceled)
+    {
+        return;
+    }
+
+    QVector<Message> positions;
+    int remaining = this->m_Num;
+    for (int entry = this->m_EntryId; entry >= 0 && remaining > 0; --entry, --remaining)
+    {
+        positions << Message(this->m_LedgerId, entry);
+    }
+
+    int current = -1;
+    for (int i = 0, n = _segments.size(); i < n; ++i)
+    {
+        if (_segments[i].ledgerId() == this->m_LedgerId)
+        {
+            current = i;
+            break;
+        }
+    }
+    for (int i = current - 1; i >= 0 && remaining > 0; --i)
+    {
+        const TopicSegment& segment = _segments[i];
+        for (int entry = segment.entries() - 1; entry >= 0 && remaining > 0; --entry, --remaining)
+        {
+            positions << Message(segment.ledgerId(), entry);
+        }
+    }
+    std::reverse(positions.begin(), positions.end());
+
+    this->m_Positions = positions;
+    this->m_Results = QVector<PulsarMessage>(positions.size());
+    this->m_Done = QVector<bool>(positions.size(), false);
+    this->m_Next = 0;
+    this->m_Emitted = 0;
+    this->m_Messages.clear();
+    if (positions.isEmpty())
+    {
+        finish();
+        return;
+    }
+    pump();
+}
+
+void MessageFetcher::pump()
+{
+    RequestQueue* queue = RequestQueue::instance(this->m_Cluster);
+    while (!this->m_Canceled && this->m_InFlight < this->m_Window && this->m_Next < this->m_Positions.size())
+    {
+        int index = this->m_Next++;
+        const Message& position = this->m_Positions[index];
+        QUrl url(this->m_MessagePath.arg(position.ledgerId()).arg(position.entryId()));
+        qCInfo(lcTopic) << "Get Message Service url: " << url.toString() << Qt::endl;
+
+        this->m_InFlight++;
+        queue->enqueue(this->m_Client, HttpRequest(HttpRequest::Get, url), this, [this, index](const HttpResponse& _response)
+        {
+            complete(index, _response);
+        });
+    }
+}
+
+/**
+ * @brief The window slot is released as soon as the response is in, decompressing and splitting
+ * the entry runs on the global thread pool.
+ */
+void MessageFetcher::complete(const int& _index, const HttpResponse& _response)
+{
+    this->m_InFlight--;
+    if (this->m_Canceled)
+    {
+        return;
+    }
+
+    const Message& position = this->m_Positions[_index];
+    if (!_response.isSuccess())
+    {
+        qCWarning(lcTopic) << "Get Message " << position.ledgerId() << ":" << position.entryId() << " failed: " << _response.code << Qt::endl;
+        decoded(_index, PulsarMessage());
+        pump();
+        return;
+    }
+
+    QPointer<MessageFetcher> self(this);
+    int ledgerId = position.ledgerId();
+    int entryId = position.entryId();
+    QThreadPool::globalInstance()->start([self, _index, _response, ledgerId, entryId]()
+    {
+        PulsarMessage message = TopicService::toMessage(_response, ledgerId, entryId);
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [self, _index, message]()
+        {
+            if (!self.isNull())
+            {
+                self->decoded(_index, message);
+            }
+        }, Qt::QueuedConnection);
+    });
+    pump();
+}
+
+void MessageFetcher::decoded(const int& _index, const PulsarMessage& _message)
+{
+    if (this->m_Canceled)
+    {
+        return;
+    }
+    this->m_Results[_index] = _message;
+    this->m_Done[_index] = true;
+
+    //Hand out the messages in entry order, a gap waits for its response
+    while (this->m_Emitted < this->m_Done.size() && this->m_Done[this->m_Emitted])
+    {
+        if (this->m_Results[this->m_Emitted].ledgerId() >= 0) //failed entries are left out
+        {
+            this->m_Messages << this->m_Results[this->m_Emitted];
+            emit messageLoaded(this->m_Results[this->m_Emitted]);
+        }
+        this->m_Results[this->m_Emitted] = PulsarMessage();
+        this->m_Emitted++;
+    }
+
+    if (this->m_Emitted == this->m_Positions.size())
+    {
+        finish();
+    }
+}
+
+void MessageFetcher::finish()
+{
+    emit finished();
+}
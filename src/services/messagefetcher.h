@@ -0,0 +1,76 @@
+#ifndef MESSAGEFETCHER_H
+#define MESSAGEFETCHER_H
+
+#include <QObject>
+#include <QUrl>
+#include <QVector>
+
+#include "httpclient.h"
+#include "../pulsarmessage.h"
+#include "../topic.h"
+
+/**
+ * @brief Fetches the last N entries before a message id with a window of concurrent requests.
+ *
+ * Up to window() entry requests are in flight at a time, the responses are decoded on worker
+ * threads and reassembled in entry order. When the range reaches the start of the ledger, the
+ * ledger list of internalStats is used to continue with the previous ledgers.
+ */
+class MessageFetcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param _client must outlive the fetcher, normally the fetcher is a child of its service
+     * @param _cluster the admin url of the cluster, selects the request queue
+     * @param _messagePath the entry url with %1 left for the ledger and %2 for the entry
+     * @param _storageUrl the internalStats url of the topic
+     */
+    explicit MessageFetcher(const HttpClient* _client, const QString& _cluster, const QString& _messagePath, const QUrl& _storageUrl, QObject* parent = nullptr);
+
+    inline void setWindow(const int& _window) { this->m_Window = qMax(1, _window); }
+    inline int window() const { return this->m_Window; }
+
+    void start(const int& _ledgerId, const int& _entryId, const int& _num);
+    void cancel();
+
+    inline QList<PulsarMessage> messages() const { return this->m_Messages; }
+    /**
+     * @brief The entries of the range, the oldest first, once they are planned.
+     */
+    inline QVector<Message> positions() const { return this->m_Positions; }
+
+signals:
+    void messageLoaded(const PulsarMessage&);
+    void finished();
+
+private:
+    void plan(const TopicSegments& _segments);
+    void pump();
+    void complete(const int& _index, const HttpResponse& _response);
+    void decoded(const int& _index, const PulsarMessage& _message);
+    void finish();
+
+private:
+    const HttpClient* m_Client;
+    QString m_Cluster;
+    QString m_MessagePath;
+    QUrl m_StorageUrl;
+    int m_Window;
+    bool m_Canceled;
+
+    int m_LedgerId;
+    int m_EntryId;
+    int m_Num;
+
+    QVector<Message> m_Positions;
+    QVector<PulsarMessage> m_Results;
+    QVector<bool> m_Done;
+    int m_Next;
+    int m_InFlight;
+    int m_Emitted;
+    QList<PulsarMessage> m_Messages;
+};
+
+#endif // MESSAGEFETCHER_H
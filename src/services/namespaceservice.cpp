@@ -3,9 +3,9 @@
 #include <QUrl>
 #include <QJsonDocument>
 #include <QJsonArray>
-#include <QDebug>
 
 #include "../constants.h"
+#include "../logging.h"
 
 QList<Namespace> NamespaceService::namespaces(const Tenant& _tenant) const
 {
@@ -13,7 +13,7 @@ QList<Namespace> NamespaceService::namespaces(const Tenant& _tenant) const
     QString path(_tenant.cluster().adminUrl());
     path = path.append(this->m_Settings->value(GET_NAMESPACES_PATH_KEY).toString()).arg(_tenant.name());
     QUrl url(path);
-    qDebug() << "Get the list of all the namespaces for a certain tenant service url: " << url.toString() << Qt::endl;
+    qCInfo(lcAdmin) << "Get the list of all the namespaces for a certain tenant service url: " << url.toString() << Qt::endl;
 
     QByteArray result = this->m_Client->get(url);
     QJsonParseError error;
@@ -27,7 +27,7 @@ QList<Namespace> NamespaceService::namespaces(const Tenant& _tenant) const
         }
     }
 
-    qDebug() << "Get the list of all the namespaces for a certain tenant response result: " << QString::fromLatin1(result) << Qt::endl;
+    qCDebug(lcAdmin) << "Get the list of all the namespaces for a certain tenant response result: " << QString::fromLatin1(result) << Qt::endl;
 
     return namespaces;
 }
@@ -37,10 +37,10 @@ void NamespaceService::createNamespace(const Namespace& _namespace, HttpStatusCo
     QString path(_namespace.tenant().cluster().adminUrl());
     path = path.append(this->m_Settings->value(PUT_NEW_NAMESPACE_PATH_KEY).toString()).arg(_namespace.tenant().name(), _namespace.name());
     QUrl url(path);
-    qDebug() << "Create a new namesapce service url: " << url.toString() << Qt::endl;
+    qCInfo(lcAdmin) << "Create a new namesapce service url: " << url.toString() << Qt::endl;
 
     QString json = _namespace.toJson();
-    qDebug() << "Create a new namesapce request body: " << json << Qt::endl;
+    qCDebug(lcAdmin) << "Create a new namesapce request body: " << json << Qt::endl;
 
     int statusCode;
     QByteArray result = this->m_Client->put(url, json.toLatin1(), statusCode);
@@ -67,7 +67,7 @@ void NamespaceService::createNamespace(const Namespace& _namespace, HttpStatusCo
         break;
     }
 
-    qDebug() << "Create a new namesapce response result: " << QString::fromLatin1(result) << Qt::endl;
+    qCDebug(lcAdmin) << "Create a new namesapce response result: " << QString::fromLatin1(result) << Qt::endl;
 }
 
 void NamespaceService::deleteNamespace(const Namespace& _namespace, HttpStatusCode& _code)
@@ -75,7 +75,7 @@ void NamespaceService::deleteNamespace(const Namespace& _namespace, HttpStatusCo
     QString path(_namespace.tenant().cluster().adminUrl());
     path = path.append(this->m_Settings->value(DELETE_NAMESPACE_PATH_KEY).toString()).arg(_namespace.tenant().name(), _namespace.name());
     QUrl url(path);
-    qDebug() << "Delete a namespace and all the topics under it service url: " << url.toString() << Qt::endl;
+    qCInfo(lcAdmin) << "Delete a namespace and all the topics under it service url: " << url.toString() << Qt::endl;
 
     int statusCode;
     QByteArray result = this->m_Client->deleteResource(url, statusCode);
@@ -98,5 +98,5 @@ void NamespaceService::deleteNamespace(const Namespace& _namespace, HttpStatusCo
         break;
     }
 
-    qDebug() << "Delete a namespace and all the topics under it response result: " << QString::fromLatin1(result) << Qt::endl;
+    qCDebug(lcAdmin) << "Delete a namespace and all the topics under it response result: " << QString::fromLatin1(result) << Qt::endl;
 }
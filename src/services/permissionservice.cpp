@@ -4,9 +4,9 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
-#include <QDebug>
 
 #include "../constants.h"
+#include "../logging.h"
 
 QStringList PermissionService::roles() const
 {
@@ -27,7 +27,7 @@ QList<Role> PermissionService::roles(const Namespace& _namespace, HttpStatusCode
     QString path(_namespace.tenant().cluster().adminUrl());
     path = path.append(this->m_Settings->value(GET_NAMESPACE_PERMISSIONS_PATH_KEY).toString());
     QUrl url(path.arg(_namespace.tenant().name(), _namespace.name()));
-    qDebug() << "Get Namespace Permissions service url: " << url.toString() << Qt::endl;
+    qCInfo(lcAdmin) << "Get Namespace Permissions service url: " << url.toString() << Qt::endl;
 
     int code;
     QByteArray json = this->m_Client->get(url, code);
@@ -79,7 +79,7 @@ QList<Role> PermissionService::roles(const Namespace& _namespace, HttpStatusCode
         }
     }
 
-    qDebug() << "Get Namespace Permissions response result: " << QString::fromLatin1(json) << Qt::endl;
+    qCDebug(lcAdmin) << "Get Namespace Permissions response result: " << QString::fromLatin1(json) << Qt::endl;
 
     return roles;
 }
@@ -95,10 +95,10 @@ void PermissionService::grant(const Role& _role, HttpStatusCode& _code)
     QString path(_role.getNamespace().tenant().cluster().adminUrl());
     path = path.append(this->m_Settings->value(GRANT_NAMESPACE_PERMISSION_PATH_KEY).toString());
     QUrl url(path.arg(_role.getNamespace().tenant().name(), _role.getNamespace().name(), _role.name()));
-    qDebug() << "Grant Namespace Permission service url: " << url.toString() << Qt::endl;
+    qCInfo(lcAdmin) << "Grant Namespace Permission service url: " << url.toString() << Qt::endl;
 
     QByteArray body = _role.toJson();
-    qDebug() << "Grant Permission request body: " << QString::fromLatin1(body) << Qt::endl;
+    qCDebug(lcAdmin) << "Grant Permission request body: " << QString::fromLatin1(body) << Qt::endl;
 
     int statusCode;
     QByteArray json = this->m_Client->post(url, body, statusCode);
@@ -125,7 +125,7 @@ void PermissionService::grant(const Role& _role, HttpStatusCode& _code)
         break;
     }
 
-    qDebug() << "Grant Permission response result: " << QString::fromLatin1(json) << Qt::endl;
+    qCDebug(lcAdmin) << "Grant Permission response result: " << QString::fromLatin1(json) << Qt::endl;
 }
 
 void PermissionService::revoke(const Role& _role, HttpStatusCode& _code)
@@ -133,7 +133,7 @@ void PermissionService::revoke(const Role& _role, HttpStatusCode& _code)
     QString path(_role.getNamespace().tenant().cluster().adminUrl());
     path += this->m_Settings->value(REVOKE_NAMESPACE_PERMISSION_PATH_KEY).toString();
     QUrl url(path.arg(_role.getNamespace().tenant().name(), _role.getNamespace().name(), _role.name()));
-    qDebug() << "Revoke Namespace Permission service url: " << url.toString() << Qt::endl;
+    qCInfo(lcAdmin) << "Revoke Namespace Permission service url: " << url.toString() << Qt::endl;
 
     int statusCode;
     QByteArray json = this->m_Client->deleteResource(url, statusCode);
@@ -152,7 +152,7 @@ void PermissionService::revoke(const Role& _role, HttpStatusCode& _code)
         break;
     }
 
-    qDebug() << "Revoke Permission response result: " << QString::fromLatin1(json) << Qt::endl;
+    qCDebug(lcAdmin) << "Revoke Permission response result: " << QString::fromLatin1(json) << Qt::endl;
 }
 
 bool PermissionService::exists(const Role& _role) const
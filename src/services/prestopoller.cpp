@@ -0,0 +1,318 @@
+#include "prestopoller.h"
+
+#include <QTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include "../logging.h"
+
+namespace
+{
+//Presto answers 502, 503 and 504 while a coordinator is busy or restarting, those are retried.
+const int MAX_RETRIES = 5;
+
+bool isRetriable(const HttpResponse& _response)
+{
+    return _response.code == 502 || _response.code == HttpStatusCode::ServiceUnavailable || _response.code == 504 || (_response.code == 0 && _response.error != QNetworkReply::OperationCanceledError);
+}
+}
+
+PrestoPoller::PrestoPoller(const HttpClient* _client, QObject* parent) : QObject(parent), m_Client(_client), m_MinInterval(100), m_MaxInterval(2000)
+{
+}
+
+/**
+ * @brief Post the query and poll the statement until it has no page left. A statement already
+ * polled is cancelled first.
+ */
+void PrestoPoller::start(const HttpRequest& _request, Statement* _statement)
+{
+    cancel(_statement);
+    Poll poll;
+    poll.context = new QObject(this);
+    poll.inFlight = true;
+    poll.held = false;
+    poll.waiting = false;
+    poll.interval = this->m_MinInterval;
+    poll.retries = 0;
+    this->m_Polls.insert(_statement, poll);
+
+    qCInfo(lcPresto) << "Query Topic Data service url: " << _request.url.toString() << Qt::endl;
+    qCDebug(lcPresto) << "Query Topic Data request body: " << QString::fromUtf8(_request.body) << Qt::endl;
+    this->m_Client->send(_request, poll.context, [this, _statement](const HttpResponse& _response)
+    {
+        complete(_statement, _response);
+    });
+}
+
+/**
+ * @brief Cancel the leaf stages of the query through its partialCancelUri, it finishes with the
+ * rows read so far, which are still polled. Without that uri yet the query is closed.
+ */
+void PrestoPoller::stop(Statement* _statement)
+{
+    if (!this->m_Polls.contains(_statement))
+    {
+        return;
+    }
+    if (_statement->cancelUri().isEmpty())
+    {
+        close(_statement);
+        finish(_statement);
+        return;
+    }
+
+    QUrl url(_statement->cancelUri());
+    qCInfo(lcPresto) << "Cancel query Topic data service url: " << url.toString() << Qt::endl;
+    this->m_Client->deleteAsync(url, this, [](const HttpResponse& _response)
+    {
+        qCDebug(lcPresto) << "Cancel query Topic data response result: " << QString::fromLatin1(_response.body) << ", code: " << _response.code << Qt::endl;
+    });
+
+    //Do not sit out the backoff, the remaining pages come right after the cancel
+    Poll& poll = this->m_Polls[_statement];
+    poll.interval = this->m_MinInterval;
+    if (!poll.inFlight && !poll.waiting)
+    {
+        delete poll.context;
+        poll.context = new QObject(this);
+        schedule(_statement, 0);
+    }
+}
+
+/**
+ * @brief Close the query through the DELETE of its nextUri and stop polling it at once, the
+ * request in flight is dropped. The statement may be deleted right after.
+ */
+void PrestoPoller::cancel(Statement* _statement)
+{
+    if (this->m_Polls.contains(_statement))
+    {
+        close(_statement);
+        remove(_statement);
+    }
+}
+
+void PrestoPoller::cancelAll()
+{
+    foreach (Statement* statement, this->m_Polls.keys())
+    {
+        cancel(statement);
+    }
+}
+
+/**
+ * @brief Ask for no page of the statement after the one in flight or the one waiting on its timer.
+ */
+void PrestoPoller::hold(Statement* _statement)
+{
+    if (this->m_Polls.contains(_statement))
+    {
+        this->m_Polls[_statement].held = true;
+    }
+}
+
+void PrestoPoller::resume(Statement* _statement)
+{
+    if (!this->m_Polls.contains(_statement))
+    {
+        return;
+    }
+    Poll& poll = this->m_Polls[_statement];
+    poll.held = false;
+    if (poll.waiting)
+    {
+        poll.waiting = false;
+        schedule(_statement, 0);
+    }
+}
+
+void PrestoPoller::next(Statement* _statement, const int& _delay)
+{
+    Poll& poll = this->m_Polls[_statement];
+    if (poll.held)
+    {
+        poll.waiting = true;
+        return;
+    }
+    schedule(_statement, _delay);
+}
+
+void PrestoPoller::schedule(Statement* _statement, const int& _delay)
+{
+    QTimer::singleShot(_delay, this->m_Polls.value(_statement).context, [this, _statement]()
+    {
+        request(_statement);
+    });
+}
+
+void PrestoPoller::request(Statement* _statement)
+{
+    Poll& poll = this->m_Polls[_statement];
+    poll.inFlight = true;
+    QUrl url(_statement->nextUri());
+    qCInfo(lcPresto) << "Query Topic next data service url: " << url.toString() << Qt::endl;
+
+    HttpRequest request(HttpRequest::Get, url);
+    request.cacheMode = HttpRequest::RefreshCache;
+    this->m_Client->send(request, poll.context, [this, _statement](const HttpResponse& _response)
+    {
+        complete(_statement, _response);
+    });
+}
+
+void PrestoPoller::complete(Statement* _statement, const HttpResponse& _response)
+{
+    Poll& poll = this->m_Polls[_statement];
+    poll.inFlight = false;
+    qCDebug(lcPresto) << "Query Topic next data response result: " << QString::fromLatin1(_response.body) << ", code: " << _response.code << Qt::endl;
+
+    if (!_response.isSuccess())
+    {
+        if (isRetriable(_response) && !_statement->nextUri().isEmpty() && ++poll.retries <= MAX_RETRIES)
+        {
+            qCWarning(lcPresto) << "Query Topic next data failed, code: " << _response.code << ", retry " << poll.retries << Qt::endl;
+            poll.interval = qMin(this->m_MaxInterval, qMax(poll.interval * 2, 1));
+            next(_statement, poll.interval);
+            return;
+        }
+        qCWarning(lcPresto) << "Query Topic data failed, code: " << _response.code << ", error: " << _response.errorDesc << Qt::endl;
+        _statement->setError(tr("Presto responded with %1: %2").arg(_response.code).arg(_response.errorDesc.isEmpty() ? QString::fromUtf8(_response.body) : _response.errorDesc));
+        finish(_statement);
+        return;
+    }
+    poll.retries = 0;
+
+    QueryState before = _statement->state();
+    qsizetype rows = read(_statement, _response.body);
+    if (rows < 0)
+    {
+        close(_statement);
+        finish(_statement);
+        return;
+    }
+
+    emit pageRead(_statement);
+    if (!this->m_Polls.contains(_statement))
+    {
+        return;
+    }
+
+    QueryState after = _statement->state();
+    if (after.state() == QString("FAILED") || _statement->nextUri().isEmpty())
+    {
+        finish(_statement);
+    }
+    else if (_statement->isFull())
+    {
+        close(_statement);
+        finish(_statement);
+    }
+    else if (rows > 0)
+    {
+        this->m_Polls[_statement].interval = this->m_MinInterval;
+        next(_statement, 0);
+    }
+    else if (after.state() != before.state() || after.processedRows() != before.processedRows() || after.processedBytes() != before.processedBytes())
+    {
+        this->m_Polls[_statement].interval = this->m_MinInterval;
+        next(_statement, this->m_MinInterval);
+    }
+    else
+    {
+        Poll& idle = this->m_Polls[_statement];
+        idle.interval = qMin(this->m_MaxInterval, qMax(idle.interval * 2, 1));
+        next(_statement, idle.interval);
+    }
+}
+
+void PrestoPoller::finish(Statement* _statement)
+{
+    remove(_statement);
+    emit finished(_statement);
+}
+
+/**
+ * @brief Delete the query at its nextUri, the reply is only logged.
+ */
+void PrestoPoller::close(Statement* _statement)
+{
+    if (_statement->nextUri().isEmpty())
+    {
+        return;
+    }
+    QUrl url(_statement->nextUri());
+    _statement->setNextUri(QString());
+    qCInfo(lcPresto) << "Close query Topic data service url: " << url.toString() << Qt::endl;
+    this->m_Client->deleteAsync(url, this, [](const HttpResponse& _response)
+    {
+        qCDebug(lcPresto) << "Close query Topic data response result: " << QString::fromLatin1(_response.body) << ", code: " << _response.code << Qt::endl;
+    });
+}
+
+void PrestoPoller::remove(Statement* _statement)
+{
+    Poll poll = this->m_Polls.take(_statement);
+    delete poll.context;
+}
+
+/**
+ * @brief Update the statement from a response and append its rows, as far as its row limit allows.
+ * @return the rows appended, -1 if the response cannot be parsed
+ */
+qsizetype PrestoPoller::read(Statement* _statement, const QByteArray& _body)
+{
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(_body, &error);
+    if (error.error != QJsonParseError::ParseError::NoError)
+    {
+        qCWarning(lcPresto) << "Query Topic data response is not JSON: " << error.errorString() << Qt::endl;
+        _statement->setError(tr("Presto response cannot be parsed: %1").arg(error.errorString()));
+        return -1;
+    }
+
+    QJsonObject root = doc.object();
+    _statement->setId(root["id"].toString());
+    _statement->setNextUri(root["nextUri"].toString());
+    if (root.contains("partialCancelUri"))
+    {
+        _statement->setCancelUri(root["partialCancelUri"].toString());
+    }
+    QJsonObject stats = root["stats"].toObject();
+    QueryState state;
+    state.setState(stats["state"].toString());
+    state.setElapsedTimeMillis(stats["elapsedTimeMillis"].toInteger());
+    state.setProcessedRows(stats["processedRows"].toInteger());
+    state.setProcessedBytes(stats["processedBytes"].toInteger());
+    if (state.state() == QString("FAILED"))
+    {
+        QJsonObject error = root["error"].toObject();
+        _statement->setError(error["message"].toString());
+    }
+    _statement->setState(state);
+
+    if (_statement->columns().size() <= 0)
+    {
+        QJsonArray columns = root["columns"].toArray();
+        for (int i = 0, n = columns.size(); i < n; ++i)
+        {
+            QJsonObject columnObject = columns[i].toObject();
+            Column col;
+            col.setName(columnObject["name"].toString());
+            col.setType(columnObject["type"].toString());
+            _statement->addColumn(col);
+        }
+    }
+
+    if (_statement->result().columnCount() == 0 && _statement->columns().size() > 0)
+    {
+        _statement->result().setColumns(_statement->columns());
+    }
+    else if (!_statement->retainRows())
+    {
+        _statement->result().clearRows();
+    }
+    qsizetype room = _statement->maxRows() > 0 ? qMax<qsizetype>(0, _statement->maxRows() - _statement->result().rowCount()) : -1;
+    return _statement->result().append(root["data"].toArray(), room);
+}
@@ -0,0 +1,81 @@
+#ifndef PRESTOPOLLER_H
+#define PRESTOPOLLER_H
+
+#include <QObject>
+#include <QHash>
+
+#include "httpclient.h"
+#include "../table.h"
+
+/**
+ * @brief Submits Presto statements and follows their nextUri without blocking the caller.
+ *
+ * Every statement has its own single shot timer and at most one request in flight, any number
+ * of statements are polled at the same time. A page that brings rows is followed right away,
+ * one where the server has made progress after minInterval(), one without progress doubles the
+ * wait up to maxInterval(). Rows are appended to the result of the statement, a statement
+ * which reaches its row limit is closed. A reader slower than the server holds the statement,
+ * its next page is only asked for once it is resumed.
+ */
+class PrestoPoller : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param _client must outlive the poller, normally the poller is a child of its service
+     */
+    explicit PrestoPoller(const HttpClient* _client, QObject* parent = nullptr);
+
+    inline void setMinInterval(const int& _millis) { this->m_MinInterval = qMax(0, _millis); }
+    inline int minInterval() const { return this->m_MinInterval; }
+    inline void setMaxInterval(const int& _millis) { this->m_MaxInterval = qMax(0, _millis); }
+    inline int maxInterval() const { return this->m_MaxInterval; }
+
+    void start(const HttpRequest& _request, Statement* _statement);
+    void stop(Statement* _statement);
+    void cancel(Statement* _statement);
+    void cancelAll();
+    void hold(Statement* _statement);
+    void resume(Statement* _statement);
+
+    inline bool isPolling(Statement* _statement) const { return this->m_Polls.contains(_statement); }
+    inline int count() const { return static_cast<int>(this->m_Polls.size()); }
+
+signals:
+    void pageRead(Statement* _statement);
+    /**
+     * @brief The statement has no page left, or has failed and carries an error. Not emitted
+     * for the statements given to cancel().
+     */
+    void finished(Statement* _statement);
+
+private:
+    struct Poll
+    {
+        QObject* context;       //of the timer and the request in flight, deleted to drop them
+        bool inFlight;
+        bool held;
+        bool waiting;           //for resume(), to read the next page
+        int interval;
+        int retries;
+    };
+
+    void next(Statement* _statement, const int& _delay);
+    void schedule(Statement* _statement, const int& _delay);
+    void request(Statement* _statement);
+    void complete(Statement* _statement, const HttpResponse& _response);
+    void finish(Statement* _statement);
+    void close(Statement* _statement);
+    void remove(Statement* _statement);
+
+    static qsizetype read(Statement* _statement, const QByteArray& _body);
+
+private:
+    const HttpClient* m_Client;
+    int m_MinInterval;
+    int m_MaxInterval;
+    QHash<Statement*, Poll> m_Polls;
+};
+
+#endif // PRESTOPOLLER_H
@@ -1,158 +1,132 @@
 #include "prestoqueryservice.h"
 
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
-#include <QDebug>
+#include <QTimeZone>
 
+#include "queryexporter.h"
 #include "../constants.h"
 #include "../topic.h"
 #include "../table.h"
 
-void PrestoQueryService::query(const Topic& _topic, Statement* _statement)
+PrestoQueryService::PrestoQueryService(QObject* parent) : BaseService(parent), m_Poller(new PrestoPoller(this->m_Client, this)), m_Exporter(nullptr)
 {
-    QString path(_topic.getNamespace().tenant().cluster().prestoUrl());
-    if (!path.isEmpty())
-    {
-        path = path.append(this->m_Settings->value(PRESTO_STATEMENT_PATH_KEY).toString());
-        QUrl url(path);
-        qDebug() << "Query Topic Data service url: " << url.toString() << Qt::endl;
+    this->m_Poller->setMinInterval(this->m_Settings->value(PRESTO_POLL_MIN_INTERVAL_KEY, 100).toInt());
+    this->m_Poller->setMaxInterval(this->m_Settings->value(PRESTO_POLL_MAX_INTERVAL_KEY, 2000).toInt());
+    this->m_Exporter = new QueryExporter(this, this);
+    this->m_Exporter->setMaxQueuedPages(this->m_Settings->value(PRESTO_EXPORT_QUEUED_PAGES_KEY, 4).toInt());
+}
 
-        QString query("select * from pulsar.\"%1/%2\".\"%3\"");
-        query = query.arg(_topic.getNamespace().tenant().name(), _topic.getNamespace().name(), _topic.name());
-        if (!_statement->condition().isEmpty())
-        {
-            query =  query.append(" where %4").arg(_statement->condition());
-        }
-        qDebug() << "Query Topic Data request body: " << query << Qt::endl;
+/**
+ * @brief Submit the query of a topic, its pages are read by the poller without blocking.
+ * @param _topic
+ * @param _statement
+ */
+void PrestoQueryService::query(const Topic& _topic, Statement* _statement)
+{
+    submit(_topic, queryText(_topic, _statement), _statement);
+}
 
-        int statusCode;
-        QByteArray result = this->m_Client->post(url, query.toLatin1(), statusCode);
+/**
+ * @brief Submit SHOW COLUMNS for the table of a topic, the rows are the column names and types
+ * the connector derives from the topic schema, its internal columns included.
+ * @param _topic
+ * @param _statement
+ */
+void PrestoQueryService::describe(const Topic& _topic, Statement* _statement)
+{
+    submit(_topic, QString("show columns from %1").arg(tableName(_topic)), _statement);
+}
 
-        if (statusCode == HttpStatusCode::StatusCode::OK)
-        {
-            QJsonParseError error;
-            QJsonDocument doc = QJsonDocument::fromJson(result, &error);
-            if (error.error == QJsonParseError::ParseError::NoError)
-            {
-                QJsonObject root = doc.object();
-                _statement->setId(root["id"].toString());
-                _statement->setNextUri(root["nextUri"].toString());
-                QJsonObject stats = root["stats"].toObject();
-                QueryState state;
-                state.setState(stats["state"].toString());
-                state.setElapsedTimeMillis(stats["elapsedTimeMillis"].toInt());
-                state.setProcessedRows(stats["processedRows"].toInt());
-                state.setProcessedBytes(stats["processedBytes"].toInt());
-                if (state.state() == QString("FAILED"))
-                {
-                    QJsonObject error = root["error"].toObject();
-                    _statement->setError(error["message"].toString());
-                }
-                _statement->setState(state);
-            }
-        }
+/**
+ * @brief The SELECT of a statement. Only the selected columns are read, the __publish_time__
+ * bounds let the Pulsar connector skip the ledgers out of the range and the LIMIT ends the scan
+ * once enough rows are in.
+ * @param _topic
+ * @param _statement
+ * @return
+ */
+QString PrestoQueryService::queryText(const Topic& _topic, const Statement* _statement) const
+{
+    QStringList columns;
+    foreach (const QString& column, _statement->projection())
+    {
+        columns << quoted(column);
+    }
+    QString query("select %1 from %2");
+    query = query.arg(columns.isEmpty() ? QString("*") : columns.join(", "), tableName(_topic));
 
-        qDebug() << "Query Topic Data response result: " << QString::fromLatin1(result) << ", code: " << statusCode << Qt::endl;
+    //Timestamp literals are read in the time zone of the session, which is the local one.
+    QStringList predicates;
+    if (_statement->publishedFrom().isValid())
+    {
+        predicates << QString("__publish_time__ >= timestamp '%1'").arg(_statement->publishedFrom().toLocalTime().toString("yyyy-MM-dd HH:mm:ss.zzz"));
+    }
+    if (_statement->publishedUntil().isValid())
+    {
+        predicates << QString("__publish_time__ <= timestamp '%1'").arg(_statement->publishedUntil().toLocalTime().toString("yyyy-MM-dd HH:mm:ss.zzz"));
+    }
+    if (!_statement->condition().trimmed().isEmpty())
+    {
+        predicates << QString("(%1)").arg(_statement->condition().trimmed());
+    }
+    if (!predicates.isEmpty())
+    {
+        query.append(" where ").append(predicates.join(" and "));
     }
+    if (_statement->limit() > 0)
+    {
+        query.append(QString(" limit %1").arg(_statement->limit()));
+    }
+    return query;
 }
 
-void PrestoQueryService::queryNext(Statement* _statement)
+QString PrestoQueryService::tableName(const Topic& _topic)
 {
-    QUrl url(_statement->nextUri());
-    qDebug() << "Query Topic next data service url: " << url.toString() << Qt::endl;
-
-    int statusCode;
-    QByteArray result = this->m_Client->get(url, statusCode);
-    if (statusCode == HttpStatusCode::StatusCode::OK)
-    {
-        QJsonParseError error;
-        QJsonDocument doc = QJsonDocument::fromJson(result, &error);
-        if (error.error == QJsonParseError::ParseError::NoError)
-        {
-            QJsonObject root = doc.object();
-            _statement->setId(root["id"].toString());
-            _statement->setNextUri(root["nextUri"].toString());
-            _statement->setCancelUri(root["partialCancelUri"].toString());
-            QJsonObject stats = root["stats"].toObject();
-            QueryState state;
-            state.setState(stats["state"].toString());
-            state.setElapsedTimeMillis(stats["elapsedTimeMillis"].toInt());
-            state.setProcessedRows(stats["processedRows"].toInt());
-            state.setProcessedBytes(stats["processedBytes"].toInt());
-            if (state.state() == QString("FAILED"))
-            {
-                QJsonObject error = root["error"].toObject();
-                _statement->setError(error["message"].toString());
-            }
-            _statement->setState(state);
+    QString name("pulsar.%1.%2");
+    return name.arg(quoted(QString("%1/%2").arg(_topic.getNamespace().tenant().name(), _topic.getNamespace().name())), quoted(_topic.name()));
+}
 
-            if (_statement->columns().size() <= 0)
-            {
-                QJsonArray columns = root["columns"].toArray();
-                if (columns.size() > 0)
-                {
-                    _statement->clearColumns();
-                    for (int i = 0, n = columns.size(); i < n; ++i)
-                    {
-                        QJsonObject columnObject = columns[i].toObject();
-                        Column col;
-                        col.setName(columnObject["name"].toString());
-                        col.setType(columnObject["type"].toString());
-                        _statement->addColumn(col);
-                    }
-                }
-            }
+QString PrestoQueryService::quoted(const QString& _identifier)
+{
+    QString identifier(_identifier);
+    return QString("\"%1\"").arg(identifier.replace('"', "\"\""));
+}
 
-            QJsonArray rows = root["data"].toArray();
-            if (rows.size() > 0)
-            {
-                //_statement->clearResult();
-                for (int i = 0, n = rows.size(); i < n; ++i)
-                {
-                    QJsonArray data = rows[i].toArray();
-                    QStringList row;
-                    for (int j = 0, m = data.size(); j < m; ++j)
-                    {
-                        if (data[j].isString())
-                        {
-                            row <<  data[j].toString();
-                        }
-                        else if (data[j].isBool())
-                        {
-                            row << (data[j].toBool() ? "true" : "false");
-                        }
-                        else if (data[j].isDouble())
-                        {
-                            row << QString::number(data[j].toDouble());
-                        }
-                        else if (data[j].isNull())
-                        {
-                            row << QString("");
-                        }
-                        else if (data[j].isUndefined())
-                        {
-                            row << QString("undefined");
-                        }
-                    }
-                    _statement->addResult(row.join("\t"));
-                }
-            }
-        }
+void PrestoQueryService::submit(const Topic& _topic, const QString& _query, Statement* _statement)
+{
+    QString path(_topic.getNamespace().tenant().cluster().prestoUrl());
+    if (!path.isEmpty())
+    {
+        path = path.append(this->m_Settings->value(PRESTO_STATEMENT_PATH_KEY).toString());
+        HttpRequest request(HttpRequest::Post, QUrl(path));
+        request.body = _query.toUtf8();
+        request.contentType = "text/plain";
+        request.headers.append(QNetworkReply::RawHeaderPair("X-Presto-Time-Zone", QTimeZone::systemTimeZoneId()));
+        this->m_Poller->start(request, _statement);
     }
-
-    qDebug() << "Query Topic next data response result: " << QString::fromLatin1(result) << ", code: " << statusCode << Qt::endl;
 }
 
+/**
+ * @brief Cancel the leaf stages of the query, it finishes with the rows read so far.
+ * @param _statement
+ */
 void PrestoQueryService::cancelQuery(Statement* _statement)
 {
-    if (!_statement->cancelUri().isEmpty())
-    {
-        QUrl url(_statement->cancelUri());
-        qDebug() << "Cancel query Topic data service url: " << url.toString() << Qt::endl;
+    this->m_Poller->stop(_statement);
+}
 
-        int statusCode;
-        QByteArray result = this->m_Client->deleteResource(url, statusCode);
-        qDebug() << "Cancel query Topic data response result: " << QString::fromLatin1(result) << ", code: " << statusCode << Qt::endl;
-    }
+/**
+ * @brief Cancel the whole query, not only its leaf stage, and stop reading its pages.
+ * @param _statement
+ */
+void PrestoQueryService::closeQuery(Statement* _statement)
+{
+    this->m_Poller->cancel(_statement);
+}
+
+/**
+ * @brief The rows a query shows at most, 0 for no limit.
+ */
+int PrestoQueryService::maxRows() const
+{
+    return qMax(0, this->m_Settings->value(PRESTO_MAX_ROWS_KEY, 100000).toInt());
 }
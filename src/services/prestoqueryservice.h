@@ -2,23 +2,44 @@
 #define PRESTOQUERYSERVICE_H
 
 #include "baseservice.h"
+#include "prestopoller.h"
 
 class Topic;
-class Statement;
+class QueryExporter;
 
 class PrestoQueryService : public BaseService
 {
     Q_OBJECT
 
 public:
-    explicit PrestoQueryService(QObject* parent = nullptr) : BaseService(parent) {}
+    explicit PrestoQueryService(QObject* parent = nullptr);
 
     void query(const Topic& _topic, Statement* _statement);
-    void queryNext(Statement* _statement);
+    void describe(const Topic& _topic, Statement* _statement);
+    QString queryText(const Topic& _topic, const Statement* _statement) const;
     void cancelQuery(Statement* _statement);
+    void closeQuery(Statement* _statement);
+    int maxRows() const;
+
+    /**
+     * @brief Reports the pages and the end of the statements given to query().
+     */
+    inline PrestoPoller* poller() const { return this->m_Poller; }
+    /**
+     * @brief Writes the result of a query to a file as its pages are read.
+     */
+    inline QueryExporter* exporter() const { return this->m_Exporter; }
+
+    static QString tableName(const Topic& _topic);
+    static QString quoted(const QString& _identifier);
+
+private:
+    void submit(const Topic& _topic, const QString& _query, Statement* _statement);
 
 private:
     QString m_ServiceHost;
+    PrestoPoller* m_Poller;
+    QueryExporter* m_Exporter;
 
 };
 
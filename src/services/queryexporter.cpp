@@ -0,0 +1,531 @@
+#include "queryexporter.h"
+
+#include <QPointer>
+#include <QThreadPool>
+#include <QCoreApplication>
+#include <QMutex>
+#include <QQueue>
+#include <QSaveFile>
+#include <QElapsedTimer>
+
+#include <cmath>
+#include <memory>
+
+#include "prestoqueryservice.h"
+#include "../arrowstreamwriter.h"
+#include "../logging.h"
+#include "../topic.h"
+#include "../table.h"
+
+/**
+ * @brief The state shared by the exporter and the worker writing the file. The pages, the
+ * columns and the flags are guarded by the mutex, the file and the counters belong to the
+ * worker, only one of which runs at a time.
+ */
+struct QueryExporter::Job
+{
+    QPointer<QueryExporter> owner;
+    QString fileName;
+    Format format;
+    int maxQueued;
+
+    QMutex mutex;
+    QQueue<QueryResult> pages;
+    QList<Column> columns;
+    bool writing = false;           //a worker is draining the pages
+    bool ended = false;             //the statement has no page left
+    bool cancelled = false;
+    QString error;
+
+    std::unique_ptr<QSaveFile> file;
+    std::unique_ptr<ArrowStreamWriter> arrow;
+    QList<QByteArray> keys;         //the quoted column names followed by a colon, for Ndjson
+    bool started = false;
+    qint64 rows = 0;
+    qint64 bytes = 0;
+    QElapsedTimer elapsed;
+};
+
+namespace
+{
+const int PROGRESS_INTERVAL = 200;
+
+/**
+ * @brief An empty value is quoted, so that it stays apart from a null, which is left empty.
+ */
+void appendCsv(QByteArray& _buffer, const QByteArray& _value)
+{
+    if (_value.isEmpty() || _value.contains(',') || _value.contains('"') || _value.contains('\n') || _value.contains('\r'))
+    {
+        _buffer.append('"').append(QByteArray(_value).replace("\"", "\"\"")).append('"');
+    }
+    else
+    {
+        _buffer.append(_value);
+    }
+}
+
+void appendJson(QByteArray& _buffer, const QByteArray& _value)
+{
+    _buffer.append('"');
+    for (char c : _value)
+    {
+        switch (c)
+        {
+        case '"':
+            _buffer.append("\\\"");
+            break;
+        case '\\':
+            _buffer.append("\\\\");
+            break;
+        case '\n':
+            _buffer.append("\\n");
+            break;
+        case '\r':
+            _buffer.append("\\r");
+            break;
+        case '\t':
+            _buffer.append("\\t");
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                _buffer.append(QString("\\u%1").arg(static_cast<int>(c), 4, 16, QChar('0')).toLatin1());
+            }
+            else
+            {
+                _buffer.append(c);
+            }
+        }
+    }
+    _buffer.append('"');
+}
+
+QByteArray csvHeader(const QList<Column>& _columns)
+{
+    QByteArray buffer;
+    for (int i = 0, n = static_cast<int>(_columns.size()); i < n; ++i)
+    {
+        if (i > 0)
+        {
+            buffer.append(',');
+        }
+        appendCsv(buffer, _columns.at(i).name().toUtf8());
+    }
+    return buffer.append('\n');
+}
+
+QByteArray csvRows(const QueryResult& _page)
+{
+    QByteArray buffer;
+    for (qsizetype row = 0, rows = _page.rowCount(); row < rows; ++row)
+    {
+        for (int i = 0, n = _page.columnCount(); i < n; ++i)
+        {
+            if (i > 0)
+            {
+                buffer.append(',');
+            }
+            if (!_page.isNull(row, i))
+            {
+                appendCsv(buffer, _page.text(row, i).toUtf8());
+            }
+        }
+        buffer.append('\n');
+    }
+    return buffer;
+}
+
+/**
+ * @brief One object per row, NaN and the infinities as the strings Presto sends for them.
+ */
+QByteArray ndjsonRows(const QueryResult& _page, const QList<QByteArray>& _keys)
+{
+    QByteArray buffer;
+    for (qsizetype row = 0, rows = _page.rowCount(); row < rows; ++row)
+    {
+        buffer.append('{');
+        for (int i = 0, n = qMin(_page.columnCount(), static_cast<int>(_keys.size())); i < n; ++i)
+        {
+            if (i > 0)
+            {
+                buffer.append(',');
+            }
+            buffer.append(_keys.at(i));
+            if (_page.isNull(row, i))
+            {
+                buffer.append("null");
+                continue;
+            }
+            switch (_page.type(i))
+            {
+            case QueryResult::Integer:
+                buffer.append(QByteArray::number(_page.integer(row, i)));
+                break;
+            case QueryResult::Double:
+            {
+                double value = _page.real(row, i);
+                if (std::isnan(value))
+                {
+                    buffer.append("\"NaN\"");
+                }
+                else if (std::isinf(value))
+                {
+                    buffer.append(value < 0 ? "\"-Infinity\"" : "\"Infinity\"");
+                }
+                else
+                {
+                    buffer.append(_page.text(row, i).toLatin1());
+                }
+                break;
+            }
+            case QueryResult::Boolean:
+                buffer.append(_page.boolean(row, i) ? "true" : "false");
+                break;
+            case QueryResult::Varchar:
+                appendJson(buffer, _page.text(row, i).toUtf8());
+                break;
+            }
+        }
+        buffer.append("}\n");
+    }
+    return buffer;
+}
+}
+
+QueryExporter::QueryExporter(PrestoQueryService* _service, QObject* parent) : QObject(parent), m_Service(_service), m_Poller(_service->poller()), m_Statement(new Statement()), m_MaxQueuedPages(4)
+{
+    connect(this->m_Poller, &PrestoPoller::pageRead, this, &QueryExporter::handlePageRead);
+    connect(this->m_Poller, &PrestoPoller::finished, this, &QueryExporter::handleFinished);
+}
+
+QueryExporter::~QueryExporter()
+{
+    cancel();
+    delete this->m_Statement;
+}
+
+/**
+ * @brief Start an export, the one running is cancelled and reports no more.
+ */
+void QueryExporter::start(const Topic& _topic, const Statement& _query, const Format& _format, const QString& _fileName)
+{
+    cancel();
+    QSharedPointer<Job> job(new Job);
+    job->owner = this;
+    job->fileName = _fileName;
+    job->format = _format;
+    job->maxQueued = this->m_MaxQueuedPages;
+    job->elapsed.start();
+    this->m_Job = job;
+
+    this->m_Statement->reset();
+    this->m_Statement->setRetainRows(false);
+    this->m_Statement->setMaxRows(0);
+    this->m_Statement->setProjection(_query.projection());
+    this->m_Statement->setLimit(_query.limit());
+    this->m_Statement->setPublishedFrom(_query.publishedFrom());
+    this->m_Statement->setPublishedUntil(_query.publishedUntil());
+    this->m_Statement->setCondition(_query.condition());
+    qCInfo(lcPresto) << "export" << this->m_Service->queryText(_topic, this->m_Statement) << "to" << _fileName << Qt::endl;
+
+    //The file is opened by the first worker, a bad name fails the export before the first page.
+    job->writing = true;
+    launch(job);
+    this->m_Service->query(_topic, this->m_Statement);
+}
+
+/**
+ * @brief Stop the running export and close its query, finished() still comes once the worker
+ * has let go of the file, which is then left as it was.
+ */
+void QueryExporter::cancel()
+{
+    if (this->m_Job.isNull())
+    {
+        return;
+    }
+    if (this->m_Poller)
+    {
+        this->m_Poller->cancel(this->m_Statement);
+    }
+    bool idle = false;
+    {
+        QMutexLocker locker(&this->m_Job->mutex);
+        this->m_Job->cancelled = true;
+        idle = !this->m_Job->writing;
+        this->m_Job->writing = true;
+    }
+    if (idle)
+    {
+        launch(this->m_Job);
+    }
+}
+
+void QueryExporter::handlePageRead(Statement* _statement)
+{
+    if (_statement != this->m_Statement || this->m_Job.isNull())
+    {
+        return;
+    }
+    const QueryResult& page = _statement->result();
+    bool idle = false;
+    bool full = false;
+    bool cancelled = false;
+    {
+        QMutexLocker locker(&this->m_Job->mutex);
+        cancelled = this->m_Job->cancelled;
+        if (!cancelled && page.columnCount() > 0)
+        {
+            if (this->m_Job->columns.isEmpty())
+            {
+                this->m_Job->columns = _statement->columns();
+            }
+            if (page.rowCount() > 0)
+            {
+                this->m_Job->pages.enqueue(page);
+            }
+            full = this->m_Job->pages.size() >= this->m_Job->maxQueued;
+            idle = !this->m_Job->writing;
+            this->m_Job->writing = true;
+        }
+    }
+    if (cancelled)
+    {
+        //The file could not be written, the worker reports why.
+        this->m_Poller->cancel(_statement);
+        return;
+    }
+    if (full)
+    {
+        this->m_Poller->hold(_statement);
+    }
+    if (idle)
+    {
+        launch(this->m_Job);
+    }
+}
+
+void QueryExporter::handleFinished(Statement* _statement)
+{
+    if (_statement != this->m_Statement || this->m_Job.isNull())
+    {
+        return;
+    }
+    bool idle = false;
+    {
+        QMutexLocker locker(&this->m_Job->mutex);
+        this->m_Job->ended = true;
+        if (!_statement->error().isEmpty() && this->m_Job->error.isEmpty())
+        {
+            this->m_Job->error = _statement->error();
+        }
+        idle = !this->m_Job->writing;
+        this->m_Job->writing = true;
+    }
+    if (idle)
+    {
+        launch(this->m_Job);
+    }
+}
+
+void QueryExporter::launch(const QSharedPointer<Job>& _job)
+{
+    QThreadPool::globalInstance()->start([_job]()
+    {
+        run(_job);
+    });
+}
+
+/**
+ * @brief Write the queued pages, then leave the pages to come to another worker, or finish the
+ * file once the statement has ended.
+ */
+void QueryExporter::run(const QSharedPointer<Job>& _job)
+{
+    if (!_job->file)
+    {
+        _job->file.reset(new QSaveFile(_job->fileName));
+        if (!_job->file->open(QIODevice::WriteOnly))
+        {
+            QMutexLocker locker(&_job->mutex);
+            _job->error = _job->file->errorString();
+            _job->cancelled = true;
+        }
+        else if (_job->format == ArrowStream)
+        {
+            _job->arrow.reset(new ArrowStreamWriter(_job->file.get()));
+        }
+    }
+
+    QElapsedTimer progress;
+    progress.start();
+    forever
+    {
+        QueryResult page;
+        QList<Column> columns;
+        bool done = false;
+        {
+            QMutexLocker locker(&_job->mutex);
+            if (_job->cancelled || _job->pages.isEmpty())
+            {
+                if (!_job->cancelled && !_job->ended)
+                {
+                    _job->writing = false;
+                    break;
+                }
+                done = true;
+            }
+            else
+            {
+                page = _job->pages.dequeue();
+            }
+            columns = _job->columns;
+        }
+
+        //The header goes out with the first page, or at the end of a query without rows.
+        bool ok = true;
+        if (!_job->started && !columns.isEmpty() && !(done && _job->cancelled))
+        {
+            _job->started = true;
+            switch (_job->format)
+            {
+            case Csv:
+                ok = _job->file->write(csvHeader(columns)) >= 0;
+                break;
+            case Ndjson:
+                foreach (const Column& column, columns)
+                {
+                    QByteArray key;
+                    appendJson(key, column.name().toUtf8());
+                    _job->keys << key.append(':');
+                }
+                break;
+            case ArrowStream:
+                ok = _job->arrow->writeSchema(columns);
+                break;
+            }
+        }
+        if (done)
+        {
+            break;
+        }
+
+        switch (_job->format)
+        {
+        case Csv:
+            ok = ok && _job->file->write(csvRows(page)) >= 0;
+            break;
+        case Ndjson:
+            ok = ok && _job->file->write(ndjsonRows(page, _job->keys)) >= 0;
+            break;
+        case ArrowStream:
+            ok = ok && _job->arrow->writeBatch(page);
+            break;
+        }
+        _job->rows += page.rowCount();
+        _job->bytes = _job->file->pos();
+        if (!ok)
+        {
+            QMutexLocker locker(&_job->mutex);
+            _job->error = _job->file->errorString();
+            _job->cancelled = true;
+        }
+        if (progress.elapsed() >= PROGRESS_INTERVAL)
+        {
+            report(_job, false);
+            progress.restart();
+        }
+    }
+
+    bool finished = false;
+    {
+        QMutexLocker locker(&_job->mutex);
+        finished = _job->cancelled || (_job->ended && _job->pages.isEmpty());
+        if (_job->cancelled && _job->error.isEmpty())
+        {
+            _job->error = QCoreApplication::translate("QueryExporter", "The export was cancelled.");
+        }
+    }
+    if (!finished)
+    {
+        report(_job, false);
+        return;
+    }
+
+    if (_job->file->isOpen())
+    {
+        if (_job->error.isEmpty() && _job->arrow && !_job->started)
+        {
+            _job->arrow->writeSchema(QList<Column>());
+        }
+        if (_job->error.isEmpty() && _job->arrow)
+        {
+            _job->arrow->writeEnd();
+        }
+        _job->bytes = _job->file->pos();
+        if (!_job->error.isEmpty())
+        {
+            _job->file->cancelWriting();
+        }
+        else if (!_job->file->commit())
+        {
+            _job->error = _job->file->errorString();
+        }
+    }
+    if (_job->error.isEmpty())
+    {
+        qCInfo(lcPresto) << "exported" << _job->rows << "rows to" << _job->fileName << Qt::endl;
+    }
+    else
+    {
+        qCWarning(lcPresto) << "export to" << _job->fileName << "failed:" << _job->error << Qt::endl;
+    }
+    report(_job, true);
+}
+
+/**
+ * @brief Hand the counters to the exporter, which resumes the statement once the worker has
+ * made room in the queue.
+ */
+void QueryExporter::report(const QSharedPointer<Job>& _job, const bool& _finished)
+{
+    qint64 rows = _job->rows;
+    qint64 bytes = _job->bytes;
+    qint64 millis = _job->elapsed.elapsed();
+    QString error;
+    if (_finished)
+    {
+        QMutexLocker locker(&_job->mutex);
+        error = _job->error;
+    }
+    QMetaObject::invokeMethod(QCoreApplication::instance(), [_job, _finished, rows, bytes, millis, error]()
+    {
+        QueryExporter* owner = _job->owner;
+        if (!owner || owner->m_Job != _job)
+        {
+            return;
+        }
+        if (_finished)
+        {
+            //A file which failed stops the query too.
+            if (owner->m_Poller)
+            {
+                owner->m_Poller->cancel(owner->m_Statement);
+            }
+            owner->m_Job.reset();
+            emit owner->finished(error, rows, bytes, millis);
+            return;
+        }
+        emit owner->progress(rows, bytes, millis);
+        bool room = false;
+        {
+            QMutexLocker locker(&_job->mutex);
+            room = _job->pages.size() < _job->maxQueued;
+        }
+        if (room && owner->m_Poller)
+        {
+            owner->m_Poller->resume(owner->m_Statement);
+        }
+    }, Qt::QueuedConnection);
+}
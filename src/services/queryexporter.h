@@ -0,0 +1,78 @@
+#ifndef QUERYEXPORTER_H
+#define QUERYEXPORTER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QSharedPointer>
+
+class PrestoQueryService;
+class PrestoPoller;
+class Statement;
+class Topic;
+
+/**
+ * @brief Writes the result of a Presto query to a local file page by page as it is read.
+ *
+ * The query runs as a statement of its own which keeps the rows of its last page only, each
+ * page is handed to a worker thread that appends it to the file. While maxQueuedPages() pages
+ * wait to be written the poller is held, so a slow disk slows the query down rather than filling
+ * the memory. The file is written as a whole or not at all.
+ *
+ * Csv writes a header line and the values quoted when they need to be, nulls as empty fields.
+ * Ndjson writes one JSON object per row, numbers and booleans unquoted. ArrowStream writes an
+ * Apache Arrow IPC stream with a record batch per page.
+ */
+class QueryExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Format
+    {
+        Csv,
+        Ndjson,
+        ArrowStream
+    };
+
+    /**
+     * @param _service must outlive the exporter, normally the exporter is a child of the service
+     */
+    explicit QueryExporter(PrestoQueryService* _service, QObject* parent = nullptr);
+    ~QueryExporter();
+
+    inline void setMaxQueuedPages(const int& _pages) { this->m_MaxQueuedPages = qMax(1, _pages); }
+    inline int maxQueuedPages() const { return this->m_MaxQueuedPages; }
+
+    /**
+     * @param _query the columns, range, limit and condition of the query, as for PrestoQueryService::query()
+     */
+    void start(const Topic& _topic, const Statement& _query, const Format& _format, const QString& _fileName);
+    void cancel();
+    inline bool isRunning() const { return !this->m_Job.isNull(); }
+
+signals:
+    void progress(qint64 _rows, qint64 _bytes, qint64 _millis);
+    /**
+     * @brief The export is done, _error is empty when the file was written.
+     */
+    void finished(const QString& _error, qint64 _rows, qint64 _bytes, qint64 _millis);
+
+private:
+    struct Job;
+
+    void handlePageRead(Statement* _statement);
+    void handleFinished(Statement* _statement);
+
+    static void launch(const QSharedPointer<Job>& _job);
+    static void run(const QSharedPointer<Job>& _job);
+    static void report(const QSharedPointer<Job>& _job, const bool& _finished);
+
+private:
+    PrestoQueryService* m_Service;
+    QPointer<PrestoPoller> m_Poller;        //gone before the exporter when both are children of the service
+    Statement* m_Statement;
+    QSharedPointer<Job> m_Job;
+    int m_MaxQueuedPages;
+};
+
+#endif // QUERYEXPORTER_H
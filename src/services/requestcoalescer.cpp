@@ -0,0 +1,53 @@
+#include "requestcoalescer.h"
+
+#include <QCoreApplication>
+
+RequestCoalescer* RequestCoalescer::s_Instance = Q_NULLPTR;
+
+RequestCoalescer::RequestCoalescer(QObject* _parent) : QObject(_parent), m_Saved(0)
+{
+}
+
+RequestCoalescer* RequestCoalescer::instance()
+{
+    if (!s_Instance)
+    {
+        s_Instance = new RequestCoalescer(QCoreApplication::instance());
+    }
+    return s_Instance;
+}
+
+/**
+ * @brief Register a waiter for the key.
+ * @param _key
+ * @param _context
+ * @param _callback
+ * @return true if an identical request is already running and the waiter was attached to it,
+ * false if the caller is the first one and has to issue the request.
+ */
+bool RequestCoalescer::join(const QString& _key, QObject* _context, const HttpCallback& _callback)
+{
+    Waiter waiter { _context, QPointer<QObject>(_context), _callback };
+    QHash<QString, QList<Waiter>>::iterator it = this->m_InFlight.find(_key);
+    if (it != this->m_InFlight.end())
+    {
+        it->append(waiter);
+        emit savedChanged(++this->m_Saved);
+        return true;
+    }
+    this->m_InFlight.insert(_key, QList<Waiter>() << waiter);
+    return false;
+}
+
+void RequestCoalescer::complete(const QString& _key, const HttpResponse& _response)
+{
+    //Taken out first, a callback issuing the same request again starts a new flight
+    QList<Waiter> waiters = this->m_InFlight.take(_key);
+    foreach (const Waiter& waiter, waiters)
+    {
+        if (!waiter.context || !waiter.guard.isNull())
+        {
+            waiter.callback(_response);
+        }
+    }
+}
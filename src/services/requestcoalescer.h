@@ -0,0 +1,46 @@
+#ifndef REQUESTCOALESCER_H
+#define REQUESTCOALESCER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QHash>
+
+#include "httpclient.h"
+
+/**
+ * @brief Single-flight for GET requests: while a request is running, identical ones (same url,
+ * same token) wait for its response instead of going to the network again.
+ */
+class RequestCoalescer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static RequestCoalescer* instance();
+
+    bool join(const QString& _key, QObject* _context, const HttpCallback& _callback);
+    void complete(const QString& _key, const HttpResponse& _response);
+
+    inline int saved() const { return this->m_Saved; }
+
+signals:
+    void savedChanged(int);
+
+private:
+    explicit RequestCoalescer(QObject* parent = nullptr);
+
+private:
+    struct Waiter
+    {
+        QObject* context;
+        QPointer<QObject> guard;
+        HttpCallback callback;
+    };
+
+    QHash<QString, QList<Waiter>> m_InFlight;
+    int m_Saved;
+
+    static RequestCoalescer* s_Instance;
+};
+
+#endif // REQUESTCOALESCER_H
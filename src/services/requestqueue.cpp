@@ -0,0 +1,98 @@
+#include "requestqueue.h"
+
+#include <QCoreApplication>
+
+QHash<QString, RequestQueue*> RequestQueue::s_Queues;
+int RequestQueue::s_MaxInFlight = 6;
+
+RequestQueue::RequestQueue(QObject* _parent) : QObject(_parent), m_MaxInFlight(s_MaxInFlight), m_InFlight(0)
+{
+}
+
+RequestQueue* RequestQueue::instance(const QString& _cluster)
+{
+    RequestQueue* queue = s_Queues.value(_cluster, Q_NULLPTR);
+    if (!queue)
+    {
+        queue = new RequestQueue(QCoreApplication::instance());
+        s_Queues.insert(_cluster, queue);
+    }
+    return queue;
+}
+
+void RequestQueue::setDefaultMaxInFlight(const int& _max)
+{
+    if (qMax(1, _max) == s_MaxInFlight)
+    {
+        return;
+    }
+    s_MaxInFlight = qMax(1, _max);
+    foreach (RequestQueue* queue, s_Queues)
+    {
+        queue->setMaxInFlight(s_MaxInFlight);
+    }
+}
+
+void RequestQueue::setMaxInFlight(const int& _max)
+{
+    this->m_MaxInFlight = qMax(1, _max);
+    pump();
+}
+
+void RequestQueue::enqueue(const HttpClient* _client, const HttpRequest& _request, QObject* _context, const HttpCallback& _callback)
+{
+    Job job { _client, _request, QPointer<QObject>(_context), _callback, HttpStreamCallback() };
+    this->m_Jobs.enqueue(job);
+    pump();
+}
+
+/**
+ * @brief Queue a streamed request, the data callback gets the body chunk by chunk.
+ */
+void RequestQueue::enqueue(const HttpClient* _client, const HttpRequest& _request, QObject* _context, const HttpStreamCallback& _onData, const HttpCallback& _callback)
+{
+    Job job { _client, _request, QPointer<QObject>(_context), _callback, _onData };
+    this->m_Jobs.enqueue(job);
+    pump();
+}
+
+void RequestQueue::pump()
+{
+    while (this->m_InFlight < this->m_MaxInFlight && !this->m_Jobs.isEmpty())
+    {
+        Job job = this->m_Jobs.dequeue();
+        if (job.context.isNull())
+        {
+            continue; //the requester has gone away
+        }
+
+        this->m_InFlight++;
+        QPointer<QObject> context = job.context;
+        HttpCallback callback = job.callback;
+        //The queue is the context of the reply, so the slot is released even if the requester is gone.
+        HttpCallback finished = [this, context, callback](const HttpResponse& _response)
+        {
+            this->m_InFlight--;
+            if (!context.isNull())
+            {
+                callback(_response);
+            }
+            pump();
+        };
+        if (job.onData)
+        {
+            HttpStreamCallback onData = job.onData;
+            job.client->stream(job.request, this, [context, onData](const QByteArray& _chunk)
+            {
+                if (!context.isNull())
+                {
+                    onData(_chunk);
+                }
+            }, finished);
+        }
+        else
+        {
+            job.client->send(job.request, this, finished);
+        }
+    }
+}
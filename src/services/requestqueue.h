@@ -0,0 +1,65 @@
+#ifndef REQUESTQUEUE_H
+#define REQUESTQUEUE_H
+
+#include <QObject>
+#include <QPointer>
+#include <QQueue>
+#include <QHash>
+
+#include "httpclient.h"
+
+/**
+ * @brief Bounded-concurrency dispatcher for asynchronous requests.
+ *
+ * One queue exists per cluster, so every window talking to the same cluster shares its
+ * budget of in-flight requests. Requests over the limit wait in FIFO order.
+ */
+class RequestQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    static RequestQueue* instance(const QString& _cluster);
+
+    /**
+     * The limit of every queue, the ones to come included.
+     */
+    static void setDefaultMaxInFlight(const int& _max);
+
+    inline int maxInFlight() const { return this->m_MaxInFlight; }
+    void setMaxInFlight(const int& _max);
+
+    inline int inFlight() const { return this->m_InFlight; }
+    inline int pending() const { return this->m_Jobs.size(); }
+
+    /**
+     * The client must stay alive as long as the context does, normally the context is the
+     * service owning the client. Queued jobs whose context is gone are dropped.
+     */
+    void enqueue(const HttpClient* _client, const HttpRequest& _request, QObject* _context, const HttpCallback& _callback);
+    void enqueue(const HttpClient* _client, const HttpRequest& _request, QObject* _context, const HttpStreamCallback& _onData, const HttpCallback& _callback);
+
+private:
+    explicit RequestQueue(QObject* parent = nullptr);
+
+    void pump();
+
+private:
+    struct Job
+    {
+        const HttpClient* client;
+        HttpRequest request;
+        QPointer<QObject> context;
+        HttpCallback callback;
+        HttpStreamCallback onData;
+    };
+
+    QQueue<Job> m_Jobs;
+    int m_MaxInFlight;
+    int m_InFlight;
+
+    static QHash<QString, RequestQueue*> s_Queues;
+    static int s_MaxInFlight;
+};
+
+#endif // REQUESTQUEUE_H
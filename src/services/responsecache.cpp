@@ -0,0 +1,208 @@
+#include "responsecache.h"
+
+#include <QDir>
+#include <QSettings>
+#include <QCoreApplication>
+#include <QCryptographicHash>
+
+#include "../constants.h"
+#include "../logging.h"
+#include "connectionpool.h"
+#include "endpointtemplates.h"
+
+ResponseCache* ResponseCache::s_Instance = Q_NULLPTR;
+
+ResponseCache::ResponseCache(QObject* _parent) : QObject(_parent)
+{
+    QDir dir(QCoreApplication::applicationDirPath());
+    this->m_Settings = new QSettings(dir.absoluteFilePath(INI_FILE), QSettings::IniFormat, this);
+    this->m_MaxEntries = this->m_Settings->value(CACHE_MAX_ENTRIES_KEY, 512).toInt();
+    this->m_MaxBytes = this->m_Settings->value(CACHE_MAX_BYTES_KEY, 16777216).toLongLong();
+    this->m_Bytes = 0;
+    this->m_MaxStreamedBody = this->m_Settings->value(CACHE_MAX_STREAMED_BODY_KEY, 1048576).toInt();
+}
+
+ResponseCache* ResponseCache::instance()
+{
+    if (!s_Instance)
+    {
+        s_Instance = new ResponseCache(QCoreApplication::instance());
+    }
+    return s_Instance;
+}
+
+/**
+ * @brief Responses depend on the caller's token, so it is part of the key.
+ * @param _url
+ * @param _token
+ * @return
+ */
+QString ResponseCache::key(const QUrl& _url, const QString& _token)
+{
+    QByteArray token = _token.isEmpty() ? QByteArray() : QCryptographicHash::hash(_token.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return _url.toString().append('|').append(QString::fromLatin1(token));
+}
+
+int ResponseCache::ttl(const HttpRequest& _request) const
+{
+    if (_request.method != HttpRequest::Get)
+    {
+        return 0;
+    }
+    QString endpoint = EndpointTemplates::instance()->match(_request.method, _request.url);
+    int ttl = this->m_Settings->value(CACHE_DEFAULT_TTL_KEY, 0).toInt();
+    if (!endpoint.isEmpty())
+    {
+        ttl = this->m_Settings->value(QString("HTTP_CACHE/").append(endpoint), ttl).toInt();
+    }
+    return ttl;
+}
+
+bool ResponseCache::lookup(const QString& _key, HttpResponse& _response) const
+{
+    QHash<QString, Entry>::const_iterator it = this->m_Entries.constFind(_key);
+    if (it != this->m_Entries.constEnd() && it->expires > QDateTime::currentDateTimeUtc())
+    {
+        _response = it->response;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Turn the request into a conditional one when a stale entry has validators.
+ * @param _key
+ * @param _request
+ */
+void ResponseCache::prepare(const QString& _key, HttpRequest& _request) const
+{
+    QHash<QString, Entry>::const_iterator it = this->m_Entries.constFind(_key);
+    if (it != this->m_Entries.constEnd())
+    {
+        if (!it->etag.isEmpty())
+        {
+            _request.headers.append(QNetworkReply::RawHeaderPair("If-None-Match", it->etag));
+        }
+        if (!it->lastModified.isEmpty())
+        {
+            _request.headers.append(QNetworkReply::RawHeaderPair("If-Modified-Since", it->lastModified));
+        }
+    }
+}
+
+/**
+ * @brief The broker answered 304 Not Modified, serve the cached body for another ttl.
+ * @param _key
+ * @param _request
+ * @param _response
+ * @return
+ */
+HttpResponse ResponseCache::revalidated(const QString& _key, const HttpRequest& _request, const HttpResponse& _response)
+{
+    QHash<QString, Entry>::iterator it = this->m_Entries.find(_key);
+    if (it == this->m_Entries.end())
+    {
+        return _response;
+    }
+    it->expires = QDateTime::currentDateTimeUtc().addSecs(ttl(_request));
+    qCDebug(lcHttp) << "Revalidated cached response: " << _request.url.toString() << Qt::endl;
+    return it->response;
+}
+
+void ResponseCache::store(const QString& _key, const HttpRequest& _request, const HttpResponse& _response)
+{
+    int seconds = ttl(_request);
+    if (seconds <= 0 || !_response.isSuccess() || _response.body.size() > this->m_MaxBytes)
+    {
+        return;
+    }
+
+    Entry entry;
+    entry.url = _request.url;
+    entry.response = _response;
+    entry.expires = QDateTime::currentDateTimeUtc().addSecs(seconds);
+    entry.etag = _response.header("ETag");
+    entry.lastModified = _response.header("Last-Modified");
+    this->m_Bytes -= this->m_Entries.value(_key).response.body.size();
+    this->m_Bytes += entry.response.body.size();
+    this->m_Entries.insert(_key, entry);
+
+    if (this->m_Entries.size() > this->m_MaxEntries || this->m_Bytes > this->m_MaxBytes)
+    {
+        evict();
+    }
+}
+
+/**
+ * @brief Drop every entry of the resource, its parents and its children on the same origin,
+ * e.g. invalidating /admin/v2/persistent/public/default also drops the topic list and the stats
+ * of every topic in the namespace.
+ * @param _url
+ */
+void ResponseCache::invalidate(const QUrl& _url)
+{
+    QString origin = ConnectionPool::origin(_url);
+    QString path = _url.path();
+    if (path.endsWith('/'))
+    {
+        path.chop(1);
+    }
+
+    QHash<QString, Entry>::iterator it = this->m_Entries.begin();
+    while (it != this->m_Entries.end())
+    {
+        QString other = it->url.path();
+        bool related = other == path || other.startsWith(path + '/') || path.startsWith(other + '/');
+        if (related && ConnectionPool::origin(it->url) == origin)
+        {
+            this->m_Bytes -= it->response.body.size();
+            it = this->m_Entries.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void ResponseCache::clear()
+{
+    this->m_Entries.clear();
+    this->m_Bytes = 0;
+}
+
+/**
+ * @brief Drop the expired entries, then the ones closest to expiry until the cache fits in both
+ * its entry and byte budgets.
+ */
+void ResponseCache::evict()
+{
+    QDateTime now = QDateTime::currentDateTimeUtc();
+    QHash<QString, Entry>::iterator it = this->m_Entries.begin();
+    while (it != this->m_Entries.end())
+    {
+        if (it->expires <= now && it->etag.isEmpty() && it->lastModified.isEmpty())
+        {
+            this->m_Bytes -= it->response.body.size();
+            it = this->m_Entries.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    while (!this->m_Entries.isEmpty() && (this->m_Entries.size() > this->m_MaxEntries || this->m_Bytes > this->m_MaxBytes))
+    {
+        QHash<QString, Entry>::iterator oldest = this->m_Entries.begin();
+        for (it = this->m_Entries.begin(); it != this->m_Entries.end(); ++it)
+        {
+            if (it->expires < oldest->expires)
+            {
+                oldest = it;
+            }
+        }
+        this->m_Bytes -= oldest->response.body.size();
+        this->m_Entries.erase(oldest);
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef RESPONSECACHE_H
+#define RESPONSECACHE_H
+
+#include <QObject>
+#include <QHash>
+#include <QDateTime>
+
+#include "httpclient.h"
+
+class QSettings;
+
+/**
+ * @brief Process-wide cache of GET responses of the admin api.
+ *
+ * The time to live of every endpoint is configured in the HTTP_CACHE section of config.ini,
+ * keyed like the PULSAR_SERVICE_PATH entries. Expired entries carrying an ETag or a
+ * Last-Modified header are revalidated with a conditional request instead of being dropped.
+ * The cache holds MAX_ENTRIES responses and MAX_BYTES of bodies at most.
+ */
+class ResponseCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static ResponseCache* instance();
+
+    static QString key(const QUrl& _url, const QString& _token);
+
+    bool lookup(const QString& _key, HttpResponse& _response) const;
+    void prepare(const QString& _key, HttpRequest& _request) const;
+    HttpResponse revalidated(const QString& _key, const HttpRequest& _request, const HttpResponse& _response);
+    void store(const QString& _key, const HttpRequest& _request, const HttpResponse& _response);
+
+    void invalidate(const QUrl& _url);
+    void clear();
+
+    int ttl(const HttpRequest& _request) const;
+    inline int maxStreamedBody() const { return this->m_MaxStreamedBody; }
+
+private:
+    explicit ResponseCache(QObject* parent = nullptr);
+
+    void evict();
+
+private:
+    struct Entry
+    {
+        QUrl url;
+        HttpResponse response;
+        QDateTime expires;
+        QByteArray etag;
+        QByteArray lastModified;
+    };
+
+    QHash<QString, Entry> m_Entries;
+    QSettings* m_Settings;
+    int m_MaxEntries;
+    qint64 m_MaxBytes;
+    qint64 m_Bytes;
+    int m_MaxStreamedBody;
+
+    static ResponseCache* s_Instance;
+};
+
+#endif // RESPONSECACHE_H
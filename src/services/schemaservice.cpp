@@ -0,0 +1,203 @@
+#include "schemaservice.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPointer>
+#include <QThreadPool>
+#include <QCoreApplication>
+
+#include "../constants.h"
+#include "../logging.h"
+#include "../schemadecoder.h"
+#include "requestqueue.h"
+
+QHash<QString, QSharedPointer<const SchemaDecoder>> SchemaService::s_Decoders;
+QHash<QString, SchemaService::Latest> SchemaService::s_Latest;
+
+namespace
+{
+    struct DecodeJob
+    {
+        QList<PulsarMessage> messages;
+        QHash<qint64, QSharedPointer<const SchemaDecoder>> decoders;
+        QList<QVariant> results;
+        QPointer<QObject> context;
+        SchemaService::DecodeCallback callback;
+        int loading;
+        int running;
+    };
+
+    /**
+     * @brief Split the page into one slice per pool thread, the slices come back to the GUI
+     * thread and the callback runs once all are in.
+     */
+    void run(const QSharedPointer<DecodeJob>& _job)
+    {
+        const int count = _job->messages.size();
+        if (count == 0)
+        {
+            if (!_job->context.isNull())
+            {
+                _job->callback(_job->results);
+            }
+            return;
+        }
+        int threads = qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+        int size = (count + threads - 1) / threads;
+        _job->running = (count + size - 1) / size;
+        for (int start = 0; start < count; start += size)
+        {
+            QList<PulsarMessage> slice = _job->messages.mid(start, size);
+            QHash<qint64, QSharedPointer<const SchemaDecoder>> decoders = _job->decoders;
+            QThreadPool::globalInstance()->start([_job, slice, decoders, start]()
+            {
+                QList<QVariant> values;
+                values.reserve(slice.size());
+                foreach (const PulsarMessage& message, slice)
+                {
+                    QSharedPointer<const SchemaDecoder> decoder = decoders.value(message.schemaVersion());
+                    values << (decoder.isNull() ? QVariant() : decoder->decode(message.key().toUtf8(), message.bodyView()));
+                }
+                QMetaObject::invokeMethod(QCoreApplication::instance(), [_job, values, start]()
+                {
+                    for (int i = 0, n = values.size(); i < n; ++i)
+                    {
+                        _job->results[start + i] = values[i];
+                    }
+                    if (--_job->running == 0 && !_job->context.isNull())
+                    {
+                        _job->callback(_job->results);
+                    }
+                }, Qt::QueuedConnection);
+            });
+        }
+    }
+}
+
+void SchemaService::decode(const Topic& _topic, const QList<PulsarMessage>& _messages, QObject* _context, const DecodeCallback& _callback)
+{
+    QSharedPointer<DecodeJob> job(new DecodeJob);
+    job->messages = _messages;
+    for (int i = 0, n = _messages.size(); i < n; ++i)
+    {
+        job->results << QVariant();
+    }
+    job->context = _context;
+    job->callback = _callback;
+    job->loading = 0;
+    job->running = 0;
+
+    QList<qint64> missing;
+    foreach (const PulsarMessage& message, _messages)
+    {
+        qint64 version = message.schemaVersion();
+        if (job->decoders.contains(version) || missing.contains(version))
+        {
+            continue;
+        }
+        if (version >= 0 && s_Decoders.contains(cacheKey(_topic, version)))
+        {
+            job->decoders.insert(version, s_Decoders.value(cacheKey(_topic, version)));
+        }
+        else if (version < 0 && s_Latest.value(cacheKey(_topic, version)).expires > QDateTime::currentDateTimeUtc())
+        {
+            job->decoders.insert(version, s_Latest.value(cacheKey(_topic, version)).decoder);
+        }
+        else
+        {
+            missing << version;
+        }
+    }
+
+    job->loading = missing.size();
+    if (job->loading == 0)
+    {
+        run(job);
+        return;
+    }
+    foreach (qint64 version, missing)
+    {
+        load(_topic, version, [job, version](const QSharedPointer<const SchemaDecoder>& _decoder)
+        {
+            job->decoders.insert(version, _decoder);
+            if (--job->loading == 0)
+            {
+                run(job);
+            }
+        });
+    }
+}
+
+/**
+ * @brief Fetch and compile a schema, -1 stands for the latest version. Versions that do not
+ * exist are remembered as such, the latest version and a topic without a schema for
+ * LATEST_SCHEMA_TTL seconds. Other failures are not remembered.
+ */
+void SchemaService::load(const Topic& _topic, const qint64& _version, const LoadCallback& _callback)
+{
+    QUrl url = schemaUrl(_topic, _version);
+    qCInfo(lcTopic) << "Get Schema Service url: " << url.toString() << Qt::endl;
+
+    Topic topic(_topic);
+    int ttl = this->m_Settings->value(LATEST_SCHEMA_TTL_KEY, 60).toInt();
+    QString cluster(_topic.getNamespace().tenant().cluster().adminUrl());
+    RequestQueue::instance(cluster)->enqueue(this->m_Client, HttpRequest(HttpRequest::Get, url), this, [topic, _version, ttl, _callback](const HttpResponse& _response)
+    {
+        QSharedPointer<const SchemaDecoder> decoder;
+        qint64 version = _version;
+        QJsonParseError error;
+        QJsonDocument doc = QJsonDocument::fromJson(_response.body, &error);
+        if (_response.isSuccess() && error.error == QJsonParseError::NoError)
+        {
+            QJsonObject root = doc.object();
+            version = root["version"].toVariant().toLongLong();
+            QString key = cacheKey(topic, version);
+            if (s_Decoders.contains(key))
+            {
+                decoder = s_Decoders.value(key);
+            }
+            else
+            {
+                Properties properties;
+                QJsonObject props = root["properties"].toObject();
+                for (QJsonObject::const_iterator it = props.constBegin(); it != props.constEnd(); ++it)
+                {
+                    properties[it.key()] = it.value().toString();
+                }
+                decoder = SchemaDecoder::create(root["type"].toString().toUtf8(), root["data"].toString().toUtf8(), properties);
+                s_Decoders.insert(key, decoder);
+            }
+        }
+        else
+        {
+            qCWarning(lcTopic) << "Get Schema " << _version << " failed: " << _response.code << Qt::endl;
+            if (_version >= 0 && _response.code == HttpStatusCode::StatusCode::NotFound)
+            {
+                s_Decoders.insert(cacheKey(topic, _version), decoder);
+            }
+        }
+        if (_version < 0 && ttl > 0 && (_response.isSuccess() || _response.code == HttpStatusCode::StatusCode::NotFound))
+        {
+            s_Latest.insert(cacheKey(topic, _version), Latest { decoder, QDateTime::currentDateTimeUtc().addSecs(ttl) });
+        }
+        _callback(decoder);
+    });
+}
+
+QUrl SchemaService::schemaUrl(const Topic& _topic, const qint64& _version) const
+{
+    QString path(_topic.getNamespace().tenant().cluster().adminUrl());
+    if (_version < 0)
+    {
+        path = path.append(this->m_Settings->value(GET_LATEST_SCHEMA_PATH_KEY).toString());
+        return QUrl(path.arg(_topic.getNamespace().tenant().name(), _topic.getNamespace().name(), _topic.name()));
+    }
+    path = path.append(this->m_Settings->value(GET_SCHEMA_PATH_KEY).toString());
+    return QUrl(path.arg(_topic.getNamespace().tenant().name(), _topic.getNamespace().name(), _topic.name()).arg(_version));
+}
+
+QString SchemaService::cacheKey(const Topic& _topic, const qint64& _version)
+{
+    return QString("%1/%2/%3/%4/%5").arg(_topic.getNamespace().tenant().cluster().adminUrl(), _topic.getNamespace().tenant().name(),
+                                         _topic.getNamespace().name(), _topic.name()).arg(_version);
+}
@@ -0,0 +1,58 @@
+#ifndef SCHEMASERVICE_H
+#define SCHEMASERVICE_H
+
+#include <QHash>
+#include <QVariant>
+#include <QSharedPointer>
+#include <QDateTime>
+
+#include "baseservice.h"
+
+#include "../topic.h"
+#include "../pulsarmessage.h"
+
+class SchemaDecoder;
+
+/**
+ * @brief Decodes messages with the schemas of their topic.
+ *
+ * Schemas are fetched by the version the messages were produced with, or the latest one for
+ * messages without a version, and compiled once into a decoder cached per topic and version
+ * for the whole process. The latest version of a topic, or that it has none, is remembered for
+ * LATEST_SCHEMA_TTL seconds. A page of messages is decoded in slices on the global thread pool.
+ */
+class SchemaService : public BaseService
+{
+    Q_OBJECT
+
+public:
+    explicit SchemaService(QObject* parent = nullptr) : BaseService(parent) {}
+
+    typedef std::function<void(const QList<QVariant>&)> DecodeCallback;
+
+    /**
+     * @brief The callback gets the decoded values in the order of _messages, an invalid
+     * QVariant for a message that could not be decoded. It is not called once _context is gone.
+     */
+    void decode(const Topic& _topic, const QList<PulsarMessage>& _messages, QObject* _context, const DecodeCallback& _callback);
+
+private:
+    typedef std::function<void(const QSharedPointer<const SchemaDecoder>&)> LoadCallback;
+
+    void load(const Topic& _topic, const qint64& _version, const LoadCallback& _callback);
+    QUrl schemaUrl(const Topic& _topic, const qint64& _version) const;
+
+    static QString cacheKey(const Topic& _topic, const qint64& _version);
+
+private:
+    struct Latest
+    {
+        QSharedPointer<const SchemaDecoder> decoder; //null for a topic without a schema
+        QDateTime expires;
+    };
+
+    static QHash<QString, QSharedPointer<const SchemaDecoder>> s_Decoders;
+    static QHash<QString, Latest> s_Latest;
+};
+
+#endif // SCHEMASERVICE_H
@@ -6,9 +6,9 @@
 #include <QHttpPart>
 #include <QFileInfo>
 #include <QMimeDatabase>
-#include <QDebug>
 
 #include "../constants.h"
+#include "../logging.h"
 
 QList<Sink> SinkService::sinks(const Namespace& _namespace) const
 {
@@ -30,7 +30,7 @@ QList<Sink> SinkService::sinks(const Namespace& _namespace) const
 void SinkService::create(const Sink& _sink, QFile* _file, HttpStatusCode& _code)
 {
     QByteArray json = _sink.toJson();
-    qDebug() << "Greate a new Sink request body: " << QString::fromLatin1(json) << Qt::endl;
+    qCDebug(lcFunction) << "Greate a new Sink request body: " << QString::fromLatin1(json) << Qt::endl;
 
     QHttpMultiPart* multiPart = new QHttpMultiPart(QHttpMultiPart::FormDataType);
     //配置部分
@@ -55,7 +55,7 @@ void SinkService::create(const Sink& _sink, QFile* _file, HttpStatusCode& _code)
     QString path(_sink.getNamespace().tenant().cluster().functionUrl());
     path += this->m_Settings->value(PUT_NEW_SINK_PATH_KEY).toString();
     QUrl url(path.arg(_sink.getNamespace().tenant().name(), _sink.getNamespace().name(), _sink.name()));
-    qDebug() << "Greate a new Sink service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Greate a new Sink service url: " << url.toString() << Qt::endl;
 
     int code;
     QByteArray result = this->m_Client->post(url, multiPart, code);
@@ -82,13 +82,13 @@ void SinkService::create(const Sink& _sink, QFile* _file, HttpStatusCode& _code)
         break;
     }
 
-    qDebug() << "Greate a new Sink response result: " << QString::fromLatin1(result) << ", code: " << code << Qt::endl;
+    qCDebug(lcFunction) << "Greate a new Sink response result: " << QString::fromLatin1(result) << ", code: " << code << Qt::endl;
 }
 
 void SinkService::update(const Sink& _sink, QFile* _file, HttpStatusCode& _code)
 {
     QByteArray json = _sink.toJson();
-    qDebug() << "Update Sink request body: " << QString::fromLatin1(json) << Qt::endl;
+    qCDebug(lcFunction) << "Update Sink request body: " << QString::fromLatin1(json) << Qt::endl;
 
     QHttpMultiPart* multiPart = new QHttpMultiPart(QHttpMultiPart::FormDataType);
     //配置部分
@@ -116,7 +116,7 @@ void SinkService::update(const Sink& _sink, QFile* _file, HttpStatusCode& _code)
     QString path(_sink.getNamespace().tenant().cluster().functionUrl());
     path += this->m_Settings->value(PUT_SINK_PATH_KEY).toString();
     QUrl url(path.arg(_sink.getNamespace().tenant().name(), _sink.getNamespace().name(), _sink.name()));
-    qDebug() << "Updae a Sink service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Updae a Sink service url: " << url.toString() << Qt::endl;
 
     int code;
     QByteArray result = this->m_Client->put(url, multiPart, code);
@@ -151,7 +151,7 @@ void SinkService::update(const Sink& _sink, QFile* _file, HttpStatusCode& _code)
         break;
     }
 
-    qDebug() << "Updae a Sink response result: " << QString::fromLatin1(result) << ", code: " << code << Qt::endl;
+    qCDebug(lcFunction) << "Updae a Sink response result: " << QString::fromLatin1(result) << ", code: " << code << Qt::endl;
 }
 
 void SinkService::remove(const Sink& _sink, HttpStatusCode& _code)
@@ -159,7 +159,7 @@ void SinkService::remove(const Sink& _sink, HttpStatusCode& _code)
     QString path(_sink.getNamespace().tenant().cluster().functionUrl());
     path += this->m_Settings->value(DELETE_SINK_PATH_KEY).toString();
     QUrl url(path.arg(_sink.getNamespace().tenant().name(), _sink.getNamespace().name(), _sink.name()));
-    qDebug() << "Delete a Sink service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Delete a Sink service url: " << url.toString() << Qt::endl;
 
     int statusCode;
     QByteArray result = this->m_Client->deleteResource(url, statusCode);
@@ -194,7 +194,7 @@ void SinkService::remove(const Sink& _sink, HttpStatusCode& _code)
         break;
     }
 
-    qDebug() << "Delete a Sink response result: " << QString::fromLatin1(result) << ", code: " << statusCode << Qt::endl;
+    qCDebug(lcFunction) << "Delete a Sink response result: " << QString::fromLatin1(result) << ", code: " << statusCode << Qt::endl;
 }
 
 void SinkService::start(const Sink& _sink, HttpStatusCode& _code)
@@ -202,7 +202,7 @@ void SinkService::start(const Sink& _sink, HttpStatusCode& _code)
     QString path(_sink.getNamespace().tenant().cluster().functionUrl());
     path += this->m_Settings->value(START_SINK_PATH_KEY).toString();
     QUrl url(path.arg(_sink.getNamespace().tenant().name(), _sink.getNamespace().name(), _sink.name()));
-    qDebug() << "Start a Sink service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Start a Sink service url: " << url.toString() << Qt::endl;
 
     int statusCode;
     QByteArray result = this->m_Client->post(url, QByteArray(), statusCode);
@@ -233,7 +233,7 @@ void SinkService::start(const Sink& _sink, HttpStatusCode& _code)
         break;
     }
 
-    qDebug() << "Start a Sink response result: " << QString::fromLatin1(result) << ", code: " << statusCode << Qt::endl;
+    qCDebug(lcFunction) << "Start a Sink response result: " << QString::fromLatin1(result) << ", code: " << statusCode << Qt::endl;
 }
 
 void SinkService::stop(const Sink& _sink, HttpStatusCode& _code)
@@ -241,7 +241,7 @@ void SinkService::stop(const Sink& _sink, HttpStatusCode& _code)
     QString path(_sink.getNamespace().tenant().cluster().functionUrl());
     path += this->m_Settings->value(STOP_SINK_PATH_KEY).toString();
     QUrl url(path.arg(_sink.getNamespace().tenant().name(), _sink.getNamespace().name(), _sink.name()));
-    qDebug() << "Stop a Sink service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Stop a Sink service url: " << url.toString() << Qt::endl;
 
     int statusCode;
     QByteArray result = this->m_Client->post(url, QByteArray(), statusCode);
@@ -272,7 +272,7 @@ void SinkService::stop(const Sink& _sink, HttpStatusCode& _code)
         break;
     }
 
-    qDebug() << "Stop a Sink response result: " << QString::fromLatin1(result) << ", code: " << statusCode << Qt::endl;
+    qCDebug(lcFunction) << "Stop a Sink response result: " << QString::fromLatin1(result) << ", code: " << statusCode << Qt::endl;
 }
 
 QList<FunctionInstance> SinkService::instances(const Sink& _sink) const
@@ -281,7 +281,7 @@ QList<FunctionInstance> SinkService::instances(const Sink& _sink) const
     QString path(_sink.getNamespace().tenant().cluster().functionUrl());
     path += this->m_Settings->value(GET_SINK_STATUS_PATH_KEY).toString();
     QUrl url(path.arg(_sink.getNamespace().tenant().name(), _sink.getNamespace().name(), _sink.name()));
-    qDebug() << "Get Sink status service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Get Sink status service url: " << url.toString() << Qt::endl;
 
     int code;
     QByteArray result = this->m_Client->get(url, code);
@@ -310,7 +310,7 @@ QList<FunctionInstance> SinkService::instances(const Sink& _sink) const
         }
     }
 
-    qDebug() << "Get Source Sink response result: " << QString::fromLatin1(result) << Qt::endl;
+    qCDebug(lcFunction) << "Get Source Sink response result: " << QString::fromLatin1(result) << Qt::endl;
 
     return instances;
 }
@@ -321,7 +321,7 @@ QStringList SinkService::sinkNames(const Namespace& _namespace) const
     QString path(_namespace.tenant().cluster().functionUrl());
     path += this->m_Settings->value(GET_SINKS_PATH_KEY).toString();
     QUrl url(path.arg(_namespace.tenant().name(), _namespace.name()));
-    qDebug() << "Get Sink names service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Get Sink names service url: " << url.toString() << Qt::endl;
 
     int code;
     QByteArray result = this->m_Client->get(url, code);
@@ -339,7 +339,7 @@ QStringList SinkService::sinkNames(const Namespace& _namespace) const
         }
     }
 
-    qDebug() << "Get Sink names response result: " << QString::fromLatin1(result) << ", code: " << code << Qt::endl;
+    qCDebug(lcFunction) << "Get Sink names response result: " << QString::fromLatin1(result) << ", code: " << code << Qt::endl;
 
     return names;
 }
@@ -349,11 +349,11 @@ QByteArray SinkService::information(const Namespace& _namespace, const QString&
     QString path(_namespace.tenant().cluster().functionUrl());
     path += this->m_Settings->value(GET_SINK_INFO_PATH_KEY).toString();
     QUrl url(path.arg(_namespace.tenant().name(), _namespace.name(), _name));
-    qDebug() << "Get Sink information service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Get Sink information service url: " << url.toString() << Qt::endl;
 
     int code;
     QByteArray result = this->m_Client->get(url, code);
-    qDebug() << "Get Sink information response result: " << QString::fromLatin1(result) << ", code: " << code << Qt::endl;
+    qCDebug(lcFunction) << "Get Sink information response result: " << QString::fromLatin1(result) << ", code: " << code << Qt::endl;
 
     return result;
 }
@@ -363,11 +363,11 @@ QByteArray SinkService::status(const Namespace& _namespace, const QString& _name
     QString path(_namespace.tenant().cluster().functionUrl());
     path += this->m_Settings->value(GET_SINK_STATUS_PATH_KEY).toString();
     QUrl url(path.arg(_namespace.tenant().name(), _namespace.name(), _name));
-    qDebug() << "Get Sink status service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Get Sink status service url: " << url.toString() << Qt::endl;
 
     int code;
     QByteArray result = this->m_Client->get(url, code);
-    qDebug() << "Get Sink status response result: " << QString::fromLatin1(result) << ", code: " << code << Qt::endl;
+    qCDebug(lcFunction) << "Get Sink status response result: " << QString::fromLatin1(result) << ", code: " << code << Qt::endl;
 
     return result;
 }
@@ -6,9 +6,9 @@
 #include <QHttpPart>
 #include <QFileInfo>
 #include <QMimeDatabase>
-#include <QDebug>
 
 #include "../constants.h"
+#include "../logging.h"
 
 QList<Source> SourceService::sources(const Namespace& _namespace)
 {
@@ -16,7 +16,7 @@ QList<Source> SourceService::sources(const Namespace& _namespace)
     QString path(_namespace.tenant().cluster().functionUrl());
     path += this->m_Settings->value(GET_SOURCES_PATH_KEY).toString();
     QUrl url(path.arg(_namespace.tenant().name(), _namespace.name()));
-    qDebug() << "Get Sources List service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Get Sources List service url: " << url.toString() << Qt::endl;
 
     int code;
     QByteArray result = this->m_Client->get(url, code);
@@ -38,7 +38,7 @@ QList<Source> SourceService::sources(const Namespace& _namespace)
         }
     }
 
-    qDebug() << "Get Sources List response result: " << QString::fromLatin1(result) << Qt::endl;
+    qCDebug(lcFunction) << "Get Sources List response result: " << QString::fromLatin1(result) << Qt::endl;
 
     return sources;
 }
@@ -48,7 +48,7 @@ Source& SourceService::information(Source& _source)
     QString path(_source.getNamespace().tenant().cluster().functionUrl());
     path += this->m_Settings->value(GET_SOURCE_INFO_PATH_KEY).toString();
     QUrl url(path.arg(_source.getNamespace().tenant().name(), _source.getNamespace().name(), _source.name()));
-    qDebug() << "Get Source information service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Get Source information service url: " << url.toString() << Qt::endl;
 
     int code;
     QByteArray result = this->m_Client->get(url, code);
@@ -71,7 +71,7 @@ Source& SourceService::information(Source& _source)
         }
     }
 
-    qDebug() << "Get Source information response result: " << QString::fromLatin1(result) << Qt::endl;
+    qCDebug(lcFunction) << "Get Source information response result: " << QString::fromLatin1(result) << Qt::endl;
 
     return _source;
 }
@@ -81,7 +81,7 @@ Source& SourceService::status(Source& _source)
     QString path(_source.getNamespace().tenant().cluster().functionUrl());
     path += this->m_Settings->value(GET_SOURCE_STATUS_PATH_KEY).toString();
     QUrl url(path.arg(_source.getNamespace().tenant().name(), _source.getNamespace().name(), _source.name()));
-    qDebug() << "Get Source status service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Get Source status service url: " << url.toString() << Qt::endl;
 
     int code;
     QByteArray result = this->m_Client->get(url, code);
@@ -97,7 +97,7 @@ Source& SourceService::status(Source& _source)
         }
     }
 
-    qDebug() << "Get Source status response result: " << QString::fromLatin1(result) << Qt::endl;
+    qCDebug(lcFunction) << "Get Source status response result: " << QString::fromLatin1(result) << Qt::endl;
 
     return _source;
 }
@@ -105,7 +105,7 @@ Source& SourceService::status(Source& _source)
 void SourceService::createSource(const Source& _source, QFile* _file, HttpStatusCode& _code)
 {
     QByteArray json = _source.toJson();
-    qDebug() << "Greate a new Source request body: " << QString::fromLatin1(json) << Qt::endl;
+    qCDebug(lcFunction) << "Greate a new Source request body: " << QString::fromLatin1(json) << Qt::endl;
 
     QHttpMultiPart* multiPart = new QHttpMultiPart(QHttpMultiPart::FormDataType);
     //配置部分
@@ -131,7 +131,7 @@ void SourceService::createSource(const Source& _source, QFile* _file, HttpStatus
     QString path(_source.getNamespace().tenant().cluster().functionUrl());
     path += this->m_Settings->value(PUT_NEW_SOURCE_PATH_KEY).toString();
     QUrl url(path.arg(_source.getNamespace().tenant().name(), _source.getNamespace().name(), _source.name()));
-    qDebug() << "Greate a new Source service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Greate a new Source service url: " << url.toString() << Qt::endl;
 
     int code;
     QByteArray result = this->m_Client->post(url, multiPart, code);
@@ -158,13 +158,13 @@ void SourceService::createSource(const Source& _source, QFile* _file, HttpStatus
         break;
     }
 
-    qDebug() << "Greate a new Source response result: " << QString::fromLatin1(result) << ", code: " << code << Qt::endl;
+    qCDebug(lcFunction) << "Greate a new Source response result: " << QString::fromLatin1(result) << ", code: " << code << Qt::endl;
 }
 
 void SourceService::updateSource(const Source& _source, QFile* _file, HttpStatusCode& _code)
 {
     QByteArray json = _source.toJson();
-    qDebug() << "Update Source request body: " << QString::fromLatin1(json) << Qt::endl;
+    qCDebug(lcFunction) << "Update Source request body: " << QString::fromLatin1(json) << Qt::endl;
 
     QHttpMultiPart* multiPart = new QHttpMultiPart(QHttpMultiPart::FormDataType);
     //配置部分
@@ -192,7 +192,7 @@ void SourceService::updateSource(const Source& _source, QFile* _file, HttpStatus
     QString path(_source.getNamespace().tenant().cluster().functionUrl());
     path += this->m_Settings->value(PUT_SOURCE_PATH_KEY).toString();
     QUrl url(path.arg(_source.getNamespace().tenant().name(), _source.getNamespace().name(), _source.name()));
-    qDebug() << "Updae a Source service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Updae a Source service url: " << url.toString() << Qt::endl;
 
     int code;
     QByteArray result = this->m_Client->put(url, multiPart, code);
@@ -227,7 +227,7 @@ void SourceService::updateSource(const Source& _source, QFile* _file, HttpStatus
         break;
     }
 
-    qDebug() << "Updae a Source response result: " << QString::fromLatin1(result) << ", code: " << code << Qt::endl;
+    qCDebug(lcFunction) << "Updae a Source response result: " << QString::fromLatin1(result) << ", code: " << code << Qt::endl;
 }
 
 void SourceService::deleteSource(const Source& _source, HttpStatusCode& _code)
@@ -235,7 +235,7 @@ void SourceService::deleteSource(const Source& _source, HttpStatusCode& _code)
     QString path(_source.getNamespace().tenant().cluster().functionUrl());
     path += this->m_Settings->value(DELETE_SOURCE_PATH_KEY).toString();
     QUrl url(path.arg(_source.getNamespace().tenant().name(), _source.getNamespace().name(), _source.name()));
-    qDebug() << "Delete a Source service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Delete a Source service url: " << url.toString() << Qt::endl;
 
     int statusCode;
     QByteArray result = this->m_Client->deleteResource(url, statusCode);
@@ -270,7 +270,7 @@ void SourceService::deleteSource(const Source& _source, HttpStatusCode& _code)
         break;
     }
 
-    qDebug() << "Delete a Source response result: " << QString::fromLatin1(result) << ", code: " << statusCode << Qt::endl;
+    qCDebug(lcFunction) << "Delete a Source response result: " << QString::fromLatin1(result) << ", code: " << statusCode << Qt::endl;
 }
 
 void SourceService::startSource(const Source& _source, HttpStatusCode& _code)
@@ -278,7 +278,7 @@ void SourceService::startSource(const Source& _source, HttpStatusCode& _code)
     QString path(_source.getNamespace().tenant().cluster().functionUrl());
     path += this->m_Settings->value(START_SOURCE_PATH_KEY).toString();
     QUrl url(path.arg(_source.getNamespace().tenant().name(), _source.getNamespace().name(), _source.name()));
-    qDebug() << "Start a Source service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Start a Source service url: " << url.toString() << Qt::endl;
 
     int statusCode;
     QByteArray result = this->m_Client->post(url, QByteArray(), statusCode);
@@ -309,7 +309,7 @@ void SourceService::startSource(const Source& _source, HttpStatusCode& _code)
         break;
     }
 
-    qDebug() << "Start a Source response result: " << QString::fromLatin1(result) << ", code: " << statusCode << Qt::endl;
+    qCDebug(lcFunction) << "Start a Source response result: " << QString::fromLatin1(result) << ", code: " << statusCode << Qt::endl;
 }
 
 void SourceService::stopSource(const Source& _source, HttpStatusCode& _code)
@@ -317,7 +317,7 @@ void SourceService::stopSource(const Source& _source, HttpStatusCode& _code)
     QString path(_source.getNamespace().tenant().cluster().functionUrl());
     path += this->m_Settings->value(STOP_SOURCE_PATH_KEY).toString();
     QUrl url(path.arg(_source.getNamespace().tenant().name(), _source.getNamespace().name(), _source.name()));
-    qDebug() << "Stop a Source service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Stop a Source service url: " << url.toString() << Qt::endl;
 
     int statusCode;
     QByteArray result = this->m_Client->post(url, QByteArray(), statusCode);
@@ -348,7 +348,7 @@ void SourceService::stopSource(const Source& _source, HttpStatusCode& _code)
         break;
     }
 
-    qDebug() << "Stop a Source response result: " << QString::fromLatin1(result) << ", code: " << statusCode << Qt::endl;
+    qCDebug(lcFunction) << "Stop a Source response result: " << QString::fromLatin1(result) << ", code: " << statusCode << Qt::endl;
 }
 
 QList<SourceInstance> SourceService::instances(const Source& _source)
@@ -357,7 +357,7 @@ QList<SourceInstance> SourceService::instances(const Source& _source)
     QString path(_source.getNamespace().tenant().cluster().functionUrl());
     path += this->m_Settings->value(GET_SOURCE_STATUS_PATH_KEY).toString();
     QUrl url(path.arg(_source.getNamespace().tenant().name(), _source.getNamespace().name(), _source.name()));
-    qDebug() << "Get Source status service url: " << url.toString() << Qt::endl;
+    qCInfo(lcFunction) << "Get Source status service url: " << url.toString() << Qt::endl;
 
     int code;
     QByteArray result = this->m_Client->get(url, code);
@@ -384,7 +384,7 @@ QList<SourceInstance> SourceService::instances(const Source& _source)
         }
     }
 
-    qDebug() << "Get Source status response result: " << QString::fromLatin1(result) << Qt::endl;
+    qCDebug(lcFunction) << "Get Source status response result: " << QString::fromLatin1(result) << Qt::endl;
 
     return instances;
 }
@@ -3,9 +3,9 @@
 #include <QUrl>
 #include <QJsonDocument>
 #include <QJsonArray>
-#include <QDebug>
 
 #include "../constants.h"
+#include "../logging.h"
 
 QList<Tenant> TenantService::tenants(const Cluster& _cluster) const
 {
@@ -14,7 +14,7 @@ QList<Tenant> TenantService::tenants(const Cluster& _cluster) const
     QString path(_cluster.adminUrl());
     path = path.append(this->m_Settings->value(GET_TENANTS_PATH_KEY).toString());
     QUrl url(path);
-    qDebug() << "Get the list of existing tenants service url: " << url.toString() << Qt::endl;
+    qCInfo(lcAdmin) << "Get the list of existing tenants service url: " << url.toString() << Qt::endl;
 
     QByteArray result = this->m_Client->get(url);
     QJsonParseError error;
@@ -30,7 +30,7 @@ QList<Tenant> TenantService::tenants(const Cluster& _cluster) const
         }
     }
 
-    qDebug() << "List tenants response result: " << QString::fromLatin1(result) << Qt::endl;
+    qCDebug(lcAdmin) << "List tenants response result: " << QString::fromLatin1(result) << Qt::endl;
 
     return tenants;
 }
@@ -40,11 +40,11 @@ void TenantService::createTenant(const Tenant& _tenant, HttpStatusCode& _code)
     QString path(_tenant.cluster().adminUrl());
     path = path.append(this->m_Settings->value(PUT_NEW_TENANT_PATH_KEY).toString()).arg(_tenant.name());
     QUrl url(path);
-    qDebug() << "Create a new tenant service url: " << url.toString() << Qt::endl;
+    qCInfo(lcAdmin) << "Create a new tenant service url: " << url.toString() << Qt::endl;
 
     QJsonDocument doc = QJsonDocument::fromVariant(_tenant.toVariant());
     QByteArray json = doc.toJson(QJsonDocument::JsonFormat::Compact);
-    qDebug() << "Create a new tenant request body: " << QString::fromLatin1(json) << Qt::endl;
+    qCDebug(lcAdmin) << "Create a new tenant request body: " << QString::fromLatin1(json) << Qt::endl;
 
     int statusCode;
     QByteArray result = this->m_Client->put(url, json, statusCode);
@@ -67,7 +67,7 @@ void TenantService::createTenant(const Tenant& _tenant, HttpStatusCode& _code)
         break;
     }
 
-    qDebug() << "Create a new tenant Response result: " << QString::fromLatin1(result) << ", status code: " << statusCode << Qt::endl;
+    qCDebug(lcAdmin) << "Create a new tenant Response result: " << QString::fromLatin1(result) << ", status code: " << statusCode << Qt::endl;
 }
 
 void TenantService::deleteTenant(const Tenant& _tenant, HttpStatusCode& _code)
@@ -75,7 +75,7 @@ void TenantService::deleteTenant(const Tenant& _tenant, HttpStatusCode& _code)
     QString path(_tenant.cluster().adminUrl());
     path = path.append(this->m_Settings->value(DELETE_TENANT_PATH_KEY).toString()).arg(_tenant.name());
     QUrl url(path);
-    qDebug() << "Delete a tenant and all namespaces and topics under it service path: " << url.toString() << Qt::endl;
+    qCDebug(lcAdmin) << "Delete a tenant and all namespaces and topics under it service path: " << url.toString() << Qt::endl;
 
     int statusCode;
     QByteArray result = this->m_Client->deleteResource(url, statusCode);
@@ -98,5 +98,5 @@ void TenantService::deleteTenant(const Tenant& _tenant, HttpStatusCode& _code)
         break;
     }
 
-    qDebug() << "Delete a tenant and all namespaces and topics under it Response result: " << QString::fromLatin1(result) << ", status code: " << statusCode << Qt::endl;
+    qCDebug(lcAdmin) << "Delete a tenant and all namespaces and topics under it Response result: " << QString::fromLatin1(result) << ", status code: " << statusCode << Qt::endl;
 }
@@ -6,9 +6,9 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QVariantList>
-#include <QDebug>
 
 #include "../qjsonwebtoken.h"
+#include "../logging.h"
 
 void TokenService::readTokens()
 {
@@ -23,7 +23,7 @@ void TokenService::readTokens()
             QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
             if (error.error == QJsonParseError::ParseError::NoError)
             {
-                qDebug() << "Read tokens json: " << QString::fromLatin1(doc.toJson(QJsonDocument::Compact)) << Qt::endl;
+                qCDebug(lcAdmin) << "Read tokens json: " << QString::fromLatin1(doc.toJson(QJsonDocument::Compact)) << Qt::endl;
 
                 QJsonArray roots = doc.array();
                 for (int i = 0; i < roots.size(); ++i)
@@ -34,7 +34,7 @@ void TokenService::readTokens()
             }
             else
             {
-                qDebug() << "parse JSON error: " << error.error << Qt::endl;
+                qCWarning(lcAdmin) << "parse JSON error: " << error.error << Qt::endl;
             }
         }
         file.close();
@@ -56,7 +56,7 @@ void TokenService::writeTokens()
         QJsonDocument doc = QJsonDocument::fromVariant(roots);
         QByteArray json = doc.toJson(QJsonDocument::Compact);
 
-        qDebug() << "Write tokens json: " << QString::fromLatin1(json) << Qt::endl;
+        qCDebug(lcAdmin) << "Write tokens json: " << QString::fromLatin1(json) << Qt::endl;
         file.write(json);
         file.close();
     }
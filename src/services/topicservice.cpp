@@ -3,10 +3,21 @@
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QJsonObject>
-#include <QTextCodec>
-#include <QDebug>
+#include <QSharedPointer>
+#include <QEventLoop>
+#include <QtEndian>
 
 #include "../constants.h"
+#include "../logging.h"
+#include "../jsonreader.h"
+#include "../decompressor.h"
+#include "../messagemodel.h"
+#include "internalstatsreader.h"
+#include "messagefetcher.h"
+#include "chunkreassembler.h"
+#include "messageexporter.h"
+#include "requestqueue.h"
+#include "responsecache.h"
 
 QList<Topic> TopicService::topics(const Namespace& _namespace) const
 {
@@ -33,12 +44,12 @@ void TopicService::createTopic(const Topic& _topic, HttpStatusCode& _code)
     }
 
     QUrl url(path.arg(_topic.getNamespace().tenant().name(), _topic.getNamespace().name(), _topic.name(), _topic.domain()));
-    qDebug() << "Create a new Topic service url: " << url.toString() << Qt::endl;
+    qCInfo(lcTopic) << "Create a new Topic service url: " << url.toString() << Qt::endl;
 
     QVariant root;
     root.setValue(_topic.stats().partitions());
     QByteArray body = root.toByteArray();
-    qDebug() << "Create a new Topic request body: " << QString::fromLatin1(body) << Qt::endl;
+    qCDebug(lcTopic) << "Create a new Topic request body: " << QString::fromLatin1(body) << Qt::endl;
 
     int statusCode;
     QByteArray result = this->m_Client->put(url, body, statusCode);
@@ -73,7 +84,12 @@ void TopicService::createTopic(const Topic& _topic, HttpStatusCode& _code)
         break;
     }
 
-    qDebug() << "Create a new Topic response result: " << QString::fromLatin1(result) << Qt::endl;
+    if (_code.code == HttpStatusCode::StatusCode::NoContent)
+    {
+        invalidate(_topic.getNamespace());
+    }
+
+    qCDebug(lcTopic) << "Create a new Topic response result: " << QString::fromLatin1(result) << Qt::endl;
 }
 
 /**
@@ -93,7 +109,7 @@ void TopicService::deleteTopic(const Topic& _topic, HttpStatusCode& _code)
         path = path.append(this->m_Settings->value(DELETE_TOPIC_PATH_KEY).toString());
     }
     QUrl url(path.arg(_topic.getNamespace().tenant().name(), _topic.getNamespace().name(), _topic.name(), _topic.domain()));
-    qDebug() << "Delete a Topic service url: " << url.toString() << Qt::endl;
+    qCInfo(lcTopic) << "Delete a Topic service url: " << url.toString() << Qt::endl;
 
     int statusCode;
     QByteArray result = this->m_Client->deleteResource(url, statusCode);
@@ -124,7 +140,12 @@ void TopicService::deleteTopic(const Topic& _topic, HttpStatusCode& _code)
         break;
     }
 
-    qDebug() << "Delete a Topic response result: " << QString::fromLatin1(result) << Qt::endl;
+    if (_code.code == HttpStatusCode::StatusCode::NoContent)
+    {
+        invalidate(_topic.getNamespace());
+    }
+
+    qCDebug(lcTopic) << "Delete a Topic response result: " << QString::fromLatin1(result) << Qt::endl;
 }
 
 /**
@@ -139,7 +160,7 @@ void TopicService::getLastMessageId(const Topic& _topic, const int& _partition,
     QString path(_topic.getNamespace().tenant().cluster().adminUrl());
     path = path.append(this->m_Settings->value(GET_LAST_MESSAGE_ID_PATH_KEY).toString());
     QUrl url(path.arg(_topic.getNamespace().tenant().name(), _topic.getNamespace().name(), topicName));
-    qDebug() << "Get Last Message ID Service url: " << url.toString() << Qt::endl;
+    qCInfo(lcTopic) << "Get Last Message ID Service url: " << url.toString() << Qt::endl;
 
     QByteArray result = this->m_Client->get(url);
     QJsonParseError error;
@@ -151,142 +172,241 @@ void TopicService::getLastMessageId(const Topic& _topic, const int& _partition,
         _message.setEntryId(root["entryId"].toInt());
     }
 
-    qDebug() << "Get Last Message ID response result: " << QString::fromLatin1(result) << Qt::endl;
+    qCDebug(lcTopic) << "Get Last Message ID response result: " << QString::fromLatin1(result) << Qt::endl;
 }
 
 /**
- * @brief Get message by its messageId
- * @param _topic
- * @param _partition
- * @param _ledgerId
- * @param _entryId
- * @param _num
- * @return
+ * @brief Blocking wrapper around messageFetcher().
  */
-QList<PulsarMessage> TopicService::messages(const Topic& _topic, const int& _partition, const int& _ledgerId, const int& _entryId, const int& _num) const
+QList<PulsarMessage> TopicService::messages(const Topic& _topic, const int& _partition, const int& _ledgerId, const int& _entryId, const int& _num)
 {
-    QList<PulsarMessage> msgs;
-    if (_ledgerId >= 0)
+    MessageFetcher* fetcher = this->messageFetcher(_topic, _partition);
+    QEventLoop eventLoop;
+    bool finished = false;
+    connect(fetcher, &MessageFetcher::finished, &eventLoop, [&finished, &eventLoop]()
     {
-        QString path(_topic.getNamespace().tenant().cluster().adminUrl());
-        path = path.append(this->m_Settings->value(GET_MESSAGE_PATH_KEY).toString());
-        QString topicName = _partition >= 0 ? QString("%1-partition-%2").arg(_topic.name()).arg(_partition) : _topic.name();
-        int i = _entryId < _num ? _entryId : (_num - 1);
-        while (i >= 0)
-        {
-            QUrl url(path.arg(_topic.getNamespace().tenant().name(), _topic.getNamespace().name(), topicName).arg(_ledgerId).arg(_entryId - i));
-            qDebug() << "Get Last Message Service url: " << url.toString() << Qt::endl;
-
-            QByteArray result = this->m_Client->get(url);
-            PulsarMessage m(result);
-            m.setLedgerId(_ledgerId);
-            m.setEntryId(i);
-            //QTextCodec* codec = QTextCodec::codecForName("ISO 8859-1");
-            //QString str = codec->toUnicode(result);
-            msgs << m;
-            i--;
-
-            QTextCodec* codec = QTextCodec::codecForName("ISO 8859-1");
-            QString str = codec->toUnicode(result);
-            qDebug() << "Get Last Message response result: " << QString::fromUtf8(result.toHex(' ')) << Qt::endl;
-            qDebug() << "Get Last Message response result: " << str << Qt::endl;
-        }
+        finished = true;
+        eventLoop.quit();
+    });
+    fetcher->start(_ledgerId, _entryId, _num);
+    if (!finished)
+    {
+        eventLoop.exec(); //block until finish
     }
+    QList<PulsarMessage> msgs = fetcher->messages();
+    fetcher->deleteLater();
     return msgs;
 }
 
+/**
+ * @brief Create a fetcher for the entries of a topic, the caller connects to its signals,
+ * calls start() and deletes it once finished.
+ * @param _topic
+ * @param _partition
+ * @return
+ */
+MessageFetcher* TopicService::messageFetcher(const Topic& _topic, const int& _partition)
+{
+    QString topicName = _partition >= 0 ? QString("%1-partition-%2").arg(_topic.name()).arg(_partition) : _topic.name();
+    QString cluster(_topic.getNamespace().tenant().cluster().adminUrl());
+    QString messagePath = this->messagePath(_topic, _partition);
+    QString storagePath(cluster);
+    storagePath = storagePath.append(this->m_Settings->value(GET_STORED_TOPIC_METADATA_KEY).toString());
+    QUrl storageUrl(storagePath.arg(_topic.getNamespace().tenant().name(), _topic.getNamespace().name(), topicName, _topic.domain()));
+
+    MessageFetcher* fetcher = new MessageFetcher(this->m_Client, cluster, messagePath, storageUrl, this);
+    fetcher->setWindow(this->m_Settings->value(MESSAGE_FETCH_WINDOW_KEY, 8).toInt());
+    return fetcher;
+}
+
+/**
+ * @brief Create a reassembler for the chunked messages of a topic, the caller adds the chunks
+ * it reads, connects to its signals and deletes it when done.
+ * @param _topic
+ * @param _partition
+ * @return
+ */
+ChunkReassembler* TopicService::chunkReassembler(const Topic& _topic, const int& _partition)
+{
+    QString cluster(_topic.getNamespace().tenant().cluster().adminUrl());
+    ChunkReassembler* reassembler = new ChunkReassembler(this->m_Client, cluster, messagePath(_topic, _partition), this);
+    reassembler->setMaxBufferedBytes(this->m_Settings->value(CHUNK_MAX_BUFFERED_BYTES_KEY, 64 * 1024 * 1024).toLongLong());
+    reassembler->setMaxScanEntries(this->m_Settings->value(CHUNK_MAX_SCAN_ENTRIES_KEY, 64).toInt());
+    return reassembler;
+}
+
+/**
+ * @brief Create the model of a message browser with the page size and the memory budget of
+ * the settings, the caller sets its loader.
+ * @param _parent
+ * @return
+ */
+MessageModel* TopicService::messageModel(QObject* _parent)
+{
+    MessageModel* model = new MessageModel(_parent);
+    model->setPageSize(this->m_Settings->value(MESSAGE_PAGE_SIZE_KEY, 100).toInt());
+    model->setMaxCachedBytes(this->m_Settings->value(MESSAGE_MAX_CACHED_BYTES_KEY, 128 * 1024 * 1024).toLongLong());
+    return model;
+}
+
+/**
+ * @brief Create an exporter reading ahead and buffering as much as the settings allow.
+ * @param _parent
+ * @return
+ */
+MessageExporter* TopicService::messageExporter(QObject* _parent)
+{
+    MessageExporter* exporter = new MessageExporter(_parent);
+    exporter->setReadAhead(this->m_Settings->value(EXPORT_READ_AHEAD_KEY, 64).toInt());
+    exporter->setMaxBufferedMessages(this->m_Settings->value(EXPORT_MAX_BUFFERED_MESSAGES_KEY, 10000).toInt());
+    exporter->setReceiverQueueSize(this->m_Settings->value(EXPORT_RECEIVER_QUEUE_SIZE_KEY, 1000).toInt());
+    return exporter;
+}
+
+/**
+ * @brief The full name the client knows a topic or one of its partitions by,
+ * persistent://public/default/foo-partition-0.
+ */
+QString TopicService::topicName(const Topic& _topic, const int& _partition) const
+{
+    QString name = _partition >= 0 ? QString("%1-partition-%2").arg(_topic.name()).arg(_partition) : _topic.name();
+    return QString("%1://%2/%3/%4").arg(_topic.domain(), _topic.getNamespace().tenant().name(), _topic.getNamespace().name(), name);
+}
+
+/**
+ * @brief The entry url of a topic with %1 left for the ledger and %2 for the entry.
+ */
+QString TopicService::messagePath(const Topic& _topic, const int& _partition) const
+{
+    QString topicName = _partition >= 0 ? QString("%1-partition-%2").arg(_topic.name()).arg(_partition) : _topic.name();
+    QString path(_topic.getNamespace().tenant().cluster().adminUrl());
+    path = path.append(this->m_Settings->value(GET_MESSAGE_PATH_KEY).toString());
+    return path.arg(_topic.getNamespace().tenant().name(), _topic.getNamespace().name(), topicName);
+}
+
 TopicStorage& TopicService::topicStorage(const Topic& _topic, const int& _partition, TopicStorage& _storage)
 {
     QString topicName = _partition >= 0 ? QString("%1-partition-%2").arg(_topic.name()).arg(_partition) : _topic.name();
     QString path(_topic.getNamespace().tenant().cluster().adminUrl());
     path = path.append(this->m_Settings->value(GET_STORED_TOPIC_METADATA_KEY).toString());
     QUrl url(path.arg(_topic.getNamespace().tenant().name(), _topic.getNamespace().name(), topicName, _topic.domain()));
-    qDebug() << "Get stored topic metadata Service url: " << url.toString() << Qt::endl;
+    qCInfo(lcTopic) << "Get stored topic metadata Service url: " << url.toString() << Qt::endl;
 
-    int code;
-    QByteArray result = this->m_Client->get(url, code);
-    QJsonParseError error;
-    QJsonDocument doc = QJsonDocument::fromJson(result, &error);
-    if (error.error == QJsonParseError::ParseError::NoError)
+    //Thousands of ledgers are mapped while they arrive, no document is built
+    InternalStatsReader reader;
+    HttpResponse response = this->m_Client->executeStream(HttpRequest(HttpRequest::Get, url), [&reader](const QByteArray& _chunk)
     {
-        QJsonObject root = doc.object();
-        _storage.setStorageSize(root["totalSize"].toInt());
-        _storage.setEntryNum(root["numberOfEntries"].toInt());
-        QJsonArray ledgers = root["ledgers"].toArray();
-        _storage.setSegmentNum(ledgers.size());
-        TopicSegments ts;
-        for (int i = 0, n = ledgers.size(); i < n; ++i)
-        {
-            QJsonObject ledger = ledgers[i].toObject();
-            TopicSegment segment;
-            segment.setLedgerId(ledger["ledgerId"].toInt());
-            segment.setEntries(i < (n - 1) ? ledger["entries"].toInt(0) : root["currentLedgerEntries"].toInt(0));
-            segment.setSize(i < (n - 1) ? ledger["size"].toInt(0) : root["currentLedgerSize"].toInt(0));
-            segment.setOffload(ledger["offloaded"].toBool());
-            segment.setStatus(i < (n - 1) ? TopicSegment::Status::CLOSE : TopicSegment::Status::OPEN);
-            ts.append(segment);
-        }
-        _storage.setSegments(ts);
+        reader.addData(_chunk);
+    });
+    if (response.isSuccess() && reader.finish())
+    {
+        _storage = reader.storage();
     }
 
-    qDebug() << "Get stored topic metadata response result: " << QString::fromLatin1(result) << Qt::endl;
+    qCDebug(lcTopic) << "Get stored topic metadata response: " << response.code << ", ledgers: " << _storage.segmentNum() << Qt::endl;
 
     return _storage;
 }
 
 TopicStats TopicService::overview(const Topic& _topic, const int& _partition) const
 {
+    QString name = _partition >= 0 ? QString("%1-partition-%2").arg(_topic.name()).arg(_partition) : _topic.name();
+    QString path(_topic.getNamespace().tenant().cluster().adminUrl());
+    path = path.append(this->m_Settings->value(GET_TOPIC_STATS_KEY).toString());
+    QUrl url(path.arg(_topic.getNamespace().tenant().name(), _topic.getNamespace().name(), name, _topic.domain()));
+    qCInfo(lcTopic) << "Get Topic stats Service url: " << url.toString() << Qt::endl;
+
     TopicStats stats;
-    QStringList topicNames;
-    if (_partition >= 0)
-    {
-        QString topicName("%1-partition-%2");
-        topicNames << topicName.arg(_topic.name()).arg(_partition);
-    }
-    else
+    QByteArray result = this->m_Client->get(url);
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(result, &error);
+    if (error.error == QJsonParseError::ParseError::NoError)
     {
-        topicNames << _topic.name();
+        stats = this->parseOverview(doc.object());
     }
 
+    qCDebug(lcTopic) << "Get Topic stats response result: " << QString::fromLatin1(result) << Qt::endl;
+    return stats;
+}
+
+/**
+ * @brief Get the stats of a partitioned topic, both the totals and every partition, in one round trip.
+ * @param _topic
+ * @return
+ */
+PartitionedTopicStats TopicService::partitionedStats(const Topic& _topic) const
+{
     QString path(_topic.getNamespace().tenant().cluster().adminUrl());
-    path = path.append(this->m_Settings->value(GET_TOPIC_STATS_KEY).toString());
-    foreach (const QString& name, topicNames)
+    path = path.append(this->m_Settings->value(GET_PARTITIONED_TOPIC_STATS_KEY).toString());
+    QUrl url(path.arg(_topic.getNamespace().tenant().name(), _topic.getNamespace().name(), _topic.name(), _topic.domain()));
+    url.setQuery("perPartition=true");
+    qCInfo(lcTopic) << "Get partitioned Topic stats Service url: " << url.toString() << Qt::endl;
+
+    PartitionedTopicStats stats;
+    QByteArray result = this->m_Client->get(url);
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(result, &error);
+    if (error.error == QJsonParseError::ParseError::NoError)
     {
-        QUrl url(path.arg(_topic.getNamespace().tenant().name(), _topic.getNamespace().name(), name, _topic.domain()));
-        qDebug() << "Get Topic stats Service url: " << url.toString() << Qt::endl;
+        QJsonObject root = doc.object();
+        TopicStats total = this->parseOverview(root);
+        total.setPartitions(root["metadata"].toObject()["partitions"].toInt(_topic.partitions()));
+        stats.setTotal(total);
 
-        QByteArray result = this->m_Client->get(url);
-        QJsonParseError error;
-        QJsonDocument doc = QJsonDocument::fromJson(result, &error);
-        if (error.error == QJsonParseError::ParseError::NoError)
+        //Keyed by the full partition name, e.g. persistent://public/default/foo-partition-0
+        QJsonObject partitions = root["partitions"].toObject();
+        QJsonObject::const_iterator it;
+        for (it = partitions.constBegin(); it != partitions.constEnd(); ++it)
         {
-            QJsonObject root = doc.object();
-            QJsonArray publishers = root["publishers"].toArray();
-            QJsonObject subscriptions = root["subscriptions"].toObject();
-
-            for (int i = 0, n = publishers.size(); i < n; ++i)
+            int index = it.key().lastIndexOf("-partition-");
+            if (index >= 0)
             {
-                QJsonObject obj = publishers[i].toObject();
-                QJsonDocument _doc(obj);
-                Producer producer;
-                producer = Producer::fromJson(_doc.toJson(), producer);
-                stats.addProducer(producer);
+                bool ok;
+                int partition = it.key().mid(index + QString("-partition-").length()).toInt(&ok);
+                if (ok)
+                {
+                    stats.setPartition(partition, this->parseOverview(it->toObject()));
+                }
             }
+        }
+    }
 
-            QJsonObject::const_iterator it;
-            for (it = subscriptions.constBegin(); it != subscriptions.constEnd(); ++it)
-            {
-                Subscription subscription;
-                subscription.setName(it.key());
-                QJsonDocument _doc(it->toObject());
-                subscription = Subscription::fromJson(_doc.toJson(), subscription);
-                stats.addSubscription(subscription);
+    qCDebug(lcTopic) << "Get partitioned Topic stats response result: " << QString::fromLatin1(result) << Qt::endl;
+    return stats;
+}
 
-            }
-        }
+/**
+ * @brief Fill the producers and subscriptions of a topic (or partition) stats object.
+ * @param _root
+ * @return
+ */
+TopicStats TopicService::parseOverview(const QJsonObject& _root) const
+{
+    TopicStats stats;
+    QJsonArray publishers = _root["publishers"].toArray();
+    QJsonObject subscriptions = _root["subscriptions"].toObject();
+
+    for (int i = 0, n = publishers.size(); i < n; ++i)
+    {
+        QJsonObject obj = publishers[i].toObject();
+        QJsonDocument _doc(obj);
+        Producer producer;
+        producer = Producer::fromJson(_doc.toJson(), producer);
+        stats.addProducer(producer);
+    }
 
-        qDebug() << "Get Topic stats response result: " << QString::fromLatin1(result) << Qt::endl;
+    QJsonObject::const_iterator it;
+    for (it = subscriptions.constBegin(); it != subscriptions.constEnd(); ++it)
+    {
+        Subscription subscription;
+        subscription.setName(it.key());
+        QJsonDocument _doc(it->toObject());
+        subscription = Subscription::fromJson(_doc.toJson(), subscription);
+        stats.addSubscription(subscription);
     }
+
+    stats.setProducerNum(publishers.size());
+    stats.setSubscriptionNum(subscriptions.size());
     return stats;
 }
 
@@ -309,21 +429,184 @@ QList<PulsarMessage> TopicService::messages(const Topic& _topic, const int& _par
     while (i > 0)
     {
         QUrl url(path.arg(_topic.getNamespace().tenant().name(), _topic.getNamespace().name(), topicName, _subName).arg(i).arg(_topic.domain()));
-        qDebug() << "Peek nth message on a topic subscription Service url: " << url.toString() << Qt::endl;
+        qCInfo(lcTopic) << "Peek nth message on a topic subscription Service url: " << url.toString() << Qt::endl;
 
-        QByteArray result = this->m_Client->get(url);
-        PulsarMessage message(result);
-        message.setEntryId(i);
+        HttpResponse response = this->m_Client->execute(HttpRequest(HttpRequest::Get, url));
+        PulsarMessage message = toMessage(response, -1, i);
         messages << message;
 
-        qDebug() << "Peek nth message on a topic subscription response result: " << QString::fromUtf8(result.toHex(' ')) << Qt::endl;
-        qDebug() << "Message key: " << message.key() << ", body: " << message.toString() << Qt::endl;
+        qCDebug(lcTopic) << "Peek nth message on a topic subscription response result: " << QString::fromUtf8(response.body.toHex(' ')) << Qt::endl;
+        qCDebug(lcTopic) << "Message key: " << message.key() << ", batch: " << message.batch().size() << Qt::endl;
 
         i--;
     }
     return messages;
 }
 
+/**
+ * @brief Peek the messages at positions _position to _position + _num - 1 of a subscription.
+ * The requests go through the request queue of the cluster, the callback gets the messages in
+ * position order once all are back, the positions past the backlog are left out. It is not
+ * called once _context is gone.
+ * @param _topic
+ * @param _partition
+ * @param _subName
+ * @param _position the first position, 1 is the next message of the subscription
+ * @param _num
+ * @param _context
+ * @param _callback
+ */
+void TopicService::peekMessages(const Topic& _topic, const int& _partition, const QString& _subName, const int& _position, const int& _num, QObject* _context, const MessagesCallback& _callback)
+{
+    QString path(_topic.getNamespace().tenant().cluster().adminUrl());
+    path = path.append(this->m_Settings->value(PEEK_SUBSCRIPTION_MSG_PATH_KEY).toString());
+    QString topicName = _partition >= 0 ? QString("%1-partition-%2").arg(_topic.name()).arg(_partition) : _topic.name();
+    RequestQueue* queue = RequestQueue::instance(_topic.getNamespace().tenant().cluster().adminUrl());
+
+    QSharedPointer<QVector<PulsarMessage>> results(new QVector<PulsarMessage>(qMax(0, _num)));
+    QSharedPointer<int> remaining(new int(_num));
+    if (_num <= 0)
+    {
+        _callback(QList<PulsarMessage>());
+        return;
+    }
+    for (int i = 0; i < _num; ++i)
+    {
+        int position = _position + i;
+        QUrl url(path.arg(_topic.getNamespace().tenant().name(), _topic.getNamespace().name(), topicName, _subName).arg(position).arg(_topic.domain()));
+        qCInfo(lcTopic) << "Peek nth message on a topic subscription Service url: " << url.toString() << Qt::endl;
+        queue->enqueue(this->m_Client, HttpRequest(HttpRequest::Get, url), _context, [results, remaining, i, position, _callback](const HttpResponse& _response)
+        {
+            if (_response.isSuccess())
+            {
+                (*results)[i] = toMessage(_response, -1, position);
+            }
+            else
+            {
+                qCWarning(lcTopic) << "Peek nth message " << position << " failed: " << _response.code << Qt::endl;
+            }
+            if (--(*remaining) == 0)
+            {
+                QList<PulsarMessage> messages;
+                foreach (const PulsarMessage& message, *results)
+                {
+                    if (message.entryId() >= 0)
+                    {
+                        messages << message;
+                    }
+                }
+                _callback(messages);
+            }
+        });
+    }
+}
+
+/**
+ * @brief Map an entry read through the admin api. The X-Pulsar-* headers carry the message id
+ * and the metadata of the entry, a compressed payload is decompressed and a batch is split into
+ * its messages. A chunk of a large message keeps its raw slice, see ChunkReassembler. Reentrant,
+ * the message fetcher calls it on worker threads.
+ * @param _response
+ * @param _ledgerId used when the response has no message id
+ * @param _entryId used when the response has no message id
+ * @return
+ */
+PulsarMessage TopicService::toMessage(const HttpResponse& _response, const int& _ledgerId, const int& _entryId)
+{
+    int ledgerId = _ledgerId;
+    int entryId = _entryId;
+    QList<QByteArray> id = _response.header("X-Pulsar-Message-ID").split(':');
+    if (id.size() >= 2)
+    {
+        ledgerId = id[0].toInt();
+        entryId = id[1].toInt();
+    }
+
+    //A compressed entry is inflated as a whole, the batch is split afterwards. A chunk is only
+    //a slice of the compressed payload, it is inflated once the message is reassembled.
+    QByteArray payload = _response.body;
+    MessageMetadata::CompressionType compression = Decompressor::compressionType(_response.header("X-Pulsar-compression"));
+    bool ok;
+    int uncompressedSize = _response.header("X-Pulsar-uncompressed-size").toInt(&ok);
+    QByteArray uuid = _response.header("X-Pulsar-uuid");
+    int numChunks = _response.header("X-Pulsar-num-chunks-from-msg").toInt();
+    bool chunk = !uuid.isEmpty() && numChunks > 1;
+    if (compression != MessageMetadata::NONE && !chunk)
+    {
+        QByteArray uncompressed;
+        if (ok && Decompressor::decompress(compression, payload, uncompressedSize, uncompressed))
+        {
+            payload = uncompressed;
+        }
+    }
+
+    //The broker passes the 8 bytes of the version through, newer ones the number as text
+    qint64 schemaVersion = -1;
+    QByteArray version = _response.header("X-Pulsar-schema-version");
+    bool numeric;
+    qint64 number = version.toLongLong(&numeric);
+    if (numeric)
+    {
+        schemaVersion = number;
+    }
+    else if (version.size() == 8)
+    {
+        schemaVersion = qFromBigEndian<qint64>(version.constData());
+    }
+
+    PulsarMessage message;
+    QByteArray num = _response.header("X-Pulsar-num-batch-message");
+    if (!num.isEmpty() && !chunk)
+    {
+        int size = _response.header("X-Pulsar-batch-size").toInt(&ok);
+        if (compression == MessageMetadata::NONE && ok && size > 0 && size < payload.size())
+        {
+            payload.truncate(size);
+        }
+        message = PulsarMessage::fromPayload(payload);
+        QList<PulsarMessage> batch = PulsarMessage::splitBatch(payload, num.toInt());
+        for (int i = 0, n = batch.size(); i < n; ++i)
+        {
+            batch[i].setLedgerId(ledgerId);
+            batch[i].setEntryId(entryId);
+            batch[i].setSchemaVersion(schemaVersion);
+        }
+        message.setBatch(batch);
+    }
+    else if (!_response.header("X-Pulsar-Message-ID").isEmpty())
+    {
+        message = PulsarMessage::fromPayload(payload);
+    }
+    else
+    {
+        message = PulsarMessage(payload);
+    }
+
+    foreach (const QNetworkReply::RawHeaderPair& header, _response.headers)
+    {
+        //HTTP/2 and some proxies deliver the header names lowercase
+        QByteArrayView prefix("X-Pulsar-Property-");
+        if (QByteArrayView(header.first).left(prefix.size()).compare(prefix, Qt::CaseInsensitive) == 0)
+        {
+            message.addProperties(QString::fromUtf8(header.first.mid(prefix.size())), QString::fromUtf8(header.second));
+        }
+    }
+    QByteArray key = _response.header("X-Pulsar-partition-key");
+    if (!key.isEmpty())
+    {
+        message.setKey(QString::fromUtf8(key));
+    }
+    if (chunk)
+    {
+        message.setChunk(QString::fromUtf8(uuid), _response.header("X-Pulsar-chunk-id").toInt(), numChunks, _response.header("X-Pulsar-total-chunk-msg-size").toInt());
+        message.setCompression(compression, ok ? uncompressedSize : 0);
+    }
+    message.setSchemaVersion(schemaVersion);
+    message.setLedgerId(ledgerId);
+    message.setEntryId(entryId);
+    return message;
+}
+
 /**
  * @brief Create a subscription on the topic
  * @param _topic
@@ -335,7 +618,7 @@ void TopicService::createSubscription(const Topic& _topic, const QString& _subNa
     QString path(_topic.getNamespace().tenant().cluster().adminUrl());
     path += this->m_Settings->value(PUT_SUBSCRIPTION_PATH_KEY).toString();
     QUrl url(path.arg(_topic.getNamespace().tenant().name(), _topic.getNamespace().name(), _topic.name(), _subName, _topic.domain()));
-    qDebug() << "Create a subscription on the topic service url: " << url.toString() << Qt::endl;
+    qCInfo(lcTopic) << "Create a subscription on the topic service url: " << url.toString() << Qt::endl;
 
     int statusCode;
     QByteArray result = this->m_Client->put(url, QByteArray(), statusCode);
@@ -378,7 +661,12 @@ void TopicService::createSubscription(const Topic& _topic, const QString& _subNa
         break;
     }
 
-    qDebug() << "Create a subscription on the topic response result: " << QString::fromLatin1(result) << Qt::endl;
+    if (_code.code == HttpStatusCode::StatusCode::NoContent)
+    {
+        invalidate(_topic.getNamespace());
+    }
+
+    qCDebug(lcTopic) << "Create a subscription on the topic response result: " << QString::fromLatin1(result) << Qt::endl;
 }
 
 void TopicService::deleteSubscription(const Topic& _topic, const QString& _subName, HttpStatusCode& _code)
@@ -386,7 +674,7 @@ void TopicService::deleteSubscription(const Topic& _topic, const QString& _subNa
     QString path(_topic.getNamespace().tenant().cluster().adminUrl());
     path += this->m_Settings->value(DELETE_SUBSCRIPTION_PATH_KEY).toString();
     QUrl url(path.arg(_topic.getNamespace().tenant().name(), _topic.getNamespace().name(), _topic.name(), _subName, _topic.domain()));
-    qDebug() << "Delete a subscription service url: " << url.toString() << Qt::endl;
+    qCInfo(lcTopic) << "Delete a subscription service url: " << url.toString() << Qt::endl;
 
     int statusCode;
     QByteArray result = this->m_Client->deleteResource(url, statusCode);
@@ -421,7 +709,135 @@ void TopicService::deleteSubscription(const Topic& _topic, const QString& _subNa
         break;
     }
 
-    qDebug() << "Delete a subscription response result: " << QString::fromLatin1(result) << Qt::endl;
+    if (_code.code == HttpStatusCode::StatusCode::NoContent)
+    {
+        invalidate(_topic.getNamespace());
+    }
+
+    qCDebug(lcTopic) << "Delete a subscription response result: " << QString::fromLatin1(result) << Qt::endl;
+}
+
+/**
+ * @brief Load the topics of a namespace without blocking. Each topic is emitted through
+ * topicLoaded() as soon as its metadata and stats have arrived, topicsLoaded() follows the
+ * last one. A new call supersedes the one still running.
+ * @param _namespace
+ * @param _refresh bypass the response cache
+ */
+void TopicService::loadTopics(const Namespace& _namespace, const bool& _refresh)
+{
+    int generation = ++this->m_Generation;
+    this->m_Pending = 0;
+    this->m_Refresh = _refresh;
+
+    QStringList domains;
+    domains << "persistent" << "non-persistent";
+    QString topicsPath(_namespace.tenant().cluster().adminUrl());
+    topicsPath = topicsPath.append(this->m_Settings->value(GET_TOPICS_PATH_KEY).toString());
+    QString partitionedPath(_namespace.tenant().cluster().adminUrl());
+    partitionedPath = partitionedPath.append(this->m_Settings->value(GET_PARTITIONED_TOPICS_PATH_KEY).toString());
+
+    QStringList::const_iterator it;
+    for (it = domains.constBegin(); it != domains.constEnd(); ++it)
+    {
+        QUrl url(topicsPath.arg(_namespace.tenant().name(), _namespace.name(), *it));
+        qCInfo(lcTopic) << "List none partitioned Topics service url: " << url.toString() << Qt::endl;
+        fetchTopics(_namespace, url, generation, Topic::TopicPartitioned::NonPartitioned);
+
+        url = QUrl(partitionedPath.arg(_namespace.tenant().name(), _namespace.name(), *it));
+        qCInfo(lcTopic) << "List partitioned Topics service url: " << url.toString() << Qt::endl;
+        fetchTopics(_namespace, url, generation, Topic::TopicPartitioned::Partitioned);
+    }
+}
+
+/**
+ * @brief Stream a topic list, the stats request of every topic is queued as soon as its name
+ * has been read, while the rest of the list is still being transferred.
+ * @param _namespace
+ * @param _url
+ * @param _generation
+ * @param _partitioned
+ */
+void TopicService::fetchTopics(const Namespace& _namespace, const QUrl& _url, const int& _generation, const Topic::TopicPartitioned& _partitioned)
+{
+    QSharedPointer<JsonReader> reader(new JsonReader());
+    fetch(_namespace, _url, _generation, [](const QByteArray&) {}, [this, _namespace, _generation, _partitioned, reader](const QByteArray& _chunk)
+    {
+        if (_generation != this->m_Generation)
+        {
+            return;
+        }
+        reader->addData(_chunk);
+        QList<Topic> topics = this->readTopics(_namespace, *reader, _partitioned);
+        foreach (const Topic& topic, topics)
+        {
+            //The partitioned stats carry the partition count as well
+            fetch(_namespace, this->statsUrl(topic), _generation, [this, topic](const QByteArray& _stats)
+            {
+                Topic loaded(topic);
+                loaded.setStats(this->parseStats(loaded, _stats));
+                if (loaded.partitioned() == Topic::TopicPartitioned::Partitioned)
+                {
+                    loaded.setPartitions(loaded.stats().partitions());
+                }
+                emit topicLoaded(loaded);
+            });
+        }
+    });
+}
+
+/**
+ * @brief Queue a GET request on the cluster of the namespace, the handler only runs for the
+ * current generation of loadTopics().
+ * @param _namespace
+ * @param _url
+ * @param _generation
+ * @param _handler
+ * @param _onData if set the body is streamed to it and the handler only gets error bodies
+ */
+void TopicService::fetch(const Namespace& _namespace, const QUrl& _url, const int& _generation, const std::function<void(const QByteArray&)>& _handler, const HttpStreamCallback& _onData)
+{
+    RequestQueue* queue = RequestQueue::instance(_namespace.tenant().cluster().adminUrl());
+
+    HttpRequest request(HttpRequest::Get, _url);
+    request.cacheMode = this->m_Refresh ? HttpRequest::RefreshCache : HttpRequest::PreferCache;
+    this->m_Pending++;
+    HttpCallback callback = [this, _generation, _handler](const HttpResponse& _response)
+    {
+        if (_generation != this->m_Generation)
+        {
+            return;
+        }
+        _handler(_response.body);
+        if (--this->m_Pending == 0)
+        {
+            emit topicsLoaded();
+        }
+    };
+    if (_onData)
+    {
+        queue->enqueue(this->m_Client, request, this, _onData, callback);
+    }
+    else
+    {
+        queue->enqueue(this->m_Client, request, this, callback);
+    }
+}
+
+/**
+ * @brief Drop the cached topic lists and stats of a namespace, in both domains.
+ * @param _namespace
+ */
+void TopicService::invalidate(const Namespace& _namespace) const
+{
+    QString path(_namespace.tenant().cluster().adminUrl());
+    path = path.append(this->m_Settings->value(GET_TOPICS_PATH_KEY).toString());
+    QStringList domains;
+    domains << "persistent" << "non-persistent";
+    foreach (const QString& domain, domains)
+    {
+        ResponseCache::instance()->invalidate(QUrl(path.arg(_namespace.tenant().name(), _namespace.name(), domain)));
+    }
 }
 
 /**
@@ -440,30 +856,16 @@ QList<Topic> TopicService::partitionedTopics(const Namespace& _namespace) const
     for (it = domains.constBegin(); it != domains.constEnd(); ++it)
     {
         QUrl url(path.arg(_namespace.tenant().name(), _namespace.name(), *it));
-        qDebug() << "List partitioned Topics service url: " << url.toString() << Qt::endl;
+        qCInfo(lcTopic) << "List partitioned Topics service url: " << url.toString() << Qt::endl;
 
         QByteArray result = this->m_Client->get(url);
-        QJsonParseError error;
-        QJsonDocument doc = QJsonDocument::fromJson(result, &error);
-        if (error.error == QJsonParseError::ParseError::NoError)
+        QList<Topic> list = this->parseTopics(_namespace, result, Topic::TopicPartitioned::Partitioned);
+        for (int i = 0, n = list.size(); i < n; ++i)
         {
-            QJsonArray roots = doc.array();
-            for (int i = 0, n = roots.size(); i < n; ++i)
-            {
-                QString name = this->topicName(roots[i].toString());
-                if (!name.isEmpty())
-                {
-                    Topic topic(name, _namespace);
-                    topic.setDomain(this->domain(roots[i].toString()));
-                    topic.setPartitions(this->partitions(topic));
-                    topic.setPartitioned(Topic::TopicPartitioned::Partitioned);
-                    topic.setStats(this->stats(topic));
-                    topics << topic;
-                }
-            }
+            list[i].setStats(this->stats(list[i]));
+            list[i].setPartitions(list[i].stats().partitions());
         }
-
-        qDebug() << "List partitioned Topics response result: " << QString::fromLatin1(result) << Qt::endl;
+        topics << list;
     }
     return topics;
 }
@@ -485,72 +887,131 @@ QList<Topic> TopicService::nonePartitionedTopics(const Namespace& _namespace) co
     for (it = domains.constBegin(); it != domains.constEnd(); ++it)
     {
         QUrl url(path.arg(_namespace.tenant().name(), _namespace.name(), *it));
-        qDebug() << "List none partitioned Topics service url: " << url.toString() << Qt::endl;
+        qCInfo(lcTopic) << "List none partitioned Topics service url: " << url.toString() << Qt::endl;
 
         QByteArray result = this->m_Client->get(url);
-        QJsonParseError error;
-        QJsonDocument doc = QJsonDocument::fromJson(result, &error);
-        if (error.error == QJsonParseError::ParseError::NoError)
+        QList<Topic> list = this->parseTopics(_namespace, result, Topic::TopicPartitioned::NonPartitioned);
+        for (int i = 0, n = list.size(); i < n; ++i)
         {
-            QJsonArray roots = doc.array();
-            for (int i = 0, n = roots.size(); i < n; ++i)
-            {
-                QString name = this->topicName(roots[i].toString());
-                if (!name.isEmpty())
-                {
-                    Topic topic(name, _namespace);
-                    topic.setDomain(this->domain(roots[i].toString()));
-                    topic.setPartitions(0);
-                    topic.setPartitioned(Topic::TopicPartitioned::NonPartitioned);
-                    topic.setStats(this->stats(topic));
-                    topics << topic;
-                }
-            }
+            list[i].setStats(this->stats(list[i]));
         }
-
-        qDebug() << "List non partitioned Topics response result: " << QString::fromLatin1(result) << Qt::endl;
+        topics << list;
     }
     return topics;
 }
 
-TopicStats TopicService::stats(const Topic& _topic) const
+/**
+ * @brief Map a topic list response to topics, partitions and stats are left to the caller.
+ * @param _namespace
+ * @param _result
+ * @param _partitioned
+ * @return
+ */
+QList<Topic> TopicService::parseTopics(const Namespace& _namespace, const QByteArray& _result, const Topic::TopicPartitioned& _partitioned) const
 {
-    QStringList topicNames;
-    if (_topic.partitions() > 0)
+    JsonReader reader;
+    reader.addData(_result);
+    reader.finish();
+    QList<Topic> topics = this->readTopics(_namespace, reader, _partitioned);
+    if (reader.hasError())
     {
-        QString topicName("%1-partition-%2");
-        topicNames << topicName.arg(_topic.name()).arg(0);
+        qCWarning(lcTopic) << "List Topics response error: " << reader.errorString() << Qt::endl;
     }
-    else
+
+    qCDebug(lcTopic) << "List Topics response result: " << topics.size() << " topics" << Qt::endl;
+    return topics;
+}
+
+/**
+ * @brief Pull the topic names available in the reader, a partial list is completed by the next call.
+ * @param _namespace
+ * @param _reader
+ * @param _partitioned
+ * @return
+ */
+QList<Topic> TopicService::readTopics(const Namespace& _namespace, JsonReader& _reader, const Topic::TopicPartitioned& _partitioned) const
+{
+    QList<Topic> topics;
+    forever
     {
-        topicNames << _topic.name();
+        JsonReader::TokenType token = _reader.readNext();
+        if (token == JsonReader::NeedMoreData || token == JsonReader::EndDocument || token == JsonReader::Invalid)
+        {
+            break;
+        }
+        if (token == JsonReader::StartObject || (token == JsonReader::StartArray && _reader.depth() > 1))
+        {
+            _reader.skipCurrent();
+            continue;
+        }
+        if (token != JsonReader::String || _reader.depth() != 1)
+        {
+            continue;
+        }
+        QString fullname = _reader.text();
+        QString name = this->topicName(fullname);
+        if (!name.isEmpty())
+        {
+            Topic topic(name, _namespace);
+            topic.setDomain(this->domain(fullname));
+            topic.setPartitions(0);
+            topic.setPartitioned(_partitioned);
+            topics << topic;
+        }
     }
+    return topics;
+}
+
+TopicStats TopicService::stats(const Topic& _topic) const
+{
+    QUrl url = this->statsUrl(_topic);
+    qCInfo(lcTopic) << "Get Topic stats Service url: " << url.toString() << Qt::endl;
 
+    QByteArray result = this->m_Client->get(url);
+    return this->parseStats(_topic, result);
+}
+
+/**
+ * @brief A partitioned topic is summed up by the broker over all of its partitions.
+ * @param _topic
+ * @return
+ */
+QUrl TopicService::statsUrl(const Topic& _topic) const
+{
     QString path(_topic.getNamespace().tenant().cluster().adminUrl());
-    path = path.append(this->m_Settings->value(GET_TOPIC_STATS_KEY).toString());
-    int publisherNum = 0, subscriptionNum = 0;
-    foreach (const QString& name, topicNames)
+    if (_topic.partitioned() == Topic::TopicPartitioned::Partitioned)
     {
-        QUrl url(path.arg(_topic.getNamespace().tenant().name(), _topic.getNamespace().name(), name, _topic.domain()));
-        qDebug() << "Get Topic stats Service url: " << url.toString() << Qt::endl;
+        path = path.append(this->m_Settings->value(GET_PARTITIONED_TOPIC_STATS_KEY).toString());
+        QUrl url(path.arg(_topic.getNamespace().tenant().name(), _topic.getNamespace().name(), _topic.name(), _topic.domain()));
+        url.setQuery("perPartition=false");
+        return url;
+    }
+    path = path.append(this->m_Settings->value(GET_TOPIC_STATS_KEY).toString());
+    return QUrl(path.arg(_topic.getNamespace().tenant().name(), _topic.getNamespace().name(), _topic.name(), _topic.domain()));
+}
 
-        QByteArray result = this->m_Client->get(url);
-        QJsonParseError error;
-        QJsonDocument doc = QJsonDocument::fromJson(result, &error);
-        if (error.error == QJsonParseError::ParseError::NoError)
+TopicStats TopicService::parseStats(const Topic& _topic, const QByteArray& _result) const
+{
+    int publisherNum = 0, subscriptionNum = 0, partitions = _topic.partitions();
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(_result, &error);
+    if (error.error == QJsonParseError::ParseError::NoError)
+    {
+        QJsonObject root = doc.object();
+        QJsonArray publishers = root["publishers"].toArray();
+        publisherNum += publishers.size();
+        QVariantMap subscriptions = root["subscriptions"].toVariant().toMap();
+        subscriptionNum += subscriptions.size();
+        if (root.contains("metadata"))
         {
-            QJsonObject root = doc.object();
-            QJsonArray publishers = root["publishers"].toArray();
-            publisherNum += publishers.size();
-            QVariantMap subscriptions = root["subscriptions"].toVariant().toMap();
-            subscriptionNum += subscriptions.size();
+            partitions = root["metadata"].toObject()["partitions"].toInt(partitions);
         }
-
-        qDebug() << "Get Topic stats response result: " << QString::fromLatin1(result) << Qt::endl;
     }
 
+    qCDebug(lcTopic) << "Get Topic stats response result: " << QString::fromLatin1(_result) << Qt::endl;
+
     TopicStats stats;
-    stats.setPartitions(_topic.partitions());
+    stats.setPartitions(partitions);
     stats.setProducerNum(publisherNum);
     stats.setSubscriptionNum(subscriptionNum);
 
@@ -572,30 +1033,3 @@ QString TopicService::domain(const QString& _fullname) const
     QUrl url(_fullname);
     return url.scheme();
 }
-
-/**
- * @brief Get partitioned topic metadata
- * @param _topic
- * @return
- */
-int TopicService::partitions(const Topic& _topic) const
-{
-    QString path(_topic.getNamespace().tenant().cluster().adminUrl());
-    path = path.append(this->m_Settings->value(GET_PARTITIONS_TOPIC_PATH_KEY).toString());
-    QUrl url(path.arg(_topic.getNamespace().tenant().name(), _topic.getNamespace().name(), _topic.name(), _topic.domain()));
-    qDebug() << "Get Topic partitions Service url: " << url.toString() << Qt::endl;
-
-    QByteArray result = this->m_Client->get(url);
-    QJsonParseError error;
-    QJsonDocument doc = QJsonDocument::fromJson(result, &error);
-    if (error.error == QJsonParseError::ParseError::NoError)
-    {
-        QJsonObject root = doc.object();
-        int partitions = root["partitions"].toInt();
-        return partitions;
-    }
-
-    qDebug() << "Get Topic partitions response result: " << QString::fromLatin1(result) << Qt::endl;
-
-    return 0;
-}
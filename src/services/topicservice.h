@@ -6,31 +6,67 @@
 #include "../topic.h"
 #include "../pulsarmessage.h"
 
+class QJsonObject;
+class JsonReader;
+class MessageFetcher;
+class ChunkReassembler;
+class MessageModel;
+class MessageExporter;
+
 class TopicService : public BaseService
 {
     Q_OBJECT
 
 public:
-    explicit TopicService(QObject* parent = nullptr) : BaseService(parent) {}
+    explicit TopicService(QObject* parent = nullptr) : BaseService(parent), m_Generation(0), m_Pending(0), m_Refresh(false) {}
+
+    typedef std::function<void(const QList<PulsarMessage>&)> MessagesCallback;
 
     QList<Topic> topics(const Namespace& _namespace) const;
+    void loadTopics(const Namespace& _namespace, const bool& _refresh = false);
     void createTopic(const Topic& _topic, HttpStatusCode& _code);
     void deleteTopic(const Topic& _topic, HttpStatusCode& _code);
     void getLastMessageId(const Topic& _topic, const int& _partition, Message& _message);
-    QList<PulsarMessage> messages(const Topic& _topic, const int& _partition, const int& _ledgerId, const int& _entryId, const int& _num = 1) const;
+    QList<PulsarMessage> messages(const Topic& _topic, const int& _partition, const int& _ledgerId, const int& _entryId, const int& _num = 1);
+    MessageFetcher* messageFetcher(const Topic& _topic, const int& _partition);
+    ChunkReassembler* chunkReassembler(const Topic& _topic, const int& _partition);
+    MessageModel* messageModel(QObject* _parent);
+    MessageExporter* messageExporter(QObject* _parent);
+    QString topicName(const Topic& _topic, const int& _partition) const;
     TopicStorage& topicStorage(const Topic& _topic, const int& _partition, TopicStorage& _storage);
     TopicStats overview(const Topic& _topic, const int& _partition) const;
+    PartitionedTopicStats partitionedStats(const Topic& _topic) const;
     QList<PulsarMessage> messages(const Topic& _topic, const int& _partition, const QString& _subName, const int& _num = 1) const;
+    void peekMessages(const Topic& _topic, const int& _partition, const QString& _subName, const int& _position, const int& _num, QObject* _context, const MessagesCallback& _callback);
     void createSubscription(const Topic& _topic, const QString& _subName, HttpStatusCode& _code);
     void deleteSubscription(const Topic& _topic, const QString& _subName, HttpStatusCode& _code);
 
+    static PulsarMessage toMessage(const HttpResponse& _response, const int& _ledgerId = -1, const int& _entryId = -1);
+
+signals:
+    void topicLoaded(const Topic&);
+    void topicsLoaded();
+
 private:
+    void fetch(const Namespace& _namespace, const QUrl& _url, const int& _generation, const std::function<void(const QByteArray&)>& _handler, const HttpStreamCallback& _onData = HttpStreamCallback());
+    void fetchTopics(const Namespace& _namespace, const QUrl& _url, const int& _generation, const Topic::TopicPartitioned& _partitioned);
+    void invalidate(const Namespace& _namespace) const;
+    QList<Topic> parseTopics(const Namespace& _namespace, const QByteArray& _result, const Topic::TopicPartitioned& _partitioned) const;
+    QList<Topic> readTopics(const Namespace& _namespace, JsonReader& _reader, const Topic::TopicPartitioned& _partitioned) const;
     QList<Topic> partitionedTopics(const Namespace& _namespace) const;
     QList<Topic> nonePartitionedTopics(const Namespace& _namespace) const;
     TopicStats stats(const Topic& _topic) const;
+    QUrl statsUrl(const Topic& _topic) const;
+    QString messagePath(const Topic& _topic, const int& _partition) const;
+    TopicStats parseStats(const Topic& _topic, const QByteArray& _result) const;
+    TopicStats parseOverview(const QJsonObject& _root) const;
     QString topicName(const QString& _fullname) const;
     QString domain(const QString& _fullname) const;
-    int partitions(const Topic& _topic) const;
+
+private:
+    int m_Generation;
+    int m_Pending;
+    bool m_Refresh;
 
 };
 
@@ -23,7 +23,13 @@ Statement& Statement::operator=(const Statement& _other)
     this->m_Columns = _other.columns();
     this->m_Error = _other.error();
     this->m_Condition = _other.condition();
-    this->m_Results = _other.result();
+    this->m_Projection = _other.projection();
+    this->m_Limit = _other.limit();
+    this->m_PublishedFrom = _other.publishedFrom();
+    this->m_PublishedUntil = _other.publishedUntil();
+    this->m_Result = _other.result();
+    this->m_MaxRows = _other.maxRows();
+    this->m_RetainRows = _other.retainRows();
     this->m_CancelUri = _other.cancelUri();
     return *this;
 }
@@ -2,6 +2,10 @@
 #define TABLE_H
 
 #include <QObject>
+#include <QDateTime>
+#include <QStringList>
+
+#include "queryresult.h"
 
 class Column
 {
@@ -29,19 +33,19 @@ public:
     QueryState(const QueryState& _other) { *this = _other; }
     QueryState& operator=(const QueryState& _other);
 
-    inline void setElapsedTimeMillis(const int& _elapsedTimeMillis) { this->m_ElapsedTimeMillis = _elapsedTimeMillis; }
-    inline int elapsedTimeMillis() const { return this->m_ElapsedTimeMillis; }
-    inline void setProcessedRows(const int& _processedRows) { this->m_ProcessedRows = _processedRows; }
-    inline int processedRows() const { return this->m_ProcessedRows; }
-    inline void setProcessedBytes(const int& _processedBytes) { this->m_ProcessedBytes = _processedBytes; }
-    inline int processedBytes() const { return this->m_ProcessedBytes; }
+    inline void setElapsedTimeMillis(const qint64& _elapsedTimeMillis) { this->m_ElapsedTimeMillis = _elapsedTimeMillis; }
+    inline qint64 elapsedTimeMillis() const { return this->m_ElapsedTimeMillis; }
+    inline void setProcessedRows(const qint64& _processedRows) { this->m_ProcessedRows = _processedRows; }
+    inline qint64 processedRows() const { return this->m_ProcessedRows; }
+    inline void setProcessedBytes(const qint64& _processedBytes) { this->m_ProcessedBytes = _processedBytes; }
+    inline qint64 processedBytes() const { return this->m_ProcessedBytes; }
     inline void setState(const QString& _state) { this->m_State = _state; }
     inline QString state() const { return this->m_State; }
 
 private:
-    int m_ElapsedTimeMillis;
-    int m_ProcessedRows;
-    int m_ProcessedBytes;
+    qint64 m_ElapsedTimeMillis = 0;
+    qint64 m_ProcessedRows = 0;
+    qint64 m_ProcessedBytes = 0;
     QString m_State;
 
 };
@@ -68,24 +72,60 @@ public:
     inline QString error() const { return this->m_Error; }
     inline void setCondition(const QString& _condition) { this->m_Condition = _condition; }
     inline QString condition() const { return this->m_Condition; }
+    /**
+     * @brief The columns selected, all of them when empty.
+     */
+    inline void setProjection(const QStringList& _projection) { this->m_Projection = _projection; }
+    inline QStringList projection() const { return this->m_Projection; }
+    /**
+     * @brief The LIMIT of the query, 0 for none.
+     */
+    inline void setLimit(const int& _limit) { this->m_Limit = _limit; }
+    inline int limit() const { return this->m_Limit; }
+    /**
+     * @brief The bounds of __publish_time__, both included, an invalid one leaves its side open.
+     */
+    inline void setPublishedFrom(const QDateTime& _from) { this->m_PublishedFrom = _from; }
+    inline QDateTime publishedFrom() const { return this->m_PublishedFrom; }
+    inline void setPublishedUntil(const QDateTime& _until) { this->m_PublishedUntil = _until; }
+    inline QDateTime publishedUntil() const { return this->m_PublishedUntil; }
     inline void setId(const QString& _id) { this->m_Id = _id; }
     inline QString id() const { return this->m_Id; }
     inline void setState(const QueryState& _state) { this->m_State = _state; }
     inline QueryState state() const { return this->m_State; }
-    inline QStringList result() const { return this->m_Results; }
+    /**
+     * @brief The rows read so far, typed by column.
+     */
+    inline const QueryResult& result() const { return this->m_Result; }
+    inline QueryResult& result() { return this->m_Result; }
+    /**
+     * @brief The rows kept at most, 0 for no limit; the rows of a page beyond it are dropped.
+     */
+    inline void setMaxRows(const int& _maxRows) { this->m_MaxRows = _maxRows; }
+    inline int maxRows() const { return this->m_MaxRows; }
+    inline bool isFull() const { return this->m_MaxRows > 0 && this->m_Result.rowCount() >= this->m_MaxRows; }
+    /**
+     * @brief Whether the result keeps the rows of every page, or only those of the last one.
+     */
+    inline void setRetainRows(const bool& _retain) { this->m_RetainRows = _retain; }
+    inline bool retainRows() const { return this->m_RetainRows; }
     inline void setCancelUri(const QString& _cancelUri) { this->m_CancelUri = _cancelUri; }
     inline QString cancelUri() const { return this->m_CancelUri; }
 
     void addColumn(const Column& _column) { this->m_Columns << _column; }
-    void addResult(const QString& _result) { this->m_Results << _result; }
     void clearColumns() { this->m_Columns.clear(); }
-    void clearResult() { this->m_Results.clear(); }
+    void clearResult() { this->m_Result.clear(); }
     void reset()
     {
         clearColumns();
         clearResult();
+        this->m_State = QueryState();
         this->m_Error = QString();
         this->m_Condition = QString();
+        this->m_Projection = QStringList();
+        this->m_Limit = 0;
+        this->m_PublishedFrom = QDateTime();
+        this->m_PublishedUntil = QDateTime();
         this->m_CancelUri = QString();
         this->m_NextUri = QString();
     }
@@ -96,9 +136,15 @@ private:
     QString m_NextUri;
     QString m_CancelUri;
     QList<Column> m_Columns;
-    QStringList m_Results;
+    QueryResult m_Result;
+    int m_MaxRows = 0;
+    bool m_RetainRows = true;
     QString m_Error;
     QString m_Condition;
+    QStringList m_Projection;
+    int m_Limit = 0;
+    QDateTime m_PublishedFrom;
+    QDateTime m_PublishedUntil;
 };
 
 Q_DECLARE_METATYPE(Statement);
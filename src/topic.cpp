@@ -38,6 +38,13 @@ TopicStats TopicStats::fromJson(const QByteArray& json)
     return stats;
 }
 
+PartitionedTopicStats& PartitionedTopicStats::operator =(const PartitionedTopicStats& _other)
+{
+    this->m_Total = _other.total();
+    this->m_Partitions = _other.partitions();
+    return *this;
+}
+
 Topic::Topic() : m_Name(QString()), m_Domain(QString()), m_Schema(QString()), m_Role(QString()), m_Partitioned(Topic::NonPartitioned), m_Partitions(-1) {}
 
 Topic::Topic(const QString& _name, const Namespace& _namespace) : m_Name(_name), m_Namespace(_namespace), m_Domain(QString()), m_Schema(QString()), m_Role(QString()), m_Partitioned(Topic::NonPartitioned), m_Partitions(-1) {}
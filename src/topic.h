@@ -48,6 +48,28 @@ private:
 
 Q_DECLARE_METATYPE(TopicStats);
 
+class PartitionedTopicStats
+{
+public:
+    explicit PartitionedTopicStats() {}
+    PartitionedTopicStats(const PartitionedTopicStats& _other) { *this = _other; }
+    PartitionedTopicStats& operator=(const PartitionedTopicStats& _other);
+
+    inline TopicStats total() const { return this->m_Total; }
+    inline void setTotal(const TopicStats& _total) { this->m_Total = _total; }
+
+    inline bool hasPartition(const int& _partition) const { return this->m_Partitions.contains(_partition); }
+    inline TopicStats partition(const int& _partition) const { return this->m_Partitions.value(_partition); }
+    inline void setPartition(const int& _partition, const TopicStats& _stats) { this->m_Partitions.insert(_partition, _stats); }
+    inline QMap<int, TopicStats> partitions() const { return this->m_Partitions; }
+
+private:
+    TopicStats m_Total;
+    QMap<int, TopicStats> m_Partitions;
+};
+
+Q_DECLARE_METATYPE(PartitionedTopicStats);
+
 typedef QMap<QString, QString> TopicData;
 
 class Topic
@@ -0,0 +1,80 @@
+#include "varianttreewidget.h"
+
+#include <QHeaderView>
+#include <QDateTime>
+
+VariantTreeWidget::VariantTreeWidget(QWidget* _parent) : QTreeWidget(_parent)
+{
+    QStringList header;
+    header << tr("Field") << tr("Value");
+    setColumnCount(header.length());
+    setHeaderLabels(header);
+    this->header()->setSectionResizeMode(QHeaderView::Interactive);
+    this->header()->setStretchLastSection(true);
+    setEditTriggers(QAbstractItemView::NoEditTriggers);
+    setSelectionBehavior(QAbstractItemView::SelectRows);
+}
+
+void VariantTreeWidget::setValue(const QVariant& _value)
+{
+    clear();
+    if (_value.typeId() == QMetaType::QVariantMap)
+    {
+        QVariantMap map = _value.toMap();
+        for (QVariantMap::const_iterator it = map.constBegin(); it != map.constEnd(); ++it)
+        {
+            appendValue(nullptr, it.key(), it.value());
+        }
+    }
+    else
+    {
+        appendValue(nullptr, QString(), _value);
+    }
+    expandToDepth(1);
+    resizeColumnToContents(0);
+}
+
+void VariantTreeWidget::appendValue(QTreeWidgetItem* _parent, const QString& _name, const QVariant& _value)
+{
+    QTreeWidgetItem* item = _parent ? new QTreeWidgetItem(_parent) : new QTreeWidgetItem(this);
+    item->setText(0, _name);
+    if (_value.typeId() == QMetaType::QVariantMap)
+    {
+        QVariantMap map = _value.toMap();
+        item->setText(1, tr("{%1 fields}").arg(map.size()));
+        for (QVariantMap::const_iterator it = map.constBegin(); it != map.constEnd(); ++it)
+        {
+            appendValue(item, it.key(), it.value());
+        }
+    }
+    else if (_value.typeId() == QMetaType::QVariantList)
+    {
+        QVariantList list = _value.toList();
+        item->setText(1, tr("[%1 items]").arg(list.size()));
+        for (int i = 0, n = list.size(); i < n; ++i)
+        {
+            appendValue(item, QString("[%1]").arg(i), list[i]);
+        }
+    }
+    else
+    {
+        item->setText(1, format(_value));
+    }
+}
+
+QString VariantTreeWidget::format(const QVariant& _value)
+{
+    if (!_value.isValid() || _value.isNull())
+    {
+        return QString("null");
+    }
+    switch (_value.typeId())
+    {
+    case QMetaType::QByteArray:
+        return QString::fromLatin1(_value.toByteArray().toHex(' '));
+    case QMetaType::QDateTime:
+        return _value.toDateTime().toString(Qt::ISODateWithMs);
+    default:
+        return _value.toString();
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef VARIANTTREEWIDGET_H
+#define VARIANTTREEWIDGET_H
+
+#include <QTreeWidget>
+#include <QVariant>
+
+/**
+ * @brief Shows a decoded message as a tree of fields and values, maps and lists are expanded
+ * into child rows.
+ */
+class VariantTreeWidget : public QTreeWidget
+{
+    Q_OBJECT
+
+public:
+    explicit VariantTreeWidget(QWidget* _parent = nullptr);
+
+    void setValue(const QVariant& _value);
+
+private:
+    void appendValue(QTreeWidgetItem* _parent, const QString& _name, const QVariant& _value);
+
+    static QString format(const QVariant& _value);
+};
+
+#endif // VARIANTTREEWIDGET_H
@@ -0,0 +1,126 @@
+#include "diagnosticswindow.h"
+
+#include <QToolBar>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QFileDialog>
+#include <QTimer>
+#include <QFile>
+#include <QDir>
+
+#include "../services/endpointmetrics.h"
+
+DiagnosticsWindow::DiagnosticsWindow(QWidget* parent) : BaseMdiSubWindow(parent), m_Timer(new QTimer(this)), m_Dirty(false)
+{
+    m_Header << tr("Endpoint") << tr("Requests") << tr("Errors") << tr("Bytes In") << tr("Bytes Out") << tr("p50 (ms)") << tr("p90 (ms)") << tr("p99 (ms)");
+    this->twTable->setColumnCount(m_Header.length());
+    this->twTable->setHorizontalHeaderLabels(m_Header);
+    this->twTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
+    this->twTable->setSortingEnabled(true);
+
+    this->actRefresh = new QAction(QIcon(":/refresh"), tr("&Refresh"), this);
+    this->actRefresh->setStatusTip(tr("Refresh the endpoint metrics."));
+    this->actReset = new QAction(QIcon(":/remove"), tr("R&eset"), this);
+    this->actReset->setStatusTip(tr("Reset all endpoint metrics."));
+    this->actDump = new QAction(QIcon(":/export"), tr("&Dump to JSON..."), this);
+    this->actDump->setStatusTip(tr("Save the endpoint metrics as a JSON file."));
+    this->actClose = new QAction(QIcon(":/exit"), tr("&Close"), this);
+    this->actClose->setStatusTip(tr("Close the window."));
+
+    this->tbToolbar->addAction(this->actRefresh);
+    this->tbToolbar->addAction(this->actReset);
+    this->tbToolbar->addAction(this->actDump);
+    this->tbToolbar->addSeparator();
+    this->tbToolbar->addAction(this->actClose);
+
+    setWindowTitle(tr("Diagnostics"));
+    setWindowIcon(QIcon(":/overview"));
+
+    //Requests may finish in bursts, the table is redrawn at most once a second
+    this->m_Timer->setInterval(1000);
+
+    connect(this->actRefresh, &QAction::triggered, this, &DiagnosticsWindow::handleReload);
+    connect(this->actReset, &QAction::triggered, this, &DiagnosticsWindow::handleReset);
+    connect(this->actDump, &QAction::triggered, this, &DiagnosticsWindow::handleDump);
+    connect(this->actClose, &QAction::triggered, this, &DiagnosticsWindow::close);
+    connect(this, &DiagnosticsWindow::initialize, this, &DiagnosticsWindow::handleReload);
+    connect(EndpointMetrics::instance(), &EndpointMetrics::updated, this, &DiagnosticsWindow::handleUpdated);
+    connect(this->m_Timer, &QTimer::timeout, this, [this]()
+    {
+        if (this->m_Dirty)
+        {
+            handleReload();
+        }
+    });
+    this->m_Timer->start();
+}
+
+MdiSubWindow::SubWindowType DiagnosticsWindow::subWindowType() const
+{
+    return MdiSubWindow::SubWindowType::DiagnosticsSubWindow;
+}
+
+void DiagnosticsWindow::afterWindowActivated(const QVariant& _var)
+{
+    BaseMdiSubWindow::afterWindowActivated(_var);
+    emit initialize();
+    showMaximized();
+}
+
+void DiagnosticsWindow::handleUpdated()
+{
+    this->m_Dirty = true;
+}
+
+void DiagnosticsWindow::handleReload()
+{
+    this->m_Dirty = false;
+    QList<EndpointStats> metrics = EndpointMetrics::instance()->snapshot();
+    this->twTable->setSortingEnabled(false);
+    this->twTable->clearContents();
+    this->twTable->setRowCount(metrics.length());
+    for (int i = 0, n = metrics.length(); i < n; i++)
+    {
+        const EndpointStats& stats = metrics[i];
+        QList<QVariant> values;
+        values << stats.endpoint() << stats.count() << stats.errors() << stats.bytesIn() << stats.bytesOut()
+               << stats.percentile(0.50) << stats.percentile(0.90) << stats.percentile(0.99);
+        for (int j = 0, m = values.length(); j < m; j++)
+        {
+            QTableWidgetItem* item = new QTableWidgetItem;
+            //Numbers are stored as such so that sorting by a column works
+            item->setData(Qt::DisplayRole, values[j]);
+            this->twTable->setItem(i, j, item);
+        }
+    }
+    this->twTable->setSortingEnabled(true);
+}
+
+void DiagnosticsWindow::handleReset(bool)
+{
+    QMessageBox::StandardButton button = QMessageBox::question(this, tr("Reset Metrics"), tr("Are you sure you want to reset all endpoint metrics?"));
+    if (button == QMessageBox::Yes)
+    {
+        EndpointMetrics::instance()->reset();
+        handleReload();
+    }
+}
+
+void DiagnosticsWindow::handleDump(bool)
+{
+    const QString fileName = QFileDialog::getSaveFileName(this, tr("Dump Endpoint Metrics"), QDir::home().absoluteFilePath("pdm-metrics.json"), tr("JSON File (*.json)"));
+    if (!fileName.isEmpty())
+    {
+        QFile file(fileName);
+        if (file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            file.write(EndpointMetrics::instance()->toJson());
+            file.close();
+        }
+        else
+        {
+            QMessageBox::critical(this, tr("Error"), file.errorString());
+        }
+    }
+}
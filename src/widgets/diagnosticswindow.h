@@ -0,0 +1,36 @@
+#ifndef DIAGNOSTICSWINDOW_H
+#define DIAGNOSTICSWINDOW_H
+
+#include "basemdisubwindow.h"
+
+class QTimer;
+
+class DiagnosticsWindow : public BaseMdiSubWindow
+{
+    Q_OBJECT
+
+public:
+    explicit DiagnosticsWindow(QWidget* parent = nullptr);
+
+    MdiSubWindow::SubWindowType subWindowType() const override;
+
+public slots:
+    virtual void afterWindowActivated(const QVariant&) override;
+
+private:
+    QStringList m_Header;
+    QTimer* m_Timer;
+    bool m_Dirty;
+
+    QAction* actReset;
+    QAction* actDump;
+
+private slots:
+    void handleReload();
+    void handleUpdated();
+    void handleReset(bool);
+    void handleDump(bool);
+
+};
+
+#endif // DIAGNOSTICSWINDOW_H
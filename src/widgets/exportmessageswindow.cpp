@@ -0,0 +1,262 @@
+#include "exportmessageswindow.h"
+
+#include <QVBoxLayout>
+#include <QFormLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QComboBox>
+#include <QCheckBox>
+#include <QSpinBox>
+#include <QDateTimeEdit>
+#include <QProgressBar>
+#include <QFileDialog>
+#include <QLocale>
+
+#include <limits>
+
+#include "../services/clusterservice.h"
+#include "../services/topicservice.h"
+#include "../services/messageexporter.h"
+
+ExportMessagesWindow::ExportMessagesWindow(QWidget* _parent): QDialog(_parent), m_ClusterService(new ClusterService(this)), m_TopicService(new TopicService(this))
+{
+    this->m_Exporter = this->m_TopicService->messageExporter(this);
+
+    QVBoxLayout* layout = new QVBoxLayout;
+
+    QFormLayout* formLayout = new QFormLayout;
+    formLayout->setFieldGrowthPolicy(QFormLayout::AllNonFixedFieldsGrow);
+    this->lblTopicName = new QLabel;
+    this->teServerUrl = new QLineEdit;
+    this->cbCluster = new QComboBox;
+    this->cbPartitions = new QComboBox;
+    this->cbStart = new QComboBox;
+    this->cbStart->addItem(tr("Earliest"));
+    this->cbStart->addItem(tr("Message ID"));
+    this->cbStart->addItem(tr("Publish Time"));
+    this->teMessageId = new QLineEdit;
+    this->teMessageId->setPlaceholderText(tr("ledgerId:entryId"));
+    this->dtStartTime = new QDateTimeEdit(QDateTime::currentDateTime().addDays(-1));
+    this->dtStartTime->setDisplayFormat("yyyy-MM-dd HH:mm:ss");
+    this->dtStartTime->setCalendarPopup(true);
+    this->ckEndTime = new QCheckBox(tr("Published until:"));
+    this->dtEndTime = new QDateTimeEdit(QDateTime::currentDateTime());
+    this->dtEndTime->setDisplayFormat("yyyy-MM-dd HH:mm:ss");
+    this->dtEndTime->setCalendarPopup(true);
+    this->dtEndTime->setEnabled(false);
+    this->sbMaxMessages = new QSpinBox;
+    this->sbMaxMessages->setRange(0, std::numeric_limits<int>::max());
+    this->sbMaxMessages->setSpecialValueText(tr("No limit"));
+    this->cbFormat = new QComboBox;
+    this->cbFormat->addItem(tr("NDJSON"), MessageExporter::Ndjson);
+    this->cbFormat->addItem(tr("Length-prefixed binary"), MessageExporter::LengthPrefixed);
+    this->teFileName = new QLineEdit;
+    QPushButton* btnBrowse = new QPushButton(tr("&Browse..."));
+    QHBoxLayout* fileLayout = new QHBoxLayout;
+    fileLayout->setContentsMargins(0, 0, 0, 0);
+    fileLayout->addWidget(this->teFileName, 1);
+    fileLayout->addWidget(btnBrowse);
+
+    formLayout->addRow(tr("Allowed &Clusters:"), this->cbCluster);
+    formLayout->addRow(tr("&Broker Service URL:"), this->teServerUrl);
+    formLayout->addRow(tr("&Topic Name:"), this->lblTopicName);
+    formLayout->addRow(tr("&Partition:"), this->cbPartitions);
+    formLayout->addRow(tr("&Start At:"), this->cbStart);
+    formLayout->addRow(tr("&Message ID:"), this->teMessageId);
+    formLayout->addRow(tr("Published &From:"), this->dtStartTime);
+    formLayout->addRow(this->ckEndTime, this->dtEndTime);
+    formLayout->addRow(tr("Ma&x Messages:"), this->sbMaxMessages);
+    formLayout->addRow(tr("F&ormat:"), this->cbFormat);
+    formLayout->addRow(tr("&File:"), fileLayout);
+
+    this->pbProgress = new QProgressBar;
+    this->pbProgress->setRange(0, 1);
+    this->pbProgress->setValue(0);
+    this->lblStatus = new QLabel;
+
+    QHBoxLayout* buttonLayout = new QHBoxLayout;
+#ifdef Q_OS_MACOS
+    this->btnExport = new QPushButton(tr("&Export"));
+    this->btnCancel = new QPushButton(tr("C&ancel"));
+    QPushButton* btnClose = new QPushButton(tr("&Close"));
+#else
+    this->btnExport = new QPushButton(QIcon(":/export"), tr("&Export"));
+    const QIcon stopIcon = QIcon::fromTheme("process-stop", QIcon(":/stop"));
+    this->btnCancel = new QPushButton(stopIcon, tr("C&ancel"));
+    const QIcon closeIcon = QIcon::fromTheme("window-close", QIcon(":/cancel"));
+    QPushButton* btnClose = new QPushButton(closeIcon, tr("&Close"));
+#endif
+    this->btnCancel->setEnabled(false);
+    buttonLayout->setContentsMargins(0, 0, 0, 0);
+    buttonLayout->addWidget(this->lblStatus, 1);
+    buttonLayout->addWidget(this->btnExport);
+    buttonLayout->addSpacing(5);
+    buttonLayout->addWidget(this->btnCancel);
+    buttonLayout->addSpacing(5);
+    buttonLayout->addWidget(btnClose);
+
+    layout->addLayout(formLayout);
+    layout->addWidget(this->pbProgress);
+    layout->addLayout(buttonLayout);
+
+    setLayout(layout);
+    setFixedWidth(720);
+    setAttribute(Qt::WA_DeleteOnClose);
+    setWindowTitle(tr("Export Messages"));
+    setWindowIcon(QIcon(":/export"));
+    setWindowFlags(Qt::WindowCloseButtonHint);
+
+    connect(this->btnExport, &QPushButton::clicked, this, &ExportMessagesWindow::handleExport);
+    connect(this->btnCancel, &QPushButton::clicked, this, &ExportMessagesWindow::handleCancel);
+    connect(btnBrowse, &QPushButton::clicked, this, &ExportMessagesWindow::handleBrowse);
+    connect(btnClose, &QPushButton::clicked, this, &ExportMessagesWindow::close);
+    connect(this->cbStart, &QComboBox::currentIndexChanged, this, &ExportMessagesWindow::handleStartChanged);
+    connect(this->ckEndTime, &QCheckBox::toggled, this->dtEndTime, &QDateTimeEdit::setEnabled);
+    connect(this->cbCluster, &QComboBox::currentTextChanged, this, &ExportMessagesWindow::handleCurrentTextChanged);
+    connect(this->m_Exporter, &MessageExporter::progress, this, &ExportMessagesWindow::handleProgress);
+    connect(this->m_Exporter, &MessageExporter::finished, this, &ExportMessagesWindow::handleFinished);
+    handleStartChanged(0);
+}
+
+void ExportMessagesWindow::afterWindowActivated(const QVariant& _var)
+{
+    if (_var.canConvert<Topic>())
+    {
+        this->m_topic = _var.value<Topic>();
+        if (!this->m_topic.authToken().isEmpty())
+        {
+            this->m_ClusterService->setAuthToken(this->m_topic.authToken());
+        }
+        this->lblTopicName->setText(this->m_TopicService->topicName(this->m_topic, -1));
+        int partitions = this->m_topic.stats().partitions();
+        for (int i = 0; i < partitions; i++)
+        {
+            this->cbPartitions->addItem(QString::number(i));
+        }
+        this->cbPartitions->setEnabled(partitions > 0);
+        this->teFileName->setText(QString("%1.ndjson").arg(this->m_topic.name()));
+        Cluster cluster = this->m_topic.getNamespace().tenant().cluster();
+        this->cbCluster->addItems(this->m_ClusterService->clusters(cluster));
+    }
+}
+
+void ExportMessagesWindow::handleExport()
+{
+    if (this->teServerUrl->text().isEmpty())
+    {
+        QMessageBox::critical(this, tr("Error"), tr("Pulsar Server URL is required."));
+        this->teServerUrl->setFocus();
+        return;
+    }
+    if (this->teFileName->text().isEmpty())
+    {
+        QMessageBox::critical(this, tr("Error"), tr("The file to export to is required."));
+        this->teFileName->setFocus();
+        return;
+    }
+    MessageExporter::Range range;
+    if (this->cbStart->currentIndex() == 1)
+    {
+        QStringList parts = this->teMessageId->text().split(':');
+        bool ledgerOk = false;
+        bool entryOk = false;
+        if (parts.size() == 2)
+        {
+            range.ledgerId = parts.at(0).trimmed().toLongLong(&ledgerOk);
+            range.entryId = parts.at(1).trimmed().toLongLong(&entryOk);
+        }
+        if (!ledgerOk || !entryOk || range.ledgerId < 0 || range.entryId < 0)
+        {
+            QMessageBox::critical(this, tr("Error"), tr("The message ID must be given as ledgerId:entryId."));
+            this->teMessageId->setFocus();
+            return;
+        }
+    }
+    else if (this->cbStart->currentIndex() == 2)
+    {
+        range.startTime = this->dtStartTime->dateTime();
+    }
+    if (this->ckEndTime->isChecked())
+    {
+        range.endTime = this->dtEndTime->dateTime();
+    }
+    range.maxMessages = this->sbMaxMessages->value();
+
+    int partition = this->cbPartitions->currentText().isEmpty() ? -1 : this->cbPartitions->currentText().toInt();
+    MessageExporter::Format format = static_cast<MessageExporter::Format>(this->cbFormat->currentData().toInt());
+    this->pbProgress->setRange(0, range.maxMessages > 0 ? static_cast<int>(range.maxMessages) : 0);
+    this->pbProgress->setValue(0);
+    this->lblStatus->setText(tr("Connecting..."));
+    setRunning(true);
+    this->m_Exporter->start(this->teServerUrl->text(), this->m_TopicService->topicName(this->m_topic, partition), this->m_topic.authToken(), range, format, this->teFileName->text());
+}
+
+void ExportMessagesWindow::handleCancel()
+{
+    this->m_Exporter->cancel();
+    this->btnCancel->setEnabled(false);
+    this->lblStatus->setText(tr("Cancelling..."));
+}
+
+void ExportMessagesWindow::handleBrowse()
+{
+    QString filter = this->cbFormat->currentData().toInt() == MessageExporter::Ndjson ? tr("NDJSON (*.ndjson *.jsonl);;All Files (*)") : tr("Binary (*.bin);;All Files (*)");
+    QString fileName = QFileDialog::getSaveFileName(this, tr("Export Messages"), this->teFileName->text(), filter);
+    if (!fileName.isEmpty())
+    {
+        this->teFileName->setText(fileName);
+    }
+}
+
+void ExportMessagesWindow::handleStartChanged(int _index)
+{
+    this->teMessageId->setEnabled(_index == 1);
+    this->dtStartTime->setEnabled(_index == 2);
+}
+
+void ExportMessagesWindow::handleCurrentTextChanged(const QString& _text)
+{
+    QString broker(this->m_ClusterService->brokerServiceUrl(this->m_topic.getNamespace().tenant().cluster(), _text));
+    this->teServerUrl->setText(broker);
+}
+
+void ExportMessagesWindow::handleProgress(qint64 _messages, qint64 _bytes)
+{
+    if (this->pbProgress->maximum() > 0)
+    {
+        this->pbProgress->setValue(static_cast<int>(_messages));
+    }
+    QLocale locale;
+    this->lblStatus->setText(tr("%1 messages, %2 written").arg(locale.toString(_messages), locale.formattedDataSize(_bytes)));
+}
+
+void ExportMessagesWindow::handleFinished(const QString& _error, qint64 _messages, qint64 _bytes)
+{
+    setRunning(false);
+    this->pbProgress->setRange(0, 1);
+    QLocale locale;
+    if (_error.isEmpty())
+    {
+        this->pbProgress->setValue(1);
+        this->lblStatus->setText(tr("%1 messages, %2 exported").arg(locale.toString(_messages), locale.formattedDataSize(_bytes)));
+    }
+    else
+    {
+        this->pbProgress->setValue(0);
+        this->lblStatus->setText(_error);
+    }
+}
+
+void ExportMessagesWindow::setRunning(const bool& _running)
+{
+    this->btnExport->setEnabled(!_running);
+    this->btnCancel->setEnabled(_running);
+    this->cbCluster->setEnabled(!_running);
+    this->teServerUrl->setEnabled(!_running);
+    this->cbPartitions->setEnabled(!_running && this->cbPartitions->count() > 0);
+    this->cbStart->setEnabled(!_running);
+    this->cbFormat->setEnabled(!_running);
+    this->teFileName->setEnabled(!_running);
+}
@@ -0,0 +1,66 @@
+#ifndef EXPORTMESSAGESWINDOW_H
+#define EXPORTMESSAGESWINDOW_H
+
+#include <QDialog>
+
+#include "../topic.h"
+
+class QLabel;
+class QLineEdit;
+class QComboBox;
+class QCheckBox;
+class QSpinBox;
+class QDateTimeEdit;
+class QProgressBar;
+class ClusterService;
+class TopicService;
+class MessageExporter;
+
+class ExportMessagesWindow : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit ExportMessagesWindow(QWidget* parent = nullptr);
+
+public slots:
+    void afterWindowActivated(const QVariant&);
+
+private slots:
+    void handleExport();
+    void handleCancel();
+    void handleBrowse();
+    void handleStartChanged(int);
+    void handleCurrentTextChanged(const QString&);
+    void handleProgress(qint64, qint64);
+    void handleFinished(const QString&, qint64, qint64);
+
+private:
+    void setRunning(const bool& _running);
+
+private:
+    Topic m_topic;
+
+    QPushButton* btnExport;
+    QPushButton* btnCancel;
+    QLineEdit* teServerUrl;
+    QLabel* lblTopicName;
+    QComboBox* cbCluster;
+    QComboBox* cbPartitions;
+    QComboBox* cbStart;
+    QLineEdit* teMessageId;
+    QDateTimeEdit* dtStartTime;
+    QCheckBox* ckEndTime;
+    QDateTimeEdit* dtEndTime;
+    QSpinBox* sbMaxMessages;
+    QComboBox* cbFormat;
+    QLineEdit* teFileName;
+    QProgressBar* pbProgress;
+    QLabel* lblStatus;
+
+    ClusterService* m_ClusterService;
+    TopicService* m_TopicService;
+    MessageExporter* m_Exporter;
+};
+
+#endif // EXPORTMESSAGESWINDOW_H
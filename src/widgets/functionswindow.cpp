@@ -65,7 +65,7 @@ void FunctionsWindow::createActions()
     this->actRefresh->setStatusTip(tr("Refresh Functions."));
 
     connect(this->actNew, &QAction::triggered, this, &FunctionsWindow::handleNewFunction);
-    connect(this->actRefresh, &QAction::triggered, this, &FunctionsWindow::handleReload);
+    connect(this->actRefresh, &QAction::triggered, this, &FunctionsWindow::handleRefresh);
 
     this->actUpdate->setText(tr("&Update Function..."));
     this->actUpdate->setStatusTip(tr("Updates a Pulsar Function currently running in cluster mode."));
@@ -151,6 +151,14 @@ void FunctionsWindow::handleUpdateFunction(bool)
     }
 }
 
+void FunctionsWindow::handleRefresh(bool)
+{
+    //An explicit refresh bypasses the response cache
+    this->m_FunctionService->setCacheMode(HttpRequest::RefreshCache);
+    handleReload();
+    this->m_FunctionService->setCacheMode(HttpRequest::PreferCache);
+}
+
 void FunctionsWindow::handleReload()
 {
     emit start();
@@ -41,6 +41,7 @@ private slots:
     void handleNewFunction(bool);
     void handleUpdateFunction(bool);
     void handleReload();
+    void handleRefresh(bool);
     void handleInsertNewFunction(const QVariant&);
     void handleFunctionInstances(bool);
     void handleTableItemDoubleClicked(QTableWidgetItem*);
@@ -9,14 +9,24 @@
 #include <QPushButton>
 #include <QSpinBox>
 #include <QMessageBox>
-#include <QTableWidget>
+#include <QTreeView>
 #include <QHeaderView>
 #include <QTabWidget>
+#include <QItemSelectionModel>
+#include <QSharedPointer>
+#include <QHash>
 
 #include "../pulsarmessage.h"
+#include "../messagemodel.h"
 #include "../services/topicservice.h"
+#include "../services/messagefetcher.h"
+#include "../services/chunkreassembler.h"
+#include "../services/schemaservice.h"
+#include "../varianttreewidget.h"
+#include "../payloadview.h"
+#include "../messagefilterbar.h"
 
-LastCommitMessageWindow::LastCommitMessageWindow(QWidget* _parent) : QDialog(_parent), m_TopicService(new TopicService(this)), twMessages(new QTableWidget(this))
+LastCommitMessageWindow::LastCommitMessageWindow(QWidget* _parent) : QDialog(_parent), m_TopicService(new TopicService(this)), m_Model(m_TopicService->messageModel(this)), m_SchemaService(new SchemaService(this)), m_Generation(0), twMessages(new QTreeView(this))
 {
     QVBoxLayout* layout = new QVBoxLayout;
 
@@ -26,26 +36,25 @@ LastCommitMessageWindow::LastCommitMessageWindow(QWidget* _parent) : QDialog(_pa
     this->cbPartitions = new QComboBox;
     this->lblMessageId = new QLabel;
     this->sbNumber = new QSpinBox;
-    this->sbNumber->setRange(1, 100);
+    this->sbNumber->setRange(1, 10000000);
     this->sbNumber->setSingleStep(1);
     formLayout->addRow(tr("&Topic Name:"), lblTopicName);
     formLayout->addRow(tr("Partition:"), this->cbPartitions);
     formLayout->addRow(tr("&MessageId:"), this->lblMessageId);
     formLayout->addRow(tr("&Number of Messages:"), this->sbNumber);
 
-    QStringList header;
-    header << tr("LedgerId") << tr("EntryId") << tr("Message Key") << tr("Properties Count") << tr("Body Length");
-    this->twMessages->setColumnCount(header.length());
-    this->twMessages->setHorizontalHeaderLabels(header);
-    this->twMessages->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    this->twMessages->setModel(this->m_Model);
+    this->twMessages->setUniformRowHeights(true);
+    this->twMessages->header()->setSectionResizeMode(QHeaderView::Stretch);
+    this->twMessages->header()->setStretchLastSection(true);
     this->twMessages->setSelectionBehavior(QAbstractItemView::SelectRows);
-    this->twMessages->horizontalHeader()->setStretchLastSection(true);
     this->twMessages->setSelectionMode(QAbstractItemView::SingleSelection);
-    this->twMessages->verticalHeader()->setHidden(true);
-    this->twMessages->setEditTriggers(QTableWidget::NoEditTriggers);
+    this->twMessages->setEditTriggers(QAbstractItemView::NoEditTriggers);
     this->twMessages->setFocusPolicy(Qt::NoFocus);
     this->twMessages->setContextMenuPolicy(Qt::CustomContextMenu);
     formLayout->addRow(new QLabel("Messages:"));
+    this->fbMessages = new MessageFilterBar(this->twMessages, this->m_Model);
+    formLayout->addRow(this->fbMessages);
     formLayout->addRow(this->twMessages);
 
     QTabWidget* tabs = new QTabWidget();
@@ -54,8 +63,7 @@ LastCommitMessageWindow::LastCommitMessageWindow(QWidget* _parent) : QDialog(_pa
     this->teProperties->setReadOnly(true);
     this->teKey = new QTextEdit();
     this->teKey->setReadOnly(true);
-    this->teMessage = new QTextEdit;
-    this->teMessage->setReadOnly(true);
+    this->pvMessage = new PayloadView;
     this->cbSchema = new QComboBox;
     QVBoxLayout* layoutProperties = new QVBoxLayout;
     layoutProperties->addWidget(this->teProperties);
@@ -67,7 +75,10 @@ LastCommitMessageWindow::LastCommitMessageWindow(QWidget* _parent) : QDialog(_pa
     layoutSchema->addWidget(this->cbSchema);
     layoutSchema->addStretch();
     layoutBody->addLayout(layoutSchema);
-    layoutBody->addWidget(this->teMessage);
+    layoutBody->addWidget(this->pvMessage);
+    this->twDecoded = new VariantTreeWidget;
+    this->twDecoded->hide();
+    layoutBody->addWidget(this->twDecoded);
 
     QWidget* tbProperties = new QWidget();
     QWidget* tbKey = new QWidget();
@@ -110,8 +121,11 @@ LastCommitMessageWindow::LastCommitMessageWindow(QWidget* _parent) : QDialog(_pa
     connect(this->cbPartitions, &QComboBox::currentTextChanged, this, &LastCommitMessageWindow::handleCurrentIndexChanged);
     connect(this->btnGet, &QPushButton::clicked, this, &LastCommitMessageWindow::handleGetMessages);
     connect(btnCancel, &QPushButton::clicked, this, &LastCommitMessageWindow::close);
-    connect(this->twMessages, &QTableWidget::itemSelectionChanged, this, &LastCommitMessageWindow::handleItemSelectionChanged);
+    connect(this->twMessages->selectionModel(), &QItemSelectionModel::currentChanged, this, &LastCommitMessageWindow::handleItemSelectionChanged);
+    connect(this->m_Model, &MessageModel::pageLoaded, this, &LastCommitMessageWindow::handlePageLoaded);
+    connect(this->m_Model, &MessageModel::loadingChanged, this, &LastCommitMessageWindow::handleLoadingChanged);
     connect(this->cbSchema, &QComboBox::currentTextChanged, this, &LastCommitMessageWindow::handleCurrentTextChanged);
+    connect(this->cbSchema, &QComboBox::currentTextChanged, this, &LastCommitMessageWindow::handleSchemaViewChanged);
 }
 
 void LastCommitMessageWindow::afterWindowActivated(const QVariant& _var)
@@ -122,6 +136,7 @@ void LastCommitMessageWindow::afterWindowActivated(const QVariant& _var)
         if (!this->m_topic.authToken().isEmpty())
         {
             this->m_TopicService->setAuthToken(this->m_topic.authToken());
+            this->m_SchemaService->setAuthToken(this->m_topic.authToken());
         }
         this->lblTopicName->setText(QString("%1://%2/%3/%4").arg(m_topic.domain(), m_topic.getNamespace().tenant().name(), m_topic.getNamespace().name(), m_topic.name()));
         int partitions = this->m_topic.stats().partitions();
@@ -138,10 +153,16 @@ void LastCommitMessageWindow::afterWindowActivated(const QVariant& _var)
         }
     }
     QStringList schemas;
-    schemas << "Text" << "Hex" << "Json";
+    schemas << "Text" << "Hex" << "Json" << "Schema";
     this->cbSchema->addItems(schemas);
 }
 
+/**
+ * @brief The entries are read a page at a time as the list is scrolled, the newest first and
+ * back from the message id up to the number of messages asked for. Every page after the first
+ * starts from the oldest entry of the previous one, which is left out again. Chunks go to the
+ * reassembler the first time their page is read.
+ */
 void LastCommitMessageWindow::handleGetMessages()
 {
     QVariant object = this->lblMessageId->property(QString("messageId").toLatin1());
@@ -149,40 +170,135 @@ void LastCommitMessageWindow::handleGetMessages()
     {
         Message message = object.value<Message>();
         int partitions = this->cbPartitions->currentText().isEmpty() ? -1 : this->cbPartitions->currentText().toInt();
-        QList<PulsarMessage> messages = this->m_TopicService->messages(m_topic, partitions, message.ledgerId(), message.entryId(), this->sbNumber->value());
-        if (messages.size() > 0)
+        if (this->m_Reassembler)
         {
-            //this->teProperties->clear();
-            this->twMessages->clearContents();
-            this->twMessages->setRowCount(messages.size());
-            for (int i = messages.size() - 1, n = 0; i >= n; i--)
+            this->m_Reassembler->cancel();
+            this->m_Reassembler->deleteLater();
+        }
+        this->m_Generation++;
+        this->btnGet->setEnabled(false);
+
+        this->m_Reassembler = this->m_TopicService->chunkReassembler(m_topic, partitions);
+        connect(this->m_Reassembler, &ChunkReassembler::messageAssembled, this, &LastCommitMessageWindow::handleMessageAssembled);
+        connect(this->m_Reassembler, &ChunkReassembler::messageIncomplete, this, &LastCommitMessageWindow::handleMessageIncomplete);
+
+        Topic topic(this->m_topic);
+        int limit = this->sbNumber->value();
+        QSharedPointer<QHash<int, Message>> starts(new QHash<int, Message>());
+        starts->insert(0, message);
+        this->m_Model->setLoader([this, topic, partitions, limit, starts](const int& _page, const bool& _reload, const MessageModel::PageCallback& _callback)
+        {
+            int pageSize = this->m_Model->pageSize();
+            int num = qMin(pageSize, limit - _page * pageSize);
+            int skip = _page > 0 ? 1 : 0;
+            Message start = starts->value(_page);
+            QPointer<ChunkReassembler> reassembler = _reload ? QPointer<ChunkReassembler>() : this->m_Reassembler;
+            MessageFetcher* fetcher = this->m_TopicService->messageFetcher(topic, partitions);
+            connect(fetcher, &MessageFetcher::finished, this, [fetcher, starts, _page, start, skip, num, limit, pageSize, reassembler, _callback]()
             {
-                PulsarMessage pm = messages[i];
-                QTableWidgetItem* item1 = new QTableWidgetItem(QString::number(pm.ledgerId()));
-                item1->setTextAlignment(Qt::AlignCenter);
-                this->twMessages->setItem(i, 0, item1);
-                QTableWidgetItem* item2 = new QTableWidgetItem(QString::number(pm.entryId()));
-                item2->setTextAlignment(Qt::AlignCenter);
-                this->twMessages->setItem(i, 1, item2);
-                QTableWidgetItem* item3 = new QTableWidgetItem(pm.key());
-                this->twMessages->setItem(i, 2, item3);
-                QTableWidgetItem* item4 = new QTableWidgetItem(QString::number(pm.properties().size()));
-                item4->setTextAlignment(Qt::AlignRight | Qt::AlignCenter);
-                this->twMessages->setItem(i, 3, item4);
-                QTableWidgetItem* item5 = new QTableWidgetItem(QString::number(pm.body().length()));
-                item5->setTextAlignment(Qt::AlignRight | Qt::AlignCenter);
-                this->twMessages->setItem(i, 4, item5);
-                item1->setData(Qt::UserRole, QVariant::fromValue(pm));
-
-                //this->teMessage->insertHtml(QString(tr("<b>********** MessageId:%1:%2 **********</b><br>")).arg(message.ledgerId()).arg(message.entryId() - i));
-                //this->teMessage->insertHtml(QString(tr("<div style='color: #0008FF;'>%1</div><br>")).arg(messages.at(i)));
-                //this->teMessage->insertHtml("<br>");
-            }
+                QList<PulsarMessage> messages;
+                foreach (const PulsarMessage& pm, fetcher->messages())
+                {
+                    if (skip > 0 && pm.ledgerId() == start.ledgerId() && pm.entryId() == start.entryId())
+                    {
+                        continue; //the last row of the previous page
+                    }
+                    if (pm.isChunk())
+                    {
+                        if (reassembler)
+                        {
+                            reassembler->add(pm);
+                        }
+                        continue;
+                    }
+                    messages.prepend(pm);
+                }
+                if (reassembler)
+                {
+                    reassembler->flush(); //reads the chunks before and after the page
+                }
+                QVector<Message> positions = fetcher->positions();
+                bool more = positions.size() == num + skip && (_page + 1) * pageSize < limit;
+                if (more)
+                {
+                    starts->insert(_page + 1, positions.first());
+                }
+                fetcher->deleteLater();
+                _callback(messages, more);
+            });
+            fetcher->start(start.ledgerId(), start.entryId(), num + skip);
+        });
+        this->m_Model->fetchMore(QModelIndex());
+    }
+}
+
+void LastCommitMessageWindow::handleMessageAssembled(const PulsarMessage& _message)
+{
+    this->m_Model->appendMessages(QList<PulsarMessage>() << _message);
+}
+
+void LastCommitMessageWindow::handleMessageIncomplete(const QList<PulsarMessage>& _chunks)
+{
+    this->m_Model->appendMessages(_chunks);
+}
+
+/**
+ * @brief Decode the bodies of the rows with the topic schema, the values are kept by the model
+ * for the Schema view until their page is dropped.
+ * @param _indexes
+ */
+void LastCommitMessageWindow::decodeMessages(const QModelIndexList& _indexes)
+{
+    QList<PulsarMessage> messages;
+    foreach (const QModelIndex& index, _indexes)
+    {
+        messages << this->m_Model->message(index);
+    }
+
+    int generation = this->m_Generation;
+    this->m_SchemaService->decode(this->m_topic, messages, this, [this, _indexes, generation](const QList<QVariant>& _values)
+    {
+        if (generation != this->m_Generation)
+        {
+            return; //the rows are gone
         }
-        else
+        for (int i = 0, n = _indexes.size(); i < n; ++i)
+        {
+            this->m_Model->setData(_indexes[i], _values[i], MessageModel::DecodedRole);
+        }
+        if (this->cbSchema->currentText() == "Schema")
         {
-            QMessageBox::warning(this, "Warning", "No messages can be read.");
+            handleCurrentTextChanged(this->cbSchema->currentText());
         }
+    });
+}
+
+/**
+ * @brief Decode and filter the rows of a page read or read again, the details of the current
+ * row come back with its page. Only the Schema view shows decoded values, the other views
+ * leave the rows to be decoded once it is chosen.
+ * @param _indexes
+ */
+void LastCommitMessageWindow::handlePageLoaded(const QModelIndexList& _indexes)
+{
+    if (this->cbSchema->currentText() == "Schema")
+    {
+        decodeMessages(_indexes);
+    }
+    this->fbMessages->refresh();
+    QModelIndex current = this->twMessages->currentIndex();
+    if (current.isValid() && _indexes.contains(current.sibling(current.row(), 0)))
+    {
+        handleItemSelectionChanged();
+    }
+}
+
+void LastCommitMessageWindow::handleLoadingChanged(bool _loading)
+{
+    this->btnGet->setEnabled(!_loading);
+    if (!_loading && this->m_Model->rowCount() == 0 && !this->m_Model->canFetchMore(QModelIndex()))
+    {
+        QMessageBox::warning(this, "Warning", "No messages can be read.");
     }
 }
 
@@ -199,42 +315,73 @@ void LastCommitMessageWindow::handleCurrentIndexChanged(const QString& _text)
 void LastCommitMessageWindow::handleItemSelectionChanged()
 {
     //this->teProperties->clear();
-    QTableWidgetItem* current = this->twMessages->currentItem();
-    if (current)
+    QModelIndex current = this->twMessages->currentIndex();
+    if (current.isValid())
     {
-        int row = current->row();
-        QTableWidgetItem* item = this->twMessages->item(row, 0);
-        QVariant data = item->data(Qt::UserRole);
+        QVariant data = current.data(MessageModel::MessageRole);
         if (data.canConvert<PulsarMessage>())
         {
             PulsarMessage message = data.value<PulsarMessage>();
             this->teProperties->setText(message.formatProperties());
             this->teKey->setText(message.key());
-            this->teMessage->setProperty("body", data);
-            this->teMessage->setText(message.toString());
-            this->cbSchema->setCurrentIndex(0);
+            this->pvMessage->setMessage(message);
+            handleCurrentTextChanged(this->cbSchema->currentText());
+        }
+        else
+        {
+            //not in memory, its page is read again, see handlePageLoaded()
+            this->teProperties->clear();
+            this->teKey->clear();
+            this->pvMessage->clear();
+            this->twDecoded->clear();
         }
     }
 }
 
-void LastCommitMessageWindow::handleCurrentTextChanged(const QString& _text)
+/**
+ * @brief Decode the rows in memory that were read while another view was shown.
+ */
+void LastCommitMessageWindow::handleSchemaViewChanged(const QString& _text)
 {
-    QVariant data = this->teMessage->property("body");
-    if (data.canConvert<PulsarMessage>())
+    if (_text != "Schema")
     {
-        PulsarMessage message = data.value<PulsarMessage>();
-        if (_text == "Text")
-        {
-            this->teMessage->setText(message.toString());
-        }
-        else if (_text == "Json")
-        {
-            this->teMessage->setText(message.toJson());
-        }
-        else if (_text == "Hex")
+        return;
+    }
+    QModelIndexList indexes;
+    QList<PulsarMessage> messages;
+    this->m_Model->residentMessages(indexes, messages);
+    QModelIndexList undecoded;
+    foreach (const QModelIndex& index, indexes)
+    {
+        if (!index.data(MessageModel::DecodedRole).isValid())
         {
-            this->teMessage->setText(message.toHex());
+            undecoded << index;
         }
     }
+    if (!undecoded.isEmpty())
+    {
+        decodeMessages(undecoded);
+    }
+}
 
+void LastCommitMessageWindow::handleCurrentTextChanged(const QString& _text)
+{
+    this->pvMessage->setVisible(_text != "Schema");
+    this->twDecoded->setVisible(_text == "Schema");
+    if (_text == "Text")
+    {
+        this->pvMessage->setMode(PayloadView::Text);
+    }
+    else if (_text == "Json")
+    {
+        this->pvMessage->setMode(PayloadView::Json);
+    }
+    else if (_text == "Hex")
+    {
+        this->pvMessage->setMode(PayloadView::Hex);
+    }
+    else if (_text == "Schema" && this->twMessages->currentIndex().isValid())
+    {
+        this->twDecoded->setValue(this->twMessages->currentIndex().data(MessageModel::DecodedRole));
+    }
 }
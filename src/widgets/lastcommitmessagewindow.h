@@ -2,6 +2,8 @@
 #define LASTCOMMITMESSAGEWINDOW_H
 
 #include <QDialog>
+#include <QPointer>
+#include <QModelIndex>
 
 #include "../topic.h"
 
@@ -9,8 +11,15 @@ class QComboBox;
 class QTextEdit;
 class QLabel;
 class QSpinBox;
-class QTableWidget;
+class QTreeView;
 class TopicService;
+class SchemaService;
+class VariantTreeWidget;
+class PayloadView;
+class MessageModel;
+class MessageFilterBar;
+class ChunkReassembler;
+class PulsarMessage;
 
 class LastCommitMessageWindow : public QDialog
 {
@@ -26,6 +35,10 @@ public slots:
 
 private:
     TopicService* m_TopicService;
+    MessageModel* m_Model;
+    SchemaService* m_SchemaService;
+    int m_Generation;
+    QPointer<ChunkReassembler> m_Reassembler;
     Topic m_topic;
 
     QComboBox* cbPartitions;
@@ -33,17 +46,26 @@ private:
     QLabel* lblMessageId;
     QSpinBox* sbNumber;
     QLabel* lblTopicName;
-    QTableWidget* twMessages;
+    QTreeView* twMessages;
+    MessageFilterBar* fbMessages;
     QTextEdit* teProperties;
     QTextEdit* teKey;
-    QTextEdit* teMessage;
+    PayloadView* pvMessage;
+    VariantTreeWidget* twDecoded;
     QComboBox* cbSchema;
 
+    void decodeMessages(const QModelIndexList& _indexes);
+
 private slots:
     void handleGetMessages();
+    void handleMessageAssembled(const PulsarMessage&);
+    void handleMessageIncomplete(const QList<PulsarMessage>&);
+    void handlePageLoaded(const QModelIndexList&);
+    void handleLoadingChanged(bool);
     void handleCurrentIndexChanged(const QString&);
     void handleItemSelectionChanged();
     void handleCurrentTextChanged(const QString&);
+    void handleSchemaViewChanged(const QString&);
 };
 
 #endif // LASTCOMMITMESSAGEWINDOW_H
@@ -15,11 +15,14 @@
 #include <QMessageBox>
 #include <QDebug>
 #include <QDir>
+#include <QLabel>
 
 #include "../constants.h"
 #include "../services/clusterservice.h"
 #include "../services/tenantservice.h"
 #include "../services/namespaceservice.h"
+#include "../services/connectionpool.h"
+#include "../services/requestcoalescer.h"
 #include "../widgets/newclusterwindow.h"
 #include "../widgets/tenantwindow.h"
 #include "../widgets/namespacewindow.h"
@@ -28,6 +31,7 @@
 #include "../widgets/sourceswindow.h"
 #include "../widgets/sinkswindow.h"
 #include "../widgets/permissionswindow.h"
+#include "../widgets/diagnosticswindow.h"
 #include "../widgets/tokenwindow.h"
 
 MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent),
@@ -102,6 +106,11 @@ void MainWindow::createActions()
     fileMenu->addAction(exitAct);
 
     this->menuView = menuBar()->addMenu(tr("&View"));
+    this->actDiagnostics = new QAction(QIcon(":/overview"), tr("&Diagnostics..."), this);
+    this->actDiagnostics->setStatusTip(tr("Latency and throughput of the admin endpoints."));
+    connect(this->actDiagnostics, & QAction::triggered, this, & MainWindow::handleDiagnosticsWindow);
+    this->menuView->addAction(this->actDiagnostics);
+    this->menuView->addSeparator();
     this->menuWindow = menuBar()->addMenu(tr("&Window"));
     connect(this->menuWindow, & QMenu::aboutToShow, this, & MainWindow::updateWindowMenu);
 
@@ -257,6 +266,16 @@ void MainWindow::createClustersDock()
 void MainWindow::createStatusBar()
 {
     statusBar()->showMessage(tr("Ready"));
+
+    this->lblSavedRequests = new QLabel(tr("Saved requests: %1").arg(0));
+    this->lblSavedRequests->setToolTip(tr("Identical requests answered by one already in flight."));
+    statusBar()->addPermanentWidget(this->lblSavedRequests);
+    connect(RequestCoalescer::instance(), &RequestCoalescer::savedChanged, this, &MainWindow::handleSavedRequestsChanged);
+}
+
+void MainWindow::handleSavedRequestsChanged(int _saved)
+{
+    this->lblSavedRequests->setText(tr("Saved requests: %1").arg(_saved));
 }
 
 void MainWindow::readSettings()
@@ -344,7 +363,11 @@ void MainWindow::handleReflashAll(bool)
         if (data.canConvert<Cluster>())
         {
             Cluster cluster = data.value<Cluster>();
+            this->m_TenantService->setCacheMode(HttpRequest::RefreshCache);
+            this->m_NamespaceService->setCacheMode(HttpRequest::RefreshCache);
             handleLoadTenantsAndNamespaces(cluster);
+            this->m_TenantService->setCacheMode(HttpRequest::PreferCache);
+            this->m_NamespaceService->setCacheMode(HttpRequest::PreferCache);
         }
     }
 }
@@ -527,6 +550,21 @@ void MainWindow::handlePermissionWindow(bool)
     }
 }
 
+void MainWindow::handleDiagnosticsWindow(bool)
+{
+    MdiSubWindow* subWindow = findMdiSubWindow(MdiSubWindow::SubWindowType::DiagnosticsSubWindow);
+    if (subWindow)
+    {
+        this->mdiMain->setActiveSubWindow(subWindow);
+    }
+    else
+    {
+        BaseMdiSubWindow* mdiChild = new DiagnosticsWindow(this->mdiMain);
+        this->mdiMain->addSubWindow(mdiChild);
+        mdiChild->afterWindowActivated(QVariant());
+    }
+}
+
 void MainWindow::handleOpenCluster(bool)
 {
     QTreeWidgetItem* item = this->treeClusters->currentItem();
@@ -564,6 +602,7 @@ void MainWindow::handleCloseCluster(bool)
                 this->tlbTenantToolbar->setEnabled(false);
                 this->mdiMain->closeAllSubWindows();
                 this->treeTenants->clear();
+                ConnectionPool::instance()->close(cluster);
                 item->setData(0, Qt::UserRole, QVariant::fromValue(cluster));
             }
         }
@@ -638,6 +677,7 @@ void MainWindow::handleTreeItemDoubleClicked(QTreeWidgetItem* _item, int)
             _item->setIcon(0, QIcon(":/connected"));
             _item->setData(0, Qt::UserRole, QVariant::fromValue(cluster));
             this->tlbTenantToolbar->setEnabled(true);
+            ConnectionPool::instance()->open(cluster);
             handleLoadTenantsAndNamespaces(cluster);
         }
     }
@@ -747,6 +787,7 @@ void MainWindow::handleDeleteCluster(bool)
                     this->tlbTenantToolbar->setEnabled(false);
                     this->mdiMain->closeAllSubWindows();
                     this->treeTenants->clear();
+                    ConnectionPool::instance()->close(cluster);
                 }
                 this->m_ClusterService->removeCluster(cluster);
                 delete item;
@@ -7,6 +7,7 @@ class QMdiArea;
 class QTreeWidget;
 class QToolBar;
 class QTreeWidgetItem;
+class QLabel;
 class ClusterService;
 class TenantService;
 class NamespaceService;
@@ -62,6 +63,7 @@ private slots:
     void handleSourceWindow(bool);
     void handleSinkWindow(bool);
     void handlePermissionWindow(bool);
+    void handleDiagnosticsWindow(bool);
     void handleOpenCluster(bool);
     void handleCloseCluster(bool);
     void handleInsertTreeItem(const Cluster& _cluster);
@@ -76,6 +78,7 @@ private slots:
     void handleDeleteNamespace(bool);
     void updateMenus();
     void updateWindowMenu();
+    void handleSavedRequestsChanged(int);
 
 private:
     QMdiArea* mdiMain;
@@ -85,6 +88,7 @@ private:
     QMenu* menuWindow;
     QToolBar* tlbTenantToolbar;
     QToolBar* tlbClusterToolbar;
+    QLabel* lblSavedRequests;
 
     QAction* actTokens;
     QAction* actNewTenant;
@@ -100,6 +104,7 @@ private:
     QAction* actSinks;
     QAction* actSources;
     QAction* actPermission;
+    QAction* actDiagnostics;
 
     QAction* closeAct;
     QAction* closeAllAct;
@@ -18,6 +18,7 @@ public:
         PermissionSubWindow = 0x3,
         SinkSubWindow = 0x4,
         SourceSubWindow = 0x5,
+        DiagnosticsSubWindow = 0x6,
     };
     Q_ENUM(SubWindowType)
 
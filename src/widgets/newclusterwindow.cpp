@@ -22,11 +22,13 @@ NewClusterWindow::NewClusterWindow(QWidget* parent) : QDialog(parent), m_New(tru
     this->tbFunctionUrl = new QLineEdit;
     this->tbPrestoUrl = new QLineEdit;
     this->tbAuthToken = new QLineEdit;
+    this->cbTlsAllowInsecure = new QCheckBox(tr("Allow &insecure TLS connection, the certificate is not verified"));
     formLayout->addRow(tr("&Cluster Name:"), this->tbName);
     formLayout->addRow(tr("&Admin Service URL:"), this->tbServiceUrl);
     formLayout->addRow(tr("&Function Service URL:"), this->tbFunctionUrl);
     formLayout->addRow(tr("&Presto Service URL:"), this->tbPrestoUrl);
     formLayout->addRow(tr("A&uthorization:"), this->tbAuthToken);
+    formLayout->addRow(QString(), this->cbTlsAllowInsecure);
 
     QHBoxLayout* buttonLayout = new QHBoxLayout;
 
@@ -49,7 +51,7 @@ NewClusterWindow::NewClusterWindow(QWidget* parent) : QDialog(parent), m_New(tru
     layout->addLayout(buttonLayout);
 
     setLayout(layout);
-    setFixedSize(QSize(560, 230));
+    setFixedSize(QSize(560, 260));
     setAttribute(Qt::WA_DeleteOnClose);
     setWindowTitle(tr("New Cluster"));
     setWindowIcon(QIcon(":/newcluster.png"));
@@ -70,6 +72,7 @@ void NewClusterWindow::afterWindowActivated(const Cluster* _cluster)
         this->tbFunctionUrl->setText(_cluster->functionUrl());
         this->tbPrestoUrl->setText(_cluster->prestoUrl());
         this->tbAuthToken->setText(_cluster->authtoken());
+        this->cbTlsAllowInsecure->setChecked(_cluster->tlsAllowInsecureConnection());
         this->m_New = false;
     }
 }
@@ -97,6 +100,7 @@ void NewClusterWindow::handleNewCluster()
     cluster.setFunctionUrl(this->tbFunctionUrl->text());
     cluster.setPrestoUrl(this->tbPrestoUrl->text());
     cluster.setAuthtoken(this->tbAuthToken->text());
+    cluster.setTlsAllowInsecureConnection(this->cbTlsAllowInsecure->isChecked());
 
     if (m_New)
     {
@@ -3,6 +3,7 @@
 
 #include <QDialog>
 #include <QLineEdit>
+#include <QCheckBox>
 
 class Cluster;
 
@@ -26,6 +27,7 @@ private:
     QLineEdit* tbFunctionUrl;
     QLineEdit* tbPrestoUrl;
     QLineEdit* tbAuthToken;
+    QCheckBox* cbTlsAllowInsecure;
     QPushButton* btnOk;
     QPushButton* btnCancel;
 
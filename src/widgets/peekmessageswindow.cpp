@@ -4,7 +4,8 @@
 #include <QFormLayout>
 #include <QLabel>
 #include <QSpinBox>
-#include <QTableWidget>
+#include <QTreeView>
+#include <QItemSelectionModel>
 #include <QHeaderView>
 #include <QPushButton>
 #include <QTextEdit>
@@ -12,10 +13,16 @@
 #include <QDebug>
 
 #include "../pulsarmessage.h"
+#include "../messagemodel.h"
 #include "../services/cursorservice.h"
 #include "../services/topicservice.h"
+#include "../services/chunkreassembler.h"
+#include "../services/schemaservice.h"
+#include "../varianttreewidget.h"
+#include "../payloadview.h"
+#include "../messagefilterbar.h"
 
-PeekMessagesWindow::PeekMessagesWindow(QWidget* parent) : QDialog(parent), m_TopicService(new TopicService(this)), m_CursorService(new CursorService(this))
+PeekMessagesWindow::PeekMessagesWindow(QWidget* parent) : QDialog(parent), m_TopicService(new TopicService(this)), m_Model(m_TopicService->messageModel(this)), m_SchemaService(new SchemaService(this)), m_Generation(0), m_CursorService(new CursorService(this))
 {
     QVBoxLayout* layout = new QVBoxLayout;
     QFormLayout* formLayout = new QFormLayout;
@@ -35,19 +42,18 @@ PeekMessagesWindow::PeekMessagesWindow(QWidget* parent) : QDialog(parent), m_Top
     actionsLayout->addWidget(this->btnPeek);
     actionsLayout->addStretch();
     layout->addLayout(actionsLayout);
-    QStringList header;
-    header << tr("LedgerId") << tr("EntryId") << tr("Message Key") << tr("Properties Count") << tr("Body Length");
-    this->twMessages = new QTableWidget(this);
-    this->twMessages->setColumnCount(header.length());
-    this->twMessages->setHorizontalHeaderLabels(header);
-    this->twMessages->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    this->twMessages = new QTreeView(this);
+    this->twMessages->setModel(this->m_Model);
+    this->twMessages->setUniformRowHeights(true);
+    this->twMessages->header()->setSectionResizeMode(QHeaderView::Stretch);
+    this->twMessages->header()->setStretchLastSection(true);
     this->twMessages->setSelectionBehavior(QAbstractItemView::SelectRows);
-    this->twMessages->horizontalHeader()->setStretchLastSection(true);
     this->twMessages->setSelectionMode(QAbstractItemView::SingleSelection);
-    this->twMessages->verticalHeader()->setHidden(true);
-    this->twMessages->setEditTriggers(QTableWidget::NoEditTriggers);
+    this->twMessages->setEditTriggers(QAbstractItemView::NoEditTriggers);
     this->twMessages->setFocusPolicy(Qt::NoFocus);
     this->twMessages->setContextMenuPolicy(Qt::CustomContextMenu);
+    this->fbMessages = new MessageFilterBar(this->twMessages, this->m_Model);
+    layout->addWidget(this->fbMessages);
     layout->addWidget(this->twMessages);
 
     QTabWidget* tabs = new QTabWidget();
@@ -55,8 +61,7 @@ PeekMessagesWindow::PeekMessagesWindow(QWidget* parent) : QDialog(parent), m_Top
     this->teProperties->setReadOnly(true);
     this->teKey = new QTextEdit();
     this->teKey->setReadOnly(true);
-    this->teMessage = new QTextEdit;
-    this->teMessage->setReadOnly(true);
+    this->pvMessage = new PayloadView;
     this->cbSchema = new QComboBox;
 
     QVBoxLayout* layoutProperties = new QVBoxLayout;
@@ -69,7 +74,10 @@ PeekMessagesWindow::PeekMessagesWindow(QWidget* parent) : QDialog(parent), m_Top
     layoutSchema->addWidget(this->cbSchema);
     layoutSchema->addStretch();
     layoutBody->addLayout(layoutSchema);
-    layoutBody->addWidget(this->teMessage);
+    layoutBody->addWidget(this->pvMessage);
+    this->twDecoded = new VariantTreeWidget;
+    this->twDecoded->hide();
+    layoutBody->addWidget(this->twDecoded);
 
     QWidget* tbProperties = new QWidget();
     QWidget* tbKey = new QWidget();
@@ -105,8 +113,10 @@ PeekMessagesWindow::PeekMessagesWindow(QWidget* parent) : QDialog(parent), m_Top
     connect(btnCancel, &QPushButton::clicked, this, &PeekMessagesWindow::close);
     connect(this->sbNumber, SIGNAL(valueChanged(int)), this, SLOT(handleValueChanged(int)));
     connect(this, &PeekMessagesWindow::initialize, this, &PeekMessagesWindow::handleInitialize);
-    connect(this->twMessages, &QTableWidget::itemSelectionChanged, this, &PeekMessagesWindow::handleItemSelectionChanged);
+    connect(this->twMessages->selectionModel(), &QItemSelectionModel::currentChanged, this, &PeekMessagesWindow::handleItemSelectionChanged);
+    connect(this->m_Model, &MessageModel::pageLoaded, this, &PeekMessagesWindow::handlePageLoaded);
     connect(this->cbSchema, &QComboBox::currentTextChanged, this, &PeekMessagesWindow::handleCurrentTextChanged);
+    connect(this->cbSchema, &QComboBox::currentTextChanged, this, &PeekMessagesWindow::handleSchemaViewChanged);
 }
 
 PeekMessagesWindow::~PeekMessagesWindow() {}
@@ -118,6 +128,7 @@ void PeekMessagesWindow::afterWindowActivated(const Topic& _topic, const Subscri
     if (!this->m_Topic.authToken().isEmpty())
     {
         this->m_TopicService->setAuthToken(this->m_Topic.authToken());
+        this->m_SchemaService->setAuthToken(this->m_Topic.authToken());
         this->m_CursorService->setAuthToken(this->m_Topic.authToken());
     }
     this->m_Subscription = _subscription;
@@ -133,11 +144,15 @@ void PeekMessagesWindow::afterWindowActivated(const Topic& _topic, const Subscri
     this->lblTopicName->setText(this->m_Topic.formatName());
     this->lblBacklog->setText(QString::number(this->m_Subscription.msgBacklog()));
     QStringList schemas;
-    schemas << "Text" << "Hex" << "Json";
+    schemas << "Text" << "Hex" << "Json" << "Schema";
     this->cbSchema->addItems(schemas);
     emit initialize();
 }
 
+/**
+ * @brief The positions are peeked a page at a time as the list is scrolled, up to the number of
+ * messages asked for. Chunks go to the reassembler the first time their page is read.
+ */
 void PeekMessagesWindow::handleInitialize()
 {
     int backlog = this->m_Subscription.msgBacklog();
@@ -145,28 +160,113 @@ void PeekMessagesWindow::handleInitialize()
     {
         Cursor cursor = m_CursorService->find(this->m_Topic, this->m_Partitions, this->m_Subscription.name());
         int ledgerId = cursor.deletePositionLedgerId();
-        QList<PulsarMessage> messages = m_TopicService->messages(this->m_Topic, this->m_Partitions, this->m_Subscription.name(), this->sbNumber->value());
-        this->twMessages->clearContents();
-        this->twMessages->setRowCount(messages.size());
-        for (int i = messages.size() - 1, n = 0; i >= n; i--)
+        this->m_Generation++;
+        if (this->m_Reassembler)
         {
-            PulsarMessage pm = messages[i];
-            QTableWidgetItem* item1 = new QTableWidgetItem(QString::number(ledgerId));
-            item1->setTextAlignment(Qt::AlignCenter);
-            this->twMessages->setItem(i, 0, item1);
-            QTableWidgetItem* item2 = new QTableWidgetItem(QString::number(pm.entryId()));
-            item2->setTextAlignment(Qt::AlignCenter);
-            this->twMessages->setItem(i, 1, item2);
-            QTableWidgetItem* item3 = new QTableWidgetItem(pm.key());
-            this->twMessages->setItem(i, 2, item3);
-            QTableWidgetItem* item4 = new QTableWidgetItem(QString::number(pm.properties().size()));
-            item4->setTextAlignment(Qt::AlignRight | Qt::AlignCenter);
-            this->twMessages->setItem(i, 3, item4);
-            QTableWidgetItem* item5 = new QTableWidgetItem(QString::number(pm.body().length()));
-            item5->setTextAlignment(Qt::AlignRight | Qt::AlignCenter);
-            this->twMessages->setItem(i, 4, item5);
-            item1->setData(Qt::UserRole, QVariant::fromValue(pm));
+            this->m_Reassembler->cancel();
+            this->m_Reassembler->deleteLater();
         }
+        this->m_Reassembler = this->m_TopicService->chunkReassembler(this->m_Topic, this->m_Partitions);
+        connect(this->m_Reassembler, &ChunkReassembler::messageAssembled, this, &PeekMessagesWindow::handleMessageAssembled);
+        connect(this->m_Reassembler, &ChunkReassembler::messageIncomplete, this, &PeekMessagesWindow::handleMessageIncomplete);
+
+        Topic topic(this->m_Topic);
+        int partitions = this->m_Partitions;
+        QString subName = this->m_Subscription.name();
+        int limit = this->sbNumber->value();
+        this->m_Model->setLoader([this, topic, partitions, subName, ledgerId, limit](const int& _page, const bool& _reload, const MessageModel::PageCallback& _callback)
+        {
+            int position = _page * this->m_Model->pageSize() + 1;
+            int num = qMin(this->m_Model->pageSize(), limit - position + 1);
+            QPointer<ChunkReassembler> reassembler = _reload ? QPointer<ChunkReassembler>() : this->m_Reassembler;
+            this->m_TopicService->peekMessages(topic, partitions, subName, position, num, this, [ledgerId, reassembler, position, num, limit, _callback](const QList<PulsarMessage>& _messages)
+            {
+                QList<PulsarMessage> messages;
+                foreach (PulsarMessage pm, _messages)
+                {
+                    if (pm.ledgerId() < 0)
+                    {
+                        pm.setLedgerId(ledgerId);
+                    }
+                    if (pm.isChunk())
+                    {
+                        if (reassembler)
+                        {
+                            reassembler->add(pm);
+                        }
+                        continue;
+                    }
+                    messages << pm;
+                }
+                if (reassembler)
+                {
+                    reassembler->flush(); //reads the chunks beyond the peeked ones
+                }
+                _callback(messages, _messages.size() == num && position + num <= limit);
+            });
+        });
+        this->m_Model->fetchMore(QModelIndex());
+    }
+}
+
+void PeekMessagesWindow::handleMessageAssembled(const PulsarMessage& _message)
+{
+    this->m_Model->appendMessages(QList<PulsarMessage>() << _message);
+}
+
+void PeekMessagesWindow::handleMessageIncomplete(const QList<PulsarMessage>& _chunks)
+{
+    this->m_Model->appendMessages(_chunks);
+}
+
+/**
+ * @brief Decode the bodies of the rows with the topic schema, the values are kept by the model
+ * for the Schema view until their page is dropped.
+ * @param _indexes
+ */
+void PeekMessagesWindow::decodeMessages(const QModelIndexList& _indexes)
+{
+    QList<PulsarMessage> messages;
+    foreach (const QModelIndex& index, _indexes)
+    {
+        messages << this->m_Model->message(index);
+    }
+
+    int generation = this->m_Generation;
+    this->m_SchemaService->decode(this->m_Topic, messages, this, [this, _indexes, generation](const QList<QVariant>& _values)
+    {
+        if (generation != this->m_Generation)
+        {
+            return; //the rows are gone
+        }
+        for (int i = 0, n = _indexes.size(); i < n; ++i)
+        {
+            this->m_Model->setData(_indexes[i], _values[i], MessageModel::DecodedRole);
+        }
+        if (this->cbSchema->currentText() == "Schema")
+        {
+            handleCurrentTextChanged(this->cbSchema->currentText());
+        }
+    });
+}
+
+/**
+ * @brief Decode and filter the rows of a page read or read again, the details of the current
+ * row come back with its page. Only the Schema view shows decoded values, the other views
+ * leave the rows to be decoded once it is chosen.
+ * @param _indexes
+ */
+void PeekMessagesWindow::handlePageLoaded(const QModelIndexList& _indexes)
+{
+    if (this->cbSchema->currentText() == "Schema")
+    {
+        decodeMessages(_indexes);
+    }
+    this->fbMessages->refresh();
+    QModelIndex current = this->twMessages->currentIndex();
+    if (current.isValid() && _indexes.contains(current.sibling(current.row(), 0)))
+    {
+        handleItemSelectionChanged();
     }
 }
 
@@ -177,41 +277,73 @@ void PeekMessagesWindow::handleValueChanged(int _value)
 
 void PeekMessagesWindow::handleItemSelectionChanged()
 {
-    QTableWidgetItem* current = this->twMessages->currentItem();
-    if (current)
+    QModelIndex current = this->twMessages->currentIndex();
+    if (current.isValid())
     {
-        int row = current->row();
-        QTableWidgetItem* item = this->twMessages->item(row, 0);
-        QVariant data = item->data(Qt::UserRole);
+        QVariant data = current.data(MessageModel::MessageRole);
         if (data.canConvert<PulsarMessage>())
         {
             PulsarMessage message = data.value<PulsarMessage>();
             this->teProperties->setText(message.formatProperties());
             this->teKey->setText(message.key());
-            this->teMessage->setProperty("body", data);
-            this->teMessage->setText(message.toString());
-            this->cbSchema->setCurrentIndex(0);
+            this->pvMessage->setMessage(message);
+            handleCurrentTextChanged(this->cbSchema->currentText());
+        }
+        else
+        {
+            //not in memory, its page is read again, see handlePageLoaded()
+            this->teProperties->clear();
+            this->teKey->clear();
+            this->pvMessage->clear();
+            this->twDecoded->clear();
         }
     }
 }
 
-void PeekMessagesWindow::handleCurrentTextChanged(const QString& _text)
+/**
+ * @brief Decode the rows in memory that were read while another view was shown.
+ */
+void PeekMessagesWindow::handleSchemaViewChanged(const QString& _text)
 {
-    QVariant data = this->teMessage->property("body");
-    if (data.canConvert<PulsarMessage>())
+    if (_text != "Schema")
     {
-        PulsarMessage message = data.value<PulsarMessage>();
-        if (_text == "Text")
-        {
-            this->teMessage->setText(message.toString());
-        }
-        else if (_text == "Json")
-        {
-            this->teMessage->setText(message.toJson());
-        }
-        else if (_text == "Hex")
+        return;
+    }
+    QModelIndexList indexes;
+    QList<PulsarMessage> messages;
+    this->m_Model->residentMessages(indexes, messages);
+    QModelIndexList undecoded;
+    foreach (const QModelIndex& index, indexes)
+    {
+        if (!index.data(MessageModel::DecodedRole).isValid())
         {
-            this->teMessage->setText(message.toHex());
+            undecoded << index;
         }
     }
+    if (!undecoded.isEmpty())
+    {
+        decodeMessages(undecoded);
+    }
+}
+
+void PeekMessagesWindow::handleCurrentTextChanged(const QString& _text)
+{
+    this->pvMessage->setVisible(_text != "Schema");
+    this->twDecoded->setVisible(_text == "Schema");
+    if (_text == "Text")
+    {
+        this->pvMessage->setMode(PayloadView::Text);
+    }
+    else if (_text == "Json")
+    {
+        this->pvMessage->setMode(PayloadView::Json);
+    }
+    else if (_text == "Hex")
+    {
+        this->pvMessage->setMode(PayloadView::Hex);
+    }
+    else if (_text == "Schema" && this->twMessages->currentIndex().isValid())
+    {
+        this->twDecoded->setValue(this->twMessages->currentIndex().data(MessageModel::DecodedRole));
+    }
 }
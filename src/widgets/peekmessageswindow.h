@@ -2,17 +2,26 @@
 #define PEEKMESSAGESWINDOW_H
 
 #include <QDialog>
+#include <QPointer>
+#include <QModelIndex>
 
 #include "../topic.h"
 #include "../subscription.h"
 
 class QLabel;
-class QTableWidget;
+class QTreeView;
+class PulsarMessage;
 class QTextEdit;
 class QComboBox;
 class QSpinBox;
 class TopicService;
+class SchemaService;
+class VariantTreeWidget;
+class PayloadView;
+class MessageModel;
+class MessageFilterBar;
 class CursorService;
+class ChunkReassembler;
 
 class PeekMessagesWindow : public QDialog
 {
@@ -34,23 +43,35 @@ private:
     int m_Partitions;
 
     TopicService* m_TopicService;
+    MessageModel* m_Model;
+    SchemaService* m_SchemaService;
+    int m_Generation;
     CursorService* m_CursorService;
+    QPointer<ChunkReassembler> m_Reassembler;
 
     QLabel* lblTopicName;
     QLabel* lblBacklog;
-    QTableWidget* twMessages;
+    QTreeView* twMessages;
+    MessageFilterBar* fbMessages;
     QTextEdit* teProperties;
     QTextEdit* teKey;
-    QTextEdit* teMessage;
+    PayloadView* pvMessage;
+    VariantTreeWidget* twDecoded;
     QComboBox* cbSchema;
     QSpinBox* sbNumber;
     QPushButton* btnPeek;
 
+    void decodeMessages(const QModelIndexList& _indexes);
+
 private slots:
     void handleInitialize();
+    void handleMessageAssembled(const PulsarMessage&);
+    void handleMessageIncomplete(const QList<PulsarMessage>&);
+    void handlePageLoaded(const QModelIndexList&);
     void handleValueChanged(int);
     void handleItemSelectionChanged();
     void handleCurrentTextChanged(const QString&);
+    void handleSchemaViewChanged(const QString&);
 
 };
 
@@ -5,20 +5,30 @@
 #include <QLabel>
 #include <QIcon>
 #include <QTextEdit>
+#include <QListWidget>
+#include <QSpinBox>
+#include <QCheckBox>
+#include <QDateTimeEdit>
 #include <QPushButton>
 #include <QMessageBox>
-#include <QTableWidget>
+#include <QTableView>
 #include <QHeaderView>
 #include <QAction>
 #include <QMenu>
 #include <QApplication>
 #include <QClipboard>
+#include <QFileDialog>
+#include <QLocale>
+
+#include <limits>
 
 #include "../services/prestoqueryservice.h"
+#include "../services/queryexporter.h"
 #include "../table.h"
+#include "../queryresultmodel.h"
 #include "../topic.h"
 
-QueryTopicDataWindow::QueryTopicDataWindow(QWidget* parent) : QDialog(parent), twResult(new QTableWidget(this)), meuPopupMenu(new QMenu(this)), m_Query(new PrestoQueryService(this)), m_Statement(new Statement())
+QueryTopicDataWindow::QueryTopicDataWindow(QWidget* parent) : QDialog(parent), twResult(new QTableView(this)), meuPopupMenu(new QMenu(this)), m_Query(new PrestoQueryService(this)), m_Statement(new Statement()), m_Describe(new Statement()), m_Model(new QueryResultModel(&m_Statement->result(), this)), m_FirstRowMillis(-1)
 {
     QVBoxLayout* layout = new QVBoxLayout;
 
@@ -27,25 +37,64 @@ QueryTopicDataWindow::QueryTopicDataWindow(QWidget* parent) : QDialog(parent), t
     this->lblTopicName = new QLabel;
     this->teCondition = new QTextEdit;
     this->teCondition->setFixedHeight(50);
+    this->lwColumns = new QListWidget;
+    this->lwColumns->setFlow(QListView::LeftToRight);
+    this->lwColumns->setWrapping(true);
+    this->lwColumns->setFixedHeight(60);
+    this->lwColumns->setToolTip(tr("The columns to read, all of them when none is checked"));
+    this->sbLimit = new QSpinBox;
+    this->sbLimit->setRange(0, std::numeric_limits<int>::max());
+    this->sbLimit->setSpecialValueText(tr("No limit"));
+    this->ckStartTime = new QCheckBox(tr("Published &from:"));
+    this->dtStartTime = new QDateTimeEdit(QDateTime::currentDateTime().addSecs(-3600));
+    this->dtStartTime->setDisplayFormat("yyyy-MM-dd HH:mm:ss");
+    this->dtStartTime->setCalendarPopup(true);
+    this->dtStartTime->setEnabled(false);
+    this->ckEndTime = new QCheckBox(tr("u&ntil:"));
+    this->dtEndTime = new QDateTimeEdit(QDateTime::currentDateTime());
+    this->dtEndTime->setDisplayFormat("yyyy-MM-dd HH:mm:ss");
+    this->dtEndTime->setCalendarPopup(true);
+    this->dtEndTime->setEnabled(false);
+    QHBoxLayout* rangeLayout = new QHBoxLayout;
+    rangeLayout->setContentsMargins(0, 0, 0, 0);
+    rangeLayout->addWidget(this->ckStartTime);
+    rangeLayout->addWidget(this->dtStartTime);
+    rangeLayout->addSpacing(10);
+    rangeLayout->addWidget(this->ckEndTime);
+    rangeLayout->addWidget(this->dtEndTime);
+    rangeLayout->addStretch();
+    QLabel* lblLimit = new QLabel(tr("&Limit:"));
+    lblLimit->setBuddy(this->sbLimit);
+    rangeLayout->addWidget(lblLimit);
+    rangeLayout->addWidget(this->sbLimit);
+
     formLayout->addRow(tr("&Topic Name:"), this->lblTopicName);
+    formLayout->addRow(tr("Col&umns:"), this->lwColumns);
+    formLayout->addRow(rangeLayout);
     formLayout->addRow(new QLabel("Query Condition:"));
     formLayout->addRow(this->teCondition);
 
-    //this->twResult->setColumnCount(header.length());
-    //this->twResult->setHorizontalHeaderLabels(header);
+    this->twResult->setModel(this->m_Model);
     this->twResult->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
     this->twResult->setSelectionBehavior(QAbstractItemView::SelectRows);
     this->twResult->horizontalHeader()->setStretchLastSection(true);
     this->twResult->setSelectionMode(QAbstractItemView::SingleSelection);
     this->twResult->verticalHeader()->setHidden(true);
-    this->twResult->setEditTriggers(QTableWidget::NoEditTriggers);
+    this->twResult->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    this->twResult->setEditTriggers(QAbstractItemView::NoEditTriggers);
     this->twResult->setFocusPolicy(Qt::NoFocus);
     this->twResult->setContextMenuPolicy(Qt::CustomContextMenu);
+    this->twResult->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
+    this->twResult->setSortingEnabled(true);
     formLayout->addRow(new QLabel("Query Result:"));
     QHBoxLayout* actionsLayout = new QHBoxLayout;
     this->btnStop = new QPushButton(QIcon(":/stop"), tr("&Stop"));
     this->btnStop->setEnabled(false);
     actionsLayout->addWidget(this->btnStop);
+    this->btnExport = new QPushButton(QIcon(":/export"), tr("&Export..."));
+    actionsLayout->addWidget(this->btnExport);
+    this->lblExport = new QLabel;
+    actionsLayout->addWidget(this->lblExport, 1);
     actionsLayout->addStretch();
     formLayout->addRow(actionsLayout);
     formLayout->addRow(this->twResult);
@@ -84,10 +133,13 @@ QueryTopicDataWindow::QueryTopicDataWindow(QWidget* parent) : QDialog(parent), t
     connect(btnCancel, &QPushButton::clicked, this, &QueryTopicDataWindow::close);
     connect(this->btnQuery, &QPushButton::clicked, this, &QueryTopicDataWindow::handleQuery);
     connect(this->btnStop, &QPushButton::clicked, this, &QueryTopicDataWindow::handleCancelQuery);
-    connect(this, &QueryTopicDataWindow::queryNext, this, &QueryTopicDataWindow::handleQueryNext);
-    connect(this, &QueryTopicDataWindow::running, this, &QueryTopicDataWindow::handleRunning);
-    connect(this, &QueryTopicDataWindow::finish, this, &QueryTopicDataWindow::handleFinish);
-    connect(this, &QueryTopicDataWindow::error, this, &QueryTopicDataWindow::handleError);
+    connect(this->btnExport, &QPushButton::clicked, this, &QueryTopicDataWindow::handleExport);
+    connect(this->m_Query->exporter(), &QueryExporter::progress, this, &QueryTopicDataWindow::handleExportProgress);
+    connect(this->m_Query->exporter(), &QueryExporter::finished, this, &QueryTopicDataWindow::handleExportFinished);
+    connect(this->m_Query->poller(), &PrestoPoller::pageRead, this, &QueryTopicDataWindow::handlePageRead);
+    connect(this->m_Query->poller(), &PrestoPoller::finished, this, &QueryTopicDataWindow::handleFinish);
+    connect(this->ckStartTime, &QCheckBox::toggled, this->dtStartTime, &QDateTimeEdit::setEnabled);
+    connect(this->ckEndTime, &QCheckBox::toggled, this->dtEndTime, &QDateTimeEdit::setEnabled);
     connect(this->twResult, SIGNAL(customContextMenuRequested(QPoint)), this, SLOT(handleTableContextMenu(QPoint)));
 
     QIcon copyIcon = QIcon::fromTheme("edit-copy", QIcon(":/images/copy.ico"));
@@ -101,11 +153,19 @@ QueryTopicDataWindow::QueryTopicDataWindow(QWidget* parent) : QDialog(parent), t
 
 QueryTopicDataWindow::~QueryTopicDataWindow()
 {
+    this->m_Query->exporter()->cancel();
     if (m_Statement)
     {
+        this->m_Query->closeQuery(m_Statement);
         delete m_Statement;
         m_Statement = nullptr;
     }
+    if (m_Describe)
+    {
+        this->m_Query->closeQuery(m_Describe);
+        delete m_Describe;
+        m_Describe = nullptr;
+    }
 }
 
 void QueryTopicDataWindow::afterWindowActivated(const QVariant& _var)
@@ -119,6 +179,13 @@ void QueryTopicDataWindow::afterWindowActivated(const QVariant& _var)
         {
             this->m_Query->setAuthToken(topic.authToken());
         }
+        if (topic.getNamespace().tenant().cluster().hasPrestoUrl())
+        {
+            this->lwColumns->clear();
+            this->m_Query->closeQuery(m_Describe);
+            m_Describe->reset();
+            this->m_Query->describe(topic, m_Describe);
+        }
     }
 }
 
@@ -127,11 +194,17 @@ void QueryTopicDataWindow::handleQuery()
     Topic topic = this->m_Variant.value<Topic>();
     if (topic.getNamespace().tenant().cluster().hasPrestoUrl())
     {
+        this->m_Query->closeQuery(m_Statement);
+        this->m_Model->reset();
+        this->twResult->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
         m_Statement->reset();
+        m_Statement->setMaxRows(this->m_Query->maxRows());
+        this->m_FirstRowMillis = -1;
+        this->m_Elapsed.start();
         this->btnQuery->setEnabled(false);
-        m_Statement->setCondition(this->teCondition->toPlainText());
+        buildQuery(m_Statement);
+        this->btnStop->setEnabled(true);
         this->m_Query->query(topic, m_Statement);
-        emit queryNext();
     }
     else
     {
@@ -139,71 +212,168 @@ void QueryTopicDataWindow::handleQuery()
     }
 }
 
-void QueryTopicDataWindow::handleQueryNext()
+/**
+ * @brief Set the columns, range, limit and condition chosen in the dialog on a statement.
+ */
+void QueryTopicDataWindow::buildQuery(Statement* _statement) const
 {
-    this->m_Query->queryNext(m_Statement);
-    QueryState state = m_Statement->state();
-    QString status("Query %1, %2, %3ms [%4 rows, %5B]");
-    status = status.arg(m_Statement->id(), state.state()).arg(state.elapsedTimeMillis()).arg(state.processedRows()).arg(state.processedBytes());
-    this->lblStatus->setText(status);
-    if (state.state() == QString("QUEUED") || state.state() == QString("PLANNING"))
+    _statement->setCondition(this->teCondition->toPlainText());
+    QStringList projection;
+    for (int i = 0, n = this->lwColumns->count(); i < n; ++i)
     {
-        emit queryNext();
+        if (this->lwColumns->item(i)->checkState() == Qt::Checked)
+        {
+            projection << this->lwColumns->item(i)->text();
+        }
     }
-    else if (state.state() == QString("RUNNING"))
+    _statement->setProjection(projection);
+    _statement->setLimit(this->sbLimit->value());
+    _statement->setPublishedFrom(this->ckStartTime->isChecked() ? this->dtStartTime->dateTime() : QDateTime());
+    _statement->setPublishedUntil(this->ckEndTime->isChecked() ? this->dtEndTime->dateTime() : QDateTime());
+}
+
+/**
+ * @brief Export the query built in the dialog to a file, or cancel the export running.
+ */
+void QueryTopicDataWindow::handleExport()
+{
+    QueryExporter* exporter = this->m_Query->exporter();
+    if (exporter->isRunning())
     {
-        emit running();
+        exporter->cancel();
+        return;
     }
-    else if (state.state() == QString("FINISHED") || state.state() == QString("CANCELED"))
+    Topic topic = this->m_Variant.value<Topic>();
+    if (!topic.getNamespace().tenant().cluster().hasPrestoUrl())
     {
-        emit finish();
+        QMessageBox::warning(this, "Warning", "Presto Service has not allowed.");
+        return;
     }
-    else if (state.state() == QString("FAILED"))
+    QString csv = tr("CSV (*.csv)");
+    QString ndjson = tr("NDJSON (*.ndjson *.jsonl)");
+    QString arrow = tr("Arrow IPC stream (*.arrows)");
+    QString filter;
+    QString fileName = QFileDialog::getSaveFileName(this, tr("Export Query Result"), QString("%1.csv").arg(topic.name()), QStringList({csv, ndjson, arrow}).join(";;"), &filter);
+    if (fileName.isEmpty())
     {
-        emit error();
+        return;
     }
+    QueryExporter::Format format = filter == ndjson ? QueryExporter::Ndjson : (filter == arrow ? QueryExporter::ArrowStream : QueryExporter::Csv);
+
+    Statement query;
+    buildQuery(&query);
+    this->btnExport->setText(tr("Cancel &Export"));
+    this->lblExport->setText(tr("Exporting to %1").arg(fileName));
+    exporter->start(topic, query, format, fileName);
 }
 
-void QueryTopicDataWindow::handleRunning()
+void QueryTopicDataWindow::handleExportProgress(qint64 _rows, qint64 _bytes, qint64 _millis)
 {
-    this->btnStop->setEnabled(true);
-    emit queryNext();
+    QLocale locale;
+    double seconds = qMax<qint64>(_millis, 1) / 1000.0;
+    this->lblExport->setText(tr("%1 rows, %2 written, %3 rows/s, %4/s").arg(locale.toString(_rows), locale.formattedDataSize(_bytes), locale.toString(qRound64(_rows / seconds)), locale.formattedDataSize(qRound64(_bytes / seconds))));
 }
 
-void QueryTopicDataWindow::handleFinish()
+void QueryTopicDataWindow::handleExportFinished(const QString& _error, qint64 _rows, qint64 _bytes, qint64 _millis)
 {
-    QList<Column> columns = m_Statement->columns();
-    QStringList header;
-    foreach (const Column& column, columns)
+    this->btnExport->setText(tr("&Export..."));
+    if (_error.isEmpty())
     {
-        header << column.name();
+        QLocale locale;
+        this->lblExport->setText(tr("%1 rows, %2 exported in %3s").arg(locale.toString(_rows), locale.formattedDataSize(_bytes), locale.toString(_millis / 1000.0, 'f', 1)));
     }
-    this->twResult->setColumnCount(header.length());
-    this->twResult->setHorizontalHeaderLabels(header);
-    this->twResult->clearContents();
-    QStringList rows = m_Statement->result();
-    this->twResult->setRowCount(rows.length());
-    for (int i = 0, n = rows.size(); i < n; ++i)
+    else
     {
-        QStringList data = rows[i].split("\t");
-        for (int j = 0, m = data.size(); j < m; ++j)
-        {
-            QTableWidgetItem* item = new QTableWidgetItem(data[j]);
-            this->twResult->setItem(i, j, item);
-            item->setData(Qt::ToolTipRole, QVariant::fromValue(item->text()));
-        }
+        this->lblExport->setText(_error);
     }
-    this->btnStop->setEnabled(false);
-    this->btnQuery->setEnabled(true);
+}
+
+/**
+ * @brief Show the rows of a page right away, the poller reads the next one on its own.
+ */
+void QueryTopicDataWindow::handlePageRead(Statement* _statement)
+{
+    if (_statement == m_Statement)
+    {
+        updateStatus(appendPage());
+    }
+}
+
+/**
+ * @brief Show the rows the statement has stored from the page read.
+ * @return whether the row cap is reached
+ */
+bool QueryTopicDataWindow::appendPage()
+{
+    if (this->m_Model->columnCount() == 0 && !m_Statement->columns().isEmpty())
+    {
+        this->m_Model->setColumns(m_Statement->columns());
+    }
+    if (m_Statement->result().rowCount() > 0 && this->m_FirstRowMillis < 0)
+    {
+        this->m_FirstRowMillis = this->m_Elapsed.elapsed();
+    }
+    this->m_Model->update();
+    return m_Statement->isFull();
+}
 
+void QueryTopicDataWindow::updateStatus(const bool& _capped)
+{
+    QueryState state = m_Statement->state();
+    QString status("Query %1, %2, %3ms [%4 rows, %5B], %6 rows shown in %7");
+    status = status.arg(m_Statement->id(), state.state()).arg(state.elapsedTimeMillis()).arg(state.processedRows()).arg(state.processedBytes()).arg(this->m_Model->rowCount());
+    status = status.arg(QLocale().formattedDataSize(m_Statement->result().bytes()));
+    if (this->m_FirstRowMillis >= 0)
+    {
+        status.append(QString(", first row in %1ms").arg(this->m_FirstRowMillis));
+    }
+    if (_capped)
+    {
+        status.append(QString(", stopped at the limit of %1 rows").arg(m_Statement->maxRows()));
+    }
+    this->lblStatus->setText(status);
 }
 
-void QueryTopicDataWindow::handleError()
+void QueryTopicDataWindow::handleFinish(Statement* _statement)
 {
-    QMessageBox::critical(this, tr("Error"), m_Statement->error());
+    if (_statement == m_Describe)
+    {
+        updateColumns();
+        return;
+    }
+    if (_statement != m_Statement)
+    {
+        return;
+    }
+    updateStatus(appendPage());
     this->btnStop->setEnabled(false);
     this->btnQuery->setEnabled(true);
-    m_Statement->setError(QString());
+    if (!m_Statement->error().isEmpty())
+    {
+        QMessageBox::critical(this, tr("Error"), m_Statement->error());
+        m_Statement->setError(QString());
+    }
+}
+
+/**
+ * @brief List the columns of the topic table to pick from, the first column of SHOW COLUMNS is
+ * the name and the second the type.
+ */
+void QueryTopicDataWindow::updateColumns()
+{
+    const QueryResult& result = m_Describe->result();
+    if (!m_Describe->error().isEmpty() || result.columnCount() < 2)
+    {
+        this->lwColumns->setToolTip(tr("The columns cannot be listed: %1").arg(m_Describe->error()));
+        return;
+    }
+    for (qsizetype i = 0, n = result.rowCount(); i < n; ++i)
+    {
+        QListWidgetItem* item = new QListWidgetItem(result.text(i, 0), this->lwColumns);
+        item->setFlags(Qt::ItemIsEnabled | Qt::ItemIsUserCheckable);
+        item->setCheckState(Qt::Unchecked);
+        item->setToolTip(result.text(i, 1));
+    }
 }
 
 void QueryTopicDataWindow::handleCancelQuery()
@@ -219,28 +389,20 @@ void QueryTopicDataWindow::handleTableContextMenu(const QPoint&)
 
 void QueryTopicDataWindow::handleCopyRowText(bool)
 {
-    QTableWidgetItem* item = this->twResult->currentItem();
-    if (item && item->isSelected())
+    QModelIndex current = this->twResult->currentIndex();
+    if (current.isValid())
     {
-        QString text;
-        int row = item->row();
-        int columns = this->twResult->columnCount();
-        for (int i = 0, n = columns; i < n; ++i)
-        {
-            QTableWidgetItem* cell = this->twResult->item(row, i);
-            text.append(cell->text()).append('\t');
-        }
         QClipboard* board = QApplication::clipboard();
-        board->setText(text);
+        board->setText(this->m_Model->rowText(current.row()));
     }
 }
 
 void QueryTopicDataWindow::handleCopyCellText(bool)
 {
-    QTableWidgetItem* item = this->twResult->currentItem();
-    if (item && item->isSelected())
+    QModelIndex current = this->twResult->currentIndex();
+    if (current.isValid())
     {
         QClipboard* board = QApplication::clipboard();
-        board->setText(item->text());
+        board->setText(current.data().toString());
     }
 }
@@ -3,10 +3,16 @@
 
 #include <QDialog>
 #include <QVariant>
+#include <QElapsedTimer>
 
 class QLabel;
 class QTextEdit;
-class QTableWidget;
+class QListWidget;
+class QSpinBox;
+class QCheckBox;
+class QDateTimeEdit;
+class QTableView;
+class QueryResultModel;
 class PrestoQueryService;
 class Statement;
 class QMenu;
@@ -19,22 +25,24 @@ public:
     explicit QueryTopicDataWindow(QWidget* parent = nullptr);
     virtual ~QueryTopicDataWindow();
 
-signals:
-    void queryNext();
-    void running();
-    void finish();
-    void error();
-
 public slots:
     void afterWindowActivated(const QVariant&);
 
 private:
     QPushButton* btnQuery;
     QPushButton* btnStop;
+    QPushButton* btnExport;
+    QLabel* lblExport;
     QLabel* lblTopicName;
     QLabel* lblStatus;
     QTextEdit* teCondition;
-    QTableWidget* twResult;
+    QListWidget* lwColumns;
+    QSpinBox* sbLimit;
+    QCheckBox* ckStartTime;
+    QDateTimeEdit* dtStartTime;
+    QCheckBox* ckEndTime;
+    QDateTimeEdit* dtEndTime;
+    QTableView* twResult;
     QAction* actCopyCellText;
     QAction* actCopyRowText;
     QMenu* meuPopupMenu;
@@ -42,14 +50,24 @@ private:
 
     PrestoQueryService* m_Query;
     Statement* m_Statement;
+    Statement* m_Describe;
+    QueryResultModel* m_Model;
+    QElapsedTimer m_Elapsed;
+    qint64 m_FirstRowMillis;
+
+    bool appendPage();
+    void updateStatus(const bool& _capped);
+    void updateColumns();
+    void buildQuery(Statement* _statement) const;
 
 private slots:
     void handleQuery();
-    void handleQueryNext();
-    void handleRunning();
-    void handleFinish();
-    void handleError();
+    void handlePageRead(Statement* _statement);
+    void handleFinish(Statement* _statement);
     void handleCancelQuery();
+    void handleExport();
+    void handleExportProgress(qint64 _rows, qint64 _bytes, qint64 _millis);
+    void handleExportFinished(const QString& _error, qint64 _rows, qint64 _bytes, qint64 _millis);
     void handleTableContextMenu(const QPoint& pos);
     void handleCopyRowText(bool);
     void handleCopyCellText(bool);
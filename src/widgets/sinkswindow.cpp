@@ -65,7 +65,7 @@ void SinksWindow::createActions()
     this->actRefresh->setStatusTip(tr("Refresh Sinks."));
 
     connect(this->actNew, &QAction::triggered, this, &SinksWindow::handleNewSink);
-    connect(this->actRefresh, &QAction::triggered, this, &SinksWindow::handleReload);
+    connect(this->actRefresh, &QAction::triggered, this, &SinksWindow::handleRefresh);
 
     this->actUpdate->setText(tr("&Update Sink..."));
     this->actUpdate->setStatusTip(tr("Updates a Pulsar Sink currently running in cluster mode."));
@@ -108,6 +108,14 @@ void SinksWindow::handleUpdateSink(bool)
     }
 }
 
+void SinksWindow::handleRefresh(bool)
+{
+    //An explicit refresh bypasses the response cache
+    this->m_SinkService->setCacheMode(HttpRequest::RefreshCache);
+    handleReload();
+    this->m_SinkService->setCacheMode(HttpRequest::PreferCache);
+}
+
 void SinksWindow::handleReload()
 {
     emit start();
@@ -39,6 +39,7 @@ private slots:
     void handleNewSink(bool);
     void handleUpdateSink(bool);
     void handleReload();
+    void handleRefresh(bool);
     void handleInsertNewSink(const QVariant&);
     void handleSinkInstances(bool);
     void handleTableItemDoubleClicked(QTableWidgetItem*);
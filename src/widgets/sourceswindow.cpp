@@ -48,6 +48,14 @@ void SourcesWindow::afterWindowActivated(const QVariant& _var)
     emit initialize();
 }
 
+void SourcesWindow::handleRefresh(bool)
+{
+    //An explicit refresh bypasses the response cache
+    this->m_SourceService->setCacheMode(HttpRequest::RefreshCache);
+    handleReload();
+    this->m_SourceService->setCacheMode(HttpRequest::PreferCache);
+}
+
 void SourcesWindow::handleReload()
 {
     emit start();
@@ -180,7 +188,7 @@ void SourcesWindow::createActions()
     this->actRefresh->setStatusTip(tr("Refresh Sources."));
 
     connect(this->actNew, &QAction::triggered, this, &SourcesWindow::handleNewSource);
-    connect(this->actRefresh, &QAction::triggered, this, &SourcesWindow::handleReload);
+    connect(this->actRefresh, &QAction::triggered, this, &SourcesWindow::handleRefresh);
 
     //popup menu actions
     this->actUpdate->setText(tr("&Update Source..."));
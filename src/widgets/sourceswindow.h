@@ -32,6 +32,7 @@ protected:
 
 private slots:
     void handleReload();
+    void handleRefresh(bool);
     void handleNewSource(bool);
     void handleUpdateSource(bool);
     void handleSourceInstances();
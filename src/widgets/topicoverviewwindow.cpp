@@ -163,10 +163,18 @@ void TopicOverviewWindow::handleInitialize()
         int partitions = topic.stats().partitions();
         if (partitions > 0)
         {
+            //Every partition is fetched at once, switching partitions is served from m_Stats
+            this->m_Stats = this->m_TopicService->partitionedStats(topic);
+            int current = qMax(this->cbPartitions->currentIndex(), 0);
+            this->cbPartitions->blockSignals(true);
+            this->cbPartitions->clear();
             for (int i = 0, n = partitions; i < n; i++)
             {
                 this->cbPartitions->addItem(QString::number(i));
             }
+            this->cbPartitions->setCurrentIndex(qMin(current, partitions - 1));
+            this->cbPartitions->blockSignals(false);
+            handleCurrentIndexChanged(this->cbPartitions->currentText());
         }
         else
         {
@@ -187,8 +195,9 @@ void TopicOverviewWindow::handleCurrentIndexChanged(const QString&)
 
 void TopicOverviewWindow::handleLoad(const Topic& _topic, const int& _partitions)
 {
-    TopicStats stats = this->m_TopicService->overview(_topic, _partitions);
+    TopicStats stats = this->m_Stats.hasPartition(_partitions) ? this->m_Stats.partition(_partitions) : this->m_TopicService->overview(_topic, _partitions);
     this->twProducers->clearContents();
+    this->twProducers->setRowCount(0);
     QList<Producer> producers = stats.publishers();
     if (producers.length() > 0)
     {
@@ -210,6 +219,7 @@ void TopicOverviewWindow::handleLoad(const Topic& _topic, const int& _partitions
     }
 
     this->twSubscriptions->clearContents();
+    this->twSubscriptions->setRowCount(0);
     QList<Subscription> subscriptions = stats.subscriptions();
     if (subscriptions.length() > 0)
     {
@@ -360,8 +370,7 @@ void TopicOverviewWindow::handleDeleteSubscription(bool)
             this->m_TopicService->deleteSubscription(topic, sub.name(), error);
             if (error.code == HttpStatusCode::StatusCode::NoContent)
             {
-                int partitions = this->cbPartitions->currentText().isEmpty() ? -1 : this->cbPartitions->currentText().toInt();
-                emit load(topic, partitions);
+                handleInitialize();
             }
             else
             {
@@ -4,13 +4,13 @@
 #include <QDialog>
 #include <QVariant>
 
+#include "../topic.h"
+
 class TopicService;
 class QTableWidget;
 class QComboBox;
 class QLabel;
-class Topic;
 class QTableWidgetItem;
-class Subscription;
 class QMenu;
 class Cursors;
 
@@ -34,6 +34,7 @@ public slots:
 private:
     QVariant m_Variant;
     TopicService* m_TopicService;
+    PartitionedTopicStats m_Stats;
 
     QComboBox* cbPartitions;
     QLabel* lblTopicName;
@@ -17,8 +17,9 @@
 #include "../widgets/lastcommitmessagewindow.h"
 #include "../widgets/querytopicdatawindow.h"
 #include "../widgets/sendmessagewindow.h"
+#include "../widgets/exportmessageswindow.h"
 
-TopicsWindow::TopicsWindow(QWidget* _parent) : BaseMdiSubWindow(_parent), m_TopicService(new TopicService(this))
+TopicsWindow::TopicsWindow(QWidget* _parent) : BaseMdiSubWindow(_parent), m_TopicService(new TopicService(this)), m_Loading(false)
 {
     this->actNew = new QAction(QIcon(":/addnew"), tr("&New Topic"), this);
     this->actNew->setStatusTip(tr("Create a new topic."));
@@ -51,6 +52,9 @@ TopicsWindow::TopicsWindow(QWidget* _parent) : BaseMdiSubWindow(_parent), m_Topi
     this->actSendMessage = new QAction(QIcon(":/publish"), tr("&Send Message..."), this);
     this->actSendMessage->setStatusTip(tr("Send message by its topic."));
 
+    this->actExportMessages = new QAction(QIcon(":/export"), tr("&Export Messages..."), this);
+    this->actExportMessages->setStatusTip(tr("Export a range of the topic messages to a file."));
+
     this->tbToolbar->addAction(this->actNew);
     this->tbToolbar->addAction(this->actDelete);
     this->tbToolbar->addAction(this->actRefresh);
@@ -59,18 +63,20 @@ TopicsWindow::TopicsWindow(QWidget* _parent) : BaseMdiSubWindow(_parent), m_Topi
     this->tbToolbar->addAction(this->actQueryData);
     this->tbToolbar->addAction(this->actStorage);
     this->tbToolbar->addAction(this->actSendMessage);
+    this->tbToolbar->addAction(this->actExportMessages);
     this->tbToolbar->addSeparator();
     this->tbToolbar->addAction(this->actClose);
 
     connect(this->actNew, &QAction::triggered, this, &TopicsWindow::handleNewTopic);
     connect(this->actDelete, &QAction::triggered, this, &TopicsWindow::handleDeleteTopic);
     connect(this->actCopy, &QAction::triggered, this, &TopicsWindow::handleCopyCellText);
-    connect(this->actRefresh, &QAction::triggered, this, &TopicsWindow::handleReload);
+    connect(this->actRefresh, &QAction::triggered, this, &TopicsWindow::handleRefresh);
     connect(this->actLastMessage, &QAction::triggered, this, &TopicsWindow::handleLastCommitMessageWindow);
     connect(this->actQueryData, &QAction::triggered, this, &TopicsWindow::handleQueryTopicDataWindow);
     connect(this->actStorage, &QAction::triggered, this, &TopicsWindow::handleTopicStorageWindow);
     connect(this->actOverview, &QAction::triggered, this, &TopicsWindow::handleTopicOverviewWindow);
     connect(this->actSendMessage, &QAction::triggered, this, &TopicsWindow::handleSendMessageWindow);
+    connect(this->actExportMessages, &QAction::triggered, this, &TopicsWindow::handleExportMessagesWindow);
 
     QStringList header;
     header << tr("Tenant") << tr("Namesapce") << tr("Topic") << tr("Partitions") << tr("Domian") << tr("Producers") << tr("Subscriptions");
@@ -85,6 +91,8 @@ TopicsWindow::TopicsWindow(QWidget* _parent) : BaseMdiSubWindow(_parent), m_Topi
     connect(this->twTable, &QTableWidget::itemPressed, this, &TopicsWindow::handleTableItemPressed);
     connect(this->twTable, &QTableWidget::itemDoubleClicked, this, &TopicsWindow::handleTableItemDoubleClicked);
     connect(this, &TopicsWindow::initialize, this, &TopicsWindow::handleReload);
+    connect(this->m_TopicService, &TopicService::topicLoaded, this, &TopicsWindow::handleTopicLoaded);
+    connect(this->m_TopicService, &TopicService::topicsLoaded, this, &TopicsWindow::handleTopicsLoaded);
     connect(this->actClose, &QAction::triggered, this, &TopicsWindow::close);
 }
 
@@ -138,27 +146,58 @@ bool TopicsWindow::existTopic(const Topic& _topic)
 
 void TopicsWindow::handleReload()
 {
-    emit start();
+    load(false);
+}
+
+void TopicsWindow::handleRefresh(bool)
+{
+    //An explicit refresh bypasses the response cache
+    load(true);
+}
+
+void TopicsWindow::load(const bool& _refresh)
+{
+    if (!this->m_Loading)
+    {
+        this->m_Loading = true;
+        emit start();
+    }
     Namespace ns = value<Namespace>();
+    this->twTable->clearContents();
+    this->twTable->setRowCount(0);
+    //Rows are appended by handleTopicLoaded as the requests complete
+    this->m_TopicService->loadTopics(ns, _refresh);
+}
+
+void TopicsWindow::handleTopicLoaded(const Topic& _topic)
+{
+    appendTopic(_topic);
+}
+
+void TopicsWindow::handleTopicsLoaded()
+{
+    if (this->m_Loading)
+    {
+        this->m_Loading = false;
+        emit stop();
+    }
+}
+
+void TopicsWindow::appendTopic(const Topic& _topic)
+{
     QStringList columns;
     columns << "tenant" << "namesapces" << "name"  << "partitions" << "domain" << "producerNum" << "subscriptionNum";
-    this->twTable->clearContents();
-    QList<Topic> topics = this->m_TopicService->topics(ns);
-    this->twTable->setRowCount(topics.length());
-    for (int i = 0, n = topics.length(); i < n; i++)
+    int row = this->twTable->rowCount();
+    this->twTable->setRowCount(row + 1);
+    TopicData data = _topic.toData();
+    for (int i = 0, n = columns.length(); i < n; i++)
     {
-        TopicData data = topics[i].toData();
-        for (int j = 0, m = columns.length(); j < m; j++)
-        {
-            QTableWidgetItem* item = new QTableWidgetItem(data[columns[j]]);
-            item->setData(Qt::ToolTipRole, QVariant::fromValue(item->text()));
-            this->twTable->setItem(i, j, item);
-            if (j == 0)
-                item->setData(Qt::UserRole, QVariant::fromValue(topics[i]));
-        }
+        QTableWidgetItem* item = new QTableWidgetItem(data[columns[i]]);
+        item->setData(Qt::ToolTipRole, QVariant::fromValue(item->text()));
+        this->twTable->setItem(row, i, item);
+        if (i == 0)
+            item->setData(Qt::UserRole, QVariant::fromValue(_topic));
     }
-    this->twTable->repaint();
-    emit stop();
 }
 
 void TopicsWindow::handleNewTopic(bool)
@@ -275,6 +314,29 @@ void TopicsWindow::handleSendMessageWindow(bool)
     }
 }
 
+void TopicsWindow::handleExportMessagesWindow(bool)
+{
+    QTableWidgetItem* current = this->twTable->currentItem();
+    if (current && current->isSelected())
+    {
+        int row = current->row();
+        QTableWidgetItem* item = this->twTable->item(row, 0);
+        QVariant data = item->data(Qt::UserRole);
+        if (data.canConvert<Topic>())
+        {
+            Topic topic = data.value<Topic>();
+            ExportMessagesWindow* win = new ExportMessagesWindow;
+            connect(this, &TopicsWindow::activateExportMessagesWindow, win, &ExportMessagesWindow::afterWindowActivated);
+            emit activateExportMessagesWindow(QVariant::fromValue(topic));
+            win->exec();
+        }
+    }
+    else
+    {
+        QMessageBox::warning(this, "Warning", "A row of records must be selected at first.");
+    }
+}
+
 void TopicsWindow::handleDeleteTopic(bool)
 {
     QTableWidgetItem* current = this->twTable->currentItem();
@@ -315,19 +377,7 @@ void TopicsWindow::handleInsertTableItem(const QVariant& _var)
         Topic topic = _var.value<Topic>();
         if (!existTopic(topic))
         {
-            QStringList columns;
-            columns << "tenant" << "namesapces" << "name"  << "partitions" << "domain" << "producerNum" << "subscriptionNum";
-            int row = this->twTable->rowCount();
-            this->twTable->setRowCount(++row);
-            TopicData data = topic.toData();
-            for (int i = 0, n = columns.length(); i < n; i++)
-            {
-                QTableWidgetItem* item = new QTableWidgetItem(data[columns[i]]);
-                item->setData(Qt::ToolTipRole, QVariant::fromValue(item->text()));
-                this->twTable->setItem(row - 1, i, item);
-                if (i == 0)
-                    item->setData(Qt::UserRole, QVariant::fromValue(topic));
-            }
+            appendTopic(topic);
             this->twTable->repaint();
         }
     }
@@ -352,6 +402,7 @@ void TopicsWindow::handleTableItemPressed(QTableWidgetItem* _item)
             popup->addAction(this->actQueryData);
             popup->addAction(this->actStorage);
             popup->addAction(this->actSendMessage);
+            popup->addAction(this->actExportMessages);
             popup->addSeparator();
             popup->addAction(this->actCopy);
             popup->exec(QCursor::pos());
@@ -27,13 +27,17 @@ signals:
     void activateQueryTopicDataWindow(const QVariant&);
     void activateTopicOverviewWindow(const QVariant&);
     void activateSendMessageWindow(const QVariant&);
+    void activateExportMessagesWindow(const QVariant&);
 
 private:
     bool existTopic(const Topic&);
+    void appendTopic(const Topic&);
+    void load(const bool& _refresh);
 
 private:
     TopicService* m_TopicService;
     QStringList m_Columns;
+    bool m_Loading;
 
     QAction* actLastMessage;
     QAction* actQueryData;
@@ -41,9 +45,13 @@ private:
     QAction* actStorage;
     QAction* actOverview;
     QAction* actSendMessage;
+    QAction* actExportMessages;
 
 private slots:
     void handleReload();
+    void handleRefresh(bool);
+    void handleTopicLoaded(const Topic&);
+    void handleTopicsLoaded();
     void handleNewTopic(bool);
     void handleDeleteTopic(bool);
     void handleInsertTableItem(const QVariant&);
@@ -54,6 +62,7 @@ private slots:
     void handleQueryTopicDataWindow(bool);
     void handleTopicOverviewWindow(bool);
     void handleSendMessageWindow(bool);
+    void handleExportMessagesWindow(bool);
 
 };
 
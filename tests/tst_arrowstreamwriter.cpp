@@ -0,0 +1,155 @@
+#include <QtTest>
+#include <QBuffer>
+#include <QJsonDocument>
+#include <QtEndian>
+
+#include "../src/arrowstreamwriter.h"
+#include "../src/table.h"
+
+namespace
+{
+/**
+ * @brief A page of the columns id bigint, price double, ok boolean and name varchar, from the data
+ * array of a Presto response.
+ */
+QueryResult page(QList<Column>& _columns, const QByteArray& _rows)
+{
+    const char* names[] = { "id", "price", "ok", "name" };
+    const char* types[] = { "bigint", "double", "boolean", "varchar" };
+    _columns.clear();
+    for (int i = 0; i < 4; ++i)
+    {
+        Column column;
+        column.setName(names[i]);
+        column.setType(types[i]);
+        _columns << column;
+    }
+    QueryResult result;
+    result.setColumns(_columns);
+    result.append(QJsonDocument::fromJson(_rows).array());
+    return result;
+}
+
+/**
+ * @brief The schema and the batch of a page written as a stream.
+ */
+QByteArray stream(const QList<Column>& _columns, const QueryResult& _page)
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    ArrowStreamWriter writer(&buffer);
+    if (!writer.writeSchema(_columns) || !writer.writeBatch(_page) || !writer.writeEnd() || writer.bytes() != buffer.data().size())
+    {
+        return QByteArray();
+    }
+    return buffer.data();
+}
+
+/**
+ * @brief The body of the record batch of a stream of a schema, one batch and the end marker,
+ * empty if the framing of the messages is wrong.
+ */
+QByteArray batchBody(const QByteArray& _stream)
+{
+    qsizetype at = 0;
+    for (int message = 0; message < 2; ++message)
+    {
+        if (at + 8 > _stream.size() || qFromLittleEndian<quint32>(_stream.constData() + at) != 0xFFFFFFFF)
+        {
+            return QByteArray();
+        }
+        qint32 length = qFromLittleEndian<qint32>(_stream.constData() + at + 4);
+        if (length <= 0 || length % 8 != 0)
+        {
+            return QByteArray();
+        }
+        at += 8 + length;
+    }
+    if (_stream.size() < at + 8 || _stream.right(8) != QByteArray::fromHex("ffffffff00000000"))
+    {
+        return QByteArray();
+    }
+    return _stream.mid(at, _stream.size() - at - 8);
+}
+
+const QByteArray NULL_ROWS = "[[1, 1.5, true, \"alpha\"], [null, null, null, null], [-3, -0.25, false, \"\"], [1000000, 1e10, true, \"\xc3\xbcn\xc3\xaf" "code\"]]";
+}
+
+/**
+ * @brief The Arrow stream of a query export, against the buffers pyarrow lays out for the same table.
+ */
+class TestArrowStreamWriter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void recordBatchBody_data();
+    void recordBatchBody();
+    void wholeStream();
+};
+
+/**
+ * @brief The bodies are those of pa.ipc.new_stream() for the same columns and values, from
+ * pa.ipc.MessageReader. The Arrow format fixes their layout, buffer by buffer.
+ */
+void TestArrowStreamWriter::recordBatchBody_data()
+{
+    QTest::addColumn<QByteArray>("rows");
+    QTest::addColumn<QByteArray>("body");
+
+    QTest::newRow("nulls and an empty string") << NULL_ROWS << QByteArray::fromHex(
+        "0d0000000000000001000000000000000000000000000000fdffffffffffffff40420f00000000000d0000000000000000"
+        "0000000000f83f0000000000000000000000000000d0bf000000205fa002420d0000000000000009000000000000000d00"
+        "000000000000000000000500000005000000050000000e00000000000000616c706861c3bc6ec3af636f64650000");
+    //no validity buffer when a column has no null, the infinity as the string Presto sends
+    QTest::newRow("no nulls") << QByteArray("[[7, 0.1, false, \"x,y\"], [-9, \"Infinity\", true, \"\\\"q\\\"\"]]") << QByteArray::fromHex(
+        "0700000000000000f7ffffffffffffff9a9999999999b93f000000000000f07f0200000000000000000000000300000006"
+        "00000000000000782c792271220000");
+}
+
+void TestArrowStreamWriter::recordBatchBody()
+{
+    QFETCH(QByteArray, rows);
+    QFETCH(QByteArray, body);
+
+    QList<Column> columns;
+    QueryResult result = page(columns, rows);
+    QCOMPARE(batchBody(stream(columns, result)), body);
+}
+
+/**
+ * @brief pyarrow lays out its flatbuffers in another order, so the metadata of this writer is
+ * pinned here: pa.ipc.open_stream() reads these bytes back to the table of NULL_ROWS.
+ */
+void TestArrowStreamWriter::wholeStream()
+{
+    QList<Column> columns;
+    QueryResult result = page(columns, NULL_ROWS);
+    QCOMPARE(stream(columns, result), QByteArray::fromHex(
+        "ffffffff58010000100000000c00170014001600100008000c0000000000000000000000000000001000000004000100"
+        "08000800000004000800000004000000040000002400000068000000ac000000e0000000100012000400100011000800"
+        "00000c000000000014000000100000002000000028000000010200000200000069640000080009000400080000000000"
+        "0c00000040000000010000000000000010001200040010001100080000000c0010000000100000002000000024000000"
+        "0103000005000000707269636500060006000400000000000a0000000200000000000000100012000400100011000800"
+        "00000c00000000001400000010000000180000001800000001060000020000006f6b0000040004000400000000000000"
+        "10001200040010001100080000000c001000000010000000200000002000000001050000040000006e616d6500000400"
+        "04000000000000000a00000000000000ffffffff30010000100000000c00170014001600100008000c00000000000000"
+        "900000000000000018000000040003000a00180008001000140000000000000010000000000000000400000000000000"
+        "0c0000005000000000000000040000000400000000000000010000000000000004000000000000000100000000000000"
+        "040000000000000001000000000000000400000000000000010000000000000000000000090000000000000000000000"
+        "010000000000000008000000000000002000000000000000280000000000000001000000000000003000000000000000"
+        "200000000000000050000000000000000100000000000000580000000000000001000000000000006000000000000000"
+        "01000000000000006800000000000000140000000000000080000000000000000e000000000000000d00000000000000"
+        "01000000000000000000000000000000fdffffffffffffff40420f00000000000d00000000000000000000000000f83f"
+        "0000000000000000000000000000d0bf000000205fa002420d0000000000000009000000000000000d00000000000000"
+        "000000000500000005000000050000000e00000000000000616c706861c3bc6ec3af636f64650000ffffffff00000000"));
+
+    QCOMPARE(result.rowCount(), qsizetype(4));
+    QVERIFY(result.isNull(1, 0) && result.isNull(1, 3));
+    QVERIFY(!result.isNull(2, 3));
+    QCOMPARE(result.text(2, 3), QString(""));
+}
+
+QTEST_APPLESS_MAIN(TestArrowStreamWriter)
+
+#include "tst_arrowstreamwriter.moc"
@@ -0,0 +1,185 @@
+#include <QtTest>
+
+#include "../src/services/chunkreassembler.h"
+
+namespace
+{
+/**
+ * @brief Chunk _chunkId of the message _uuid, split in _numChunks chunks of _body each, read from
+ * entry _entryId of ledger 7.
+ */
+PulsarMessage chunk(const QString& _uuid, const int& _chunkId, const int& _numChunks, const QByteArray& _body, const int& _entryId, const int& _totalChunkSize = -1)
+{
+    PulsarMessage message = PulsarMessage::fromPayload(_body);
+    message.setChunk(_uuid, _chunkId, _numChunks, _totalChunkSize < 0 ? static_cast<int>(_body.size()) * _numChunks : _totalChunkSize);
+    message.setLedgerId(7);
+    message.setEntryId(_entryId);
+    return message;
+}
+}
+
+/**
+ * @brief Reassembly of chunked messages as the pages of a browser bring them in, without a
+ * broker: the scan for missing chunks is given no entry to read.
+ */
+class TestChunkReassembler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void outOfOrder();
+    void duplicateChunk();
+    void missingChunk();
+    void eviction();
+    void malformed_data();
+    void malformed();
+
+private:
+    void listen(ChunkReassembler& _reassembler);
+
+    QList<PulsarMessage> m_Assembled;
+    QList<QList<PulsarMessage>> m_Incomplete;
+};
+
+void TestChunkReassembler::init()
+{
+    this->m_Assembled.clear();
+    this->m_Incomplete.clear();
+}
+
+void TestChunkReassembler::listen(ChunkReassembler& _reassembler)
+{
+    connect(&_reassembler, &ChunkReassembler::messageAssembled, this, [this](const PulsarMessage& _message) { this->m_Assembled << _message; });
+    connect(&_reassembler, &ChunkReassembler::messageIncomplete, this, [this](const QList<PulsarMessage>& _chunks) { this->m_Incomplete << _chunks; });
+}
+
+void TestChunkReassembler::outOfOrder()
+{
+    ChunkReassembler reassembler(nullptr, QString(), QString());
+    listen(reassembler);
+
+    QVERIFY(reassembler.add(chunk("a", 2, 3, "ccc", 12)));
+    QVERIFY(reassembler.add(chunk("a", 0, 3, "aaa", 10)));
+    QCOMPARE(reassembler.bufferedBytes(), qint64(6));
+    QVERIFY(reassembler.add(chunk("a", 1, 3, "bbb", 11)));
+    QCOMPARE(reassembler.bufferedBytes(), qint64(0));
+
+    QTRY_COMPARE(this->m_Assembled.size(), 1);
+    const PulsarMessage& message = this->m_Assembled.first();
+    QCOMPARE(message.body(), QByteArray("aaabbbccc"));
+    QCOMPARE(message.ledgerId(), 7);
+    QCOMPARE(message.entryId(), 12);
+    QCOMPARE(message.chunks().size(), 3);
+    QCOMPARE(message.chunks().first().entryId(), 10);
+    QVERIFY(this->m_Incomplete.isEmpty());
+
+    //read again by an overlapping page
+    QVERIFY(reassembler.add(chunk("a", 0, 3, "aaa", 10)));
+    QCOMPARE(reassembler.bufferedBytes(), qint64(0));
+    QVERIFY(!reassembler.add(PulsarMessage::fromPayload("plain")));
+}
+
+void TestChunkReassembler::duplicateChunk()
+{
+    ChunkReassembler reassembler(nullptr, QString(), QString());
+    listen(reassembler);
+
+    QVERIFY(reassembler.add(chunk("a", 0, 2, "aa", 10)));
+    QVERIFY(reassembler.add(chunk("a", 0, 2, "aa", 10)));
+    QCOMPARE(reassembler.bufferedBytes(), qint64(2));
+    QVERIFY(reassembler.add(chunk("a", 1, 2, "bb", 11)));
+
+    QTRY_COMPARE(this->m_Assembled.size(), 1);
+    QCOMPARE(this->m_Assembled.first().body(), QByteArray("aabb"));
+    QVERIFY(this->m_Incomplete.isEmpty());
+}
+
+void TestChunkReassembler::missingChunk()
+{
+    ChunkReassembler reassembler(nullptr, QString(), QString());
+    reassembler.setMaxScanEntries(0);
+    listen(reassembler);
+
+    QVERIFY(reassembler.add(chunk("a", 0, 3, "aa", 10)));
+    QVERIFY(reassembler.add(chunk("a", 2, 3, "cc", 12)));
+    QVERIFY(this->m_Incomplete.isEmpty());
+    reassembler.flush();
+
+    QCOMPARE(this->m_Incomplete.size(), 1);
+    QCOMPARE(this->m_Incomplete.first().size(), 2);
+    QCOMPARE(this->m_Incomplete.first().at(0).chunkId(), 0);
+    QCOMPARE(this->m_Incomplete.first().at(1).chunkId(), 2);
+    QCOMPARE(reassembler.bufferedBytes(), qint64(0));
+
+    //the missing chunk coming late is ignored
+    QVERIFY(reassembler.add(chunk("a", 1, 3, "bb", 11)));
+    QTest::qWait(10);
+    QVERIFY(this->m_Assembled.isEmpty());
+    QCOMPARE(this->m_Incomplete.size(), 1);
+}
+
+void TestChunkReassembler::eviction()
+{
+    ChunkReassembler reassembler(nullptr, QString(), QString());
+    reassembler.setMaxBufferedBytes(10);
+    listen(reassembler);
+
+    QVERIFY(reassembler.add(chunk("a", 0, 2, "aaaaaa", 10)));
+    QVERIFY(reassembler.add(chunk("b", 0, 2, "bbbbbb", 11)));
+
+    //the oldest message is given up to get back under the cap
+    QCOMPARE(this->m_Incomplete.size(), 1);
+    QCOMPARE(this->m_Incomplete.first().size(), 1);
+    QCOMPARE(this->m_Incomplete.first().first().uuid(), QString("a"));
+    QCOMPARE(reassembler.bufferedBytes(), qint64(6));
+
+    QVERIFY(reassembler.add(chunk("a", 1, 2, "aaaaaa", 12)));
+    QVERIFY(reassembler.add(chunk("b", 1, 2, "bbbbbb", 13)));
+    QTRY_COMPARE(this->m_Assembled.size(), 1);
+    QCOMPARE(this->m_Assembled.first().body(), QByteArray("bbbbbbbbbbbb"));
+    QCOMPARE(this->m_Incomplete.size(), 1);
+    QCOMPARE(reassembler.bufferedBytes(), qint64(0));
+}
+
+void TestChunkReassembler::malformed_data()
+{
+    QTest::addColumn<QString>("uuid");
+    QTest::addColumn<int>("chunkId");
+    QTest::addColumn<int>("numChunks");
+    QTest::addColumn<int>("totalChunkSize");
+
+    QTest::newRow("chunk id past the last chunk") << QString("b") << 3 << 3 << 9;
+    QTest::newRow("more chunks than bytes") << QString("b") << 0 << 1000 << 9;
+    QTest::newRow("more chunks than the cap") << QString("b") << 0 << 0x40000000 << 0x7FFFFFFF;
+    QTest::newRow("other count than the first chunk") << QString("a") << 1 << 4 << 9;
+}
+
+void TestChunkReassembler::malformed()
+{
+    QFETCH(QString, uuid);
+    QFETCH(int, chunkId);
+    QFETCH(int, numChunks);
+    QFETCH(int, totalChunkSize);
+
+    ChunkReassembler reassembler(nullptr, QString(), QString());
+    listen(reassembler);
+    QVERIFY(reassembler.add(chunk("a", 0, 3, "aaa", 10)));
+
+    //nothing is buffered for the chunk, however many chunks it claims
+    QVERIFY(reassembler.add(chunk(uuid, chunkId, numChunks, "xxx", 11, totalChunkSize)));
+    QCOMPARE(this->m_Incomplete.size(), 1);
+    QCOMPARE(this->m_Incomplete.first().size(), 1);
+    QCOMPARE(this->m_Incomplete.first().first().chunkId(), chunkId);
+    QCOMPARE(reassembler.bufferedBytes(), qint64(3));
+
+    //the message of the chunks that match goes on
+    QVERIFY(reassembler.add(chunk("a", 1, 3, "bbb", 11)));
+    QVERIFY(reassembler.add(chunk("a", 2, 3, "ccc", 12)));
+    QTRY_COMPARE(this->m_Assembled.size(), 1);
+    QCOMPARE(this->m_Assembled.first().body(), QByteArray("aaabbbccc"));
+}
+
+QTEST_GUILESS_MAIN(TestChunkReassembler)
+
+#include "tst_chunkreassembler.moc"
@@ -0,0 +1,206 @@
+#include <QtTest>
+
+#include "../src/decompressor.h"
+
+namespace
+{
+//206 bytes with repeats, so that every codec emits back references, some of them overlapping
+const QByteArray PLAIN = QByteArray("{\"topic\":\"persistent://public/default/orders\",\"seq\":1}").repeated(3) + QByteArray(44, 'a');
+
+/**
+ * @brief A valid LZ4 block of literals only, the decoder takes no shortcut for it.
+ */
+QByteArray lz4Literals(const QByteArray& _data)
+{
+    QByteArray block;
+    qsizetype length = _data.size();
+    block.append(static_cast<char>(qMin<qsizetype>(length, 15) << 4));
+    for (length -= 15; length >= 0; length -= 255)
+    {
+        block.append(static_cast<char>(qMin<qsizetype>(length, 255)));
+        if (length < 255)
+        {
+            break;
+        }
+    }
+    return block + _data;
+}
+
+/**
+ * @brief A valid Snappy stream of literal elements of at most 64 KB.
+ */
+QByteArray snappyLiterals(const QByteArray& _data)
+{
+    QByteArray stream;
+    for (quint64 length = _data.size(); ; length >>= 7)
+    {
+        stream.append(static_cast<char>((length & 0x7F) | (length >= 0x80 ? 0x80 : 0)));
+        if (length < 0x80)
+        {
+            break;
+        }
+    }
+    for (qsizetype at = 0; at < _data.size(); at += 65536)
+    {
+        qsizetype length = qMin<qsizetype>(65536, _data.size() - at);
+        stream.append(static_cast<char>(61 << 2));
+        stream.append(static_cast<char>((length - 1) & 0xFF));
+        stream.append(static_cast<char>((length - 1) >> 8));
+        stream.append(_data.mid(at, length));
+    }
+    return stream;
+}
+}
+
+/**
+ * @brief The LZ4 and Snappy decoders run on payloads of the broker, every malformed input must
+ * fail with an empty output rather than read or write out of its buffer.
+ */
+class TestDecompressor : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void knownVectors_data();
+    void knownVectors();
+    void roundTrip_data();
+    void roundTrip();
+    void malformed_data();
+    void malformed();
+    void compressionType();
+};
+
+/**
+ * @brief PLAIN compressed with the reference codecs, through pyarrow.compress() and zlib.compress().
+ */
+void TestDecompressor::knownVectors_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<QByteArray>("input");
+
+    QTest::newRow("none") << int(MessageMetadata::NONE) << PLAIN;
+    QTest::newRow("lz4") << int(MessageMetadata::LZ4) << QByteArray::fromHex(
+        "ff277b22746f706963223a2270657273697374656e743a2f2f7075626c69632f64656661756c742f6f7264657273222c22736571223a317d3600591f61010013506161616161");
+    QTest::newRow("snappy") << int(MessageMetadata::SNAPPY) << QByteArray::fromHex(
+        "ce01d87b22746f706963223a2270657273697374656e743a2f2f7075626c69632f64656661756c742f6f7264657273222c22736571223a317d7bfe3600aa36000061aa0100");
+    QTest::newRow("zlib") << int(MessageMetadata::ZLIB) << QByteArray::fromHex(
+        "789cab562ac92fc84c56b2522a482d2ace2c2e49cd2bb1d2d72f284dcac94cd64f494d4b2ccd29d1cf2f4a01ca2ae92815a7162a5919d656d3515722090000ddac4a52");
+#ifdef PDM_HAVE_ZSTD
+    QTest::newRow("zstd") << int(MessageMetadata::ZSTD) << QByteArray::fromHex(
+        "28b52ffd20ce15020074037b22746f706963223a2270657273697374656e743a2f2f7075626c69632f64656661756c742f6f7264657273222c22736571223a317d610200e04c6129a70a0a");
+#endif
+}
+
+void TestDecompressor::knownVectors()
+{
+    QFETCH(int, type);
+    QFETCH(QByteArray, input);
+    MessageMetadata::CompressionType codec = static_cast<MessageMetadata::CompressionType>(type);
+
+    QByteArray output;
+    QVERIFY(Decompressor::decompress(codec, input, static_cast<int>(PLAIN.size()), output));
+    QCOMPARE(output, PLAIN);
+
+    if (codec != MessageMetadata::NONE)
+    {
+        //the size the broker reports must be met exactly
+        QVERIFY(!Decompressor::decompress(codec, input, static_cast<int>(PLAIN.size()) - 1, output));
+        QVERIFY(output.isEmpty());
+        QVERIFY(!Decompressor::decompress(codec, input, static_cast<int>(PLAIN.size()) + 1, output));
+        QVERIFY(output.isEmpty());
+    }
+}
+
+void TestDecompressor::roundTrip_data()
+{
+    QTest::addColumn<QByteArray>("data");
+
+    QByteArray noise(100000, Qt::Uninitialized);
+    quint32 seed = 1;
+    for (qsizetype i = 0; i < noise.size(); ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        noise[i] = static_cast<char>(seed >> 16);
+    }
+    QTest::newRow("one byte") << QByteArray("x");
+    QTest::newRow("15 bytes") << QByteArray(15, 'y');
+    QTest::newRow("270 bytes") << QByteArray(270, 'z');
+    QTest::newRow("text") << PLAIN;
+    QTest::newRow("100 KB") << noise;
+}
+
+void TestDecompressor::roundTrip()
+{
+    QFETCH(QByteArray, data);
+    const int size = static_cast<int>(data.size());
+
+    QByteArray output;
+    QVERIFY(Decompressor::decompress(MessageMetadata::LZ4, lz4Literals(data), size, output));
+    QCOMPARE(output, data);
+    QVERIFY(Decompressor::decompress(MessageMetadata::SNAPPY, snappyLiterals(data), size, output));
+    QCOMPARE(output, data);
+    QVERIFY(Decompressor::decompress(MessageMetadata::ZLIB, qCompress(data).mid(4), size, output));
+    QCOMPARE(output, data);
+}
+
+void TestDecompressor::malformed_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<QByteArray>("input");
+    QTest::addColumn<int>("size");
+
+    const int lz4 = MessageMetadata::LZ4;
+    const int snappy = MessageMetadata::SNAPPY;
+    QTest::newRow("lz4 empty") << lz4 << QByteArray() << 1;
+    QTest::newRow("lz4 truncated literal length") << lz4 << QByteArray::fromHex("f0") << 20;
+    QTest::newRow("lz4 unterminated literal length") << lz4 << QByteArray::fromHex("f0ffff") << 600;
+    QTest::newRow("lz4 literals beyond the input") << lz4 << QByteArray::fromHex("506162") << 5;
+    QTest::newRow("lz4 literals beyond the output") << lz4 << QByteArray::fromHex("5061626364656600") << 3;
+    QTest::newRow("lz4 truncated offset") << lz4 << QByteArray::fromHex("106100") << 5;
+    QTest::newRow("lz4 offset 0") << lz4 << QByteArray::fromHex("10610000") << 5;
+    QTest::newRow("lz4 offset before the output") << lz4 << QByteArray::fromHex("10610200") << 5;
+    QTest::newRow("lz4 offset far before the output") << lz4 << QByteArray::fromHex("1061ffff") << 5;
+    QTest::newRow("lz4 truncated match length") << lz4 << QByteArray::fromHex("1f610100") << 30;
+    QTest::newRow("lz4 match beyond the output") << lz4 << QByteArray::fromHex("1f61010010") << 10;
+    QTest::newRow("snappy empty") << snappy << QByteArray() << 0;
+    QTest::newRow("snappy oversized varint") << snappy << QByteArray::fromHex("ffffffffff01") << 1;
+    QTest::newRow("snappy unterminated varint") << snappy << QByteArray::fromHex("8080") << 1;
+    QTest::newRow("snappy length other than reported") << snappy << QByteArray::fromHex("020061") << 1;
+    QTest::newRow("snappy truncated literal length") << snappy << QByteArray::fromHex("05f0") << 5;
+    QTest::newRow("snappy literals beyond the input") << snappy << QByteArray::fromHex("051061") << 5;
+    QTest::newRow("snappy literals beyond the output") << snappy << QByteArray::fromHex("0108616263") << 1;
+    QTest::newRow("snappy offset 0") << snappy << QByteArray::fromHex("0500610100") << 5;
+    QTest::newRow("snappy offset before the output") << snappy << QByteArray::fromHex("0500610102") << 5;
+    QTest::newRow("snappy 4 byte offset before the output") << snappy << QByteArray::fromHex("05006103ffffffff") << 5;
+    QTest::newRow("snappy truncated copy") << snappy << QByteArray::fromHex("0500610201") << 5;
+    QTest::newRow("snappy copy beyond the output") << snappy << QByteArray::fromHex("0200610101") << 2;
+    QTest::newRow("zlib garbage") << int(MessageMetadata::ZLIB) << QByteArray::fromHex("789c0000ffff") << 10;
+    QTest::newRow("zlib truncated") << int(MessageMetadata::ZLIB) << QByteArray::fromHex("789cab562ac92f") << 206;
+    QTest::newRow("zstd garbage") << int(MessageMetadata::ZSTD) << QByteArray::fromHex("28b52ffd00") << 10;
+    QTest::newRow("negative size") << lz4 << QByteArray::fromHex("1061") << -1;
+}
+
+void TestDecompressor::malformed()
+{
+    QFETCH(int, type);
+    QFETCH(QByteArray, input);
+    QFETCH(int, size);
+
+    QByteArray output("left over");
+    QVERIFY(!Decompressor::decompress(static_cast<MessageMetadata::CompressionType>(type), input, size, output));
+    QVERIFY(output.isEmpty());
+}
+
+void TestDecompressor::compressionType()
+{
+    QCOMPARE(Decompressor::compressionType("LZ4"), MessageMetadata::LZ4);
+    QCOMPARE(Decompressor::compressionType(" zstd "), MessageMetadata::ZSTD);
+    QCOMPARE(Decompressor::compressionType("Snappy"), MessageMetadata::SNAPPY);
+    QCOMPARE(Decompressor::compressionType("ZLIB"), MessageMetadata::ZLIB);
+    QCOMPARE(Decompressor::compressionType("NONE"), MessageMetadata::NONE);
+    QCOMPARE(Decompressor::compressionType("brotli"), MessageMetadata::NONE);
+}
+
+QTEST_APPLESS_MAIN(TestDecompressor)
+
+#include "tst_decompressor.moc"
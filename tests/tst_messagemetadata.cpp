@@ -0,0 +1,117 @@
+#include <QtTest>
+
+#include "../src/messagemetadata.h"
+#include "../src/pulsarmessage.h"
+
+/**
+ * @brief Runs the metadata decoders over a table of malformed and hostile inputs, none of them
+ * may read out of the span or yield a negative size.
+ */
+class TestMessageMetadata : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseSingle_data();
+    void parseSingle();
+    void parseMalformed_data();
+    void parseMalformed();
+    void messageFields();
+};
+
+void TestMessageMetadata::parseSingle_data()
+{
+    QTest::addColumn<QByteArray>("input");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<int>("payloadSize");
+
+    QTest::newRow("payload size") << QByteArray::fromHex("1805") << true << 5;
+    QTest::newRow("property and payload size") << QByteArray::fromHex("0a080a016b120376616c1800") << true << 0;
+    QTest::newRow("unknown fixed64 skipped") << QByteArray::fromHex("5901020304050607081802") << true << 2;
+    QTest::newRow("empty") << QByteArray() << false << 0;
+    QTest::newRow("truncated varint") << QByteArray::fromHex("1880") << false << 0;
+    QTest::newRow("negative payload size") << QByteArray::fromHex("18ffffffffffffffffff01") << false << 0;
+    QTest::newRow("payload size above int32") << QByteArray::fromHex("188080808008") << false << 0;
+    QTest::newRow("varint longer than 10 bytes") << QByteArray::fromHex("18ffffffffffffffffffff01") << false << 0;
+    QTest::newRow("length beyond the span") << QByteArray::fromHex("0a0501") << false << 0;
+    QTest::newRow("length near 4 GB") << QByteArray::fromHex("12ffffffff0f") << false << 0;
+    QTest::newRow("property beyond its message") << QByteArray::fromHex("0a020a051801") << false << 0;
+    QTest::newRow("field zero") << QByteArray::fromHex("0000") << false << 0;
+    QTest::newRow("group wire type") << QByteArray::fromHex("1b") << false << 0;
+    QTest::newRow("truncated fixed32") << QByteArray::fromHex("1d0102") << false << 0;
+}
+
+void TestMessageMetadata::parseSingle()
+{
+    QFETCH(QByteArray, input);
+    QFETCH(bool, valid);
+    QFETCH(int, payloadSize);
+
+    SingleMessageMetadata metadata;
+    QCOMPARE(SingleMessageMetadata::parse(input.constData(), static_cast<int>(input.size()), metadata), valid);
+    if (valid)
+    {
+        QCOMPARE(metadata.payloadSize(), payloadSize);
+    }
+}
+
+void TestMessageMetadata::parseMalformed_data()
+{
+    QTest::addColumn<QByteArray>("input");
+
+    QTest::newRow("negative messages in batch") << QByteArray::fromHex("58ffffffffffffffffff01");
+    QTest::newRow("chunk id above int32") << QByteArray::fromHex("e8018080808008");
+    QTest::newRow("truncated producer name") << QByteArray::fromHex("0a0570");
+    QTest::newRow("truncated key") << QByteArray::fromHex("80");
+}
+
+void TestMessageMetadata::parseMalformed()
+{
+    QFETCH(QByteArray, input);
+
+    MessageMetadata metadata;
+    QVERIFY(!MessageMetadata::parse(input.constData(), static_cast<int>(input.size()), metadata));
+}
+
+/**
+ * @brief The key and the properties of a message come from the metadata parsed when the message
+ * is built, the ones set on it take precedence and stay with the copy they were set on.
+ */
+void TestMessageMetadata::messageFields()
+{
+    //content-type: json, key order-1, payload size 3, then key order-2, payload size 2
+    const QByteArray first = QByteArray::fromHex("00000021" "0a140a0c636f6e74656e742d7479706512046a736f6e" "12076f726465722d31" "1803" "616263");
+    const QByteArray second = QByteArray::fromHex("0000000b" "12076f726465722d32" "1802" "6465");
+
+    QList<PulsarMessage> batch = PulsarMessage::splitBatch(first + second, 2);
+    QCOMPARE(batch.size(), 2);
+    QCOMPARE(batch[0].key(), QString("order-1"));
+    QCOMPARE(batch[0].properties().value("content-type"), QString("json"));
+    QCOMPARE(batch[0].body(), QByteArray("abc"));
+    QCOMPARE(batch[1].key(), QString("order-2"));
+    QVERIFY(batch[1].properties().isEmpty());
+    QCOMPARE(batch[1].body(), QByteArray("de"));
+    QCOMPARE(batch[1].metadata().payloadSize(), 2);
+
+    PulsarMessage message(first);
+    QCOMPARE(message.key(), QString("order-1"));
+    QCOMPARE(message.body(), QByteArray("abc"));
+
+    PulsarMessage copy(message);
+    copy.setKey("order-9");
+    copy.addProperties("trace-id", "abc-123");
+    QCOMPARE(copy.key(), QString("order-9"));
+    QCOMPARE(copy.properties().value("trace-id"), QString("abc-123"));
+    QCOMPARE(copy.properties().value("content-type"), QString("json"));
+    QCOMPARE(message.key(), QString("order-1"));
+    QCOMPARE(message.properties().size(), 1);
+
+    PulsarMessage plain = PulsarMessage::fromPayload(QByteArray("no metadata"));
+    QVERIFY(plain.key().isEmpty());
+    QVERIFY(plain.properties().isEmpty());
+    QCOMPARE(plain.body(), QByteArray("no metadata"));
+}
+
+QTEST_APPLESS_MAIN(TestMessageMetadata)
+
+#include "tst_messagemetadata.moc"
@@ -0,0 +1,305 @@
+#include <QtTest>
+
+#include "../src/protobufreader.h"
+#include "../src/messagemetadata.h"
+
+namespace
+{
+/**
+ * @brief SingleMessageMetadata of a typical entry: two properties, a partition key and the
+ * payload size. The strings are shorter than 128 bytes, the former parser read longer ones wrong.
+ */
+const QByteArray METADATA = QByteArray::fromHex(
+    "0a140a0c636f6e74656e742d7479706512046a736f6e"          //content-type: json
+    "0a170a0874726163652d6964120b6162632d3132332d646566"    //trace-id: abc-123-def
+    "120b6f726465722d3132333435"                            //key order-12345
+    "18e807");                                              //payload size 1000
+
+/**
+ * @brief The parser replaced by ProtobufReader, as PulsarMessage::readHeader and readProperty
+ * were, kept to measure the new one against.
+ */
+struct LegacyHeader
+{
+    QByteArray header;
+    QMap<QString, QString> properties;
+    QString key;
+    int bodyLength = 0;
+
+    void readHeader(int& _pos)
+    {
+        bool ok;
+        QByteArray id = this->header.mid(_pos++, 1);
+        if (id == QString("\n"))
+        {
+            int len = this->header.mid(_pos++, 1).toHex().toInt(&ok, 16);
+            QByteArray property = this->header.mid(_pos, len);
+            _pos += len;
+            readProperty(property);
+            readHeader(_pos);
+        }
+        else if (id == QString("\x12"))
+        {
+            int len = this->header.mid(_pos++, 1).toHex().toInt(&ok, 16);
+            QByteArray key = this->header.mid(_pos, len);
+            _pos += len;
+            this->key = QString::fromLatin1(key);
+            readHeader(_pos);
+        }
+        else if (id == QString("\x18"))
+        {
+            int len = this->header.mid(_pos++, 1).toHex().toInt(&ok, 16);
+            if (len >= 128)
+            {
+                int exlen = this->header.mid(_pos++, 1).toHex().toInt(&ok, 16);
+                len += (exlen - 1) * 128;
+            }
+            this->bodyLength = len;
+        }
+    }
+
+    void readProperty(const QByteArray& _property)
+    {
+        bool ok;
+        int pos = 0;
+        int keyLength = _property.mid(++pos, 1).toHex().toInt(&ok, 16);
+        QByteArray key = _property.mid(++pos, keyLength);
+        pos += keyLength;
+        int valueLength = _property.mid(++pos, 1).toHex().toInt(&ok, 16);
+        QByteArray value = _property.mid(++pos, valueLength);
+        this->properties.insert(QString::fromLatin1(key), QString::fromLatin1(value));
+    }
+};
+}
+
+/**
+ * @brief The wire format reader on hostile input, and what it costs against the parser it replaced.
+ */
+class TestProtobufReader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void varint_data();
+    void varint();
+    void fieldKey_data();
+    void fieldKey();
+    void lengthDelimited_data();
+    void lengthDelimited();
+    void skipWireTypes_data();
+    void skipWireTypes();
+    void skipUnknownFields();
+    void sameAsLegacy();
+    void benchmarkReader();
+    void benchmarkLegacy();
+};
+
+void TestProtobufReader::varint_data()
+{
+    QTest::addColumn<QByteArray>("input");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<quint64>("value");
+
+    QTest::newRow("one byte") << QByteArray::fromHex("01") << true << quint64(1);
+    QTest::newRow("two bytes") << QByteArray::fromHex("ac02") << true << quint64(300);
+    QTest::newRow("redundant zero group") << QByteArray::fromHex("8100") << true << quint64(1);
+    QTest::newRow("10 bytes, max") << QByteArray::fromHex("ffffffffffffffffff01") << true << quint64(0xFFFFFFFFFFFFFFFFULL);
+    QTest::newRow("11 bytes") << QByteArray::fromHex("ffffffffffffffffffff01") << false << quint64(0);
+    QTest::newRow("11 bytes of zero groups") << QByteArray::fromHex("8080808080808080808000") << false << quint64(0);
+    QTest::newRow("truncated") << QByteArray::fromHex("80") << false << quint64(0);
+    QTest::newRow("empty") << QByteArray() << false << quint64(0);
+}
+
+void TestProtobufReader::varint()
+{
+    QFETCH(QByteArray, input);
+    QFETCH(bool, valid);
+    QFETCH(quint64, value);
+
+    ProtobufReader reader(input.constData(), static_cast<int>(input.size()));
+    quint64 result;
+    QCOMPARE(reader.readVarint(result), valid);
+    QCOMPARE(reader.hasError(), !valid);
+    if (valid)
+    {
+        QCOMPARE(result, value);
+        QVERIFY(reader.atEnd());
+    }
+}
+
+void TestProtobufReader::fieldKey_data()
+{
+    QTest::addColumn<QByteArray>("input");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<quint32>("field");
+    QTest::addColumn<int>("wireType");
+
+    QTest::newRow("field 1 varint") << QByteArray::fromHex("08") << true << quint32(1) << int(ProtobufReader::Varint);
+    QTest::newRow("field 2 length-delimited") << QByteArray::fromHex("12") << true << quint32(2) << int(ProtobufReader::LengthDelimited);
+    QTest::newRow("field 29 varint") << QByteArray::fromHex("e801") << true << quint32(29) << int(ProtobufReader::Varint);
+    QTest::newRow("field 0") << QByteArray::fromHex("00") << false << quint32(0) << 0;
+    QTest::newRow("field 0 fixed32") << QByteArray::fromHex("05") << false << quint32(0) << 0;
+    QTest::newRow("truncated key") << QByteArray::fromHex("e8") << false << quint32(0) << 0;
+}
+
+void TestProtobufReader::fieldKey()
+{
+    QFETCH(QByteArray, input);
+    QFETCH(bool, valid);
+    QFETCH(quint32, field);
+    QFETCH(int, wireType);
+
+    ProtobufReader reader(input.constData(), static_cast<int>(input.size()));
+    quint32 number;
+    int type;
+    QCOMPARE(reader.next(number, type), valid);
+    if (valid)
+    {
+        QCOMPARE(number, field);
+        QCOMPARE(type, wireType);
+    }
+    else
+    {
+        QVERIFY(reader.hasError());
+        QVERIFY(!reader.next(number, type));
+    }
+}
+
+void TestProtobufReader::lengthDelimited_data()
+{
+    QTest::addColumn<QByteArray>("input");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<QByteArray>("value");
+
+    QTest::newRow("three bytes") << QByteArray::fromHex("03616263") << true << QByteArray("abc");
+    QTest::newRow("empty") << QByteArray::fromHex("00") << true << QByteArray();
+    QTest::newRow("200 bytes") << QByteArray::fromHex("c801") + QByteArray(200, 'k') << true << QByteArray(200, 'k');
+    QTest::newRow("one byte short") << QByteArray::fromHex("04616263") << false << QByteArray();
+    QTest::newRow("no length") << QByteArray() << false << QByteArray();
+    QTest::newRow("truncated length") << QByteArray::fromHex("c8") << false << QByteArray();
+    QTest::newRow("length near 4 GB") << QByteArray::fromHex("ffffffff0f616263") << false << QByteArray();
+    QTest::newRow("length near 2^64") << QByteArray::fromHex("ffffffffffffffffff01616263") << false << QByteArray();
+}
+
+void TestProtobufReader::lengthDelimited()
+{
+    QFETCH(QByteArray, input);
+    QFETCH(bool, valid);
+    QFETCH(QByteArray, value);
+
+    ProtobufReader reader(input.constData(), static_cast<int>(input.size()));
+    const char* data = nullptr;
+    int length = -1;
+    QCOMPARE(reader.readBytes(data, length), valid);
+    QCOMPARE(reader.hasError(), !valid);
+    if (valid)
+    {
+        QCOMPARE(QByteArray(data, length), value);
+        //a span of the input, not a copy
+        QVERIFY(data + length == input.constData() + input.size());
+    }
+}
+
+void TestProtobufReader::skipWireTypes_data()
+{
+    QTest::addColumn<int>("wireType");
+    QTest::addColumn<QByteArray>("value");
+    QTest::addColumn<bool>("valid");
+
+    QTest::newRow("varint") << int(ProtobufReader::Varint) << QByteArray::fromHex("ac02") << true;
+    QTest::newRow("fixed64") << int(ProtobufReader::Fixed64) << QByteArray(8, '\x01') << true;
+    QTest::newRow("length-delimited") << int(ProtobufReader::LengthDelimited) << QByteArray::fromHex("02abcd") << true;
+    QTest::newRow("fixed32") << int(ProtobufReader::Fixed32) << QByteArray(4, '\x01') << true;
+    QTest::newRow("truncated fixed64") << int(ProtobufReader::Fixed64) << QByteArray(7, '\x01') << false;
+    QTest::newRow("truncated fixed32") << int(ProtobufReader::Fixed32) << QByteArray(3, '\x01') << false;
+    QTest::newRow("start group") << int(ProtobufReader::StartGroup) << QByteArray(8, '\x01') << false;
+    QTest::newRow("end group") << int(ProtobufReader::EndGroup) << QByteArray(8, '\x01') << false;
+    QTest::newRow("wire type 6") << 6 << QByteArray(8, '\x01') << false;
+    QTest::newRow("wire type 7") << 7 << QByteArray(8, '\x01') << false;
+}
+
+void TestProtobufReader::skipWireTypes()
+{
+    QFETCH(int, wireType);
+    QFETCH(QByteArray, value);
+    QFETCH(bool, valid);
+
+    //field 1 of the wire type and its value, followed by field 2 as a varint unless it is cut short
+    QByteArray input = QByteArray(1, static_cast<char>(1 << 3 | wireType)) + value + (valid ? QByteArray::fromHex("1005") : QByteArray());
+    ProtobufReader reader(input.constData(), static_cast<int>(input.size()));
+    quint32 field;
+    int type;
+    QVERIFY(reader.next(field, type));
+    QCOMPARE(type, wireType);
+    QCOMPARE(reader.skip(type), valid);
+    if (!valid)
+    {
+        QVERIFY(reader.hasError());
+        QVERIFY(!reader.next(field, type));
+        return;
+    }
+    quint64 number;
+    QVERIFY(reader.next(field, type));
+    QCOMPARE(field, quint32(2));
+    QVERIFY(reader.readVarint(number));
+    QCOMPARE(number, quint64(5));
+    QVERIFY(reader.atEnd());
+}
+
+/**
+ * @brief Fields the decoders do not know, of every wire type, are stepped over.
+ */
+void TestProtobufReader::skipUnknownFields()
+{
+    QByteArray input = QByteArray::fromHex(
+        "f807ac02"              //field 127 varint
+        "f9070102030405060708"  //field 127 fixed64
+        "fa0703616263"          //field 127 length-delimited
+        "fd0701020304"          //field 127 fixed32
+        "18e807"                //payload size 1000
+        "c8a00101");            //field 2569 varint
+    SingleMessageMetadata metadata;
+    QVERIFY(SingleMessageMetadata::parse(input.constData(), static_cast<int>(input.size()), metadata));
+    QCOMPARE(metadata.payloadSize(), 1000);
+    QVERIFY(metadata.properties().isEmpty());
+}
+
+void TestProtobufReader::sameAsLegacy()
+{
+    SingleMessageMetadata metadata;
+    QVERIFY(SingleMessageMetadata::parse(METADATA.constData(), static_cast<int>(METADATA.size()), metadata));
+    LegacyHeader legacy;
+    legacy.header = METADATA;
+    int pos = 0;
+    legacy.readHeader(pos);
+
+    QCOMPARE(metadata.properties(), legacy.properties);
+    QCOMPARE(metadata.partitionKey(), legacy.key);
+    QCOMPARE(metadata.payloadSize(), legacy.bodyLength);
+    QCOMPARE(metadata.payloadSize(), 1000);
+    QCOMPARE(metadata.properties().value("content-type"), QString("json"));
+}
+
+void TestProtobufReader::benchmarkReader()
+{
+    QBENCHMARK
+    {
+        SingleMessageMetadata metadata;
+        SingleMessageMetadata::parse(METADATA.constData(), static_cast<int>(METADATA.size()), metadata);
+    }
+}
+
+void TestProtobufReader::benchmarkLegacy()
+{
+    QBENCHMARK
+    {
+        LegacyHeader legacy;
+        legacy.header = METADATA;
+        int pos = 0;
+        legacy.readHeader(pos);
+    }
+}
+
+QTEST_APPLESS_MAIN(TestProtobufReader)
+
+#include "tst_protobufreader.moc"
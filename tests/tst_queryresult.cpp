@@ -0,0 +1,179 @@
+#include <QtTest>
+#include <QJsonDocument>
+
+#include "../src/queryresult.h"
+#include "../src/table.h"
+
+namespace
+{
+/**
+ * @brief A result of one column of _type, filled from the data array _rows.
+ */
+QueryResult single(const QString& _type, const QByteArray& _rows)
+{
+    Column column;
+    column.setName("c");
+    column.setType(_type);
+    QueryResult result;
+    result.setColumns(QList<Column>() << column);
+    result.append(QJsonDocument::fromJson(_rows).array());
+    return result;
+}
+}
+
+/**
+ * @brief The typed storage of Presto rows: the type a column is kept as, the values of the JSON
+ * numbers and the bitmap of the nulls.
+ */
+class TestQueryResult : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void typeOf_data();
+    void typeOf();
+    void integer_data();
+    void integer();
+    void nulls();
+};
+
+void TestQueryResult::typeOf_data()
+{
+    QTest::addColumn<QString>("prestoType");
+    QTest::addColumn<int>("type");
+
+    QTest::newRow("bigint") << QString("bigint") << int(QueryResult::Integer);
+    QTest::newRow("integer") << QString("integer") << int(QueryResult::Integer);
+    QTest::newRow("smallint") << QString("smallint") << int(QueryResult::Integer);
+    QTest::newRow("tinyint") << QString("tinyint") << int(QueryResult::Integer);
+    QTest::newRow("upper case, spaces") << QString(" BIGINT ") << int(QueryResult::Integer);
+    QTest::newRow("double") << QString("double") << int(QueryResult::Double);
+    QTest::newRow("real") << QString("real") << int(QueryResult::Double);
+    QTest::newRow("boolean") << QString("boolean") << int(QueryResult::Boolean);
+    QTest::newRow("varchar") << QString("varchar") << int(QueryResult::Varchar);
+    QTest::newRow("decimal") << QString("decimal(10,2)") << int(QueryResult::Varchar);
+    QTest::newRow("timestamp") << QString("timestamp(3)") << int(QueryResult::Varchar);
+    QTest::newRow("array of bigint") << QString("array(bigint)") << int(QueryResult::Varchar);
+}
+
+void TestQueryResult::typeOf()
+{
+    QFETCH(QString, prestoType);
+    QFETCH(int, type);
+
+    QCOMPARE(int(QueryResult::typeOf(prestoType)), type);
+    QCOMPARE(int(single(prestoType, "[]").type(0)), type);
+}
+
+void TestQueryResult::integer_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<qint64>("value");
+
+    QTest::newRow("integral") << QByteArray("42") << qint64(42);
+    QTest::newRow("zero") << QByteArray("0") << qint64(0);
+    QTest::newRow("negative") << QByteArray("-7") << qint64(-7);
+    QTest::newRow("max") << QByteArray("9223372036854775807") << std::numeric_limits<qint64>::max();
+    QTest::newRow("fraction truncated") << QByteArray("2.75") << qint64(2);
+    QTest::newRow("negative fraction truncated") << QByteArray("-2.75") << qint64(-2);
+    QTest::newRow("below one") << QByteArray("0.5") << qint64(0);
+    QTest::newRow("exponent") << QByteArray("1.5e3") << qint64(1500);
+    QTest::newRow("above int64") << QByteArray("1e19") << std::numeric_limits<qint64>::max();
+    QTest::newRow("below int64") << QByteArray("-1e19") << std::numeric_limits<qint64>::min();
+    QTest::newRow("string") << QByteArray("\"-12\"") << qint64(-12);
+    QTest::newRow("string with a fraction") << QByteArray("\"3.5\"") << qint64(3);
+}
+
+void TestQueryResult::integer()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(qint64, value);
+
+    QueryResult result = single("bigint", "[[" + json + "]]");
+    QCOMPARE(result.rowCount(), qsizetype(1));
+    QVERIFY(!result.isNull(0, 0));
+    QCOMPARE(result.integer(0, 0), value);
+    QCOMPARE(result.text(0, 0), QString::number(value));
+}
+
+/**
+ * @brief Nulls of every type over more than one word of the bitmap, a missing trailing cell
+ * counts as null.
+ */
+void TestQueryResult::nulls()
+{
+    QList<Column> columns;
+    const char* types[] = { "bigint", "double", "boolean", "varchar" };
+    for (int i = 0; i < 4; ++i)
+    {
+        Column column;
+        column.setName(QString("c%1").arg(i));
+        column.setType(types[i]);
+        columns << column;
+    }
+    QueryResult result;
+    result.setColumns(columns);
+
+    //two pages, the first one ending inside the second word of the bitmaps
+    QJsonArray first;
+    QJsonArray second;
+    for (int row = 0; row < 150; ++row)
+    {
+        QJsonArray cells;
+        if (row % 3 == 0)
+        {
+            cells.append(QJsonValue(QJsonValue::Null));
+            cells.append(QJsonValue(QJsonValue::Null));
+            cells.append(QJsonValue(QJsonValue::Null));
+            cells.append(QJsonValue(QJsonValue::Null));
+        }
+        else if (row % 3 == 1)
+        {
+            cells.append(row);
+            cells.append(row / 2.0);
+            cells.append(row % 2 == 0);
+            cells.append(QString(""));
+        }
+        else
+        {
+            cells.append(row);
+        }
+        (row < 70 ? first : second).append(cells);
+    }
+    QCOMPARE(result.append(first), qsizetype(70));
+    QCOMPARE(result.append(second), qsizetype(80));
+    QCOMPARE(result.rowCount(), qsizetype(150));
+
+    for (int row = 0; row < 150; ++row)
+    {
+        QCOMPARE(result.isNull(row, 0), row % 3 == 0);
+        QCOMPARE(result.isNull(row, 1), row % 3 != 1);
+        QCOMPARE(result.isNull(row, 2), row % 3 != 1);
+        QCOMPARE(result.isNull(row, 3), row % 3 != 1);
+        QCOMPARE(result.value(row, 3).isNull(), row % 3 != 1);
+        if (row % 3 != 0)
+        {
+            QCOMPARE(result.integer(row, 0), qint64(row));
+        }
+        if (row % 3 == 1)
+        {
+            QCOMPARE(result.real(row, 1), row / 2.0);
+            QCOMPARE(result.boolean(row, 2), row % 2 == 0);
+            QCOMPARE(result.text(row, 3), QString(""));
+        }
+    }
+    //nulls order first
+    QCOMPARE(result.compare(0, 0, 1), -1);
+    QCOMPARE(result.compare(0, 1, 0), 1);
+    QCOMPARE(result.compare(0, 0, 3), 0);
+
+    result.clearRows();
+    QCOMPARE(result.rowCount(), qsizetype(0));
+    QCOMPARE(result.columnCount(), 4);
+    QCOMPARE(result.append(second, 1), qsizetype(1));
+    QVERIFY(!result.isNull(0, 3));
+}
+
+QTEST_APPLESS_MAIN(TestQueryResult)
+
+#include "tst_queryresult.moc"
@@ -0,0 +1,412 @@
+#include <QtTest>
+#include <QDateTime>
+
+#include "../src/schemadecoder.h"
+
+namespace
+{
+QByteArray varint(quint64 _value)
+{
+    QByteArray bytes;
+    for (; _value >= 0x80; _value >>= 7)
+    {
+        bytes.append(static_cast<char>((_value & 0x7F) | 0x80));
+    }
+    return bytes.append(static_cast<char>(_value));
+}
+
+/**
+ * @brief A protobuf field of the wire type varint.
+ */
+QByteArray number(const quint32& _field, const quint64& _value)
+{
+    return varint(_field << 3) + varint(_value);
+}
+
+/**
+ * @brief A length-delimited protobuf field: a string, bytes or an embedded message.
+ */
+QByteArray bytes(const quint32& _field, const QByteArray& _value)
+{
+    return varint(_field << 3 | 2) + varint(_value.size()) + _value;
+}
+
+/**
+ * @brief FieldDescriptorProto with its name, number, label (1 optional, 3 repeated), type and type name.
+ */
+QByteArray fieldDescriptor(const QByteArray& _name, const int& _number, const int& _label, const int& _type, const QByteArray& _typeName = QByteArray())
+{
+    QByteArray field = bytes(1, _name) + number(3, _number) + number(4, _label) + number(5, _type);
+    return _typeName.isEmpty() ? field : field + bytes(6, _typeName);
+}
+
+/**
+ * @brief The FileDescriptorSet protoc writes for
+ *
+ *     package shop;
+ *     enum Status { NEW = 0; PAID = 1; }
+ *     message Order {
+ *         message Line { string sku = 1; int32 qty = 2; repeated int32 codes = 3; }
+ *         int64 id = 1; repeated string tags = 2; repeated Line lines = 3; Status status = 4; sint64 delta = 5;
+ *     }
+ */
+QByteArray orderDescriptors()
+{
+    QByteArray line = bytes(1, "Line")
+        + bytes(2, fieldDescriptor("sku", 1, 1, 9))
+        + bytes(2, fieldDescriptor("qty", 2, 1, 5))
+        + bytes(2, fieldDescriptor("codes", 3, 3, 5));
+    QByteArray order = bytes(1, "Order")
+        + bytes(2, fieldDescriptor("id", 1, 1, 3))
+        + bytes(2, fieldDescriptor("tags", 2, 3, 9))
+        + bytes(2, fieldDescriptor("lines", 3, 3, 11, ".shop.Order.Line"))
+        + bytes(2, fieldDescriptor("status", 4, 1, 14, ".shop.Status"))
+        + bytes(2, fieldDescriptor("delta", 5, 1, 18))
+        + bytes(3, line);
+    QByteArray status = bytes(1, "Status") + bytes(2, bytes(1, "NEW") + number(2, 0)) + bytes(2, bytes(1, "PAID") + number(2, 1));
+    QByteArray file = bytes(1, "order.proto") + bytes(2, "shop") + bytes(4, order) + bytes(5, status);
+    return bytes(1, file);
+}
+
+QByteArray protobufSchema(const QByteArray& _descriptors, const QByteArray& _root)
+{
+    return "{\"fileDescriptorSet\":\"" + _descriptors.toBase64() + "\",\"rootMessageTypeName\":\"" + _root
+        + "\",\"rootFileDescriptorName\":\"order.proto\"}";
+}
+
+QByteArray int32(const qint32& _value)
+{
+    QByteArray bytes(4, Qt::Uninitialized);
+    qToBigEndian(_value, bytes.data());
+    return bytes;
+}
+
+QVariant decode(const QByteArray& _type, const QByteArray& _definition, const QByteArray& _payload, const Properties& _properties = Properties())
+{
+    QSharedPointer<const SchemaDecoder> decoder = SchemaDecoder::create(_type, _definition, _properties);
+    if (decoder.isNull())
+    {
+        return QVariant();
+    }
+    return decoder->decode(QByteArray(), QByteArrayView(_payload));
+}
+}
+
+/**
+ * @brief The schema decoders on payloads of the broker: the encodings of every schema type,
+ * and truncated or over-long lengths, which must decode to an invalid QVariant rather than
+ * read out of the payload.
+ */
+class TestSchemaDecoder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void avroLong_data();
+    void avroLong();
+    void avroBlocks_data();
+    void avroBlocks();
+    void avroUnion_data();
+    void avroUnion();
+    void avroLogicalTypes_data();
+    void avroLogicalTypes();
+    void avroMalformed_data();
+    void avroMalformed();
+    void keyValueInline_data();
+    void keyValueInline();
+    void keyValueSeparated();
+    void keyValueAvro();
+    void protobufNative();
+    void protobufNativeMalformed_data();
+    void protobufNativeMalformed();
+    void protobufNativeDescriptors();
+};
+
+void TestSchemaDecoder::avroLong_data()
+{
+    QTest::addColumn<QByteArray>("input");
+    QTest::addColumn<qint64>("value");
+
+    QTest::newRow("0") << QByteArray::fromHex("00") << qint64(0);
+    QTest::newRow("-1") << QByteArray::fromHex("01") << qint64(-1);
+    QTest::newRow("1") << QByteArray::fromHex("02") << qint64(1);
+    QTest::newRow("-64") << QByteArray::fromHex("7f") << qint64(-64);
+    QTest::newRow("64") << QByteArray::fromHex("8001") << qint64(64);
+    QTest::newRow("-65") << QByteArray::fromHex("8101") << qint64(-65);
+    QTest::newRow("max") << QByteArray::fromHex("feffffffffffffffff01") << qint64(0x7FFFFFFFFFFFFFFFLL);
+    QTest::newRow("min") << QByteArray::fromHex("ffffffffffffffffff01") << qint64(-0x7FFFFFFFFFFFFFFFLL - 1);
+}
+
+void TestSchemaDecoder::avroLong()
+{
+    QFETCH(QByteArray, input);
+    QFETCH(qint64, value);
+
+    QVariant result = decode("AVRO", "\"long\"", input);
+    QVERIFY(result.isValid());
+    QCOMPARE(result.toLongLong(), value);
+}
+
+void TestSchemaDecoder::avroBlocks_data()
+{
+    QTest::addColumn<QByteArray>("schema");
+    QTest::addColumn<QByteArray>("input");
+    QTest::addColumn<QVariant>("value");
+
+    QByteArray array = "{\"type\":\"array\",\"items\":\"long\"}";
+    QByteArray map = "{\"type\":\"map\",\"values\":\"string\"}";
+    QTest::newRow("empty array") << array << QByteArray::fromHex("00") << QVariant(QVariantList());
+    QTest::newRow("array in one block") << array << QByteArray::fromHex("04020400") << QVariant(QVariantList { qint64(1), qint64(2) });
+    //-1 item of 1 byte after a block of 2 items
+    QTest::newRow("array with a negative count") << array << QByteArray::fromHex("040204" "0102" "06" "00")
+                                                 << QVariant(QVariantList { qint64(1), qint64(2), qint64(3) });
+    //-2 entries of 8 bytes
+    QTest::newRow("map with a negative count") << map << QByteArray::fromHex("0310" "02610278" "02620279" "00")
+                                               << QVariant(QVariantMap { { "a", "x" }, { "b", "y" } });
+    QTest::newRow("map in two blocks") << map << QByteArray::fromHex("02026102780202620279" "00")
+                                       << QVariant(QVariantMap { { "a", "x" }, { "b", "y" } });
+}
+
+void TestSchemaDecoder::avroBlocks()
+{
+    QFETCH(QByteArray, schema);
+    QFETCH(QByteArray, input);
+    QFETCH(QVariant, value);
+
+    QCOMPARE(decode("AVRO", schema, input), value);
+}
+
+void TestSchemaDecoder::avroUnion_data()
+{
+    QTest::addColumn<QByteArray>("input");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<QVariant>("note");
+
+    QTest::newRow("string branch") << QByteArray::fromHex("0204686932") << true << QVariant("hi");
+    QTest::newRow("null branch") << QByteArray::fromHex("0032") << true << QVariant();
+    QTest::newRow("branch beyond the union") << QByteArray::fromHex("0432") << false << QVariant();
+    QTest::newRow("negative branch") << QByteArray::fromHex("0132") << false << QVariant();
+    QTest::newRow("no branch") << QByteArray() << false << QVariant();
+}
+
+void TestSchemaDecoder::avroUnion()
+{
+    QFETCH(QByteArray, input);
+    QFETCH(bool, valid);
+    QFETCH(QVariant, note);
+
+    QByteArray schema = "{\"type\":\"record\",\"name\":\"Order\",\"namespace\":\"shop\",\"fields\":["
+                        "{\"name\":\"note\",\"type\":[\"null\",\"string\"]},{\"name\":\"qty\",\"type\":\"int\"}]}";
+    QVariant result = decode("AVRO", schema, input);
+    QCOMPARE(result.isValid(), valid);
+    if (valid)
+    {
+        QCOMPARE(result.toMap().value("note"), note);
+        QCOMPARE(result.toMap().value("qty").toInt(), 25);
+    }
+}
+
+void TestSchemaDecoder::avroLogicalTypes_data()
+{
+    QTest::addColumn<QByteArray>("schema");
+    QTest::addColumn<QByteArray>("input");
+    QTest::addColumn<QVariant>("value");
+
+    QTest::newRow("date") << QByteArray("{\"type\":\"int\",\"logicalType\":\"date\"}") << QByteArray::fromHex("bcae02")
+                          << QVariant(QDate(2023, 1, 1));
+    QTest::newRow("date before the epoch") << QByteArray("{\"type\":\"int\",\"logicalType\":\"date\"}") << QByteArray::fromHex("01")
+                                           << QVariant(QDate(1969, 12, 31));
+    QTest::newRow("timestamp-millis") << QByteArray("{\"type\":\"long\",\"logicalType\":\"timestamp-millis\"}") << QByteArray::fromHex("f6a186aaad61")
+                                      << QVariant(QDateTime::fromMSecsSinceEpoch(1672531200123LL, Qt::UTC));
+    QTest::newRow("timestamp-micros") << QByteArray("{\"type\":\"long\",\"logicalType\":\"timestamp-micros\"}") << QByteArray::fromHex("8089f9c090caf805")
+                                      << QVariant(QDateTime::fromMSecsSinceEpoch(1672531200123LL, Qt::UTC));
+    QByteArray decimal = "{\"type\":\"bytes\",\"logicalType\":\"decimal\",\"precision\":9,\"scale\":2}";
+    QTest::newRow("decimal") << decimal << QByteArray::fromHex("043039") << QVariant("123.45");
+    QTest::newRow("negative decimal") << decimal << QByteArray::fromHex("04ff85") << QVariant("-1.23");
+    QTest::newRow("decimal below 1") << decimal << QByteArray::fromHex("0205") << QVariant("0.05");
+    QTest::newRow("fixed decimal") << QByteArray("{\"type\":\"fixed\",\"name\":\"Price\",\"size\":2,\"logicalType\":\"decimal\",\"scale\":1}")
+                                   << QByteArray::fromHex("ff9c") << QVariant("-10.0");
+    QTest::newRow("decimal of 8 bytes, minimum") << decimal << QByteArray::fromHex("108000000000000000") << QVariant("-92233720368547758.08");
+    //more than 8 bytes are left as they are
+    QTest::newRow("wide decimal") << decimal << QByteArray::fromHex("12") + QByteArray(9, '\x01') << QVariant(QByteArray(9, '\x01'));
+}
+
+void TestSchemaDecoder::avroLogicalTypes()
+{
+    QFETCH(QByteArray, schema);
+    QFETCH(QByteArray, input);
+    QFETCH(QVariant, value);
+
+    QCOMPARE(decode("AVRO", schema, input), value);
+}
+
+void TestSchemaDecoder::avroMalformed_data()
+{
+    QTest::addColumn<QByteArray>("schema");
+    QTest::addColumn<QByteArray>("input");
+
+    QByteArray array = "{\"type\":\"array\",\"items\":\"long\"}";
+    QTest::newRow("empty long") << QByteArray("\"long\"") << QByteArray();
+    QTest::newRow("truncated long") << QByteArray("\"long\"") << QByteArray::fromHex("80");
+    QTest::newRow("long of 11 bytes") << QByteArray("\"long\"") << QByteArray::fromHex("ffffffffffffffffffff01");
+    QTest::newRow("truncated double") << QByteArray("\"double\"") << QByteArray(7, '\x01');
+    QTest::newRow("string beyond the payload") << QByteArray("\"string\"") << QByteArray::fromHex("066162");
+    QTest::newRow("negative string length") << QByteArray("\"string\"") << QByteArray::fromHex("016162");
+    QTest::newRow("string length of 2 GB") << QByteArray("\"string\"") << QByteArray::fromHex("8080808010") + QByteArray("ab");
+    QTest::newRow("bytes length near 2^63") << QByteArray("\"bytes\"") << QByteArray::fromHex("feffffffffffffffff01") + QByteArray("ab");
+    QTest::newRow("truncated fixed") << QByteArray("{\"type\":\"fixed\",\"name\":\"Hash\",\"size\":16}") << QByteArray(15, '\x01');
+    QTest::newRow("array without end marker") << array << QByteArray::fromHex("040204");
+    QTest::newRow("array count of 2^30") << array << QByteArray::fromHex("8080808008" "02");
+    QTest::newRow("negative count without size") << array << QByteArray::fromHex("01");
+    QTest::newRow("map key beyond the payload") << QByteArray("{\"type\":\"map\",\"values\":\"int\"}") << QByteArray::fromHex("02086100");
+    QTest::newRow("enum symbol beyond the enum") << QByteArray("{\"type\":\"enum\",\"name\":\"Status\",\"symbols\":[\"NEW\",\"PAID\"]}")
+                                                 << QByteArray::fromHex("04");
+    QTest::newRow("truncated record") << QByteArray("{\"type\":\"record\",\"name\":\"Pair\",\"fields\":[{\"name\":\"a\",\"type\":\"int\"},"
+                                                    "{\"name\":\"b\",\"type\":\"string\"}]}") << QByteArray::fromHex("02");
+}
+
+void TestSchemaDecoder::avroMalformed()
+{
+    QFETCH(QByteArray, schema);
+    QFETCH(QByteArray, input);
+
+    QVERIFY(!SchemaDecoder::create("AVRO", schema, Properties()).isNull());
+    QVERIFY(!decode("AVRO", schema, input).isValid());
+}
+
+void TestSchemaDecoder::keyValueInline_data()
+{
+    QTest::addColumn<QByteArray>("input");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<QVariant>("key");
+
+    QTest::newRow("key and value") << int32(3) + "abc" + int32(4) + int32(42) << true << QVariant("abc");
+    QTest::newRow("empty key") << int32(0) + int32(4) + int32(42) << true << QVariant("");
+    QTest::newRow("null key") << int32(-1) + int32(4) + int32(42) << true << QVariant();
+    QTest::newRow("no value length") << int32(3) + "abc" << false << QVariant();
+    QTest::newRow("key length -2") << int32(-2) + int32(4) + int32(42) << false << QVariant();
+    QTest::newRow("key beyond the payload") << int32(12) + "abc" + int32(4) + int32(42) << false << QVariant();
+    QTest::newRow("key length near 2 GB") << int32(0x7FFFFFFC) + "abc" + int32(4) + int32(42) << false << QVariant();
+    QTest::newRow("value beyond the payload") << int32(3) + "abc" + int32(5) + int32(42) << false << QVariant();
+    QTest::newRow("value length near 2 GB") << int32(3) + "abc" + int32(0x7FFFFFFF) + int32(42) << false << QVariant();
+    QTest::newRow("shorter than a length") << QByteArray::fromHex("000000") << false << QVariant();
+}
+
+void TestSchemaDecoder::keyValueInline()
+{
+    QFETCH(QByteArray, input);
+    QFETCH(bool, valid);
+    QFETCH(QVariant, key);
+
+    QByteArray schema = "{\"key\":{\"type\":\"STRING\",\"schema\":\"\"},\"value\":{\"type\":\"INT32\",\"schema\":\"\"}}";
+    Properties properties { { "kv.encoding.type", "INLINE" } };
+    QVariant result = decode("KEY_VALUE", schema, input, properties);
+    QCOMPARE(result.isValid(), valid);
+    if (valid)
+    {
+        QCOMPARE(result.toMap().value("key"), key);
+        QCOMPARE(result.toMap().value("value"), QVariant(42));
+    }
+}
+
+/**
+ * @brief The key is the base64 encoded partition key, the payload holds only the value. The
+ * schemas are in the binary encoding of older brokers.
+ */
+void TestSchemaDecoder::keyValueSeparated()
+{
+    QByteArray schema = int32(0) + int32(0);
+    Properties properties { { "kv.encoding.type", "SEPARATED" }, { "key.schema.type", "STRING" }, { "value.schema.type", "INT64" } };
+    QSharedPointer<const SchemaDecoder> decoder = SchemaDecoder::create("KEY_VALUE", schema, properties);
+    QVERIFY(!decoder.isNull());
+
+    QByteArray value = int32(0) + int32(1000);
+    QVariantMap result = decoder->decode(QByteArray("order-12345").toBase64(), QByteArrayView(value)).toMap();
+    QCOMPARE(result.value("key"), QVariant("order-12345"));
+    QCOMPARE(result.value("value").toLongLong(), qint64(1000));
+
+    //a value of another width does not match the schema
+    result = decoder->decode(QByteArray("order-12345").toBase64(), QByteArrayView(int32(1000))).toMap();
+    QVERIFY(!result.value("value").isValid());
+
+    QVERIFY(SchemaDecoder::create("KEY_VALUE", int32(100) + int32(0), properties).isNull());
+}
+
+/**
+ * @brief An Avro value whose schema the admin api returns as a JSON object rather than a string.
+ */
+void TestSchemaDecoder::keyValueAvro()
+{
+    QByteArray schema = "{\"key\":{\"type\":\"STRING\",\"schema\":\"\"},\"value\":{\"type\":\"AVRO\",\"schema\":"
+                        "{\"type\":\"record\",\"name\":\"Order\",\"fields\":[{\"name\":\"qty\",\"type\":\"int\"}]}}}";
+    QVariant result = decode("KEY_VALUE", schema, int32(1) + "k" + int32(1) + QByteArray::fromHex("32"), Properties());
+    QCOMPARE(result.toMap().value("key"), QVariant("k"));
+    QCOMPARE(result.toMap().value("value").toMap().value("qty").toInt(), 25);
+}
+
+/**
+ * @brief A message with a nested message, repeated strings and messages, packed repeated ints,
+ * an enum, a sint64 and a field the descriptor does not know, decoded back into its values.
+ */
+void TestSchemaDecoder::protobufNative()
+{
+    QByteArray schema = protobufSchema(orderDescriptors(), "shop.Order");
+    QByteArray payload = number(1, 7)
+        + bytes(2, "a") + bytes(2, "b")
+        + bytes(3, bytes(1, "x") + number(2, 2) + bytes(3, QByteArray::fromHex("010203")))
+        + bytes(3, bytes(1, "y") + number(2, 1) + number(3, 4) + number(3, 5))
+        + number(4, 1)
+        + number(5, 5)
+        + number(9, 300);
+
+    QVariantMap first { { "sku", "x" }, { "qty", 2 }, { "codes", QVariantList { 1, 2, 3 } } };
+    QVariantMap second { { "sku", "y" }, { "qty", 1 }, { "codes", QVariantList { 4, 5 } } };
+    QVariantMap order {
+        { "id", qint64(7) },
+        { "tags", QVariantList { "a", "b" } },
+        { "lines", QVariantList { first, second } },
+        { "status", "PAID" },
+        { "delta", qint64(-3) },
+        { "9", quint64(300) }
+    };
+    QCOMPARE(decode("PROTOBUF_NATIVE", schema, payload), QVariant(order));
+
+    //an enum number the descriptor does not name stays a number
+    QCOMPARE(decode("PROTOBUF_NATIVE", schema, number(4, 7)).toMap().value("status"), QVariant(7));
+    QCOMPARE(decode("PROTOBUF_NATIVE", schema, QByteArray()), QVariant(QVariantMap()));
+}
+
+void TestSchemaDecoder::protobufNativeMalformed_data()
+{
+    QTest::addColumn<QByteArray>("input");
+
+    QTest::newRow("truncated varint") << QByteArray::fromHex("0880");
+    QTest::newRow("string beyond the payload") << QByteArray::fromHex("1205616263");
+    QTest::newRow("length near 4 GB") << QByteArray::fromHex("12ffffffff0f616263");
+    QTest::newRow("wrong wire type") << QByteArray::fromHex("0d01020304");
+    QTest::newRow("truncated nested message") << bytes(3, QByteArray::fromHex("0a0578"));
+    QTest::newRow("truncated packed ints") << bytes(3, bytes(3, QByteArray::fromHex("0180")));
+    QTest::newRow("group") << QByteArray::fromHex("0b");
+    QTest::newRow("field 0") << QByteArray::fromHex("0001");
+}
+
+void TestSchemaDecoder::protobufNativeMalformed()
+{
+    QFETCH(QByteArray, input);
+
+    QVERIFY(!decode("PROTOBUF_NATIVE", protobufSchema(orderDescriptors(), "shop.Order"), input).isValid());
+}
+
+void TestSchemaDecoder::protobufNativeDescriptors()
+{
+    QByteArray descriptors = orderDescriptors();
+    QVERIFY(!SchemaDecoder::create("PROTOBUF_NATIVE", protobufSchema(descriptors, "shop.Order.Line"), Properties()).isNull());
+    QVERIFY(SchemaDecoder::create("PROTOBUF_NATIVE", protobufSchema(descriptors, "shop.Invoice"), Properties()).isNull());
+    QVERIFY(SchemaDecoder::create("PROTOBUF_NATIVE", protobufSchema(descriptors.left(descriptors.size() - 3), "shop.Order"), Properties()).isNull());
+    QVERIFY(SchemaDecoder::create("PROTOBUF_NATIVE", protobufSchema(QByteArray::fromHex("0affffffff0f"), "shop.Order"), Properties()).isNull());
+    QVERIFY(SchemaDecoder::create("PROTOBUF_NATIVE", "not json", Properties()).isNull());
+}
+
+QTEST_APPLESS_MAIN(TestSchemaDecoder)
+
+#include "tst_schemadecoder.moc"